@@ -3848,6 +3848,191 @@ RvStatus RVCALLCONV RvSocketSendManyBuffers(
     return retv;
 }
 
+#if (RV_SOCKET_TYPE == RV_SOCKET_BSD) && (RV_OS_TYPE == RV_OS_TYPE_LINUX)
+#include <netinet/udp.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#define RV_SEND_MESSAGES_MMSG RV_YES
+/* maximal payload of one GSO super-datagram */
+#define RV_UDP_GSO_MAX_BYTES 65000
+/* 0 - not probed yet, 1 - supported, -1 - not supported by the kernel or device */
+static volatile RvInt rvSocketUdpGsoState = 0;
+#else
+#define RV_SEND_MESSAGES_MMSG RV_NO
+#endif
+
+/********************************************************************************************
+ * RvSocketSendMessages
+ * Send several UDP datagrams to the same remote address.
+ * Each buffer is sent as a separate datagram, in order.
+ * This function is thread-safe.
+ * INPUT   : sock       - UDP socket to be used for sending
+ *           numOfMsgs  - Number of datagrams to be sent, up to RV_SOCKET_SEND_MESSAGES_MAX.
+ *           ppBuff     - Array of pointers of the datagrams to be sent.
+ *           pLen       - Array of lengths of the datagrams to be sent.
+ *           remoteAddress - Address where to send the datagrams to.
+ *           logMgr     - Log manager
+ * OUTPUT  : msgsSent   - Number of datagrams that were sent.
+ * RETURN  : RV_OK on success, other on failure
+ */
+RVCOREAPI
+RvStatus RVCALLCONV RvSocketSendMessages(
+    IN  RvSocket*   sock,
+    IN  RvUint32    numOfMsgs,
+    IN  RvUint8**   ppBuff,
+    IN  RvSize_t*   pLen,
+    IN  RvAddress*  remoteAddress,
+    IN  RvLogMgr*   logMgr,
+    OUT RvUint32*   msgsSent)
+{
+    RvStatus retv = RV_OK;
+    RvUint32 sent = 0;
+
+    if (msgsSent != NULL)
+        *msgsSent = 0;
+
+    if ((sock == NULL) || (ppBuff == NULL) || (pLen == NULL) || (remoteAddress == NULL) ||
+        (numOfMsgs > RV_SOCKET_SEND_MESSAGES_MAX))
+    {
+        return RvSocketErrorCode(RV_ERROR_BADPARAM);
+    }
+
+    if (numOfMsgs == 0)
+        return RV_OK;
+
+#if (RV_SEND_MESSAGES_MMSG == RV_YES)
+    {
+        struct mmsghdr msgs[RV_SOCKET_SEND_MESSAGES_MAX];
+        struct iovec   iovs[RV_SOCKET_SEND_MESSAGES_MAX];
+        rvASockAddr    u;
+        int            socklen = RV_SOCKET_SOCKADDR_SIZE;
+        int            socketError = 0;
+        RvSocket       ourSocket;
+        RvUint32       i;
+        RvSize_t       totalLen = 0;
+        RvBool         bSameSize = RV_TRUE;
+        int            ret;
+
+        if (RvSocketAddressToSockAddr(remoteAddress, RVSOCKADDR(u), &socklen) != RV_OK)
+        {
+            RvSockLogError((&logMgr->socketSource,
+                "RvSocketSendMessages(sock=%d) failed in RvSocketAddressToSockAddr", *sock));
+            return RV_ERROR_BADPARAM;
+        }
+
+        if (RvSocketSharerShare(logMgr, sock, &ourSocket) != RV_OK)
+            return RvSocketErrorCode(RV_ERROR_BADPARAM);
+
+        (void)rvShadowSetFlowinfo(&ourSocket, RVSOCKDATA(u), logMgr);
+
+        for (i = 0; i < numOfMsgs; i++)
+        {
+            iovs[i].iov_base = (void*)ppBuff[i];
+            iovs[i].iov_len  = pLen[i];
+            totalLen += pLen[i];
+            if ((i + 1 < numOfMsgs && pLen[i] != pLen[0]) || pLen[i] > pLen[0] || pLen[i] == 0)
+                bSameSize = RV_FALSE;
+        }
+
+        /* UDP GSO: one sendmsg() carries the whole batch, the kernel (or NIC)
+           cuts it back into pLen[0] sized datagrams. */
+        if (numOfMsgs > 1 && bSameSize && rvSocketUdpGsoState >= 0 && totalLen <= RV_UDP_GSO_MAX_BYTES)
+        {
+            struct msghdr   msg;
+            struct cmsghdr* cm;
+            char            control[CMSG_SPACE(sizeof(RvUint16))];
+            RvUint16        gsoSize = (RvUint16)pLen[0];
+
+            memset(&msg, 0, sizeof(msg));
+            memset(control, 0, sizeof(control));
+            msg.msg_name       = (void*)&u;
+            msg.msg_namelen    = socklen;
+            msg.msg_iov        = iovs;
+            msg.msg_iovlen     = numOfMsgs;
+            msg.msg_control    = control;
+            msg.msg_controllen = sizeof(control);
+            cm = CMSG_FIRSTHDR(&msg);
+            cm->cmsg_level = SOL_UDP;
+            cm->cmsg_type  = UDP_SEGMENT;
+            cm->cmsg_len   = CMSG_LEN(sizeof(RvUint16));
+            memcpy(CMSG_DATA(cm), &gsoSize, sizeof(gsoSize));
+
+            ret = sendmsg(ourSocket, &msg, RV_MSG_NOSIGNAL);
+            if (ret >= 0)
+            {
+                rvSocketUdpGsoState = 1;
+                sent = numOfMsgs;
+            }
+            else
+            {
+                socketError = RvSocketErrNo;
+                /* EINVAL/EIO also come back per destination (route MTU, segment
+                   count, no checksum offload on the egress device): only give up
+                   on GSO for good if it never worked, else fall back for this call */
+                if ((socketError == EIO || socketError == EINVAL ||
+                    socketError == ENOPROTOOPT || socketError == EOPNOTSUPP) &&
+                    rvSocketUdpGsoState == 0)
+                {
+                    /* no GSO on this kernel/device: never try again, use sendmmsg() */
+                    rvSocketUdpGsoState = -1;
+                    RvSockLogDebug((&logMgr->socketSource,
+                        "RvSocketSendMessages(sock=%d): UDP GSO not supported (errno=%d)", *sock, socketError));
+                }
+            }
+        }
+
+        if (sent == 0)
+        {
+            for (i = 0; i < numOfMsgs; i++)
+            {
+                memset(&msgs[i], 0, sizeof(msgs[i]));
+                msgs[i].msg_hdr.msg_name    = (void*)&u;
+                msgs[i].msg_hdr.msg_namelen = socklen;
+                msgs[i].msg_hdr.msg_iov     = &iovs[i];
+                msgs[i].msg_hdr.msg_iovlen  = 1;
+            }
+
+            while (sent < numOfMsgs)
+            {
+                ret = sendmmsg(ourSocket, &msgs[sent], numOfMsgs - sent, RV_MSG_NOSIGNAL);
+                if (ret <= 0)
+                {
+                    socketError = RvSocketErrNo;
+                    if (!RvSocketErrorWouldBlock(socketError))
+                        retv = RvSocketErrorCode(RV_ERROR_UNKNOWN);
+                    break;
+                }
+                sent += (RvUint32)ret;
+            }
+        }
+
+        RvSocketSharerClose(&ourSocket);
+
+        if (retv != RV_OK)
+        {
+            RvSockLogError((&logMgr->socketSource,
+                "RvSocketSendMessages(sock=%d,numOfMsgs=%d,sent=%d,errno=%d)=%d",
+                *sock, numOfMsgs, sent, socketError, retv));
+        }
+    }
+#else /* (RV_SEND_MESSAGES_MMSG == RV_YES) */
+    for (; sent < numOfMsgs; sent++)
+    {
+        retv = RvSocketSendBuffer(sock, ppBuff[sent], pLen[sent], remoteAddress, logMgr, NULL);
+        if (retv != RV_OK)
+            break;
+    }
+#endif /* (RV_SEND_MESSAGES_MMSG == RV_YES) */
+
+    if (msgsSent != NULL)
+        *msgsSent = sent;
+    return retv;
+}
+
 /********************************************************************************************
  * RvSocketReceiveBuffer
  * Receive a buffer from a socket.
@@ -64,6 +64,12 @@ such revisions or changes.
 #define RV_NET_TYPE RV_NET_SCTP
 #endif
 #endif
+/* Use of select() */
+#if defined(RV_CFLAG_SELECT)
+#undef  RV_SELECT_TYPE
+#define RV_SELECT_TYPE RV_SELECT_SELECT
+#endif
+
 /* Use of poll() */
 #if defined(RV_CFLAG_POLL)
 #undef  RV_SELECT_TYPE
@@ -776,6 +776,37 @@ RvStatus RVCALLCONV RvSocketSendManyBuffers(
     IN  RvLogMgr*   logMgr,
     OUT RvSize_t*   bytesSent);
 
+/* Maximal number of datagrams handled by one RvSocketSendMessages() call */
+#define RV_SOCKET_SEND_MESSAGES_MAX 64
+
+/********************************************************************************************
+ * RvSocketSendMessages
+ * Send several UDP datagrams to the same remote address.
+ * Each buffer is sent as a separate datagram, in order.
+ * On Linux the datagrams are handed to the kernel with a single UDP GSO (UDP_SEGMENT)
+ * sendmsg() call when all of them but the last have the same size, or with sendmmsg()
+ * otherwise. If the kernel or the outgoing device does not support GSO, the function
+ * falls back to sendmmsg() permanently. Other platforms send the datagrams one by one.
+ * This function is thread-safe.
+ * INPUT   : sock       - UDP socket to be used for sending
+ *           numOfMsgs  - Number of datagrams to be sent, up to RV_SOCKET_SEND_MESSAGES_MAX.
+ *           ppBuff     - Array of pointers of the datagrams to be sent.
+ *           pLen       - Array of lengths of the datagrams to be sent.
+ *           remoteAddress - Address where to send the datagrams to.
+ *           logMgr     - Log manager
+ * OUTPUT  : msgsSent   - Number of datagrams that were sent.
+ * RETURN  : RV_OK on success, other on failure
+ */
+RVCOREAPI
+RvStatus RVCALLCONV RvSocketSendMessages(
+    IN  RvSocket*   sock,
+    IN  RvUint32    numOfMsgs,
+    IN  RvUint8**   ppBuff,
+    IN  RvSize_t*   pLen,
+    IN  RvAddress*  remoteAddress,
+    IN  RvLogMgr*   logMgr,
+    OUT RvUint32*   msgsSent);
+
 /********************************************************************************************
  * RvSocketReceiveBuffer
  * Receive a buffer from a socket.
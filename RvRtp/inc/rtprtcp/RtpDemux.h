@@ -34,8 +34,12 @@ changes.
 extern "C" {
 #endif
 
-#define getIndexFromMultiplexID(x)   (x & 0x0000FFFF)
-#define getMultiplexID(runningCounter, vacantEntry)   (((runningCounter<<16) &0xFFFF0000)|(vacantEntry))
+/* multiplexID = (running counter << RTP_DEMUX_INDEX_BITS) | table index.
+   20 index bits allow more than 64K sub-sessions per demux object. */
+#define RTP_DEMUX_INDEX_BITS         20
+#define RTP_DEMUX_MAX_SESSIONS       (1 << RTP_DEMUX_INDEX_BITS)
+#define getIndexFromMultiplexID(x)   ((x) & (RTP_DEMUX_MAX_SESSIONS - 1))
+#define getMultiplexID(runningCounter, vacantEntry)   ((((RvUint32)(runningCounter)) << RTP_DEMUX_INDEX_BITS)|(vacantEntry))
 /* Demux table entry */
 typedef struct 
 {
@@ -493,6 +493,32 @@ RvInt32 RVCALLCONV RvRtpWrite(
         IN     RvInt32        len,
         INOUT  RvRtpParam *   p);
 
+/************************************************************************************
+ * RvRtpWriteMany
+ * description: This routine sends several RTP packets (e.g. all slices of one frame)
+ *              to every remote address of the session.
+ *              Every packet is packed the same way as RvRtpWrite does, but all packets
+ *              for one remote address are handed to the socket layer at once
+ *              (RvSocketSendMessages: UDP GSO or sendmmsg on Linux).
+ *              Encrypted sessions and multiplexed remote addresses fall back to
+ *              per-packet sending.
+ * input: hRTP  - Handle of the RTP session.
+ *        count - Number of packets.
+ *        bufs  - Array of packet buffers, see buf of RvRtpWrite.
+ *        lens  - Array of lengths in bytes of bufs (RTP header + RTP data).
+ *        p     - Array of RTP params, see p of RvRtpWrite.
+ * output: none.
+ * return value:  If no error occurs, the function returns the non-negative value.
+ *                Otherwise, it returns a negative value.
+ ***********************************************************************************/
+RVAPI
+RvInt32 RVCALLCONV RvRtpWriteMany(
+        IN     RvRtpSession   hRTP,
+        IN     RvUint32       count,
+        IN     void **        bufs,
+        IN     RvInt32 *      lens,
+        INOUT  RvRtpParam *   p);
+
 
 
 /************************************************************************************
@@ -1137,6 +1137,137 @@ RvInt32 RVCALLCONV RvRtpWrite(
 	return RvRtpWriteEx(hRTP, s->sSrc, buf, len, p);
 
 }
+
+/************************************************************************************
+ * RvRtpWriteMany
+ * description:  This routine sends several RTP packets to all remote addresses
+ *               with a minimal number of system calls.
+ * input: hRTP  - Handle of the RTP session.
+ *        count - Number of packets.
+ *        bufs  - Array of packet buffers, see RvRtpWrite.
+ *        lens  - Array of lengths in bytes of bufs (RTP header + RTP data).
+ *        p     - Array of RTP params.
+ * output: none.
+ * return value:  If no error occurs, the function returns the non-negative value.
+ *                Otherwise, it returns a negative value.
+ ***********************************************************************************/
+RVAPI
+RvInt32 RVCALLCONV RvRtpWriteMany(
+        IN     RvRtpSession   hRTP,
+        IN     RvUint32       count,
+        IN     void **        bufs,
+        IN     RvInt32 *      lens,
+        INOUT  RvRtpParam *   p)
+{
+    RvRtpSessionInfo *s = (RvRtpSessionInfo *)hRTP;
+    RvStatus          res = RV_OK;
+    RvSocket          sock = (RvSocket)RV_INVALID_SOCKET;
+    RvUint32          i;
+    RvUint32          done;
+
+	RvLogEnter(rvLogPtr,(rvLogPtr, "RvRtpWriteMany"));
+
+	if (s == NULL || bufs == NULL || lens == NULL || p == NULL)
+	{
+        RvLogError(rvLogPtr,(rvLogPtr, "RvRtpWriteMany: NULL session handle or parameters"));
+        RvLogLeave(rvLogPtr,(rvLogPtr, "RvRtpWriteMany"));
+        return RV_ERROR_NULLPTR;
+	}
+
+    /* encrypted packets are padded and encrypted one by one,
+       the socket layer can not batch them */
+    if (count == 1 || s->encryptionPlugInPtr != NULL ||
+        RvTransportGetOption(s->transport, RVTRANSPORT_OPTTYPE_SOCKETTRANSPORT,
+                             RVTRANSPORT_OPT_SOCKET, (void*)&sock) != RV_OK)
+    {
+        for (i = 0; i < count; i++)
+        {
+            res = RvRtpWriteEx(hRTP, s->sSrc, bufs[i], lens[i], &p[i]);
+        }
+        RvLogLeave(rvLogPtr,(rvLogPtr, "RvRtpWriteMany"));
+        return res;
+    }
+
+    if (s->hRTCP != NULL && rtcpSessionIsSessionInShutdown(s->hRTCP))
+    {
+        RvLogError(rvLogPtr,(rvLogPtr, "RvRtpWriteMany: Can not send. The session is in shutdown or RTCP BYE report was sent"));
+        RvLogLeave(rvLogPtr,(rvLogPtr, "RvRtpWriteMany"));
+        return RV_ERROR_ILLEGAL_ACTION;
+    }
+
+    for (done = 0; done < count && res == RV_OK; done += RV_SOCKET_SEND_MESSAGES_MAX)
+    {
+        RvUint8*      ppBuff[RV_SOCKET_SEND_MESSAGES_MAX];
+        RvSize_t      pLen[RV_SOCKET_SEND_MESSAGES_MAX];
+        RvUint32      num = count - done;
+        RvUint32      packed = 0;
+        RvAddress*    destAddress;
+
+        if (num > RV_SOCKET_SEND_MESSAGES_MAX)
+            num = RV_SOCKET_SEND_MESSAGES_MAX;
+
+        RvLockGet(&s->lock, logMgr);
+        for (i = 0; i < num; i++)
+        {
+            RvRtpParam* pp = &p[done + i];
+            pp->paddingBit = RV_FALSE;
+            if (RvRtpPackEx(hRTP, s->sSrc, (RvUint8*)bufs[done + i] + RvRtpNatMultiplexIdSize(), lens[done + i], pp) < 0)
+            {
+                res = RV_ERROR_UNKNOWN;
+                break;
+            }
+            /* the same bytes RtpSendPacket() sends for a not multiplexed address */
+            ppBuff[i] = (RvUint8*)bufs[done + i] + pp->sByte + RvRtpNatMultiplexIdSize();
+            pLen[i]   = (RvSize_t)(pp->len - RvRtpNatMultiplexIdSize());
+            packed++;
+        }
+
+        destAddress = RvRtpAddressListGetNext(&s->addressList, NULL);
+        if (destAddress == NULL)
+        {
+            RvLogError(rvLogPtr, (rvLogPtr, "RvRtpWriteMany: No destination to send."));
+            res = RV_ERROR_UNKNOWN;
+        }
+        while (destAddress != NULL && packed > 0)
+        {
+            RtpNatAddress* natAddressPtr = (RtpNatAddress*) destAddress;
+#ifdef __H323_NAT_FW__
+            if (natAddressPtr->isMultiplexed)
+            {
+                for (i = 0; i < packed; i++)
+                {
+                    if (RtpSendPacket(s->transport, (RvUint8*)bufs[done + i], 0, &p[done + i], natAddressPtr) != RV_OK)
+                    {
+                        RTPLOG_ERROR((rvLogPtr, "RvRtpWriteMany: packet was NOT sent."));
+                    }
+                }
+            }
+            else
+#endif
+            {
+                if (RvSocketSendMessages(&sock, packed, ppBuff, pLen, &natAddressPtr->address, logMgr, NULL) != RV_OK)
+                {
+                    RTPLOG_ERROR((rvLogPtr, "RvRtpWriteMany: packets were NOT sent."));
+                }
+            }
+            destAddress = RvRtpAddressListGetNext(&s->addressList, destAddress);
+        }
+        RvLockRelease(&s->lock, logMgr);
+
+        if (s->hRTCP != NULL)
+        {
+            /* inform the RTCP session about the packets that were sent in the corresponding RTP session.*/
+            for (i = 0; i < packed; i++)
+            {
+                RvRtcpSessionSetParam(s->hRTCP, RVRTCP_PARAMS_RTP_PAYLOADTYPE, &p[done + i].payload);
+                RvRtcpRTPPacketSent(s->hRTCP, lens[done + i] - RvRtpGetHeaderLength(), p[done + i].timestamp);
+            }
+        }
+    }
+
+	RvLogLeave(rvLogPtr,(rvLogPtr, "RvRtpWriteMany"));
+    return res;
+}
 /************************************************************************************
  * RvRtpUnpack
  * description: Gets the RTP header from a buffer.
@@ -125,6 +125,11 @@ RvRtpDemux RVCALLCONV RvRtpDemuxConstruct(
     RtpDemux* demuxPtr = NULL;
         
     RTPLOG_ENTER(Construct);
+    if (numberOfSessions > RTP_DEMUX_MAX_SESSIONS)
+    {
+        RTPLOG_ERROR_LEAVE(Construct, "too many demux sessions for multiplexID index");
+        return NULL;
+    }
     if (RvMemoryAlloc(NULL, (RvSize_t)sizeof(RtpDemux), logMgr, (void**)&demuxPtr) != RV_OK)
     {
         RTPLOG_ERROR_LEAVE(Construct, "failed to allocate demux table");
@@ -0,0 +1,257 @@
+/*********************************************************************
+ *                       selectBench.c                               *
+ *                                                                   *
+ * Loopback benchmark for the RvRtp select engine.                   *
+ * 1. Opens N RTP sessions (default 10000) on 127.0.0.1.             *
+ * 2. A sender thread sends K timestamped packets to every session   *
+ *    from a plain UDP socket, in rounds over all the sessions.      *
+ * 3. The main thread runs RvRtpSeliSelectUntil() and reads the      *
+ *    packets from the RTP event handler.                            *
+ * 4. Reports delivered packets, wakeup latency (send -> handler)    *
+ *    and CPU per packet of the selecting thread.                    *
+ * Build the RvRtp libraries with RV_CFLAG_EPOLL (default on Linux)  *
+ * or RV_CFLAG_SELECT and this program with the matching             *
+ * "make SELECT_ENGINE=EPOLL|SELECT" to compare the two engines.     *
+ *                                                                   *
+ * usage: selectBench [sessions] [packets_per_session] [base_port]   *
+ *********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+
+#include "rvtypes.h"
+#include "rvaddress.h"
+#include "rtp.h"
+#include "rvrtpseli.h"
+
+#define BENCH_DEF_SESSIONS      10000
+#define BENCH_DEF_PACKETS       20
+#define BENCH_DEF_BASE_PORT     20000
+#define BENCH_PAYLOAD_SIZE      172
+#define BENCH_RTP_HEAD_SIZE     12
+/* sender pauses after this many packets so socket buffers never overflow */
+#define BENCH_BURST             200
+#define BENCH_IDLE_MS           2000
+
+typedef struct
+{
+    int sessions;
+    int packets;
+    int base_port;
+    volatile int done;
+} bench_cfg_t;
+
+static RvRtpSession *g_sessions = NULL;
+static RvUint64 *g_lat = NULL;
+static RvUint32 g_received = 0;
+static RvUint32 g_lat_cap = 0;
+
+static RvUint64 now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (RvUint64)ts.tv_sec * 1000000000ULL + (RvUint64)ts.tv_nsec;
+}
+
+static RvUint64 thread_cpu_ns(void)
+{
+    struct rusage ru;
+    getrusage(RUSAGE_THREAD, &ru);
+    return ((RvUint64)ru.ru_utime.tv_sec + (RvUint64)ru.ru_stime.tv_sec) * 1000000000ULL
+        + ((RvUint64)ru.ru_utime.tv_usec + (RvUint64)ru.ru_stime.tv_usec) * 1000ULL;
+}
+
+static void RVCALLCONV bench_rtp_event(
+        IN  RvRtpSession  hRTP,
+        IN  void *       context)
+{
+    unsigned char buf[BENCH_RTP_HEAD_SIZE + BENCH_PAYLOAD_SIZE + 64];
+    RvRtpParam p;
+    RvUint64 sent;
+    RvInt32 status;
+
+    RV_UNUSED_ARG(context);
+
+    RvRtpParamConstruct(&p);
+    status = RvRtpRead(hRTP, buf, sizeof(buf), &p);
+    if (status < 0 || p.len < p.sByte + (RvInt32)sizeof(sent))
+    {
+        return;
+    }
+
+    memcpy(&sent, buf + p.sByte, sizeof(sent));
+    if (g_received < g_lat_cap)
+    {
+        g_lat[g_received] = now_ns() - sent;
+    }
+    ++g_received;
+}
+
+static void *bench_sender(void *arg)
+{
+    bench_cfg_t *cfg = (bench_cfg_t *)arg;
+    unsigned char pkt[BENCH_RTP_HEAD_SIZE + BENCH_PAYLOAD_SIZE];
+    struct sockaddr_in to;
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    int round, s, burst = 0;
+    RvUint16 seq = 0;
+
+    memset(pkt, 0, sizeof(pkt));
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    pkt[0] = 0x80;
+    pkt[1] = 96;
+    for (round = 0; round < cfg->packets; ++round)
+    {
+        for (s = 0; s < cfg->sessions; ++s)
+        {
+            RvUint64 ts;
+
+            pkt[2] = (unsigned char)(seq >> 8);
+            pkt[3] = (unsigned char)seq;
+            pkt[11] = (unsigned char)s;
+            ++seq;
+
+            ts = now_ns();
+            memcpy(pkt + BENCH_RTP_HEAD_SIZE, &ts, sizeof(ts));
+            to.sin_port = htons((unsigned short)(cfg->base_port + 2 * s));
+            sendto(fd, pkt, sizeof(pkt), 0, (struct sockaddr *)&to, sizeof(to));
+
+            if (++burst >= BENCH_BURST)
+            {
+                burst = 0;
+                usleep(1000);
+            }
+        }
+    }
+
+    close(fd);
+    cfg->done = 1;
+    return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+    RvUint64 x = *(const RvUint64 *)a;
+    RvUint64 y = *(const RvUint64 *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char *argv[])
+{
+    bench_cfg_t cfg;
+    struct rlimit rl;
+    pthread_t sender;
+    RvUint64 cpu_begin, cpu_end, wall_begin, wall_end, idle_since, sum = 0;
+    RvUint32 last_received = 0, n, i;
+    int opened = 0, s;
+
+    cfg.sessions = (argc > 1) ? atoi(argv[1]) : BENCH_DEF_SESSIONS;
+    cfg.packets = (argc > 2) ? atoi(argv[2]) : BENCH_DEF_PACKETS;
+    cfg.base_port = (argc > 3) ? atoi(argv[3]) : BENCH_DEF_BASE_PORT;
+    cfg.done = 0;
+
+    /* one fd per session plus the stack's own */
+    rl.rlim_cur = rl.rlim_max = (rlim_t)cfg.sessions + 1024;
+    if (setrlimit(RLIMIT_NOFILE, &rl) != 0)
+    {
+        printf("setrlimit(%d) failed: %s\n", (int)rl.rlim_cur, strerror(errno));
+    }
+
+    if (RvRtpInit() != RV_OK || RvRtpSeliInit() != RV_OK)
+    {
+        printf("ERROR: RvRtpInit() failed\n");
+        return 1;
+    }
+
+    g_sessions = (RvRtpSession *)calloc(cfg.sessions, sizeof(RvRtpSession));
+    g_lat_cap = (RvUint32)cfg.sessions * (RvUint32)cfg.packets;
+    g_lat = (RvUint64 *)malloc(g_lat_cap * sizeof(RvUint64));
+
+    for (s = 0; s < cfg.sessions; ++s)
+    {
+        RvNetAddress addr;
+
+        RvAddressConstruct(RV_ADDRESS_TYPE_IPV4, (RvAddress *)&addr);
+        RvAddressSetString("127.0.0.1", (RvAddress *)&addr);
+        RvAddressSetIpPort((RvAddress *)&addr, (RvUint16)(cfg.base_port + 2 * s));
+
+        g_sessions[s] = RvRtpOpen(&addr, 0, 0);
+        if (g_sessions[s] == NULL)
+        {
+            break;
+        }
+        RvRtpSetEventHandler(g_sessions[s], (RvRtpEventHandler_CB)bench_rtp_event, NULL);
+        ++opened;
+    }
+    printf("engine: %s, sessions opened: %d/%d, packets per session: %d\n",
+#if (RV_SELECT_TYPE == RV_SELECT_EPOLL)
+        "epoll",
+#else
+        "select",
+#endif
+        opened, cfg.sessions, cfg.packets);
+    cfg.sessions = opened;
+    g_lat_cap = (RvUint32)opened * (RvUint32)cfg.packets;
+
+    cpu_begin = thread_cpu_ns();
+    wall_begin = now_ns();
+    pthread_create(&sender, NULL, bench_sender, &cfg);
+
+    idle_since = now_ns();
+    while (g_received < g_lat_cap)
+    {
+        RvRtpSeliSelectUntil(10);
+        if (g_received != last_received)
+        {
+            last_received = g_received;
+            idle_since = now_ns();
+        }
+        else if (cfg.done && now_ns() - idle_since > (RvUint64)BENCH_IDLE_MS * 1000000ULL)
+        {
+            break;
+        }
+    }
+
+    wall_end = now_ns();
+    cpu_end = thread_cpu_ns();
+    pthread_join(sender, NULL);
+
+    n = (g_received < g_lat_cap) ? g_received : g_lat_cap;
+    printf("delivered: %u/%u packets in %.1f ms\n",
+        g_received, g_lat_cap, (double)(wall_end - wall_begin) / 1e6);
+    if (n > 0)
+    {
+        qsort(g_lat, n, sizeof(RvUint64), cmp_u64);
+        for (i = 0; i < n; ++i)
+        {
+            sum += g_lat[i];
+        }
+        printf("wakeup latency us: avg %.1f p50 %.1f p99 %.1f max %.1f\n",
+            (double)sum / n / 1e3, (double)g_lat[n / 2] / 1e3,
+            (double)g_lat[(RvUint64)n * 99 / 100] / 1e3, (double)g_lat[n - 1] / 1e3);
+        printf("select thread cpu: %.2f us per packet\n",
+            (double)(cpu_end - cpu_begin) / n / 1e3);
+    }
+
+    for (s = 0; s < opened; ++s)
+    {
+        RvRtpClose(g_sessions[s]);
+    }
+    free(g_sessions);
+    free(g_lat);
+    RvRtpSeliEnd();
+    RvRtpEnd();
+    return 0;
+}
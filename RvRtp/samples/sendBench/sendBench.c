@@ -0,0 +1,172 @@
+/*********************************************************************
+ *                       sendBench.c                                 *
+ *                                                                   *
+ * Loopback benchmark of the frame-granular RTP send path.           *
+ * One RTP session sends frames of F packets to a local UDP socket:  *
+ * - write: one RvRtpWrite() (one sendto) per packet                 *
+ * - many : one RvRtpWriteMany() per frame (UDP GSO or sendmmsg)     *
+ * Each mode runs with equal-sized packets (the GSO case) and with   *
+ * mixed sizes (the sendmmsg case). Reports packets per second of    *
+ * wall time and per core (CPU time of the sending thread).          *
+ *                                                                   *
+ * usage: sendBench [packets_per_frame] [payload] [seconds] [port]   *
+ *********************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+
+#include "rvtypes.h"
+#include "rvaddress.h"
+#include "rtp.h"
+#include "rvrtpseli.h"
+
+#define BENCH_DEF_PACKETS       40
+#define BENCH_DEF_PAYLOAD       1400
+#define BENCH_DEF_SECONDS       2
+#define BENCH_DEF_PORT          21000
+#define BENCH_MAX_PACKETS       256
+#define BENCH_MAX_PAYLOAD       1500
+
+static RvUint64 now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (RvUint64)ts.tv_sec * 1000000000ULL + (RvUint64)ts.tv_nsec;
+}
+
+static RvUint64 thread_cpu_ns(void)
+{
+    struct rusage ru;
+    getrusage(RUSAGE_THREAD, &ru);
+    return ((RvUint64)ru.ru_utime.tv_sec + (RvUint64)ru.ru_stime.tv_sec) * 1000000000ULL
+        + ((RvUint64)ru.ru_utime.tv_usec + (RvUint64)ru.ru_stime.tv_usec) * 1000ULL;
+}
+
+static void run(RvRtpSession hRTP, const char *mode, RvBool batch, RvBool mixed,
+                int packets, int payload, int seconds)
+{
+    static RvUint8 frame[BENCH_MAX_PACKETS][BENCH_MAX_PAYLOAD + 64];
+    void *bufs[BENCH_MAX_PACKETS];
+    RvInt32 lens[BENCH_MAX_PACKETS];
+    RvRtpParam params[BENCH_MAX_PACKETS];
+    RvInt32 head = RvRtpGetHeaderLength();
+    RvUint32 timestamp = 0;
+    RvUint64 sent = 0, cpu_begin, wall_begin, wall_end, cpu_end;
+    int i;
+
+    cpu_begin = thread_cpu_ns();
+    wall_begin = now_ns();
+    wall_end = wall_begin + (RvUint64)seconds * 1000000000ULL;
+    while (now_ns() < wall_end)
+    {
+        for (i = 0; i < packets; ++i)
+        {
+            /* mixed: every other packet is shorter, so GSO can not be used */
+            int size = (mixed && (i & 1)) ? payload / 2 : payload;
+            if (i == packets - 1)
+            {
+                size = payload / 3;
+            }
+
+            bufs[i] = frame[i];
+            lens[i] = head + size;
+            RvRtpParamConstruct(&params[i]);
+            params[i].payload = 96;
+            params[i].timestamp = timestamp;
+            params[i].marker = (i == packets - 1) ? RV_TRUE : RV_FALSE;
+            params[i].sByte = head;
+        }
+
+        if (batch)
+        {
+            RvRtpWriteMany(hRTP, (RvUint32)packets, bufs, lens, params);
+        }
+        else
+        {
+            for (i = 0; i < packets; ++i)
+            {
+                RvRtpWrite(hRTP, bufs[i], lens[i], &params[i]);
+            }
+        }
+
+        sent += (RvUint64)packets;
+        timestamp += 3600;
+    }
+    wall_end = now_ns();
+    cpu_end = thread_cpu_ns();
+
+    printf("%-5s %-6s %10.0f pkts/s %10.0f pkts/s per core\n",
+        mode, mixed ? "mixed" : "equal",
+        (double)sent * 1e9 / (double)(wall_end - wall_begin),
+        (double)sent * 1e9 / (double)(cpu_end - cpu_begin));
+}
+
+int main(int argc, char *argv[])
+{
+    int packets = (argc > 1) ? atoi(argv[1]) : BENCH_DEF_PACKETS;
+    int payload = (argc > 2) ? atoi(argv[2]) : BENCH_DEF_PAYLOAD;
+    int seconds = (argc > 3) ? atoi(argv[3]) : BENCH_DEF_SECONDS;
+    int port = (argc > 4) ? atoi(argv[4]) : BENCH_DEF_PORT;
+    RvNetAddress local, remote;
+    RvRtpSession hRTP;
+    struct sockaddr_in sin;
+    int sink;
+
+    if (packets < 1 || packets > BENCH_MAX_PACKETS || payload < 16 || payload > BENCH_MAX_PAYLOAD)
+    {
+        printf("packets_per_frame 1..%d, payload 16..%d\n", BENCH_MAX_PACKETS, BENCH_MAX_PAYLOAD);
+        return 1;
+    }
+
+    /* the receiver is never read, the kernel drops what does not fit */
+    sink = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sin.sin_port = htons((unsigned short)(port + 2));
+    if (bind(sink, (struct sockaddr *)&sin, sizeof(sin)) != 0)
+    {
+        printf("ERROR: can not bind the receiver on port %d\n", port + 2);
+        return 1;
+    }
+
+    if (RvRtpInit() != RV_OK || RvRtpSeliInit() != RV_OK)
+    {
+        printf("ERROR: RvRtpInit() failed\n");
+        return 1;
+    }
+
+    RvAddressConstruct(RV_ADDRESS_TYPE_IPV4, (RvAddress *)&local);
+    RvAddressSetString("127.0.0.1", (RvAddress *)&local);
+    RvAddressSetIpPort((RvAddress *)&local, (RvUint16)port);
+    hRTP = RvRtpOpen(&local, 0, 0);
+    if (hRTP == NULL)
+    {
+        printf("ERROR: RvRtpOpen() failed on port %d\n", port);
+        return 1;
+    }
+
+    RvAddressConstruct(RV_ADDRESS_TYPE_IPV4, (RvAddress *)&remote);
+    RvAddressSetString("127.0.0.1", (RvAddress *)&remote);
+    RvAddressSetIpPort((RvAddress *)&remote, (RvUint16)(port + 2));
+    RvRtpAddRemoteAddress(hRTP, &remote);
+
+    printf("%d packets per frame, %d bytes payload, %d s per run\n", packets, payload, seconds);
+    run(hRTP, "write", RV_FALSE, RV_FALSE, packets, payload, seconds);
+    run(hRTP, "many", RV_TRUE, RV_FALSE, packets, payload, seconds);
+    run(hRTP, "write", RV_FALSE, RV_TRUE, packets, payload, seconds);
+    run(hRTP, "many", RV_TRUE, RV_TRUE, packets, payload, seconds);
+
+    RvRtpClose(hRTP);
+    close(sink);
+    RvRtpSeliEnd();
+    RvRtpEnd();
+    return 0;
+}
@@ -2230,13 +2230,14 @@ RvStatus RVCALLCONV RvSelectHandleEpollFds(
         RvSelectEvents selectEvent = 0;
         RvBool              isError;
 
-        isError = (epFdSet->events & EPOLLERR);
+        /* Each raised element carries its own event mask */
+        isError = ((epFdElem->events & EPOLLERR) != 0);
 
-        if (epFdSet->events & EPOLLIN)
+        if (epFdElem->events & EPOLLIN)
             selectEvent |= RV_SELECT_READ;
-        if (epFdSet->events & EPOLLOUT)
+        if (epFdElem->events & EPOLLOUT)
             selectEvent |= RV_SELECT_WRITE;
-        if (epFdSet->events & EPOLLHUP)
+        if (epFdElem->events & EPOLLHUP)
             selectEvent |= RV_SELECT_READ;
 
         if (selectEvent || isError)
@@ -3001,13 +3002,21 @@ RvStatus RVCALLCONV RvSelectConstruct(
 #endif
         status = RvSelectErrorCode(RV_ERROR_UNKNOWN);
     }
-    status = RvMemoryAlloc(NULL, selectEngine->maxFds * sizeof(struct epoll_event),
-                           selectEngine->logMgr, (void**)&selectEngine->fdArray);
-    if (status != RV_OK)
+    else
     {
-        RvSelectLogError(
-            (&logMgr->selectSource, "RvMemoryAlloc failed for array of %d epoll events (sise=%d)",
-             selectEngine->maxFds, sizeof(struct epoll_event)));
+        /* Don't leak the epoll descriptor on close-on-exec children */
+        fcntl(selectEngine->epFd, F_SETFD, FD_CLOEXEC);
+
+        status = RvMemoryAlloc(NULL, selectEngine->maxFds * sizeof(struct epoll_event),
+                               selectEngine->logMgr, (void**)&selectEngine->fdArray);
+        if (status != RV_OK)
+        {
+            RvSelectLogError(
+                (&logMgr->selectSource, "RvMemoryAlloc failed for array of %d epoll events (sise=%d)",
+                 selectEngine->maxFds, sizeof(struct epoll_event)));
+            close(selectEngine->epFd);
+            selectEngine->epFd = -1;
+        }
     }
 
 #elif (RV_SELECT_TYPE == RV_SELECT_KQUEUE)
@@ -3890,14 +3899,14 @@ RvStatus RVCALLCONV RvSelectAdd(
             }
 
             /* Register the fd and it's events with the epoll */
-            ret = epoll_ctl(selectEngine->epFd, EPOLL_CTL_ADD, fd->fd, &epfd);
-            if (ret == -1)
+            if (epoll_ctl(selectEngine->epFd, EPOLL_CTL_ADD, fd->fd, &epfd) == -1)
             {
 #if (RV_LOGMASK != RV_LOGLEVEL_NONE)
                 RvInt32 errCode = errno;
                 RvSelectLogError((&logMgr->selectSource,
                     "RvSelectAdd(fd=%d) failed: errno=%d:%s", fd->fd, errCode, strerror(errCode)));
 #endif
+                ret = RvSelectErrorCode(RV_ERROR_UNKNOWN);
            }
         }
     }
@@ -4215,14 +4224,14 @@ RvStatus RVCALLCONV RvSelectRemoveEx(
         {
             struct epoll_event epfd; /* Is required by Linuxes before 2.6.9 */
             /* Remove fd from the epoll */
-            status = epoll_ctl(selectEngine->epFd, EPOLL_CTL_DEL, fd->fd, &epfd);
-            if (status == -1)
+            if (epoll_ctl(selectEngine->epFd, EPOLL_CTL_DEL, fd->fd, &epfd) == -1)
             {
 #if (RV_LOGMASK != RV_LOGLEVEL_NONE)
                 RvInt32 errCode = errno;
                 RvSelectLogError((&logMgr->selectSource,
                     "RvSelectRemove(fd=%d) failed: errno=%d:%s", fd->fd, errCode, strerror(errCode)));
 #endif
+                status = RvSelectErrorCode(RV_ERROR_UNKNOWN);
             }
         }
     }
@@ -4576,14 +4585,14 @@ RvStatus RVCALLCONV RvSelectUpdate(
             }
 
             /* Update fd events registered with the epoll */
-            status = epoll_ctl(selectEngine->epFd, EPOLL_CTL_MOD, fd->fd, &epfd);
-            if (status == -1)
+            if (epoll_ctl(selectEngine->epFd, EPOLL_CTL_MOD, fd->fd, &epfd) == -1)
             {
 #if (RV_LOGMASK != RV_LOGLEVEL_NONE)
                 RvInt32 errCode = errno;
                 RvSelectLogError((&logMgr->selectSource,
                     "RvSelectUpdate(fd=%d) failed: errno=%d:%s", fd->fd, errCode, strerror(errCode)));
 #endif
+                status = RvSelectErrorCode(RV_ERROR_UNKNOWN);
             }
         }
     }
@@ -210,6 +210,9 @@ NOTE: OP modification.
 #define RV_SELECT_TYPE RV_SELECT_SYMBIAN
 #elif (RV_OS_TYPE == RV_OS_TYPE_FREEBSD)
 #define RV_SELECT_TYPE RV_SELECT_KQUEUE
+#elif (RV_OS_TYPE == RV_OS_TYPE_LINUX)
+/* epoll is not bound by FD_SETSIZE, build with RV_CFLAG_SELECT to fall back to select() */
+#define RV_SELECT_TYPE RV_SELECT_EPOLL
 #else
 #define RV_SELECT_TYPE RV_SELECT_SELECT
 #endif
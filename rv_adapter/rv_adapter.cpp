@@ -378,6 +378,85 @@ namespace rv
         return bRet;
     }
 
+    bool rv_adapter::open_session_shard(RV_IN rv_session_descriptor *descriptor, RV_IN uint32_t shard, RV_IN uint32_t shards, RV_OUT rv_handler hrv)
+    {
+        bool bRet = false;
+        do
+        {
+            if (!m_bReady) break;
+            if (!descriptor) break;
+            if (!hrv) break;
+            if (shards < 2 || shards > RV_ADAPTER_MAX_SHARDS || shard >= shards) break;
+        #if !(RV_ADAPTER_USE_REUSEPORT)
+            break;
+        #endif
+
+            if(!(m_core.m_contexts.pin_context(shard, hrv->hthread))) break;
+            rv::open_session_event *event_open =
+                static_cast<rv::open_session_event *>(m_core.m_contexts.forceAllocEvent(rv::RV_OPEN_SESSION_EVENT));
+            if(!event_open) break;
+            event_open->assign();
+            event_open->hrv = hrv;
+            event_open->setparams(descriptor);
+            event_open->nDemux = 4;
+            event_open->nShard = shard;
+            event_open->nShards = shards;
+            event_open->set_wait_state();
+            if(!(m_core.m_contexts.post_asyn_msg(hrv->hthread, event_open)))
+            {
+                event_open->release();
+                break;
+            }
+            event_open->wait_event(500);
+            if (event_open->bRetState)
+            {
+                m_core.m_contexts.add_ref(hrv->hthread);
+                bRet = true;
+            }
+            event_open->release();
+        } while (false);
+        return bRet;
+    }
+
+    bool rv_adapter::open_demux_session_shard(RV_IN rv_session_descriptor *descriptor, RV_IN void* rtpDemux, RV_IN uint32_t shard, RV_IN uint32_t shards, RV_IN uint32_t *multiplexID, RV_OUT rv_handler hrv)
+    {
+        bool bRet = false;
+        do
+        {
+            if (!m_bReady) break;
+            if (!descriptor) break;
+            if (!hrv) break;
+            if (shards < 2 || shards > RV_ADAPTER_MAX_SHARDS || shard >= shards) break;
+
+            if(!(m_core.m_contexts.sel_context(hrv->hthread))) break;
+            rv::open_session_event *event_open =
+                static_cast<rv::open_session_event *>(m_core.m_contexts.forceAllocEvent(rv::RV_OPEN_SESSION_EVENT));
+            if(!event_open) break;
+            event_open->assign();
+            event_open->hrv = hrv;
+            event_open->setparams(descriptor);
+            event_open->nDemux = 2;
+            event_open->demux = rtpDemux;
+            event_open->multiplexID = multiplexID;
+            event_open->nShard = shard;
+            event_open->nShards = shards;
+            event_open->set_wait_state();
+            if(!(m_core.m_contexts.post_asyn_msg(hrv->hthread, event_open)))
+            {
+                event_open->release();
+                break;
+            }
+            event_open->wait_event(500);
+            if (event_open->bRetState)
+            {
+                m_core.m_contexts.add_ref(hrv->hthread);
+                bRet = true;
+            }
+            event_open->release();
+        } while (false);
+        return bRet;
+    }
+
     bool rv_adapter::close_demux_session(RV_IN rv_handler hrv)
     {
         bool bRet = false;
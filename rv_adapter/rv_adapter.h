@@ -70,6 +70,14 @@ namespace rv
 				RV_IN uint32_t buf_len,
 				RV_INOUT rv_rtp_param * p);
 
+		//rtpͺ
+		//	û̵߳õֱд뷽ʽһ֡ĶRTPһνЭջ
+		//  linuxͬһĿĵַıUDP GSOsendmmsgһϵͳ÷
+		bool write_rtp_batch(
+				RV_IN rv_handler hrv,
+				RV_IN rv_rtp_send_item *items,
+				RV_IN uint32_t count);
+
 		//rtpݷͺ
 		//	û̵߳õļдʽڲ첽¼ʽӵARTPЭջ
 		//  radvisionٷƼʽ
@@ -99,6 +107,14 @@ namespace rv
 				RV_INOUT rv_rtp_param * p,
 				RV_INOUT rv_net_address *addr);
 
+		//rtpպ
+		//	adapterڲ̲߳RtpReceiveEventHandler_CBе
+		//  һζcountģضıĸ0ʾsocketѶ
+		uint32_t read_rtp_batch(
+				RV_IN rv_handler hrv,
+				RV_INOUT rv_rtp_recv_item *items,
+				RV_IN uint32_t count);
+
 		bool add_rtp_remote_address(
 			/*
 				Adds the new RTP address of the remote peer,
@@ -316,6 +332,10 @@ namespace rv
 		bool open_demux_session(RV_IN rv_session_descriptor *descriptor, RV_IN void* rtpDemux, RV_IN uint32_t *multiplexID, RV_OUT rv_handler hrv);
 		bool close_demux_session(RV_IN rv_handler hrv);
 
+		//ö˿ڷƬshardŷƬỰ̶(shard % ߳)rv߳Ͻ
+		bool open_session_shard(RV_IN rv_session_descriptor *descriptor, RV_IN uint32_t shard, RV_IN uint32_t shards, RV_OUT rv_handler hrv);
+		bool open_demux_session_shard(RV_IN rv_session_descriptor *descriptor, RV_IN void* rtpDemux, RV_IN uint32_t shard, RV_IN uint32_t shards, RV_IN uint32_t *multiplexID, RV_OUT rv_handler hrv);
+
 		//ȫֺ
 		//  rv_net_ipv4 translate to rv_net_address
 		static bool convert_ipv4_to_rvnet(RV_OUT rv_net_address * dst, RV_IN rv_net_ipv4 * src);
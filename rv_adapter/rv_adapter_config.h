@@ -41,5 +41,29 @@
 //첽дRTPʱģʽ1Ļȹ滮
 #define RV_ADAPTER_ASYNC_WRITE_BUFFER_SIZE	2048
 
+//RTPʱȡıĸ
+#define RV_ADAPTER_RECV_BATCH_MAX	64
+
+//RTPʱһνЭջıĸַ
+#define RV_ADAPTER_SEND_BATCH_MAX	64
+
+//linuxղrecvmmsgһϵͳöģƽ̨˻Ϊȡ
+#if defined(__linux__) && !defined(__ANDROID__)
+#define RV_ADAPTER_USE_RECVMMSG	1
+#else
+#define RV_ADAPTER_USE_RECVMMSG	0
+#endif
+
+//ö˿ڷƬգͬһ˿SO_REUSEPORT򿪶׽֣һrv߳̽գ
+//ں˰CBPFݱǰ׺ĸIDƽַ̨֧Ƭ
+#if defined(__linux__) && !defined(__ANDROID__)
+#define RV_ADAPTER_USE_REUSEPORT	1
+#else
+#define RV_ADAPTER_USE_REUSEPORT	0
+#endif
+
+//ö˿ڵƬ
+#define RV_ADAPTER_MAX_SHARDS	16
+
 #endif
 
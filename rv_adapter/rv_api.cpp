@@ -150,6 +150,34 @@ rv_bool open_demux_session(RV_IN rv_session_descriptor *descriptor, RV_IN void*
 	rv::rv_adapter::share_unlock();
 	return bRet;
 }
+rv_bool open_session_shard(RV_IN rv_session_descriptor *descriptor, RV_IN uint32_t shard, RV_IN uint32_t shards, RV_OUT rv_handler hrv)
+{
+	rv_bool bRet = RV_ADAPTER_FALSE;
+	rv::rv_adapter::share_lock();
+	do
+	{
+		rv::rv_adapter * adapter = rv::rv_adapter::self();
+		if (!adapter) break;
+		if (!adapter->open_session_shard(descriptor, shard, shards, hrv)) break;
+		bRet = RV_ADAPTER_TRUE;
+	} while (false);
+	rv::rv_adapter::share_unlock();
+	return bRet;
+}
+rv_bool open_demux_session_shard(RV_IN rv_session_descriptor *descriptor, RV_IN void* rtpDemux, RV_IN uint32_t shard, RV_IN uint32_t shards, RV_OUT uint32_t *multiplexID, RV_OUT rv_handler hrv)
+{
+	rv_bool bRet = RV_ADAPTER_FALSE;
+	rv::rv_adapter::share_lock();
+	do
+	{
+		rv::rv_adapter * adapter = rv::rv_adapter::self();
+		if (!adapter) break;
+		if (!adapter->open_demux_session_shard(descriptor, rtpDemux, shard, shards, multiplexID, hrv)) break;
+		bRet = RV_ADAPTER_TRUE;
+	} while (false);
+	rv::rv_adapter::share_unlock();
+	return bRet;
+}
 rv_bool close_demux_session(RV_IN rv_handler hrv)
 {
 	rv_bool bRet = RV_ADAPTER_FALSE;
@@ -45,6 +45,14 @@ RV_ADAPTER_API rv_bool write_rtp(
 			   RV_IN uint32_t buf_len,
 			   RV_INOUT rv_rtp_param * p);
 
+//rtpͺ
+//	û̵߳õֱд뷽ʽһ֡ĶRTPһνARTPЭջ
+//  linuxͬһĿĵַıUDP GSOsendmmsgһϵͳ÷ܻỰ˻Ϊ
+RV_ADAPTER_API rv_bool write_rtp_batch(
+			   RV_IN rv_handler hrv,
+			   RV_IN rv_rtp_send_item *items,
+			   RV_IN uint32_t count);
+
 //rtpݷͺ
 //	û̵߳õļдʽڲ첽¼ʽӵARTPЭջ
 //  radvisionٷƼʽ
@@ -75,6 +83,15 @@ RV_ADAPTER_API rv_bool read_rtp(
 			  RV_INOUT rv_rtp_param * p,
 			  RV_INOUT rv_net_address *addr);
 
+//rtpպ
+//	adapterڲ̲߳RtpReceiveEventHandler_CBе
+//  linuxrecvmmsgһζcountģضıĸ0ʾsocketѶ
+//  items[i].validΪRV_ADAPTER_FALSEıѴsocketʧܣӦ
+RV_ADAPTER_API uint32_t read_rtp_batch(
+			  RV_IN rv_handler hrv,
+			  RV_INOUT rv_rtp_recv_item *items,
+			  RV_IN uint32_t count);
+
 //rtpַӺ鲥ַ
 RV_ADAPTER_API rv_bool add_rtp_remote_address(
 	RV_IN rv_handler hrv,
@@ -276,6 +293,10 @@ RV_ADAPTER_API void demux_deconstruct(RV_IN void* demux);
 
 RV_ADAPTER_API rv_bool open_demux_session(RV_IN rv_session_descriptor *descriptor, RV_IN void* rtpDemux, RV_OUT uint32_t *multiplexID, RV_OUT rv_handler hrv);
 RV_ADAPTER_API rv_bool close_demux_session(RV_IN rv_handler hrv);
+//ö˿ڷƬ(linux)ͬһ˿ڴshardsSO_REUSEPORTƬں˰ID
+//ƬỰopen_session_shard򿪣ϵĸûỰopen_demux_session_shard
+RV_ADAPTER_API rv_bool open_session_shard(RV_IN rv_session_descriptor *descriptor, RV_IN uint32_t shard, RV_IN uint32_t shards, RV_OUT rv_handler hrv);
+RV_ADAPTER_API rv_bool open_demux_session_shard(RV_IN rv_session_descriptor *descriptor, RV_IN void* rtpDemux, RV_IN uint32_t shard, RV_IN uint32_t shards, RV_OUT uint32_t *multiplexID, RV_OUT rv_handler hrv);
 RV_ADAPTER_API void setdemux_handler(rv_context func);
 RV_ADAPTER_API void setdemux_caster_handler(rv_context func);
 RV_ADAPTER_API rv_bool read_demux_rtp(
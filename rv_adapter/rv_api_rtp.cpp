@@ -33,6 +33,25 @@ rv_bool write_rtp(
 	return bRet;
 }
 
+//rtpͺ
+rv_bool write_rtp_batch(
+						RV_IN rv_handler hrv,
+						RV_IN rv_rtp_send_item *items,
+						RV_IN uint32_t count)
+{
+	rv_bool bRet = RV_ADAPTER_FALSE;
+	rv::rv_adapter::share_lock();
+	do
+	{
+		rv::rv_adapter * adapter = rv::rv_adapter::self();
+		if (!adapter) break;
+		if (!adapter->write_rtp_batch(hrv, items, count)) break;
+		bRet = RV_ADAPTER_TRUE;
+	} while (false);
+	rv::rv_adapter::share_unlock();
+	return bRet;
+}
+
 rv_bool write_rtp_s(RV_IN rv_handler hrv,
 					RV_IN void * buf,
 					RV_IN uint32_t buf_len,
@@ -91,6 +110,24 @@ rv_bool read_rtp(
 	return bRet;
 }
 
+//rtpպ
+uint32_t read_rtp_batch(
+						RV_IN rv_handler hrv,
+						RV_INOUT rv_rtp_recv_item *items,
+						RV_IN uint32_t count)
+{
+	uint32_t nRead = 0;
+	rv::rv_adapter::share_lock();
+	do
+	{
+		rv::rv_adapter * adapter = rv::rv_adapter::self();
+		if (!adapter) break;
+		nRead = adapter->read_rtp_batch(hrv, items, count);
+	} while (false);
+	rv::rv_adapter::share_unlock();
+	return nRead;
+}
+
 //rtpַӺ鲥ַ
 rv_bool add_rtp_remote_address(
 							   RV_IN rv_handler hrv,
@@ -117,6 +117,23 @@ typedef struct rv_rtp_param_
 	RV_IN      rv_bool      paddingBit;        /* for internal usage only */
 } rv_rtp_param;
 
+//read_rtp_batchʹ
+typedef struct rv_rtp_recv_item_
+{
+	RV_IN  void *          buf;         /* ջ */
+	RV_IN  uint32_t        buf_len;     /* ջ */
+	RV_OUT rv_rtp_param    param;       /* RTPͷϢȡݳȱparam.len */
+	RV_OUT rv_net_address  addr;        /* Դַ */
+	RV_OUT rv_bool         valid;       /* RV_ADAPTER_FALSEʾѶʧܣ趪 */
+} rv_rtp_recv_item;
+
+typedef struct rv_rtp_send_item_
+{
+	RV_IN  void *          buf;         /* RTP(ԤRTPͷռ) */
+	RV_IN  uint32_t        buf_len;     /* RTP */
+	RV_IN  rv_rtp_param    param;       /* RTPͷͬwrite_rtp */
+} rv_rtp_send_item;
+
 
 typedef struct rv_rtcp_srinfo_
 {
@@ -23,12 +23,15 @@
 #include <rvrtpstunfw.h>
 #include <RtpDemux.h>
 #include <RtcpTypes.h>
+#include <rvtransportsocket.h>
+#include <rvselect.h>
 
 #include <tghelper/async_event.h>
 
 #include "rv_engine.h"
 #include "rv_adapter_convert.h"
 #include "rv_adapter.h"
+#include "rv_shard.h"
 #include "mem_check_on.h"
 
 #ifndef _WIN32
@@ -41,7 +44,74 @@ namespace rv
 {
 	namespace inner
 	{
+	#if (RV_ADAPTER_USE_REUSEPORT)
+		//ip:portϵSO_REUSEPORTƬ׽ִͬRtpOpenFrom
+		static RvTransport open_shard_transport(uint32_t ip, uint16_t port, uint32_t shards)
+		{
+			int fd = open_shard_socket(RTP_DEMUX_INDEX_BITS, shards);
+			if (fd < 0) return NULL;
+
+			RvAddress localAddress;
+			RvAddressConstructIpv4(&localAddress, ip, port);
+
+			RvTransportSocketCfg cfg;
+			RvTransportInitSocketTransportCfg(&cfg);
+			cfg.protocol   = RvSocketProtocolUdp;
+			cfg.pLocalAddr = &localAddress;
+			cfg.sock       = fd;
+			cfg.options    = RVTRANSPORT_CREATEOPT_BROADCAST;
+
+			RvStatus res = RvSelectGetThreadEngine(NULL, &cfg.pSelectEngine);
+			if (res != RV_OK || cfg.pSelectEngine == NULL)
+			{
+				RvAddressDestruct(&localAddress);
+				::close(fd);
+				return NULL;
+			}
+
+			//ʧʱ󲻹رⲿ׽
+			RvTransport transp = NULL;
+			res = RvTransportCreateSocketTransport(&cfg, &transp);
+			RvAddressDestruct(&localAddress);
+			if (res != RV_OK)
+			{
+				::close(fd);
+				return NULL;
+			}
+
+			RvInt32 bufSizes[2] = {8192/*send buf*/, 8192/*recv buf*/};
+			RvTransportAddRef(transp);
+			RvTransportSetOption(transp,
+				RVTRANSPORT_OPTTYPE_SOCKETTRANSPORT,
+				RVTRANSPORT_OPT_SOCK_BUFSIZE, &bufSizes);
+			return transp;
+		}
+
+		//򿪷ƬỰRTPRTCP(˿+1)ռһƬ׽
+		static RvRtpSession open_shard_session(rv_net_address *local, uint32_t shards, char *sname)
+		{
+			rv_net_ipv4 address;
+			if (!rv_adapter::convert_rvnet_to_ipv4(&address, local)) return NULL;
+
+			RvTransport rtpTransp = open_shard_transport(address.ip, address.port, shards);
+			if (!rtpTransp) return NULL;
+
+			RvTransport rtcpTransp = open_shard_transport(address.ip, (uint16_t)(address.port + 1), shards);
+			if (!rtcpTransp)
+			{
+				RvTransportRelease(rtpTransp);
+				return NULL;
+			}
 
+			RvRtpSession rtpH = RvRtpOpenEx2(rtpTransp, 0, 0, sname, rtcpTransp);
+			if (!rtpH)
+			{
+				RvTransportRelease(rtpTransp);
+				RvTransportRelease(rtcpTransp);
+			}
+			return rtpH;
+		}
+	#endif
 	}
 
 	//ڲصӿ
@@ -173,6 +243,8 @@ namespace rv
 		hrv = 0;
 		bRetState = false;
 		nDemux = 0;
+		nShard = 0;
+		nShards = 1;
 	}
 
 	void open_session_event::setparams(const rv_session_descriptor &init_params)
@@ -242,8 +314,22 @@ namespace rv
 			}
 			else if (nDemux == 2)
 			{
+				//ƬãIDڱƬ÷(XTDemuxMan)ѴлͬһõĴ
+				if (nShards > 1)
+				{
+					RtpDemux *d = (RtpDemux*)demux;
+					d->runningCounter = inner::align_shard_counter(d->runningCounter, RTP_DEMUX_INDEX_BITS, nShard, nShards);
+				}
 				rtpH = RvRtpDemuxOpenSession((RvRtpDemux)demux, &rtpReceivingAddress, 0, 0, sname, NULL, (RvUint32*)multiplexID);
 			}
+			else if (nDemux == 4)
+			{
+			#if (RV_ADAPTER_USE_REUSEPORT)
+				rtpH = inner::open_shard_session(&(params.local_address), nShards, sname);
+			#else
+				rtpH = NULL;
+			#endif
+			}
 			else
 			{
 				rtpH  = RvRtpOpenEx(&rtpReceivingAddress, 0, 0, sname);
@@ -274,7 +360,7 @@ namespace rv
 			if (params.onRtpRcvEvent)
 			{
 				hrv->onRtpRcvEvent = (rv_context)(params.onRtpRcvEvent);
-				if (nDemux==0 || nDemux==1)
+				if (nDemux==0 || nDemux==1 || nDemux==4)
 				{
 					RvRtpSetEventHandler(rtpH, (RvRtpEventHandler_CB)(rvcore_rtpEventHandler_cb), hrv);
 				}
@@ -473,6 +559,13 @@ namespace rv
 		}
 		return false;
 	}
+	//ƬŹ̶ѡ
+	bool rv_engine_contexts::pin_context(uint32_t shard, uint32_t &key)
+	{
+		if (m_contexts.empty()) return false;
+		key = (uint32_t)(shard % m_contexts.size());
+		return true;
+	}
 	//ѡһkey,ݸؾ⻯ԭѡ
 	bool rv_engine_contexts::sel_context(uint32_t &key)
 	{
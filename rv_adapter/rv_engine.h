@@ -92,7 +92,7 @@ namespace rv
 	{
 	public:
 		open_session_event() : tghelper::async_event(RV_OPEN_SESSION_EVENT)
-		{	nDemux = 0;	}
+		{	nDemux = 0; nShard = 0; nShards = 1;	}
 		virtual void do_event();
 
 		//λ
@@ -105,10 +105,12 @@ namespace rv
 	public:
 		RV_IN rv_session_descriptor params;
 
-		int nDemux;//0:session 1:demux session 2:demux_subsession 3:demux
+		int nDemux;//0:session 1:demux session 2:demux_subsession 3:demux 4:demux shard session
 		void *demux;
 		uint32_t *multiplexID;
 		uint32_t nSessions;
+		uint32_t nShard;	//ƬţnShards>1ʱЧ
+		uint32_t nShards;	//ö˿ڷƬ
 
 		//
 	public:
@@ -308,6 +310,8 @@ namespace rv
 		bool dec_ref(uint32_t key);
 		//ѡһkey,ݸؾ⻯ԭѡ
 		bool sel_context(uint32_t &key);
+		//ƬŹ̶ѡģͬһ˿ڵĸƬڲͬ߳
+		bool pin_context(uint32_t shard, uint32_t &key);
 		//ȡӦkey
 		inline rv_engine_context * get_context(uint32_t key)
 		{
@@ -20,6 +20,13 @@
 #include "rv_adapter.h"
 #include "rv_adapter_convert.h"
 
+#if (RV_ADAPTER_USE_RECVMMSG)
+#include <rvrtpstunfw.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <string.h>
+#endif
+
 #include "mem_check_on.h"
 
 namespace rv
@@ -52,6 +59,48 @@ namespace rv
 		return bRet;
 	}
 
+	bool rv_adapter::write_rtp_batch(
+		RV_IN rv_handler hrv,
+		RV_IN rv_rtp_send_item *items,
+		RV_IN uint32_t count)
+	{
+		bool bRet = false;
+		do
+		{
+		#if (RV_ADAPTER_PARAM_CHECK)
+			if (!m_bReady) break;
+			if (!hrv || !items) break;
+			if (!count) break;
+		#endif
+
+		#if (RV_CORE_ENABLE)
+			RvRtpSession rtpH = (RvRtpSession)(hrv->hrtp);
+			void *bufs[RV_ADAPTER_SEND_BATCH_MAX];
+			RvInt32 lens[RV_ADAPTER_SEND_BATCH_MAX];
+			RvRtpParam _ps[RV_ADAPTER_SEND_BATCH_MAX];
+			bRet = true;
+			uint32_t nSent = 0;
+			while (nSent < count)
+			{
+				uint32_t n = count - nSent;
+				if (n > RV_ADAPTER_SEND_BATCH_MAX) n = RV_ADAPTER_SEND_BATCH_MAX;
+				for (uint32_t i = 0; i < n; ++i)
+				{
+					rv_rtp_send_item &item = items[nSent + i];
+					bufs[i] = item.buf;
+					lens[i] = (RvInt32)item.buf_len;
+					rv_rtp_param_to_RvRtpParam(&_ps[i], &item.param);
+				}
+				if (RvRtpWriteMany(rtpH, n, bufs, lens, _ps) < 0) bRet = false;
+				nSent += n;
+			}
+		#else
+			bRet = true;
+		#endif
+		} while (false);
+		return bRet;
+	}
+
 	bool rv_adapter::write_rtp_s(RV_IN rv_handler hrv,
 		RV_IN void * buf,
 		RV_IN uint32_t buf_len,
@@ -181,6 +230,105 @@ namespace rv
 		return bRet;
 	}
 
+#if (RV_ADAPTER_USE_RECVMMSG)
+	static void sockaddr_to_RvNetAddress(RvNetAddress *dst, const struct sockaddr_storage *src)
+	{
+		if (AF_INET6 == src->ss_family)
+		{
+			const struct sockaddr_in6 *sa6 = (const struct sockaddr_in6 *)src;
+			RvNetIpv6 ipv6;
+			::memcpy(ipv6.ip, &sa6->sin6_addr, sizeof(ipv6.ip));
+			ipv6.port = ntohs(sa6->sin6_port);
+			ipv6.scopeId = sa6->sin6_scope_id;
+			RvNetCreateIpv6(dst, &ipv6);
+		}
+		else
+		{
+			const struct sockaddr_in *sa4 = (const struct sockaddr_in *)src;
+			RvNetIpv4 ipv4;
+			ipv4.ip = sa4->sin_addr.s_addr;
+			ipv4.port = ntohs(sa4->sin_port);
+			RvNetCreateIpv4(dst, &ipv4);
+		}
+	}
+#endif
+
+	uint32_t rv_adapter::read_rtp_batch(
+		RV_IN rv_handler hrv,
+		RV_INOUT rv_rtp_recv_item *items,
+		RV_IN uint32_t count)
+	{
+		uint32_t nRead = 0;
+		do
+		{
+		#if (RV_ADAPTER_PARAM_CHECK)
+			if (!m_bReady) break;
+			if (!hrv || !items) break;
+			if (!count) break;
+		#endif
+			if (count > RV_ADAPTER_RECV_BATCH_MAX) count = RV_ADAPTER_RECV_BATCH_MAX;
+		#if (RV_CORE_ENABLE)
+			RvRtpSession rtpH = (RvRtpSession)(hrv->hrtp);
+		#if (RV_ADAPTER_USE_RECVMMSG)
+			//һϵͳösocketѵıģЭջ(SRTP)
+			int fd = (int)RvRtpSessionGetSocket(rtpH);
+			if (fd <= 0) break;
+
+			struct mmsghdr msgs[RV_ADAPTER_RECV_BATCH_MAX];
+			struct iovec iovs[RV_ADAPTER_RECV_BATCH_MAX];
+			struct sockaddr_storage froms[RV_ADAPTER_RECV_BATCH_MAX];
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				iovs[i].iov_base = items[i].buf;
+				iovs[i].iov_len = items[i].buf_len;
+				::memset(&msgs[i], 0, sizeof(struct mmsghdr));
+				msgs[i].msg_hdr.msg_name = &froms[i];
+				msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+				msgs[i].msg_hdr.msg_iov = &iovs[i];
+				msgs[i].msg_hdr.msg_iovlen = 1;
+			}
+
+			int ret = ::recvmmsg(fd, msgs, count, MSG_DONTWAIT, NULL);
+			if (ret <= 0) break;
+			nRead = (uint32_t)ret;
+
+			for (uint32_t i = 0; i < nRead; ++i)
+			{
+				rv_rtp_recv_item &item = items[i];
+				item.valid = RV_ADAPTER_FALSE;
+				if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) continue;
+
+				RvNetAddress internel_addr;
+				sockaddr_to_RvNetAddress(&internel_addr, &froms[i]);
+
+				RvRtpParam _p;
+				::memset(&_p, 0, sizeof(RvRtpParam));
+				_p.len = (RvInt32)msgs[i].msg_len;
+				if (RV_OK == RvRtpParseRawReadData(rtpH, item.buf, (RvInt32)msgs[i].msg_len, &internel_addr, &_p))
+				{
+					RvNetAddress_to_rv_net_address(&item.addr, &internel_addr);
+					RvRtpParam_to_rv_rtp_param(&item.param, &_p);
+					item.valid = RV_ADAPTER_TRUE;
+				}
+			}
+		#else
+			for (; nRead < count; ++nRead)
+			{
+				rv_rtp_recv_item &item = items[nRead];
+				RvRtpParam _p;
+				::memset(&_p, 0, sizeof(RvRtpParam));
+				RvNetAddress internel_addr;
+				if (RV_OK != RvRtpReadWithRemoteAddress(rtpH, item.buf, item.buf_len, &_p, &internel_addr)) break;
+				RvNetAddress_to_rv_net_address(&item.addr, &internel_addr);
+				RvRtpParam_to_rv_rtp_param(&item.param, &_p);
+				item.valid = RV_ADAPTER_TRUE;
+			}
+		#endif
+		#endif
+		} while (false);
+		return nRead;
+	}
+
 	bool rv_adapter::add_rtp_remote_address(
 		RV_IN rv_handler hrv,
 		RV_IN rv_net_address*  pRtpAddress)
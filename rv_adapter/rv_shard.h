@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   rv_shard.h
+// radvsion ARTPЭջ -- ö˿SO_REUSEPORTƬ
+//
+// IDλΪмindex_bitsλΪ±ꣻƬ = м % shards
+///////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef RADVISION_ADAPTER_SHARD_
+#define RADVISION_ADAPTER_SHARD_
+
+#include <stdint.h>
+#include "rv_adapter_config.h"
+
+#if (RV_ADAPTER_USE_REUSEPORT)
+#include <sys/socket.h>
+#include <unistd.h>
+#include <linux/filter.h>
+
+#ifndef SO_REUSEPORT
+#define SO_REUSEPORT 15
+#endif
+#ifndef SO_ATTACH_REUSEPORT_CBPF
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
+#endif
+
+namespace rv
+{
+	namespace inner
+	{
+		//IDƬһ
+		inline uint32_t shard_of_multid(uint32_t multid, uint32_t index_bits, uint32_t shards)
+		{
+			return (multid >> index_bits) % shards;
+		}
+
+		//صмʹһID(+1)shardƬ
+		//ȡ0ɸIDΪ0
+		inline uint32_t align_shard_counter(uint32_t running, uint32_t index_bits, uint32_t shard, uint32_t shards)
+		{
+			uint32_t mask = 0xFFFFFFFFu >> index_bits;
+			uint32_t next = (running + 1) & mask;
+			if (0 == next) next = shards;
+			next += (shard + shards - next % shards) % shards;
+			if (next > mask) next = shard ? shard : shards;
+			return next - 1;
+		}
+
+	#if (RV_ADAPTER_USE_REUSEPORT)
+		//UDPǰ4ֽΪID()(ID>>±λ) % shardsΪ׽ţ
+		//ͬһûỰ(ͬһSSRC)RTP/RTCPʼͬһƬ˳
+		inline bool attach_shard_filter(int fd, uint32_t index_bits, uint32_t shards)
+		{
+			struct sock_filter code[] = {
+				{ BPF_LD  | BPF_W   | BPF_ABS, 0, 0, 0 },
+				{ BPF_ALU | BPF_RSH | BPF_K,   0, 0, index_bits },
+				{ BPF_ALU | BPF_MOD | BPF_K,   0, 0, shards },
+				{ BPF_RET | BPF_A,             0, 0, 0 },
+			};
+			struct sock_fprog prog;
+			prog.len = sizeof(code) / sizeof(code[0]);
+			prog.filter = code;
+
+			return 0 == ::setsockopt(fd, SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog));
+		}
+
+		//δ󶨵ķƬUDP׽(SO_REUSEPORT + )ʧܷ-1
+		inline int open_shard_socket(uint32_t index_bits, uint32_t shards)
+		{
+			int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+			if (fd < 0) return -1;
+
+			int on = 1;
+			if (0 != ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) ||
+				0 != ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) ||
+				!attach_shard_filter(fd, index_bits, shards))
+			{
+				::close(fd);
+				return -1;
+			}
+			return fd;
+		}
+	#endif
+	}
+}
+
+#endif
@@ -0,0 +1,247 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   reuseport_test.cpp
+// ö˿SO_REUSEPORTƬյĻػز
+//
+// 1ͬһ˿1/2/4/8Ƭ׽ִ(rv_shard.hеķ)ÿƬһ̣߳
+//    ̶߳ÿ̶Ĵģ⸴֡
+// 2̰߳rv_engineļΪÿ·ɸIDʹŵı
+// 3УÿĶ临IDƬ򣬲ƬµĽ
+//
+// ÷reuseport_test [seconds_per_run] [streams] [port]
+///////////////////////////////////////////////////////////////////////////////////////////
+#include "rv_shard.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <boost/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+using namespace rv::inner;
+
+namespace
+{
+	const uint32_t INDEX_BITS = 20;		//ͬRTP_DEMUX_INDEX_BITS
+	const uint32_t SENDERS = 4;
+	const uint32_t PACKET_SIZE = 1200;
+	const uint32_t WORK_ROUNDS = 2000;	//ÿĵģ⴦
+
+	struct stream_info
+	{
+		uint32_t multid;
+		uint32_t shard;
+	};
+
+	struct shard_result
+	{
+		uint64_t packets;
+		uint64_t misrouted;
+		uint64_t reordered;
+	};
+
+	volatile bool g_stop = false;
+	volatile bool g_recv_stop = false;
+	boost::atomic<uint64_t> g_sent(0);
+	volatile uint32_t g_sink = 0;
+
+	//rv_engine򿪷ƬӻỰķʽɸIDs·䵽s % shardsƬ
+	void make_streams(std::vector<stream_info> &streams, uint32_t count, uint32_t shards)
+	{
+		streams.resize(count);
+		uint32_t running = 0;
+		for (uint32_t s = 0; s < count; ++s)
+		{
+			uint32_t shard = s % shards;
+			if (shards > 1) running = align_shard_counter(running, INDEX_BITS, shard, shards);
+			++running;
+			streams[s].multid = (running << INDEX_BITS) | s;
+			streams[s].shard = shard;
+		}
+	}
+
+	void receiver(int fd, uint32_t shard, uint32_t shards, uint32_t streams, shard_result *result)
+	{
+		std::vector<uint32_t> last(streams, 0);
+		uint8_t buf[2048];
+		uint32_t acc = 0;
+		while (!g_recv_stop)
+		{
+			ssize_t len = ::recv(fd, buf, sizeof(buf), 0);
+			if (len < 12) continue;
+
+			uint32_t multid, stream, seq;
+			memcpy(&multid, buf, 4);
+			memcpy(&stream, buf + 4, 4);
+			memcpy(&seq, buf + 8, 4);
+			multid = ntohl(multid);
+			if (stream >= streams) continue;
+
+			++result->packets;
+			if (shard_of_multid(multid, INDEX_BITS, shards) != shard) ++result->misrouted;
+			if (seq <= last[stream]) ++result->reordered;
+			last[stream] = seq;
+
+			for (uint32_t i = 0; i < WORK_ROUNDS; ++i)
+			{
+				acc = acc * 31 + buf[(i + seq) % len];
+			}
+		}
+		g_sink += acc;
+	}
+
+	//ÿ·ֻһ̷֤߳ͣͶ
+	void sender(uint32_t id, uint16_t port, const std::vector<stream_info> *streams)
+	{
+		int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+		struct sockaddr_in to;
+		memset(&to, 0, sizeof(to));
+		to.sin_family = AF_INET;
+		to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		to.sin_port = htons(port);
+
+		uint8_t buf[PACKET_SIZE];
+		memset(buf, 0x5a, sizeof(buf));
+		std::vector<uint32_t> seq(streams->size(), 0);
+		uint64_t sent = 0;
+		while (!g_stop)
+		{
+			for (uint32_t s = id; s < streams->size() && !g_stop; s += SENDERS)
+			{
+				uint32_t multid = htonl((*streams)[s].multid);
+				uint32_t next = ++seq[s];
+				memcpy(buf, &multid, 4);
+				memcpy(buf + 4, &s, 4);
+				memcpy(buf + 8, &next, 4);
+				if (::sendto(fd, buf, sizeof(buf), 0, (struct sockaddr *)&to, sizeof(to)) > 0) ++sent;
+			}
+		}
+		g_sent += sent;
+		::close(fd);
+	}
+
+	//ؽ(/)ʧܷظ
+	double run(uint32_t shards, uint32_t streams, int seconds, uint16_t port, uint64_t &errors)
+	{
+		std::vector<int> fds;
+		for (uint32_t k = 0; k < shards; ++k)
+		{
+			int fd = open_shard_socket(INDEX_BITS, shards);
+			if (fd < 0)
+			{
+				printf("ERROR: open shard socket failed\n");
+				return -1;
+			}
+
+			int rcvbuf = 4 * 1024 * 1024;
+			::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+			struct timeval tv = { 0, 100000 };
+			::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+			//׽ż˳
+			struct sockaddr_in sin;
+			memset(&sin, 0, sizeof(sin));
+			sin.sin_family = AF_INET;
+			sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			sin.sin_port = htons(port);
+			if (0 != ::bind(fd, (struct sockaddr *)&sin, sizeof(sin)))
+			{
+				printf("ERROR: bind shard %u on port %u failed\n", k, port);
+				::close(fd);
+				return -1;
+			}
+			fds.push_back(fd);
+		}
+
+		std::vector<stream_info> infos;
+		make_streams(infos, streams, shards);
+
+		g_stop = false;
+		g_recv_stop = false;
+		g_sent = 0;
+		std::vector<shard_result> results(shards);
+		memset(&results[0], 0, sizeof(shard_result) * shards);
+
+		boost::thread_group receivers;
+		for (uint32_t k = 0; k < shards; ++k)
+		{
+			receivers.create_thread(boost::bind(receiver, fds[k], k, shards, streams, &results[k]));
+		}
+		boost::thread_group senders;
+		for (uint32_t i = 0; i < SENDERS; ++i)
+		{
+			senders.create_thread(boost::bind(sender, i, port, &infos));
+		}
+
+		boost::this_thread::sleep(boost::posix_time::seconds(seconds));
+		g_stop = true;
+		senders.join_all();
+		//ſѽ׽ֻı
+		boost::this_thread::sleep(boost::posix_time::milliseconds(300));
+		g_recv_stop = true;
+		receivers.join_all();
+		for (uint32_t k = 0; k < shards; ++k) ::close(fds[k]);
+
+		uint64_t received = 0, misrouted = 0, reordered = 0;
+		uint32_t idle = 0;
+		for (uint32_t k = 0; k < shards; ++k)
+		{
+			received += results[k].packets;
+			misrouted += results[k].misrouted;
+			reordered += results[k].reordered;
+			if (0 == results[k].packets) ++idle;
+		}
+		errors += misrouted + reordered + idle;
+
+		double rate = (double)received / seconds;
+		printf("shards %u: sent %llu, received %llu (%.1f%%), %.0f pkts/s, misrouted %llu, reordered %llu, idle shards %u\n",
+			shards, (unsigned long long)g_sent.load(), (unsigned long long)received,
+			g_sent.load() ? 100.0 * received / g_sent.load() : 0.0, rate,
+			(unsigned long long)misrouted, (unsigned long long)reordered, idle);
+		return rate;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int seconds = (argc > 1) ? atoi(argv[1]) : 3;
+	uint32_t streams = (argc > 2) ? (uint32_t)atoi(argv[2]) : 256;
+	uint16_t port = (uint16_t)((argc > 3) ? atoi(argv[3]) : 23000);
+
+	//룺ʼĿƬҲ0
+	uint64_t errors = 0;
+	for (uint32_t shards = 1; shards <= RV_ADAPTER_MAX_SHARDS; ++shards)
+	{
+		const uint32_t starts[] = { 0, 1, 7, 0xFFFu, 0xFFEu, 0xFFDu };
+		for (size_t i = 0; i < sizeof(starts) / sizeof(starts[0]); ++i)
+		{
+			for (uint32_t shard = 0; shard < shards; ++shard)
+			{
+				uint32_t next = (align_shard_counter(starts[i], INDEX_BITS, shard, shards) + 1) & (0xFFFFFFFFu >> INDEX_BITS);
+				if (0 == next || next % shards != shard) ++errors;
+			}
+		}
+	}
+	printf("counter alignment: errors %llu\n", (unsigned long long)errors);
+
+	const uint32_t shard_counts[] = { 1, 2, 4, 8 };
+	double base = 0;
+	for (size_t i = 0; i < sizeof(shard_counts) / sizeof(shard_counts[0]); ++i)
+	{
+		double rate = run(shard_counts[i], streams, seconds, port, errors);
+		if (rate < 0) return 1;
+		if (1 == shard_counts[i]) base = rate;
+		else printf("  scaling x%.2f vs 1 shard\n", base > 0 ? rate / base : 0.0);
+	}
+
+	//ܺƣʱֻУȷ
+	unsigned cores = boost::thread::hardware_concurrency();
+	printf("%u cores%s\n", cores, (cores < 2) ? ", throughput scaling not measurable" : "");
+	printf("%s\n", (0 == errors) ? "PASS" : "FAIL");
+	return (0 == errors) ? 0 : 1;
+}
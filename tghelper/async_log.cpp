@@ -0,0 +1,1047 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   async_log.cpp
+// 첽־
+///////////////////////////////////////////////////////////////////////////////////////////
+#include "async_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+#include <boost/noncopyable.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/once.hpp>
+#include <boost/thread/tss.hpp>
+
+#if defined(_WIN32)
+#include <windows.h>
+#define TG_THREAD_LOCAL __declspec(thread)
+#else
+#include <sys/time.h>
+#define TG_THREAD_LOCAL __thread
+#endif
+
+#ifndef va_copy
+#define va_copy(dst, src) ((dst) = (src))
+#endif
+
+namespace tghelper
+{
+	namespace inner
+	{
+		enum
+		{
+			LOG_RING_WRAP = 0xFFFFFFFF,
+			LOG_RING_HEAD = 8,
+			LOG_NAME_NULL = 0xFFFF,
+			LOG_STR_NULL = 0xFFFF,
+		};
+
+		//̨߳̿ʱ֪ͨصС
+		static const uint64_t LOG_IDLE_NOTIFY_USEC = 1000000;
+
+		struct log_record_head
+		{
+			async_log_sink sink;
+			const char *fmt;		//NULLʾΪ߳Ѹʽõı
+			uint64_t usec;
+			int32_t level;
+			uint16_t name_len;
+			uint16_t args_len;
+		};
+
+		enum log_arg_type
+		{
+			LOG_ARG_INT,
+			LOG_ARG_UINT,
+			LOG_ARG_DOUBLE,
+			LOG_ARG_PTR,
+			LOG_ARG_STR,
+		};
+
+		enum log_arg_len
+		{
+			LOG_LEN_NONE,
+			LOG_LEN_L,
+			LOG_LEN_LL,
+			LOG_LEN_J,
+			LOG_LEN_Z,
+			LOG_LEN_T,
+			LOG_LEN_I,
+		};
+
+		struct log_spec
+		{
+			const char *begin;		//'%'֮
+			const char *len_begin;	//ηʼ
+			const char *end;		//ת֮
+			bool star_width;
+			bool star_prec;
+			int prec;				//澫ȣ-1ʾδָ
+			int len;
+			int type;
+		};
+
+		static inline uint64_t now_usec()
+		{
+#if defined(_WIN32)
+			FILETIME ft;
+			::GetSystemTimeAsFileTime(&ft);
+			uint64_t t = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+			return (t - 116444736000000000ULL) / 10;
+#else
+			struct timeval tv;
+			::gettimeofday(&tv, 0);
+			return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+#endif
+		}
+
+		static inline uint32_t bounded_strlen(const char *s, uint32_t max)
+		{
+			uint32_t n = 0;
+			while (n < max && s[n])
+			{
+				++n;
+			}
+			return n;
+		}
+
+		static int format_one(char *buf, size_t size, const char *spec, ...)
+		{
+			va_list args;
+			va_start(args, spec);
+#if defined(_WIN32)
+			int ret = ::_vsnprintf_s(buf, size, _TRUNCATE, spec, args);
+#else
+			int ret = ::vsnprintf(buf, size, spec, args);
+#endif
+			va_end(args);
+			return ret;
+		}
+
+		//һת˵pָ'%'֮󣬲ֵ֧д(%n%ls%Lf)false
+		static bool parse_spec(const char *p, log_spec &spec)
+		{
+			spec.begin = p;
+			spec.star_width = false;
+			spec.star_prec = false;
+			spec.prec = -1;
+			spec.len = LOG_LEN_NONE;
+
+			while (*p && ::strchr("-+ #0'", *p))
+			{
+				++p;
+			}
+			if ('*' == *p)
+			{
+				spec.star_width = true;
+				++p;
+			}
+			else
+			{
+				while (*p >= '0' && *p <= '9')
+				{
+					++p;
+				}
+			}
+			if ('.' == *p)
+			{
+				++p;
+				if ('*' == *p)
+				{
+					spec.star_prec = true;
+					++p;
+				}
+				else
+				{
+					spec.prec = 0;
+					while (*p >= '0' && *p <= '9')
+					{
+						spec.prec = spec.prec * 10 + (*p - '0');
+						++p;
+					}
+				}
+			}
+
+			spec.len_begin = p;
+			switch (*p)
+			{
+			case 'h':
+				//short/charɱΪint
+				++p;
+				if ('h' == *p)
+				{
+					++p;
+				}
+				break;
+			case 'l':
+				++p;
+				if ('l' == *p)
+				{
+					++p;
+					spec.len = LOG_LEN_LL;
+				}
+				else
+				{
+					spec.len = LOG_LEN_L;
+				}
+				break;
+			case 'q':
+				++p;
+				spec.len = LOG_LEN_LL;
+				break;
+			case 'j':
+				++p;
+				spec.len = LOG_LEN_J;
+				break;
+			case 'z':
+				++p;
+				spec.len = LOG_LEN_Z;
+				break;
+			case 't':
+				++p;
+				spec.len = LOG_LEN_T;
+				break;
+			case 'I':
+				++p;
+				if ('6' == p[0] && '4' == p[1])
+				{
+					p += 2;
+					spec.len = LOG_LEN_LL;
+				}
+				else if ('3' == p[0] && '2' == p[1])
+				{
+					p += 2;
+				}
+				else
+				{
+					spec.len = LOG_LEN_I;
+				}
+				break;
+			default:
+				break;
+			}
+
+			switch (*p)
+			{
+			case 'd':
+			case 'i':
+				spec.type = LOG_ARG_INT;
+				break;
+			case 'u':
+			case 'o':
+			case 'x':
+			case 'X':
+				spec.type = LOG_ARG_UINT;
+				break;
+			case 'c':
+				if (LOG_LEN_NONE != spec.len)
+				{
+					return false;
+				}
+				spec.type = LOG_ARG_INT;
+				break;
+			case 'e':
+			case 'E':
+			case 'f':
+			case 'F':
+			case 'g':
+			case 'G':
+			case 'a':
+			case 'A':
+				if (LOG_LEN_NONE != spec.len && LOG_LEN_L != spec.len)
+				{
+					return false;
+				}
+				spec.type = LOG_ARG_DOUBLE;
+				break;
+			case 's':
+				if (LOG_LEN_NONE != spec.len)
+				{
+					return false;
+				}
+				spec.type = LOG_ARG_STR;
+				break;
+			case 'p':
+				if (LOG_LEN_NONE != spec.len)
+				{
+					return false;
+				}
+				spec.type = LOG_ARG_PTR;
+				break;
+			default:
+				return false;
+			}
+
+			spec.end = p + 1;
+			return true;
+		}
+
+		class log_writer
+		{
+		public:
+			log_writer(uint8_t *buf, uint32_t size) : m_buf(buf), m_size(size), m_len(0)
+			{}
+
+			bool put(const void *data, uint32_t len)
+			{
+				if (m_len + len > m_size)
+				{
+					return false;
+				}
+				::memcpy(m_buf + m_len, data, len);
+				m_len += len;
+				return true;
+			}
+			uint8_t *tail() { return m_buf + m_len; }
+			uint32_t room() const { return m_size - m_len; }
+			uint32_t size() const { return m_len; }
+			void resize(uint32_t len) { m_len = len; }
+
+		private:
+			uint8_t *m_buf;
+			uint32_t m_size;
+			uint32_t m_len;
+		};
+
+		class log_reader
+		{
+		public:
+			log_reader(const uint8_t *buf, uint32_t size) : m_buf(buf), m_size(size), m_pos(0)
+			{}
+
+			bool get(void *data, uint32_t len)
+			{
+				if (m_pos + len > m_size)
+				{
+					return false;
+				}
+				::memcpy(data, m_buf + m_pos, len);
+				m_pos += len;
+				return true;
+			}
+			const uint8_t *current() const { return m_buf + m_pos; }
+
+		private:
+			const uint8_t *m_buf;
+			uint32_t m_size;
+			uint32_t m_pos;
+		};
+
+		//ʽȡԶʽд룬ͳһչΪ64λ
+		static bool encode_args(const char *fmt, va_list args, log_writer &w)
+		{
+			const char *p = fmt;
+			while (*p)
+			{
+				if ('%' != *p++)
+				{
+					continue;
+				}
+				if ('%' == *p)
+				{
+					++p;
+					continue;
+				}
+
+				log_spec spec;
+				if (!parse_spec(p, spec))
+				{
+					return false;
+				}
+				p = spec.end;
+
+				int prec = spec.prec;
+				if (spec.star_width)
+				{
+					int64_t v = va_arg(args, int);
+					if (!w.put(&v, sizeof(v)))
+					{
+						return false;
+					}
+				}
+				if (spec.star_prec)
+				{
+					int64_t v = va_arg(args, int);
+					prec = (int)v;
+					if (!w.put(&v, sizeof(v)))
+					{
+						return false;
+					}
+				}
+
+				bool ok = true;
+				switch (spec.type)
+				{
+				case LOG_ARG_INT:
+					{
+						int64_t v = 0;
+						switch (spec.len)
+						{
+						case LOG_LEN_L:		v = va_arg(args, long); break;
+						case LOG_LEN_LL:	v = va_arg(args, long long); break;
+						case LOG_LEN_J:		v = va_arg(args, intmax_t); break;
+						case LOG_LEN_Z:
+						case LOG_LEN_T:		v = va_arg(args, ptrdiff_t); break;
+						case LOG_LEN_I:		v = va_arg(args, intptr_t); break;
+						default:			v = va_arg(args, int); break;
+						}
+						ok = w.put(&v, sizeof(v));
+					}
+					break;
+				case LOG_ARG_UINT:
+					{
+						uint64_t v = 0;
+						switch (spec.len)
+						{
+						case LOG_LEN_L:		v = va_arg(args, unsigned long); break;
+						case LOG_LEN_LL:	v = va_arg(args, unsigned long long); break;
+						case LOG_LEN_J:		v = va_arg(args, uintmax_t); break;
+						case LOG_LEN_Z:
+						case LOG_LEN_T:		v = va_arg(args, size_t); break;
+						case LOG_LEN_I:		v = va_arg(args, uintptr_t); break;
+						default:			v = va_arg(args, unsigned int); break;
+						}
+						ok = w.put(&v, sizeof(v));
+					}
+					break;
+				case LOG_ARG_DOUBLE:
+					{
+						double v = va_arg(args, double);
+						ok = w.put(&v, sizeof(v));
+					}
+					break;
+				case LOG_ARG_PTR:
+					{
+						uint64_t v = (uintptr_t)va_arg(args, void *);
+						ok = w.put(&v, sizeof(v));
+					}
+					break;
+				case LOG_ARG_STR:
+					{
+						//ȵ%sܲ0βֻΪֹ
+						const char *s = va_arg(args, const char *);
+						uint16_t n = LOG_STR_NULL;
+						if (s)
+						{
+							uint32_t max = TGHELPER_ASYNC_LOG_STR_MAX;
+							if (prec >= 0 && (uint32_t)prec < max)
+							{
+								max = prec;
+							}
+							n = (uint16_t)bounded_strlen(s, max);
+						}
+						ok = w.put(&n, sizeof(n));
+						if (ok && LOG_STR_NULL != n)
+						{
+							ok = w.put(s, n);
+						}
+					}
+					break;
+				default:
+					ok = false;
+					break;
+				}
+				if (!ok)
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		//̨̰߳ʽԭת˵øʽ
+		static void format_args(const char *fmt, log_reader &r, char *out, uint32_t size)
+		{
+			char spec_buf[64];
+			char str_buf[TGHELPER_ASYNC_LOG_STR_MAX + 1];
+			uint32_t n = 0;
+			const char *p = fmt;
+			while (*p && n + 1 < size)
+			{
+				if ('%' != *p)
+				{
+					out[n++] = *p++;
+					continue;
+				}
+				if ('%' == p[1])
+				{
+					out[n++] = '%';
+					p += 2;
+					continue;
+				}
+
+				log_spec spec;
+				if (!parse_spec(p + 1, spec))
+				{
+					break;
+				}
+				p = spec.end;
+
+				int64_t star[2] = {0, 0};
+				int nstar = 0;
+				if (spec.star_width && !r.get(&star[nstar++], sizeof(int64_t)))
+				{
+					break;
+				}
+				if (spec.star_prec && !r.get(&star[nstar++], sizeof(int64_t)))
+				{
+					break;
+				}
+
+				//ؽת˵'*'滻Ϊ¼еֵ
+				uint32_t sn = 0;
+				int si = 0;
+				spec_buf[sn++] = '%';
+				for (const char *q = spec.begin; q < spec.end && sn + 16 < sizeof(spec_buf); ++q)
+				{
+					if ('*' == *q && q < spec.len_begin)
+					{
+						sn += format_one(spec_buf + sn, sizeof(spec_buf) - sn, "%d", (int)star[si++]);
+					}
+					else
+					{
+						spec_buf[sn++] = *q;
+					}
+				}
+				spec_buf[sn] = 0;
+
+				char *dst = out + n;
+				size_t room = size - n;
+				bool ok = true;
+				switch (spec.type)
+				{
+				case LOG_ARG_INT:
+					{
+						int64_t v = 0;
+						ok = r.get(&v, sizeof(v));
+						switch (spec.len)
+						{
+						case LOG_LEN_L:		format_one(dst, room, spec_buf, (long)v); break;
+						case LOG_LEN_LL:	format_one(dst, room, spec_buf, (long long)v); break;
+						case LOG_LEN_J:		format_one(dst, room, spec_buf, (intmax_t)v); break;
+						case LOG_LEN_Z:
+						case LOG_LEN_T:		format_one(dst, room, spec_buf, (ptrdiff_t)v); break;
+						case LOG_LEN_I:		format_one(dst, room, spec_buf, (intptr_t)v); break;
+						default:			format_one(dst, room, spec_buf, (int)v); break;
+						}
+					}
+					break;
+				case LOG_ARG_UINT:
+					{
+						uint64_t v = 0;
+						ok = r.get(&v, sizeof(v));
+						switch (spec.len)
+						{
+						case LOG_LEN_L:		format_one(dst, room, spec_buf, (unsigned long)v); break;
+						case LOG_LEN_LL:	format_one(dst, room, spec_buf, (unsigned long long)v); break;
+						case LOG_LEN_J:		format_one(dst, room, spec_buf, (uintmax_t)v); break;
+						case LOG_LEN_Z:
+						case LOG_LEN_T:		format_one(dst, room, spec_buf, (size_t)v); break;
+						case LOG_LEN_I:		format_one(dst, room, spec_buf, (uintptr_t)v); break;
+						default:			format_one(dst, room, spec_buf, (unsigned int)v); break;
+						}
+					}
+					break;
+				case LOG_ARG_DOUBLE:
+					{
+						double v = 0;
+						ok = r.get(&v, sizeof(v));
+						format_one(dst, room, spec_buf, v);
+					}
+					break;
+				case LOG_ARG_PTR:
+					{
+						uint64_t v = 0;
+						ok = r.get(&v, sizeof(v));
+						format_one(dst, room, spec_buf, (void *)(uintptr_t)v);
+					}
+					break;
+				case LOG_ARG_STR:
+					{
+						uint16_t len = 0;
+						ok = r.get(&len, sizeof(len));
+						if (ok && LOG_STR_NULL == len)
+						{
+							format_one(dst, room, spec_buf, (const char *)NULL);
+						}
+						else if (ok)
+						{
+							ok = r.get(str_buf, len);
+							str_buf[ok ? len : 0] = 0;
+							format_one(dst, room, spec_buf, str_buf);
+						}
+					}
+					break;
+				default:
+					ok = false;
+					break;
+				}
+				if (!ok)
+				{
+					break;
+				}
+				out[size - 1] = 0;
+				n += (uint32_t)::strlen(dst);
+			}
+			out[n < size ? n : size - 1] = 0;
+		}
+
+		//ߵ߻λ壬Ϊ̣߳Ϊ̨߳
+		class log_ring : private boost::noncopyable
+		{
+		public:
+			log_ring() : m_head(0), m_tail(0), m_closed(false)
+			{
+				m_buf = new uint8_t[TGHELPER_ASYNC_LOG_RING_SIZE];
+			}
+			~log_ring()
+			{
+				delete [] m_buf;
+			}
+
+			bool push(const uint8_t *data, uint32_t len)
+			{
+				uint32_t total = align(LOG_RING_HEAD + len);
+				if (total > TGHELPER_ASYNC_LOG_RING_SIZE / 2)
+				{
+					return false;
+				}
+
+				uint32_t head = m_head.load(boost::memory_order_relaxed);
+				uint32_t tail = m_tail.load(boost::memory_order_acquire);
+				uint32_t pos = head & (TGHELPER_ASYNC_LOG_RING_SIZE - 1);
+
+				//βռ䲻ʱдƱǣӻͷʼд
+				uint32_t skip = 0;
+				if (TGHELPER_ASYNC_LOG_RING_SIZE - pos < total)
+				{
+					skip = TGHELPER_ASYNC_LOG_RING_SIZE - pos;
+				}
+				if (TGHELPER_ASYNC_LOG_RING_SIZE - (head - tail) < skip + total)
+				{
+					return false;
+				}
+				if (skip)
+				{
+					uint32_t mark = LOG_RING_WRAP;
+					::memcpy(m_buf + pos, &mark, sizeof(mark));
+					head += skip;
+					pos = 0;
+				}
+
+				::memcpy(m_buf + pos, &len, sizeof(len));
+				::memcpy(m_buf + pos + LOG_RING_HEAD, data, len);
+				m_head.store(head + total, boost::memory_order_release);
+				return true;
+			}
+
+			const uint8_t *front(uint32_t &len)
+			{
+				uint32_t tail = m_tail.load(boost::memory_order_relaxed);
+				for (;;)
+				{
+					if (tail == m_head.load(boost::memory_order_acquire))
+					{
+						return NULL;
+					}
+					uint32_t pos = tail & (TGHELPER_ASYNC_LOG_RING_SIZE - 1);
+					uint32_t n = 0;
+					::memcpy(&n, m_buf + pos, sizeof(n));
+					if (LOG_RING_WRAP == n)
+					{
+						tail += TGHELPER_ASYNC_LOG_RING_SIZE - pos;
+						m_tail.store(tail, boost::memory_order_release);
+						continue;
+					}
+					len = n;
+					return m_buf + pos + LOG_RING_HEAD;
+				}
+			}
+
+			void pop(uint32_t len)
+			{
+				uint32_t tail = m_tail.load(boost::memory_order_relaxed);
+				m_tail.store(tail + align(LOG_RING_HEAD + len), boost::memory_order_release);
+			}
+
+			void close() { m_closed.store(true, boost::memory_order_release); }
+			bool closed() const { return m_closed.load(boost::memory_order_acquire); }
+
+		private:
+			static inline uint32_t align(uint32_t len) { return (len + 7) & ~7u; }
+
+			uint8_t *m_buf;
+			boost::atomic<uint32_t> m_head;
+			boost::atomic<uint32_t> m_tail;
+			boost::atomic<bool> m_closed;
+		};
+
+		static void close_ring(log_ring *ring)
+		{
+			//߳˳ʱֻǣɺ̨߳ſպͷ
+			ring->close();
+		}
+
+		class log_core : private boost::noncopyable
+		{
+		public:
+			static log_core *instance();
+
+			log_ring *current_ring();
+			void flush(bool wait);
+			void stop();
+
+			boost::atomic<uint32_t> m_dropped;
+
+		private:
+			log_core();
+
+			static void create();
+			static void exit_handler();
+
+			void thread_work();
+			uint32_t drain();
+			void notify_idle();
+			void emit(const uint8_t *rec, uint32_t len);
+
+			boost::mutex m_rings_mutex;
+			std::vector<log_ring *> m_rings;
+
+			//³Աֻڳm_drain_mutexʱ
+			boost::mutex m_drain_mutex;
+			std::vector<async_log_sink> m_active_sinks;
+			uint64_t m_last_notify;
+			time_t m_last_sec;
+			char m_time_prefix[32];
+			char m_time[48];
+			char m_line[TGHELPER_ASYNC_LOG_LINE_SIZE];
+
+			boost::thread_specific_ptr<log_ring> m_tss;
+			boost::atomic<bool> m_run;
+			boost::thread *m_thread;
+		};
+
+		static TG_THREAD_LOCAL log_ring *s_thread_ring = NULL;
+		static log_core *s_core = NULL;
+		static boost::once_flag s_core_once = BOOST_ONCE_INIT;
+
+		log_core::log_core()
+			: m_dropped(0)
+			, m_last_notify(0)
+			, m_last_sec(-1)
+			, m_tss(close_ring)
+			, m_run(true)
+			, m_thread(NULL)
+		{
+			m_time_prefix[0] = 0;
+			m_thread = new boost::thread(boost::bind(&log_core::thread_work, this));
+		}
+
+		void log_core::create()
+		{
+			//ڲͷţ˳ʱ߳д־
+			s_core = new log_core;
+			::atexit(&log_core::exit_handler);
+		}
+
+		void log_core::exit_handler()
+		{
+			s_core->stop();
+		}
+
+		log_core *log_core::instance()
+		{
+			boost::call_once(s_core_once, &log_core::create);
+			return s_core;
+		}
+
+		log_ring *log_core::current_ring()
+		{
+			if (NULL == s_thread_ring)
+			{
+				log_ring *ring = new log_ring;
+				{
+					boost::mutex::scoped_lock lock(m_rings_mutex);
+					m_rings.push_back(ring);
+				}
+				m_tss.reset(ring);
+				s_thread_ring = ring;
+			}
+			return s_thread_ring;
+		}
+
+		void log_core::stop()
+		{
+			m_run = false;
+#if defined(_WIN32)
+			//DLLжʱڼڣȴֻ̨̣߳ſ
+			flush(false);
+#else
+			if (m_thread)
+			{
+				m_thread->join();
+			}
+			flush(true);
+#endif
+		}
+
+		void log_core::flush(bool wait)
+		{
+			boost::mutex::scoped_lock lock(m_drain_mutex, boost::defer_lock);
+			if (wait)
+			{
+				lock.lock();
+			}
+			else
+			{
+				for (int i = 0; i < 100 && !lock.try_lock(); ++i)
+				{
+					boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+				}
+				if (!lock.owns_lock())
+				{
+					return;
+				}
+			}
+
+			while (drain() > 0)
+			{
+			}
+			notify_idle();
+		}
+
+		void log_core::thread_work()
+		{
+			while (m_run)
+			{
+				uint32_t nums = 0;
+				{
+					boost::mutex::scoped_lock lock(m_drain_mutex);
+					nums = drain();
+					if (0 == nums && !m_active_sinks.empty() && now_usec() - m_last_notify >= LOG_IDLE_NOTIFY_USEC)
+					{
+						notify_idle();
+					}
+				}
+				if (0 == nums)
+				{
+					boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+				}
+			}
+		}
+
+		uint32_t log_core::drain()
+		{
+			std::vector<log_ring *> rings;
+			{
+				boost::mutex::scoped_lock lock(m_rings_mutex);
+				rings = m_rings;
+			}
+
+			//¼ʱϲ̻߳壬֤ͬһ־ļʱ
+			uint32_t nums = 0;
+			for (;;)
+			{
+				log_ring *best = NULL;
+				const uint8_t *best_rec = NULL;
+				uint32_t best_len = 0;
+				uint64_t best_usec = 0;
+				for (std::size_t i = 0; i < rings.size(); ++i)
+				{
+					uint32_t len = 0;
+					const uint8_t *rec = rings[i]->front(len);
+					if (NULL == rec)
+					{
+						continue;
+					}
+					uint64_t usec = 0;
+					::memcpy(&usec, rec + offsetof(log_record_head, usec), sizeof(usec));
+					if (NULL == best || usec < best_usec)
+					{
+						best = rings[i];
+						best_rec = rec;
+						best_len = len;
+						best_usec = usec;
+					}
+				}
+				if (NULL == best)
+				{
+					break;
+				}
+				emit(best_rec, best_len);
+				best->pop(best_len);
+				++nums;
+			}
+
+			//˳̵߳Ļ壬жϹرձжǷΪ
+			boost::mutex::scoped_lock lock(m_rings_mutex);
+			for (std::vector<log_ring *>::iterator it = m_rings.begin(); it != m_rings.end();)
+			{
+				uint32_t len = 0;
+				if ((*it)->closed() && NULL == (*it)->front(len))
+				{
+					delete *it;
+					it = m_rings.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+
+			return nums;
+		}
+
+		void log_core::notify_idle()
+		{
+			for (std::size_t i = 0; i < m_active_sinks.size(); ++i)
+			{
+				m_active_sinks[i](NULL, 0, NULL, NULL);
+			}
+			m_active_sinks.clear();
+			m_last_notify = now_usec();
+		}
+
+		void log_core::emit(const uint8_t *rec, uint32_t len)
+		{
+			log_record_head head;
+			if (len < sizeof(head))
+			{
+				return;
+			}
+			::memcpy(&head, rec, sizeof(head));
+			log_reader r(rec + sizeof(head), len - sizeof(head));
+
+			char name[TGHELPER_ASYNC_LOG_NAME_MAX + 1];
+			const char *pname = NULL;
+			if (LOG_NAME_NULL != head.name_len)
+			{
+				if (!r.get(name, head.name_len))
+				{
+					return;
+				}
+				name[head.name_len] = 0;
+				pname = name;
+			}
+
+			if (head.fmt)
+			{
+				log_reader args(r.current(), head.args_len);
+				format_args(head.fmt, args, m_line, sizeof(m_line));
+			}
+			else
+			{
+				uint32_t n = head.args_len < sizeof(m_line) ? head.args_len : sizeof(m_line) - 1;
+				r.get(m_line, n);
+				m_line[n] = 0;
+			}
+
+			//ͬһڵļ¼ڲ
+			time_t sec = (time_t)(head.usec / 1000000);
+			if (sec != m_last_sec)
+			{
+				struct tm tm_now;
+#if defined(_WIN32)
+				::localtime_s(&tm_now, &sec);
+#else
+				::localtime_r(&sec, &tm_now);
+#endif
+				format_one(m_time_prefix, sizeof(m_time_prefix), "%04d-%02d-%02d %02d:%02d:%02d",
+					tm_now.tm_year + 1900, tm_now.tm_mon + 1, tm_now.tm_mday,
+					tm_now.tm_hour, tm_now.tm_min, tm_now.tm_sec);
+				m_last_sec = sec;
+			}
+			format_one(m_time, sizeof(m_time), "%s:%06u", m_time_prefix, (uint32_t)(head.usec % 1000000));
+
+			head.sink(pname, head.level, m_time, m_line);
+
+			if (std::find(m_active_sinks.begin(), m_active_sinks.end(), head.sink) == m_active_sinks.end())
+			{
+				m_active_sinks.push_back(head.sink);
+			}
+		}
+	}
+
+	void async_log_put(async_log_sink sink, const char *name, int level, const char *fmt, ...)
+	{
+		va_list args;
+		va_start(args, fmt);
+		async_log_vput(sink, name, level, fmt, args);
+		va_end(args);
+	}
+
+	void async_log_vput(async_log_sink sink, const char *name, int level, const char *fmt, va_list args)
+	{
+		if (NULL == sink || NULL == fmt)
+		{
+			return;
+		}
+
+		inner::log_core *core = inner::log_core::instance();
+		inner::log_ring *ring = core->current_ring();
+
+		uint8_t buf[sizeof(inner::log_record_head) + TGHELPER_ASYNC_LOG_NAME_MAX + TGHELPER_ASYNC_LOG_LINE_SIZE];
+		inner::log_record_head head;
+		head.sink = sink;
+		head.fmt = fmt;
+		head.usec = inner::now_usec();
+		head.level = level;
+
+		inner::log_writer w(buf + sizeof(head), sizeof(buf) - sizeof(head));
+		if (name)
+		{
+			head.name_len = (uint16_t)inner::bounded_strlen(name, TGHELPER_ASYNC_LOG_NAME_MAX);
+			w.put(name, head.name_len);
+		}
+		else
+		{
+			head.name_len = inner::LOG_NAME_NULL;
+		}
+		uint32_t name_bytes = w.size();
+
+		va_list args_copy;
+		va_copy(args_copy, args);
+		bool encoded = inner::encode_args(fmt, args_copy, w);
+		va_end(args_copy);
+
+		if (!encoded)
+		{
+			//ֵ֧ĸʽʱ˻Ϊڵ߳иʽ
+			w.resize(name_bytes);
+			char *text = (char *)w.tail();
+			uint32_t room = w.room();
+#if defined(_WIN32)
+			::_vsnprintf_s(text, room, _TRUNCATE, fmt, args);
+#else
+			::vsnprintf(text, room, fmt, args);
+#endif
+			text[room - 1] = 0;
+			w.resize(name_bytes + (uint32_t)::strlen(text));
+			head.fmt = NULL;
+		}
+
+		head.args_len = (uint16_t)(w.size() - name_bytes);
+		::memcpy(buf, &head, sizeof(head));
+
+		if (!ring->push(buf, sizeof(head) + w.size()))
+		{
+			++core->m_dropped;
+		}
+	}
+
+	void async_log_flush()
+	{
+		inner::log_core::instance()->flush(true);
+	}
+
+	uint32_t async_log_dropped()
+	{
+		return inner::log_core::instance()->m_dropped;
+	}
+}
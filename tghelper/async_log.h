@@ -0,0 +1,42 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   async_log.h
+// 첽־
+//
+// 1ֻ߳ʽѲԶʽ̵߳λ壬ʽļIO
+// 2̨̰߳ʱ˳ϲ̻߳壬ʽ󽻸ص
+// 3ʽΪַ¼ַֻΪʽID
+// 4ʱ־߳
+///////////////////////////////////////////////////////////////////////////////////////////
+#ifndef TGHELPER_ASYNC_LOG_H_
+#define TGHELPER_ASYNC_LOG_H_
+
+#include <stdint.h>
+#include <stdarg.h>
+
+//ÿ̻߳λСΪ2
+#define TGHELPER_ASYNC_LOG_RING_SIZE	(128 * 1024)
+//־ʽ󳤶
+#define TGHELPER_ASYNC_LOG_LINE_SIZE	4096
+//%s󿽱ȣֽض
+#define TGHELPER_ASYNC_LOG_STR_MAX		1024
+//־󿽱
+#define TGHELPER_ASYNC_LOG_NAME_MAX		128
+
+namespace tghelper
+{
+	//־صں̨߳де
+	//timeΪ"YYYY-MM-DD HH:MM:SS:ffffff"ʽıؼ¼ʱ
+	//textΪNULLʱʾſգصɽˢ»رļ
+	typedef void (*async_log_sink)(const char *name, int level, const char *time, const char *text);
+
+	void async_log_put(async_log_sink sink, const char *name, int level, const char *fmt, ...);
+	void async_log_vput(async_log_sink sink, const char *name, int level, const char *fmt, va_list args);
+
+	//ͬſ̻߳
+	void async_log_flush();
+
+	//򻺳־
+	uint32_t async_log_dropped();
+}
+
+#endif //TGHELPER_ASYNC_LOG_H_
@@ -63,6 +63,26 @@ namespace tghelper
 		return nRet;
 	}
 	
+	bool byte_block::reserve_headroom(uint32_t headroom)
+	{
+		bool bRet = false;
+		do 
+		{
+			if (!m_block) break;
+			if (m_payload_offset >= headroom)
+			{
+				bRet = true;
+				break;
+			}
+			if (headroom + m_payload_size > m_block_size) break;
+			//Ԥռ䲻㣬
+			memmove(m_block + headroom, m_block + m_payload_offset, m_payload_size);
+			m_payload_offset = headroom;
+			bRet = true;
+		} while (false);
+		return bRet;
+	}
+
 	bool byte_block::copy(byte_block &src)
 	{
 		bool bRet = false;
@@ -250,8 +270,28 @@ namespace tghelper
 		return bRet;
 	}
 
+	uint32_t byte_pool::_cache_alloc_items(byte_macro_block *dst, uint32_t block_nums)
+	{
+		uint32_t nRet = 0;
+		while (nRet < block_nums)
+		{
+			byte_block * item = static_cast<byte_block *>(_cache_alloc_item(false));
+			if (!item) break;
+			dst->push_byte_block(item);
+			nRet++;
+		}
+		return nRet;
+	}
+
 	bool byte_pool::force_alloc_items(byte_macro_block *dst, uint32_t block_nums, bool bTrace)
 	{
+		if (!dst) return false;
+		//ȡ̻߳еĽڵ
+		if (!bTrace)
+		{
+			block_nums -= _cache_alloc_items(dst, block_nums);
+			if (0 == block_nums) return true;
+		}
 		bool bRet = false;
 		m_mutex.lock();
 		do 
@@ -285,6 +325,13 @@ namespace tghelper
 
 	bool byte_pool::try_alloc_items(byte_macro_block *dst, uint32_t block_nums, bool bTrace)
 	{
+		if (!dst) return false;
+		//Զչʱ䲻ʧܣȡ̻߳еĽڵ
+		if (!bTrace && (0 < m_expand_size))
+		{
+			block_nums -= _cache_alloc_items(dst, block_nums);
+			if (0 == block_nums) return true;
+		}
 		bool bRet = false;
 		m_mutex.lock();
 		do 
@@ -57,6 +57,9 @@ namespace tghelper
 		uint32_t read(uint8_t *dst, uint32_t dst_size, uint32_t *offset = 0);
 		uint32_t read(char *dst, uint32_t dst_size, uint32_t *offset = 0)
 		{ return read((uint8_t*)dst, dst_size, offset); }
+		// ֤ǰheadroomֽڵԤռ -- falseʾռ䲻
+		// дʱԤ㹻ռ򲻷Ƹ
+		bool reserve_headroom(uint32_t headroom);
 		//Ʋ--ݿ -- memcpy
 		bool copy(byte_block &src);
 		bool copy(byte_block *src);
@@ -139,6 +142,7 @@ namespace tghelper
 		//ݲ
 		// ⲿд, slice_offsetָʾǰƬƫ -- ʵд븺ֽڳ 
 		// ǰݷƬѾɣslice_offsetͷƬʱƫСڵڵĹϵ
+		// slice_offsetÿƬǰԤռ䣬ӦͷԤͷʱֻǰƫ
 		uint32_t write(const uint8_t *src, uint32_t src_size, 
 					   uint32_t slice_size, uint32_t slice_offest);
 		uint32_t write(const char *src, uint32_t src_size, 
@@ -208,6 +212,8 @@ namespace tghelper
 		//ټ벢ڵ
 		recycle_pool_item * add_alloc_fast_item(recycle_pool_item *item, bool bTrace = false)
 		{ return recycle_pool::add_alloc_fast_item(item, bTrace);	}
+		//ӱ̻߳ȡblock_numsڵ㣬仺棬ʣಿɵһμ
+		uint32_t _cache_alloc_items(byte_macro_block *dst, uint32_t block_nums);
 		
 	protected:
 		uint32_t m_block_size;
@@ -309,6 +315,13 @@ namespace tghelper
 		//亯--ǿƲ汾
 		bool force_alloc_any_items(byte_macro_block *dst, uint32_t block_nums, bool bTrace)
 		{
+			if (!dst) return false;
+			//ȡ̻߳еĽڵ
+			if (!bTrace)
+			{
+				block_nums -= _cache_alloc_items(dst, block_nums);
+				if (0 == block_nums) return true;
+			}
 			bool bRet = false;
 			m_mutex.lock();
 			do 
@@ -343,6 +356,13 @@ namespace tghelper
 		//亯--Զչ汾
 		bool try_alloc_any_items(byte_macro_block *dst, uint32_t block_nums, bool bTrace = false)
 		{
+			if (!dst) return false;
+			//Զչʱ䲻ʧܣȡ̻߳еĽڵ
+			if (!bTrace && (0 < m_expand_size))
+			{
+				block_nums -= _cache_alloc_items(dst, block_nums);
+				if (0 == block_nums) return true;
+			}
 			bool bRet = false;
 			m_mutex.lock();
 			do 
@@ -408,6 +428,19 @@ namespace tghelper
 		//ټ벢ڵ
 		recycle_pool_item * add_alloc_fast_item(recycle_pool_item *item, bool bTrace = false)
 		{ return recycle_pool::add_alloc_fast_item(item, bTrace);	}
+		//ӱ̻߳ȡblock_numsڵ㣬仺棬ʣಿɵһμ
+		uint32_t _cache_alloc_items(byte_macro_block *dst, uint32_t block_nums)
+		{
+			uint32_t nRet = 0;
+			while (nRet < block_nums)
+			{
+				elemT * item = static_cast<elemT *>(_cache_alloc_item(false));
+				if (!item) break;
+				dst->push_byte_block(item);
+				nRet++;
+			}
+			return nRet;
+		}
 
 	protected:
 		uint32_t m_block_size;
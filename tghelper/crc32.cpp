@@ -0,0 +1,219 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   crc32.cpp
+// RTPУʹõCRC32
+///////////////////////////////////////////////////////////////////////////////////////////
+#include "crc32.h"
+#include <string.h>
+#include <boost/thread/once.hpp>
+
+//TG_CRC32_NO_CLMULǿʹslice8֧PCLMULQDQĻУ·
+#if defined(TG_CRC32_NO_CLMUL)
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#define TG_CRC32_CLMUL
+#define TG_CRC32_TARGET
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (__GNUC__ >= 5))
+#include <cpuid.h>
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <wmmintrin.h>
+#define TG_CRC32_CLMUL
+#define TG_CRC32_TARGET __attribute__((target("sse2,ssse3,pclmul")))
+#endif
+
+namespace tghelper
+{
+	namespace inner
+	{
+		static const uint32_t CRC32_POLY = 0x04C11DB7;
+
+		//table[k][b]Ϊֽbk0ֽڵCRC
+		static uint32_t s_crc_table[8][256];
+		static bool s_crc_clmul = false;
+		static boost::once_flag s_crc_once = BOOST_ONCE_INIT;
+
+		static inline uint32_t load_be32(const uint8_t *p)
+		{
+			return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+		}
+
+		static inline uint32_t crc_bytewise(uint32_t crc, const uint8_t *data, uint32_t len)
+		{
+			const uint32_t *t0 = s_crc_table[0];
+			while (len--)
+			{
+				crc = (crc << 8) ^ t0[(crc >> 24) ^ *data++];
+			}
+			return crc;
+		}
+
+		static uint32_t crc_slice8(uint32_t crc, const uint8_t *data, uint32_t len)
+		{
+			while (len >= 8)
+			{
+				uint32_t hi = crc ^ load_be32(data);
+				crc = s_crc_table[7][hi >> 24] ^
+					s_crc_table[6][(hi >> 16) & 0xFF] ^
+					s_crc_table[5][(hi >> 8) & 0xFF] ^
+					s_crc_table[4][hi & 0xFF] ^
+					s_crc_table[3][data[4]] ^
+					s_crc_table[2][data[5]] ^
+					s_crc_table[1][data[6]] ^
+					s_crc_table[0][data[7]];
+				data += 8;
+				len -= 8;
+			}
+			return crc_bytewise(crc, data, len);
+		}
+
+#ifdef TG_CRC32_CLMUL
+		//x^n mod P128λ۵
+		static uint32_t xpow_mod(uint32_t n)
+		{
+			uint32_t r = 1;
+			while (n--)
+			{
+				r = (r & 0x80000000) ? ((r << 1) ^ CRC32_POLY) : (r << 1);
+			}
+			return r;
+		}
+
+		//{64λ:x^128 mod P, 64λ:x^192 mod P}۵128λ
+		//{64λ:x^512 mod P, 64λ:x^576 mod P}4·ʱ۵512λ
+		static uint64_t s_fold_128[2];
+		static uint64_t s_fold_512[2];
+
+		static bool cpu_has_clmul()
+		{
+#if defined(_M_X64) || defined(_M_IX86)
+			int info[4];
+			__cpuid(info, 1);
+			return (info[2] & (1 << 1)) && (info[2] & (1 << 9));
+#else
+			unsigned int eax, ebx, ecx, edx;
+			if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+			{
+				return false;
+			}
+			return (ecx & bit_PCLMUL) && (ecx & bit_SSSE3);
+#endif
+		}
+
+		TG_CRC32_TARGET static inline __m128i fold(__m128i x, __m128i k, __m128i next)
+		{
+			__m128i lo = _mm_clmulepi64_si128(x, k, 0x00);
+			__m128i hi = _mm_clmulepi64_si128(x, k, 0x11);
+			return _mm_xor_si128(_mm_xor_si128(lo, hi), next);
+		}
+
+		//ݰλУ16ֽڷתx^127λ128λʽ
+		//CRCֻϢģPй(ֵ0)۵ٲһβΪ
+		TG_CRC32_TARGET static uint32_t crc_clmul(uint32_t crc, const uint8_t *data, uint32_t len)
+		{
+			const __m128i swap = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+			const __m128i k128 = _mm_loadu_si128((const __m128i *)s_fold_128);
+			const __m128i k512 = _mm_loadu_si128((const __m128i *)s_fold_512);
+
+			//ǰһε׿32λ
+			__m128i x0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), swap);
+			x0 = _mm_xor_si128(x0, _mm_slli_si128(_mm_cvtsi32_si128((int)crc), 12));
+			data += 16;
+			len -= 16;
+
+			if (len >= 48)
+			{
+				__m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), swap);
+				__m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16)), swap);
+				__m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 32)), swap);
+				data += 48;
+				len -= 48;
+
+				while (len >= 64)
+				{
+					x0 = fold(x0, k512, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), swap));
+					x1 = fold(x1, k512, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 16)), swap));
+					x2 = fold(x2, k512, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 32)), swap));
+					x3 = fold(x3, k512, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(data + 48)), swap));
+					data += 64;
+					len -= 64;
+				}
+
+				x0 = fold(x0, k128, x1);
+				x0 = fold(x0, k128, x2);
+				x0 = fold(x0, k128, x3);
+			}
+
+			while (len >= 16)
+			{
+				x0 = fold(x0, k128, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), swap));
+				data += 16;
+				len -= 16;
+			}
+
+			uint8_t rest[16];
+			_mm_storeu_si128((__m128i *)rest, _mm_shuffle_epi8(x0, swap));
+
+			return crc_slice8(crc_slice8(0, rest, 16), data, len);
+		}
+#endif
+
+		static void crc_init()
+		{
+			for (uint32_t b = 0; b < 256; ++b)
+			{
+				uint32_t r = b << 24;
+				for (int i = 0; i < 8; ++i)
+				{
+					r = (r & 0x80000000) ? ((r << 1) ^ CRC32_POLY) : (r << 1);
+				}
+				s_crc_table[0][b] = r;
+			}
+
+			for (uint32_t k = 1; k < 8; ++k)
+			{
+				for (uint32_t b = 0; b < 256; ++b)
+				{
+					uint32_t prev = s_crc_table[k - 1][b];
+					s_crc_table[k][b] = (prev << 8) ^ s_crc_table[0][prev >> 24];
+				}
+			}
+
+#ifdef TG_CRC32_CLMUL
+			s_fold_128[0] = xpow_mod(128);
+			s_fold_128[1] = xpow_mod(192);
+			s_fold_512[0] = xpow_mod(512);
+			s_fold_512[1] = xpow_mod(576);
+			s_crc_clmul = cpu_has_clmul();
+#endif
+		}
+	}
+
+	uint32_t crc32_update(uint32_t crc, const uint8_t *data, uint32_t len)
+	{
+		boost::call_once(inner::s_crc_once, &inner::crc_init);
+
+#ifdef TG_CRC32_CLMUL
+		//̰۵
+		if (inner::s_crc_clmul && len >= 64)
+		{
+			return inner::crc_clmul(crc, data, len);
+		}
+#endif
+		return inner::crc_slice8(crc, data, len);
+	}
+
+	uint32_t crc32_update_bytewise(uint32_t crc, const uint8_t *data, uint32_t len)
+	{
+		boost::call_once(inner::s_crc_once, &inner::crc_init);
+		return inner::crc_bytewise(crc, data, len);
+	}
+
+	const char *crc32_impl_name()
+	{
+		boost::call_once(inner::s_crc_once, &inner::crc_init);
+		return inner::s_crc_clmul ? "clmul" : "slice8";
+	}
+}
@@ -0,0 +1,31 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   crc32.h
+// RTPУʹõCRC32
+//
+// 1ʽ0x04C11DB7ֵ0λУ䣬ȡ(mp_entityԭCRC_32ֽڲһ)
+// 2ͨƽ̨slicing-by-8ÿδ8ֽ
+// 3x86/x64ʱ⵽PCLMULQDQʱ128λ۵β߲
+///////////////////////////////////////////////////////////////////////////////////////////
+#ifndef TGHELPER_CRC32_H_
+#define TGHELPER_CRC32_H_
+
+#include <stdint.h>
+
+namespace tghelper
+{
+	//crcΪǰһݵĽ׶δ0
+	uint32_t crc32_update(uint32_t crc, const uint8_t *data, uint32_t len);
+
+	inline uint32_t crc32(const uint8_t *data, uint32_t len)
+	{
+		return crc32_update(0, data, len);
+	}
+
+	//ֽڲĲοʵ֣Уʵʹ
+	uint32_t crc32_update_bytewise(uint32_t crc, const uint8_t *data, uint32_t len);
+
+	//ǰʹõʵƣ"clmul""slice8"
+	const char *crc32_impl_name();
+}
+
+#endif //TGHELPER_CRC32_H_
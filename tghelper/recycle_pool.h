@@ -13,7 +13,8 @@
 //		recycle_queue-->ѭFIFO
 //		recycle_stack-->ѭLIFOջ
 //
-// 2boostеmutexʵ߳ͬ
+// 2boostеmutexʵ߳ͬڵüboost::atomicʵ֣
+//    ڼʱ
 // 3stlеlistʵʴ洢
 // 4ڵüĲӦԲ
 //		recycle_pool_item->assign()
@@ -28,10 +29,14 @@
 // 6ڵṩ¼⴦
 //		recycle_pool_item->recycle_alloc_event()		ڵӳб
 //		recycle_pool_item->recycle_release_event()		ڵ㱻ɹͷŻس
+// 7recycle_poolȫֿбǰ̻߳(magazine)Ǹٽڵķͻ
+//    ̻߳ɣ/ʱżӳ/黹TGHELPER_POOL_CACHE_BATCHڵ
 //
 // ޶־
 // [2011-02-27]		汾
 // [2012-03-18]		ڴƬⵥԪrecycly_marco_block
+// [2026-10-16]		recycle_pool_itemüΪԭӲ
+// [2026-10-16]		recycle_pool̻߳
 ///////////////////////////////////////////////////////////////////////////////////////////
 
 #ifndef RECYCLE_POOL_
@@ -40,13 +45,26 @@
 #include<stdint.h>
 #include <string.h>
 #include <vector>
+#include <boost/noncopyable.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/smart_ptr/detail/spinlock.hpp>
+#include <boost/atomic.hpp>
 
 #if (_TGHELP_DEBUG_ENABLE)
 	#include <iostream>
 #endif
 
+//̻߳ -- λ̰߳״ʹ˳ӳ䵽λλͻʱɲλ֤ȫ
+#ifndef TGHELPER_POOL_CACHE_SLOTS
+#define TGHELPER_POOL_CACHE_SLOTS	8
+#endif
+//̻߳ -- ÿλڵ0ʾر̻߳
+#ifndef TGHELPER_POOL_CACHE_SIZE
+#define TGHELPER_POOL_CACHE_SIZE	32
+#endif
+//̻߳ -- ȫֿбĽڵ
+#define TGHELPER_POOL_CACHE_BATCH	(TGHELPER_POOL_CACHE_SIZE / 2)
+
 namespace tghelper
 {
 	namespace inner
@@ -61,6 +79,30 @@ namespace tghelper
 	}
 
 	class recycle_pool;
+	class recycle_pool_item;
+
+	namespace inner
+	{
+		//̻߳λrecycle_poolֵʼ
+		struct pool_cache_slot
+		{
+			boost::detail::spinlock lock;
+			uint32_t count;
+			uint64_t hits;
+			uint64_t misses;
+			uint64_t cross_frees;
+			recycle_pool_item *items[TGHELPER_POOL_CACHE_SIZE > 0 ? TGHELPER_POOL_CACHE_SIZE : 1];
+		};
+	}
+
+	//̻߳ͳϢ
+	typedef struct _recycle_pool_cache_stat
+	{
+		uint64_t hits;			//ֱ̻߳ӷĴ
+		uint64_t misses;		//̻߳ΪȫֿбĴ
+		uint64_t cross_frees;	//ɷǷ̻߳սڵĴ
+		uint32_t stock;			//ǰ̻߳еĽڵ
+	} recycle_pool_cache_stat;
 	class recycle_pool_item : private boost::noncopyable
 	{
 		friend class recycle_pool;
@@ -71,7 +113,8 @@ namespace tghelper
 		recycle_pool_item() :
 		   m_ref_count(0),
 		   m_owner(0),
-		   m_pool_trace(false)
+		   m_pool_trace(false),
+		   m_cache_slot(0)
 		{	}
 		virtual ~recycle_pool_item()
 		{
@@ -85,12 +128,12 @@ namespace tghelper
 		inline void set_owner_flag(recycle_pool * owner)
 		{ boost::mutex::scoped_lock lock(m_mutex); m_owner = owner; }
 		inline recycle_pool * get_owner_flag() { return m_owner; }
-		inline void reset_ref_count() { m_ref_count = 0; }
+		inline void reset_ref_count() { m_ref_count.store(0, boost::memory_order_relaxed); }
 
 	public:
 		int assign();
 		int release();
-		inline int use_count() { return m_ref_count; }
+		inline int use_count() { return m_ref_count.load(boost::memory_order_relaxed); }
 
 		//¼
 		virtual void recycle_alloc_event() {}
@@ -100,10 +143,11 @@ namespace tghelper
 		virtual uint32_t size_bytes() { return 0; }		//ô洢Ԫֽڳ
 
 	private:
-		int m_ref_count;
+		boost::atomic<int> m_ref_count;
 		recycle_pool * m_owner;
-		boost::mutex m_mutex;
+		boost::mutex m_mutex;		//m_ownerչ
 		bool m_pool_trace;
+		uint32_t m_cache_slot;		//ýڵ̻߳λͳƿ̻߳
 	};
 
 	class recycle_pool
@@ -124,6 +168,16 @@ namespace tghelper
 		void _add_item(recycle_pool_item *item);
 		void _del_item(recycle_pool_item *item);
 
+		//ӱ̻߳Ǹٽڵ㣬refillΪʱΪȫֿб
+		//ڳm_mutexʱ
+		recycle_pool_item * _cache_alloc_item(bool refill = true);
+
+	private:
+		//Ǹٽڵ뱾̻߳棬ʱ黹ȫֿб̻߳رʱfalse
+		bool _cache_release_item(recycle_pool_item *item);
+		//̻߳еĽڵȫ黹ȫֿб
+		void _cache_flush_all();
+
 	public:
 		//ڵ״̬
 		//һڵ㣬ڵ洢ռڲ
@@ -140,14 +194,16 @@ namespace tghelper
 		//ڴδڵ㣬δսڵ
 		uint32_t clear();
 
-		//״̬Ϣ
+		//״̬Ϣfreesize̻߳еĽڵ
 		inline uint32_t freesize() { return m_unused.size(); }
 		inline uint32_t tracesize(){ return m_used.size(); }
+		void cache_stat(recycle_pool_cache_stat &stat);
 
 	protected:
 		std::vector<recycle_pool_item *> m_unused;		//δʹб
 		std::vector<recycle_pool_item *> m_used;			//ʹб
 		boost::mutex m_mutex;
+		inner::pool_cache_slot m_cache[TGHELPER_POOL_CACHE_SLOTS];	//̻߳
 	};
 
 	template<typename elemT, int elemNums>
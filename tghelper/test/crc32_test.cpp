@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   crc32_test.cpp
+// crc32_updateʵ(slice8/clmul)ֽڲʵֵĽУ
+//
+// 1(0~4096)ʼ(0~15)߽һ
+// 2зΪηֱupdateμһ
+// 3ֽڲλĲο˶
+// 41400ֽڰϵ¶Ա
+//
+// ÷crc32_test [rounds]
+///////////////////////////////////////////////////////////////////////////////////////////
+#include "crc32.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <vector>
+
+using namespace tghelper;
+
+namespace
+{
+	const uint32_t MAX_LEN = 4096;
+	const uint32_t MAX_ALIGN = 16;
+	const uint32_t BENCH_LEN = 1400;
+	const uint32_t BENCH_LOOPS = 200000;
+
+	uint32_t g_seed = 12345;
+	uint32_t next_rand()
+	{
+		g_seed = g_seed * 1103515245u + 12345u;
+		return g_seed >> 8;
+	}
+
+	//λ㣬ʽ0x04C11DB7ֵɵ߸
+	uint32_t crc32_bitwise(uint32_t crc, const uint8_t *data, uint32_t len)
+	{
+		for (uint32_t i = 0; i < len; ++i)
+		{
+			crc ^= (uint32_t)data[i] << 24;
+			for (int b = 0; b < 8; ++b)
+			{
+				crc = (crc & 0x80000000) ? ((crc << 1) ^ 0x04C11DB7) : (crc << 1);
+			}
+		}
+		return crc;
+	}
+
+	double now_sec()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec + ts.tv_nsec / 1e9;
+	}
+
+	double bench(uint32_t (*fn)(uint32_t, const uint8_t *, uint32_t), const uint8_t *data)
+	{
+		volatile uint32_t sink = 0;
+		double begin = now_sec();
+		for (uint32_t i = 0; i < BENCH_LOOPS; ++i)
+		{
+			sink = sink + fn(0, data, BENCH_LEN);
+		}
+		double elapsed = now_sec() - begin;
+		return (double)BENCH_LEN * BENCH_LOOPS / elapsed / (1024.0 * 1024.0);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t rounds = (argc > 1) ? (uint32_t)atoi(argv[1]) : 100000;
+
+	std::vector<uint8_t> buf(MAX_LEN + MAX_ALIGN);
+	for (size_t i = 0; i < buf.size(); ++i)
+	{
+		buf[i] = (uint8_t)next_rand();
+	}
+
+	uint32_t errors = 0;
+	for (uint32_t r = 0; r < rounds; ++r)
+	{
+		//ǰָж̳ȣ֮
+		uint32_t len = (r <= 256) ? r : next_rand() % (MAX_LEN + 1);
+		uint32_t align = next_rand() % MAX_ALIGN;
+		uint32_t init = (r & 1) ? next_rand() : 0;
+		const uint8_t *p = &buf[align];
+
+		//ÿָļֽڣͬһ
+		buf[next_rand() % buf.size()] = (uint8_t)next_rand();
+
+		uint32_t expect = crc32_update_bytewise(init, p, len);
+		uint32_t fast = crc32_update(init, p, len);
+		uint32_t split = (0 == len) ? 0 : next_rand() % (len + 1);
+		uint32_t chained = crc32_update(crc32_update(init, p, split), p + split, len - split);
+
+		if (fast != expect || chained != expect)
+		{
+			if (++errors <= 10)
+			{
+				printf("mismatch: len %u align %u split %u init %08x, bytewise %08x, %s %08x, chained %08x\n",
+					len, align, split, init, expect, crc32_impl_name(), fast, chained);
+			}
+		}
+
+		//λ˶
+		if (0 == r % 64 && crc32_bitwise(init, p, len) != expect)
+		{
+			if (++errors <= 10)
+			{
+				printf("bytewise mismatch: len %u align %u init %08x\n", len, align, init);
+			}
+		}
+	}
+
+	printf("crc32 (%s) vs bytewise: %u rounds, %u errors\n", crc32_impl_name(), rounds, errors);
+	printf("throughput on %u bytes: %.0f MB/s (%s) vs %.0f MB/s (bytewise)\n",
+		BENCH_LEN, bench(crc32_update, &buf[1]), crc32_impl_name(), bench(crc32_update_bytewise, &buf[1]));
+	printf("%s\n", (0 == errors) ? "PASS" : "FAIL");
+	return (0 == errors) ? 0 : 1;
+}
@@ -0,0 +1,213 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   recycle_pool_test.cpp
+// recycle_pool_itemԭüѹܲ
+//
+// 1ѹԣڵ㱻߳ͬʱвreleaseУÿηǡûһΣ
+//    ظգʱȫڵص
+// 2ܲԣ1/4/16̶߳ͬһڵassign/releaseԭʽԱ
+//
+// ÷recycle_pool_test [stress_seconds]
+///////////////////////////////////////////////////////////////////////////////////////////
+#include "recycle_pool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <boost/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+using namespace tghelper;
+
+namespace
+{
+	const uint32_t STRESS_ITEMS = 256;
+	const uint32_t STRESS_THREADS = 8;
+	const uint32_t BENCH_LOOPS = 2000000;
+
+	boost::atomic<uint32_t> g_errors(0);
+
+	class test_item : public recycle_pool_item
+	{
+	public:
+		test_item() : m_in_pool(1), m_allocs(0), m_recycles(0) {}
+
+		virtual void recycle_alloc_event()
+		{
+			if (1 != m_in_pool.exchange(0)) ++g_errors;
+			++m_allocs;
+		}
+		virtual void recycle_release_event()
+		{
+			//ͬһη䱻μΪظ
+			if (0 != m_in_pool.exchange(1)) ++g_errors;
+			++m_recycles;
+		}
+
+		boost::atomic<int> m_in_pool;
+		boost::atomic<uint32_t> m_allocs;
+		boost::atomic<uint32_t> m_recycles;
+	};
+
+	//߳䣬߳ͶҪɱ߳releaseĽڵ
+	struct mailbox
+	{
+		boost::mutex mutex;
+		std::vector<recycle_pool_item *> items;
+	};
+
+	recycle_pool g_pool;
+	mailbox g_mailboxes[STRESS_THREADS];
+	volatile bool g_stop = false;
+
+	void drain(uint32_t id)
+	{
+		std::vector<recycle_pool_item *> items;
+		{
+			boost::mutex::scoped_lock lock(g_mailboxes[id].mutex);
+			items.swap(g_mailboxes[id].items);
+		}
+		for (size_t i = 0; i < items.size(); ++i)
+		{
+			items[i]->release();
+		}
+	}
+
+	void stress_worker(uint32_t id, uint64_t *rounds)
+	{
+		uint32_t seed = id * 2654435761u + 1;
+		while (!g_stop)
+		{
+			drain(id);
+
+			recycle_pool_item *item = g_pool.alloc_item();
+			if (!item)
+			{
+				boost::this_thread::yield();
+				continue;
+			}
+
+			//߳1~3̸߳һãrelease
+			item->assign();
+			seed = seed * 1103515245u + 12345u;
+			uint32_t peers = 1 + (seed >> 16) % 3;
+			for (uint32_t p = 0; p < peers; ++p)
+			{
+				item->assign();
+				uint32_t to = (id + 1 + p) % STRESS_THREADS;
+				boost::mutex::scoped_lock lock(g_mailboxes[to].mutex);
+				g_mailboxes[to].items.push_back(item);
+			}
+			item->release();
+			++*rounds;
+		}
+		drain(id);
+	}
+
+	int run_stress(int seconds)
+	{
+		std::vector<test_item *> items;
+		for (uint32_t i = 0; i < STRESS_ITEMS; ++i)
+		{
+			items.push_back(new test_item());
+			g_pool.add_item(items.back());
+		}
+
+		uint64_t rounds[STRESS_THREADS] = {0};
+		boost::thread_group threads;
+		for (uint32_t i = 0; i < STRESS_THREADS; ++i)
+		{
+			threads.create_thread(boost::bind(stress_worker, i, &rounds[i]));
+		}
+		boost::this_thread::sleep(boost::posix_time::seconds(seconds));
+		g_stop = true;
+		threads.join_all();
+		//߳˳ǰͶݵĽڵ
+		for (uint32_t i = 0; i < STRESS_THREADS; ++i) drain(i);
+
+		uint64_t total = 0;
+		for (uint32_t i = 0; i < STRESS_THREADS; ++i) total += rounds[i];
+
+		uint32_t leaked = 0;
+		uint32_t mismatched = 0;
+		for (uint32_t i = 0; i < STRESS_ITEMS; ++i)
+		{
+			if (1 != items[i]->m_in_pool.load()) ++leaked;
+			if (items[i]->m_allocs.load() != items[i]->m_recycles.load()) ++mismatched;
+		}
+
+		recycle_pool_cache_stat stat;
+		g_pool.cache_stat(stat);
+		uint32_t pooled = g_pool.freesize() + stat.stock;
+
+		printf("stress: %u threads, %llu shared allocations, errors %u, leaked %u, mismatched %u, pooled %u/%u\n",
+			STRESS_THREADS, (unsigned long long)total, g_errors.load(), leaked, mismatched, pooled, STRESS_ITEMS);
+		return (0 == g_errors.load() && 0 == leaked && 0 == mismatched && STRESS_ITEMS == pooled) ? 0 : 1;
+	}
+
+	//ԭʵ֣ÿμ仯ӽڵ
+	class mutex_counter
+	{
+	public:
+		mutex_counter() : m_ref(0) {}
+		int assign() { boost::mutex::scoped_lock lock(m_mutex); return ++m_ref; }
+		int release() { boost::mutex::scoped_lock lock(m_mutex); return --m_ref; }
+	private:
+		boost::mutex m_mutex;
+		int m_ref;
+	};
+
+	template<typename T>
+	void bench_worker(T *item, uint32_t loops)
+	{
+		for (uint32_t i = 0; i < loops; ++i)
+		{
+			item->assign();
+			item->release();
+		}
+	}
+
+	template<typename T>
+	double bench(T *item, uint32_t threads)
+	{
+		uint32_t loops = BENCH_LOOPS / threads;
+		boost::posix_time::ptime begin = boost::posix_time::microsec_clock::universal_time();
+		boost::thread_group group;
+		for (uint32_t i = 0; i < threads; ++i)
+		{
+			group.create_thread(boost::bind(bench_worker<T>, item, loops));
+		}
+		group.join_all();
+		boost::posix_time::time_duration d = boost::posix_time::microsec_clock::universal_time() - begin;
+		return (double)d.total_microseconds() * 1000.0 / ((double)loops * threads);
+	}
+
+	void run_bench()
+	{
+		//ڼԤȳһã
+		test_item *item = new test_item();
+		mutex_counter legacy;
+
+		const uint32_t threads[] = { 1, 4, 16 };
+		for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); ++i)
+		{
+			item->assign();
+			double atomic_ns = bench(item, threads[i]);
+			item->release();
+			legacy.assign();
+			double mutex_ns = bench(&legacy, threads[i]);
+			legacy.release();
+			printf("bench: %2u threads, assign+release %.1f ns (atomic) vs %.1f ns (mutex)\n",
+				threads[i], atomic_ns, mutex_ns);
+		}
+		delete item;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int seconds = (argc > 1) ? atoi(argv[1]) : 5;
+	int ret = run_stress(seconds);
+	run_bench();
+	printf("%s\n", (0 == ret) ? "PASS" : "FAIL");
+	return ret;
+}
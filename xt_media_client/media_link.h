@@ -17,6 +17,7 @@ namespace xt_media_client
     public:
         virtual xt_media_client_status_t get_header(uint8_t *data, uint32_t *length) = 0;
         virtual xt_media_client_status_t play(xt_media_client_frame_callback_t cb, void *ctx) = 0;
+        virtual xt_media_client_status_t play_iov(xt_media_client_frame_iov_callback_t cb, void *ctx) { return MEDIA_CLIENT_STATUS_NOT_SUPPORTED; }
         virtual xt_media_client_status_t close() = 0;
         virtual xt_media_client_status_t pause() { return MEDIA_CLIENT_STATUS_NOT_SUPPORTED; }
         virtual xt_media_client_status_t seek(double npt, float scale, uint32_t *seq, uint32_t *timestamp) { return MEDIA_CLIENT_STATUS_NOT_SUPPORTED; }
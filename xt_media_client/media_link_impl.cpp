@@ -26,7 +26,7 @@ namespace xt_media_client
         rv_rtp rtpH;
         rv_rtp_param p;
         rv_net_address address;
-        uint8_t buf[RTP_PACKAGE_MAX_SIZE];
+        rtp_pkt_t *pkt;         //ֱӶеİ飬֡óУپп
         uint32_t len;
         uint32_t m_exHead[16];
     };
@@ -176,6 +176,11 @@ namespace xt_media_client
         }
         if (rtp_demuxs_)
         {
+            //黹δİ
+            for (; front_rtp_demux_ != tail_rtp_demux_; front_rtp_demux_ = (front_rtp_demux_ + 1) % MAX_RTP_DEMUX)
+            {
+                rtp_demuxs_[front_rtp_demux_].pkt->release();
+            }
             delete[] rtp_demuxs_;
         }
     }
@@ -735,9 +740,9 @@ namespace xt_media_client
         return MEDIA_CLIENT_STATUS_OK;
     }
 
-    xt_media_client_status_t media_link_impl_base::start_capture(frame_data_dump_callback_t *cb)
+    xt_media_client_status_t media_link_impl_base::start_capture(frame_data_dump_callback_t *cb, frame_scatter_dump_callback_t *scatter_cb)
     {
-        active_rtp_sinks(cb);
+        active_rtp_sinks(cb, scatter_cb);
         if (session_)
         {
             return session_->play();
@@ -919,12 +924,12 @@ namespace xt_media_client
         rtp_sinks_.push_back(rtp_sink);
     }
 
-    void media_link_impl_base::active_rtp_sinks(frame_data_dump_callback_t *cb)
+    void media_link_impl_base::active_rtp_sinks(frame_data_dump_callback_t *cb, frame_scatter_dump_callback_t *scatter_cb)
     {
         spinlock_t::scoped_lock _lock(rtp_sinks_mutex_);
         for (std::size_t index = 0; index < rtp_sinks_.size(); ++index)
         {
-            rtp_sinks_[index]->active_rtp(cb);
+            rtp_sinks_[index]->active_rtp(cb, scatter_cb);
         }
     }
 
@@ -1090,21 +1095,22 @@ namespace xt_media_client
                     break;
                 }
 
-                int ret = rtp_sink_impl::pump_demux_rtp(sink, rtp.buf, rtp.len, rtp.p, rtp.address);
+                int ret = rtp_sink_impl::pump_demux_rtp(sink, rtp.pkt, rtp.len, rtp.p, rtp.address);
                 if (ret == 0)
                 {
                     break;
                 }
 
-                ::mp_pump_demux_rtp(sink->get_handle(), rtp.demux, rtp.buf, rtp.len, &rtp.rtpH, NULL, &rtp.p, &rtp.address);
+                ::mp_pump_demux_rtp(sink->get_handle(), rtp.demux, rtp.pkt->data(), rtp.len, &rtp.rtpH, NULL, &rtp.p, &rtp.address);
             } while (false);
+
+            rtp.pkt->release();
         }
     }
 
     void media_link_impl_base::rtp_demux_handler(void *hdemux)
     {
-        uint8_t buf[RTP_PACKAGE_MAX_SIZE];
-        uint32_t len = sizeof(buf);
+        uint32_t len = rtp_pkt_t::size();
 
         rv_rtp rtpH;
         rv_rtp_param p;
@@ -1113,10 +1119,12 @@ namespace xt_media_client
         bool ret = true;
         while (ret)
         {
-            ret = ::mp_read_demux_rtp(hdemux, buf, len, &rtpH, NULL, &p, &address);
+            rtp_pkt_t *pkt = rtp_pkt_t::alloc();
+            ret = ::mp_read_demux_rtp(hdemux, pkt->data(), len, &rtpH, NULL, &p, &address);
 
             if ((!ret) || ((uint32_t)p.len > len))
             {
+                pkt->release();
                 break;
             }
 
@@ -1134,24 +1142,24 @@ namespace xt_media_client
 
             if (new_tail_rtp_demux == front_rtp_demux_)
             {
+                pkt->release();
                 continue;
             }
-            else
-            {
-                tail_rtp_demux_ = new_tail_rtp_demux;
-            }
 
+            //дڵǰβǰƣѶ˴Ӷ׶д
             rtp_demuxs_[tail_rtp_demux_].address = address;
             rtp_demuxs_[tail_rtp_demux_].demux = hdemux;
             rtp_demuxs_[tail_rtp_demux_].len =p.len;
             rtp_demuxs_[tail_rtp_demux_].p = p;
             rtp_demuxs_[tail_rtp_demux_].rtpH = rtpH;
+            rtp_demuxs_[tail_rtp_demux_].pkt = pkt;
             if (p.extensionBit==1)
             {
                 ::memcpy(rtp_demuxs_[tail_rtp_demux_].m_exHead,p.extensionData,p.extensionLength*sizeof(uint32_t));                
                 rtp_demuxs_[tail_rtp_demux_].p.extensionData = rtp_demuxs_[tail_rtp_demux_].m_exHead;
             }
-            ::memcpy(&rtp_demuxs_[tail_rtp_demux_].buf, buf, len);
+
+            tail_rtp_demux_ = new_tail_rtp_demux;
         }
     }
 
@@ -1257,7 +1265,9 @@ namespace xt_media_client
     media_link_impl::media_link_impl(ports_mgr_t *ports_mgr)
         :media_link_impl_base(ports_mgr),
         cb_(NULL),
-        ctx_(NULL)
+        ctx_(NULL),
+        iov_cb_(NULL),
+        iov_ctx_(NULL)
     {}
 
     xt_media_client_status_t media_link_impl::get_header(uint8_t *data, uint32_t *length)
@@ -1281,6 +1291,8 @@ namespace xt_media_client
             spinlock_t::scoped_lock _lock(cb_mtx_);
             cb_ = cb;
             ctx_ = ctx;
+            iov_cb_ = NULL;
+            iov_ctx_ = NULL;
         }
 
         //added by lichao, 20151210 صÿ עⲿݻص
@@ -1292,6 +1304,25 @@ namespace xt_media_client
         return start_capture(this);
     }
 
+    //ɢ֡㲥play滻
+    xt_media_client_status_t media_link_impl::play_iov(xt_media_client_frame_iov_callback_t cb, void *ctx)
+    {
+        {
+            spinlock_t::scoped_lock _lock(cb_mtx_);
+            cb_ = NULL;
+            ctx_ = NULL;
+            iov_cb_ = cb;
+            iov_ctx_ = ctx;
+        }
+
+        if (NULL == cb)
+        {
+            return MEDIA_CLIENT_STATUS_OK;
+        }
+
+        return start_capture(this, this);
+    }
+
     xt_media_client_status_t media_link_impl::close()
     {
         close_link();
@@ -1393,6 +1424,17 @@ namespace xt_media_client
         return stat;
     }
 
+    xt_media_client_status_t media_link_impl2::play_iov(xt_media_client_frame_iov_callback_t cb, void *ctx)
+    {
+        xt_media_client_status_t stat = media_link_impl::play_iov(cb, ctx);
+        if (MEDIA_CLIENT_STATUS_OK == stat)
+        {
+            thread_timer::set_interval(RTP_BPS_CALA_PRIOD);
+        }
+
+        return stat;
+    }
+
     void media_link_impl2::on_timer()
     {
         rtp_prof_info_t rpi = { 0 };
@@ -1419,6 +1461,16 @@ namespace xt_media_client
 			cb_(ctx_, this, data, length, frame_type, data_type, timestamp, ssrc);
 		}
 	}
+
+	void media_link_impl::on_frame_scatter_dump(const xt_media_client_iovec_t *iov, uint32_t iovcnt, uint32_t length, uint32_t frame_type, uint32_t data_type, uint32_t timestamp, uint32_t ssrc)
+	{
+		no_frame_arrived_callback_impl::update_frame_arrived_ts();
+
+		if (iov_cb_)
+		{
+			iov_cb_(iov_ctx_, this, iov, iovcnt, length, frame_type, data_type, timestamp, ssrc);
+		}
+	}
 	//ʹmedia_linkcreate linkʱжΪʵ
 	void media_link_ref_t::on_frame_dump(void *data, uint32_t length, uint32_t frame_type, uint32_t data_type, uint32_t timestamp, uint32_t ssrc)
 	{
@@ -82,7 +82,7 @@ namespace xt_media_client{
         xt_media_client_status_t create_link(const char *multicast_ip, uint16_t multicast_port);
 
         void close_link();
-        xt_media_client_status_t start_capture(frame_data_dump_callback_t *cb);
+        xt_media_client_status_t start_capture(frame_data_dump_callback_t *cb, frame_scatter_dump_callback_t *scatter_cb = NULL);
         const std::string& get_sdp() const;
 
         xt_media_client_status_t set_sdp(const std::string& sdp);
@@ -124,7 +124,7 @@ namespace xt_media_client{
         bool session_setup(std::vector<xt_session_param_t>&params, bool with_describe = false);
 
         void add_rtp_sink(const rtp_sink_ptr&rtp_sink);
-        void active_rtp_sinks(frame_data_dump_callback_t *cb);
+        void active_rtp_sinks(frame_data_dump_callback_t *cb, frame_scatter_dump_callback_t *scatter_cb = NULL);
         void close_rtp_sinks();
         bool rtp_sinks_empty() const;
 
@@ -139,13 +139,14 @@ namespace xt_media_client{
         mutable spinlock_t rtp_sinks_mutex_;
     };//class media_link_impl_base
 
-    class media_link_impl : public media_link_t, public frame_data_dump_callback_t, public media_link_impl_base, protected rtcp_report_callback_impl, private no_frame_arrived_callback_impl
+    class media_link_impl : public media_link_t, public frame_data_dump_callback_t, public frame_scatter_dump_callback_t, public media_link_impl_base, protected rtcp_report_callback_impl, private no_frame_arrived_callback_impl
     {
     public:
         explicit media_link_impl(ports_mgr_t *ports_mgr);
 
         xt_media_client_status_t get_header(uint8_t *data, uint32_t *length);
         xt_media_client_status_t play(xt_media_client_frame_callback_t cb, void *ctx);
+        xt_media_client_status_t play_iov(xt_media_client_frame_iov_callback_t cb, void *ctx);
         xt_media_client_status_t close();
         xt_media_client_status_t pause();
         xt_media_client_status_t seek(double npt, float scale, uint32_t *seq, uint32_t *timestamp);
@@ -155,9 +156,12 @@ namespace xt_media_client{
 		xt_media_client_status_t register_rtcp_callback(xt_media_client_rtcp_report_callback_t cb, void *ctx);
         xt_media_client_status_t register_no_frame_arrived_callback(uint32_t priod, xt_media_client_no_frame_arrived_callback_t cb, void *ctx);
         void on_frame_dump(void *data, uint32_t length, uint32_t frame_type, uint32_t data_type, uint32_t timestamp, uint32_t ssrc);
+        void on_frame_scatter_dump(const xt_media_client_iovec_t *iov, uint32_t iovcnt, uint32_t length, uint32_t frame_type, uint32_t data_type, uint32_t timestamp, uint32_t ssrc);
     protected:
         xt_media_client_frame_callback_t cb_;
         void *ctx_;
+        xt_media_client_frame_iov_callback_t iov_cb_;
+        void *iov_ctx_;
         spinlock_t cb_mtx_;
 
     };//class media_link_impl
@@ -170,6 +174,7 @@ namespace xt_media_client{
 
         xt_media_client_status_t query_prof_info(xt_rtp_prof_info_t *prof);
         xt_media_client_status_t play(xt_media_client_frame_callback_t cb, void *ctx);
+        xt_media_client_status_t play_iov(xt_media_client_frame_iov_callback_t cb, void *ctx);
     protected:
         void on_timer();
 
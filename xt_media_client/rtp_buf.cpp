@@ -0,0 +1,192 @@
+#include "rtp_buf.h"
+
+#include <new>
+
+#ifndef _WIN32
+#include <sys/uio.h>
+#include <errno.h>
+#endif
+
+namespace xt_media_client
+{
+    rtp_buf_pool_t rtp_buf_pool_t::self_;
+
+    rtp_buf_pool_t::~rtp_buf_pool_t()
+    {
+        for (int c = 0; c < RTP_BUF_POOL_CLASSES; ++c)
+        {
+            for (std::size_t i = 0; i < free_[c].size(); ++i)
+            {
+                ::free(free_[c][i]);
+            }
+            free_[c].clear();
+        }
+
+        //˳ʱͷţԱеİ鲻
+        for (std::size_t i = 0; i < pkt_free_.size(); ++i)
+        {
+            pkt_free_[i]->~rtp_pkt_t();
+        }
+        pkt_free_.clear();
+        for (std::size_t i = 0; i < pkt_slabs_.size(); ++i)
+        {
+            ::free(pkt_slabs_[i]);
+        }
+        pkt_slabs_.clear();
+    }
+
+    int rtp_buf_pool_t::class_of(uint32_t len)
+    {
+        int c = 0;
+        while ((c < RTP_BUF_POOL_CLASSES) && (((uint32_t)1 << (RTP_BUF_POOL_MIN_SHIFT + c)) < len))
+        {
+            ++c;
+        }
+        return c;
+    }
+
+    uint8_t *rtp_buf_pool_t::alloc(uint32_t len, uint32_t &capacity)
+    {
+        int c = class_of(len);
+        if (c >= RTP_BUF_POOL_CLASSES)
+        {
+            //ּ޵İʵʳȷ䣬
+            capacity = len;
+            return static_cast<uint8_t *>(::malloc(len));
+        }
+
+        capacity = (uint32_t)1 << (RTP_BUF_POOL_MIN_SHIFT + c);
+        {
+            spinlock_t::scoped_lock _lock(mutex_[c]);
+            if (!free_[c].empty())
+            {
+                uint8_t *block = free_[c].back();
+                free_[c].pop_back();
+                return block;
+            }
+        }
+
+        return static_cast<uint8_t *>(::malloc(capacity));
+    }
+
+    void rtp_buf_pool_t::free(uint8_t *block, uint32_t capacity)
+    {
+        if (NULL == block)
+        {
+            return;
+        }
+
+        int c = class_of(capacity);
+        if ((c >= RTP_BUF_POOL_CLASSES) || (capacity != ((uint32_t)1 << (RTP_BUF_POOL_MIN_SHIFT + c))))
+        {
+            ::free(block);
+            return;
+        }
+
+        std::size_t max_blocks = RTP_BUF_POOL_CLASS_BYTES / capacity;
+        if (max_blocks < 1)
+        {
+            max_blocks = 1;
+        }
+
+        {
+            spinlock_t::scoped_lock _lock(mutex_[c]);
+            if (free_[c].size() < max_blocks)
+            {
+                free_[c].push_back(block);
+                return;
+            }
+        }
+
+        ::free(block);
+    }
+
+    rtp_pkt_t *rtp_buf_pool_t::alloc_pkt()
+    {
+        spinlock_t::scoped_lock _lock(pkt_mutex_);
+        if (pkt_free_.empty())
+        {
+            //䣬鳤ȡУʹַ
+            const std::size_t stride = (sizeof(rtp_pkt_t) + 63) & ~(std::size_t)63;
+            void *slab = ::malloc(stride * RTP_PKT_SLAB_BLOCKS + 63);
+            if (NULL == slab)
+            {
+                throw std::bad_alloc();
+            }
+            pkt_slabs_.push_back(slab);
+
+            uint8_t *base = reinterpret_cast<uint8_t *>(((uintptr_t)slab + 63) & ~(uintptr_t)63);
+            for (std::size_t i = RTP_PKT_SLAB_BLOCKS; i-- > 0; )
+            {
+                pkt_free_.push_back(new (base + i * stride) rtp_pkt_t());
+            }
+        }
+
+        rtp_pkt_t *pkt = pkt_free_.back();
+        pkt_free_.pop_back();
+        return pkt;
+    }
+
+    void rtp_buf_pool_t::free_pkt(rtp_pkt_t *pkt)
+    {
+        spinlock_t::scoped_lock _lock(pkt_mutex_);
+        pkt_free_.push_back(pkt);
+    }
+
+    void rtp_buf_pool_t::free_pkts(rtp_pkt_t *const *pkts, std::size_t count)
+    {
+        spinlock_t::scoped_lock _lock(pkt_mutex_);
+        pkt_free_.insert(pkt_free_.end(), pkts, pkts + count);
+    }
+
+    bool frame_iov_write(int fd, const frame_iovec_t *iov, uint32_t iovcnt)
+    {
+#ifdef _WIN32
+        return false;
+#else
+        struct iovec vec[RTP_BUF_IOV_BATCH];
+        uint32_t next = 0;
+        while (next < iovcnt)
+        {
+            uint32_t count = 0;
+            for (; (next < iovcnt) && (count < RTP_BUF_IOV_BATCH); ++next)
+            {
+                if (iov[next].length > 0)
+                {
+                    vec[count].iov_base = const_cast<void *>(iov[next].data);
+                    vec[count].iov_len = iov[next].length;
+                    ++count;
+                }
+            }
+
+            struct iovec *p = vec;
+            while (count > 0)
+            {
+                ssize_t n = ::writev(fd, p, count);
+                if (n <= 0)
+                {
+                    if ((n < 0) && (EINTR == errno))
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+
+                //дƬΣдƬǰ
+                while ((count > 0) && ((size_t)n >= p->iov_len))
+                {
+                    n -= p->iov_len;
+                    ++p;
+                    --count;
+                }
+                if (count > 0)
+                {
+                    p->iov_base = static_cast<uint8_t *>(p->iov_base) + n;
+                    p->iov_len -= n;
+                }
+            }
+        }
+        return true;
+#endif
+    }
+}
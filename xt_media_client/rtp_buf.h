@@ -3,27 +3,314 @@
 
 #define RTP_PACKAGE_MAX_SIZE            2048
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <vector>
+#include <algorithm>
+#include <boost/smart_ptr/detail/atomic_count.hpp>
+#include "spinlock.h"
+#include "xt_media_client_types.h"
+
+//طּ4KB2ݷּ12(8MB)ͨmalloc
+#define RTP_BUF_POOL_MIN_SHIFT          12
+#define RTP_BUF_POOL_CLASSES            12
+//ÿп黺(ֽ)ٻһ
+#define RTP_BUF_POOL_CLASS_BYTES        (16 * 1024 * 1024)
+//հ鰴64ֽڶ䣬ÿ鳣פУֵ⸴öм֡геİ
+#define RTP_PKT_SLAB_BLOCKS             64
+//ɢ֡ÿwritevƬ
+#define RTP_BUF_IOV_BATCH               1024
+
+//ֵֵ֡֡踲һGOP(NAL)ڼ䲻
+#define RTP_BUF_HINT_HOLD_FRAMES        1024
 
 namespace xt_media_client
 {
+    //ɢ֡ƬΣӿڵƬνṹһ
+    typedef xt_media_client_iovec_t frame_iovec_t;
+
+    class rtp_pkt_t;
+
+    //ּ֡ڴأ·ͷŵĿ鰴ո
+    class rtp_buf_pool_t
+    {
+    public:
+        static rtp_buf_pool_t *instance() { return &self_; }
+
+        //lenȡ䣬capacityʵ
+        uint8_t *alloc(uint32_t len, uint32_t &capacity);
+        void free(uint8_t *block, uint32_t capacity);
+
+        //հ
+        rtp_pkt_t *alloc_pkt();
+        void free_pkt(rtp_pkt_t *pkt);
+        //黹ֻһ
+        void free_pkts(rtp_pkt_t *const *pkts, std::size_t count);
+
+    private:
+        rtp_buf_pool_t() {}
+        ~rtp_buf_pool_t();
+
+        static int class_of(uint32_t len);
+
+        static rtp_buf_pool_t self_;
+
+        spinlock_t mutex_[RTP_BUF_POOL_CLASSES];
+        std::vector<uint8_t *> free_[RTP_BUF_POOL_CLASSES];
+
+        spinlock_t pkt_mutex_;
+        std::vector<rtp_pkt_t *> pkt_free_;
+        std::vector<void *> pkt_slabs_;
+    };
+
+    //հ飺⸴̰߳RTPеĿ飬ɢ֡ʱóиɣһͷʱس
+    class rtp_pkt_t
+    {
+    public:
+        //üΪ1
+        static rtp_pkt_t *alloc()
+        {
+            rtp_pkt_t *pkt = rtp_buf_pool_t::instance()->alloc_pkt();
+            ++pkt->ref_;
+            return pkt;
+        }
+
+        void add_ref()
+        {
+            ++ref_;
+        }
+
+        void release()
+        {
+            if (0 == --ref_)
+            {
+                rtp_buf_pool_t::instance()->free_pkt(this);
+            }
+        }
+
+        //ֻãtrueʱɵ÷黹
+        bool unref()
+        {
+            return (0 == --ref_);
+        }
+
+        uint8_t *data()
+        {
+            return buf_;
+        }
+
+        static uint32_t size()
+        {
+            return RTP_PACKAGE_MAX_SIZE;
+        }
+
+        bool contains(const uint8_t *data, uint32_t len) const
+        {
+            return (data >= buf_) && (data + len <= buf_ + RTP_PACKAGE_MAX_SIZE);
+        }
+
+    private:
+        friend class rtp_buf_pool_t;
+
+        rtp_pkt_t()
+            :ref_(0)
+        {}
+
+        //üͷͬ׸
+        boost::detail::atomic_count ref_;
+        uint8_t buf_[RTP_PACKAGE_MAX_SIZE];
+    };
+
+    //ɢ֡Ƭαýհ̬ݣ
+    //ڰڵɢ(عNALͷ)ɵ÷֡壬ֻƫƣʱַ
+    class rtp_buf_slices_t
+    {
+    public:
+        explicit rtp_buf_slices_t(uint32_t max_bound)
+            :length_(0),
+            max_bound_(max_bound)
+        {}
+
+        ~rtp_buf_slices_t()
+        {
+            rewind();
+        }
+
+        //ͷųеİ飬黹ʹһַ֡
+        void rewind()
+        {
+            std::size_t dead = 0;
+            for (std::size_t i = 0; i < pkts_.size(); ++i)
+            {
+                if (pkts_[i]->unref())
+                {
+                    pkts_[dead++] = pkts_[i];
+                }
+            }
+            if (0 < dead)
+            {
+                std::reverse(pkts_.begin(), pkts_.begin() + dead);
+                rtp_buf_pool_t::instance()->free_pkts(&pkts_[0], dead);
+            }
+            pkts_.clear();
+            slices_.clear();
+            length_ = 0;
+        }
+
+        //datapktΪձʾ̬
+        bool ref(const uint8_t *data, uint32_t len, rtp_pkt_t *pkt)
+        {
+            if ((uint64_t)length_ + len > max_bound_)
+            {
+                return false;
+            }
+
+            if ((NULL != pkt) && (pkts_.empty() || (pkts_.back() != pkt)))
+            {
+                pkt->add_ref();
+                pkts_.push_back(pkt);
+            }
+
+            if (!slices_.empty() && (NULL != slices_.back().data) && (slices_.back().data + slices_.back().length == data))
+            {
+                slices_.back().length += len;
+            }
+            else
+            {
+                slice_t s = { data, 0, len };
+                slices_.push_back(s);
+            }
+            length_ += len;
+            return true;
+        }
+
+        //¼ѿ֡offsetlenֽ
+        bool copy(uint32_t offset, uint32_t len)
+        {
+            if ((uint64_t)length_ + len > max_bound_)
+            {
+                return false;
+            }
+
+            if (!slices_.empty() && (NULL == slices_.back().data) && (slices_.back().offset + slices_.back().length == offset))
+            {
+                slices_.back().length += len;
+            }
+            else
+            {
+                slice_t s = { NULL, offset, len };
+                slices_.push_back(s);
+            }
+            length_ += len;
+            return true;
+        }
+
+        //ƬбƬΪ֡basehead_lenֽ(˽ͷ)
+        const frame_iovec_t *iov(const uint8_t *base, uint32_t head_len, uint32_t &iovcnt)
+        {
+            iov_.resize(slices_.size() + 1);
+            iov_[0].data = base;
+            iov_[0].length = head_len;
+            for (std::size_t i = 0; i < slices_.size(); ++i)
+            {
+                iov_[i + 1].data = (NULL != slices_[i].data) ? slices_[i].data : (base + slices_[i].offset);
+                iov_[i + 1].length = slices_[i].length;
+            }
+            iovcnt = (uint32_t)iov_.size();
+            return &iov_[0];
+        }
+
+        //ɳ(˽ͷ)
+        uint32_t length() const
+        {
+            return length_;
+        }
+
+    private:
+        struct slice_t
+        {
+            const uint8_t *data;    //Ϊʱoffsetȡ֡ڵ
+            uint32_t offset;
+            uint32_t length;
+        };
+
+        std::vector<slice_t> slices_;
+        std::vector<rtp_pkt_t *> pkts_;
+        std::vector<frame_iovec_t> iov_;
+        uint32_t length_;
+        const uint32_t max_bound_;
+    };
+
+    //ɢ֡֡дfd()ƬζRTP_BUF_IOV_BATCHʱwritevд
+    bool frame_iov_write(int fd, const frame_iovec_t *iov, uint32_t iovcnt);
+
+    //ֵ֡I֡ȴ֡GOPڳֵ֣һʱ䣬֡ٳֺ𲽻
+    class rtp_buf_hint_t
+    {
+    public:
+        rtp_buf_hint_t()
+            :peak_(0),
+            hold_(0)
+        {}
+
+        void learn(uint32_t frame_len)
+        {
+            //·ֵӽֵĴ֡ˢ±
+            if (frame_len >= (peak_ >> 1))
+            {
+                if (frame_len > peak_)
+                {
+                    peak_ = frame_len;
+                }
+                hold_ = RTP_BUF_HINT_HOLD_FRAMES;
+                return;
+            }
+
+            if (hold_ > 0)
+            {
+                --hold_;
+                return;
+            }
+
+            //ڹÿ֡1/8ڵǰ֡
+            peak_ -= (peak_ >> 3);
+            if (peak_ < frame_len)
+            {
+                peak_ = frame_len;
+            }
+        }
+
+        //Ԥ1/8
+        uint32_t hint() const
+        {
+            return peak_ + (peak_ >> 3);
+        }
+
+    private:
+        uint32_t peak_;
+        uint32_t hold_;
+    };
+
     class rtp_buf_t
     {
     public:
         rtp_buf_t(uint32_t capacity, uint32_t max_bound)
             :length_(0),
-            capacity_(capacity),
+            capacity_(0),
+            min_capacity_(capacity),
             max_bound_(max_bound),
-            data_(NULL)
+            grows_(0),
+            data_(NULL),
+            hint_()
         {
-            data_ = static_cast<uint8_t *>(::malloc(capacity));
+            data_ = rtp_buf_pool_t::instance()->alloc(capacity, capacity_);
         }
 
         ~rtp_buf_t()
         {
             if (NULL != data_)
             {
-                ::free(data_);
+                rtp_buf_pool_t::instance()->free(data_, capacity_);
                 data_ = 0;
                 length_ = 0;
                 capacity_ = 0;
@@ -43,36 +330,50 @@ namespace xt_media_client
             return len;
         }
 
+        //֤дlenֽڣʱֻд벿
         bool resize(uint32_t len)
         {
-            uint32_t new_capacity = capacity_;
-
-            do
+            uint64_t need = (uint64_t)length_ + len;
+            if (need > max_bound_)
             {
-                new_capacity <<= 1;
-
-                if (new_capacity > max_bound_)
-                {
-                    return false;
-                }
+                return false;
             }
-            while (new_capacity - length_ < len);
 
-            void *ptr = ::realloc(data_, new_capacity);
-            if (NULL == ptr)
+            if (need <= capacity_)
             {
-                return false;
+                return true;
             }
 
-            data_ = static_cast<uint8_t *>(ptr);
-            capacity_ = new_capacity;
+            ++grows_;
+            return reserve((uint32_t)need, length_);
+        }
 
-            return true;
+        //¼һ֡ȣһ֡Ԥ
+        void learn(uint32_t frame_len)
+        {
+            hint_.learn(frame_len);
         }
 
-        void rewind()
+        //ص㲢ǰkeepֽ
+        //ֵ֡ʱǰ飬֡ݣֵԶСʱС
+        void rewind(uint32_t keep = 0)
         {
-            length_ = 0;
+            length_ = keep;
+
+            uint32_t want = hint_.hint();
+            if (want > max_bound_)
+            {
+                want = max_bound_;
+            }
+            if (want < min_capacity_)
+            {
+                want = min_capacity_;
+            }
+
+            if ((want > capacity_) || ((capacity_ > min_capacity_) && (want < (capacity_ >> 2))))
+            {
+                (void)reserve(want, keep);
+            }
         }
 
         void seek(int32_t offset)
@@ -105,11 +406,43 @@ namespace xt_media_client
             return capacity_;
         }
 
+        //֡ݴ(ÿ追д벿)
+        uint32_t grows() const
+        {
+            return grows_;
+        }
+
     private:
+        bool reserve(uint32_t size, uint32_t keep)
+        {
+            uint32_t new_capacity = 0;
+            uint8_t *ptr = rtp_buf_pool_t::instance()->alloc(size, new_capacity);
+            if (NULL == ptr)
+            {
+                return false;
+            }
+
+            if ((NULL != data_) && (keep > 0))
+            {
+                memcpy(ptr, data_, keep);
+            }
+            if (NULL != data_)
+            {
+                rtp_buf_pool_t::instance()->free(data_, capacity_);
+            }
+
+            data_ = ptr;
+            capacity_ = new_capacity;
+            return true;
+        }
+
         uint32_t length_;
         uint32_t capacity_;
+        const uint32_t min_capacity_;
         const uint32_t max_bound_;
+        uint32_t grows_;
         uint8_t *data_;
+        rtp_buf_hint_t hint_;
     };
 }
 
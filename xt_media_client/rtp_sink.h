@@ -28,6 +28,7 @@ namespace xt_media_client
     struct rtp_prof_info_t
     {
         uint64_t rtp_total_bytes;
+        uint64_t rtp_incomplete_frames;     //嵽Ĳ֡
     };
 
     class MEDIA_CLIENT_NO_VTABLE rtcp_report_callback_t
@@ -47,6 +48,15 @@ namespace xt_media_client
         virtual ~frame_data_dump_callback_t() {}
     };
 
+    //ɢ֡صƬΪ˽ͷƬýհ飬ڻصڼЧ
+    class MEDIA_CLIENT_NO_VTABLE frame_scatter_dump_callback_t
+    {
+    public:
+        virtual void on_frame_scatter_dump(const xt_media_client_iovec_t *iov, uint32_t iovcnt, uint32_t length, uint32_t frame_type, uint32_t data_type, uint32_t timestamp, uint32_t ssrc) = 0;
+    protected:
+        virtual ~frame_scatter_dump_callback_t() {}
+    };
+
     struct multicast_param_t
     {
         const char *ip;
@@ -65,7 +75,8 @@ namespace xt_media_client
         };
 
         virtual bool open_rtp(const char *ip, uint16_t rtp_port, uint16_t rtcp_port, open_rtp_mode open_mode, bool demux, uint32_t& demuxid, const multicast_param_t *multicast = NULL, rv_context demux_handler = NULL) = 0;
-        virtual void active_rtp(frame_data_dump_callback_t *cb) = 0;
+        //scatter_cbǿʱ֡ɢ֡
+        virtual void active_rtp(frame_data_dump_callback_t *cb, frame_scatter_dump_callback_t *scatter_cb = NULL) = 0;
         virtual void close_rtp() = 0;
         virtual bool add_remote_address(const char *ip, uint16_t rtp_port, uint16_t rtcp_port, bool demux, uint32_t demuxid) = 0;
         //virtual bool get_rtcp_rr(rtcp_recv_report_t *rr) const = 0;
@@ -65,11 +65,12 @@ namespace xt_media_client
         return unpackers_.empty();
     }
 
-    void payload_to_unpacker_t::register_frame_dump_callback(frame_data_dump_callback_t *cb)
+    void payload_to_unpacker_t::register_frame_dump_callback(frame_data_dump_callback_t *cb, frame_scatter_dump_callback_t *scatter_cb)
     {
         spinlock_t::scoped_lock _lock(mutex_);
         for (unpacker_map_t::iterator it = unpackers_.begin(); unpackers_.end() != it; ++it)
         {
+            it->second->register_frame_scatter_callback(scatter_cb);
             it->second->register_frame_dump_callback(cb);
         }
     }
@@ -77,24 +78,28 @@ namespace xt_media_client
     rtp_sink_impl::rtp_sink_impl(uint32_t rtp_frame_bytes, uint32_t rtp_frame_max_bytes)
         :handle_(),
         cb_(NULL),
+        scatter_cb_(NULL),
         payload_to_unpacker_(),
         rtp_frame_buf_(new (std::nothrow) rtp_buf_t(rtp_frame_bytes, rtp_frame_max_bytes)),
         is_open_(false),
         is_multicast_(false),
         is_demux_(false),
         rtp_total_bytes_(0),
+        rtp_incomplete_frames_(0),
 		rtcp_cb_(NULL)
     {}
 
     rtp_sink_impl::rtp_sink_impl(const rtp_unpack_ptr&packer)
         :handle_(),
         cb_(NULL),
+        scatter_cb_(NULL),
         payload_to_unpacker_(),
         rtp_frame_buf_(),
         is_open_(false),
         is_multicast_(false),
         is_demux_(false),
         rtp_total_bytes_(0),
+        rtp_incomplete_frames_(0),
 		rtcp_cb_(NULL)
     {
         add_unpacker(-1, packer);
@@ -112,7 +117,7 @@ namespace xt_media_client
         {
             if (cb_)
             {
-                payload_to_unpacker_.register_frame_dump_callback(cb_);
+                payload_to_unpacker_.register_frame_dump_callback(cb_, scatter_cb_);
             }
         }
     }
@@ -212,15 +217,16 @@ namespace xt_media_client
         return is_open_;
     }
 
-    void rtp_sink_impl::active_rtp(frame_data_dump_callback_t *cb)
+    void rtp_sink_impl::active_rtp(frame_data_dump_callback_t *cb, frame_scatter_dump_callback_t *scatter_cb)
     {
         if (!payload_to_unpacker_.empty())
         {
-            payload_to_unpacker_.register_frame_dump_callback(cb);
+            payload_to_unpacker_.register_frame_dump_callback(cb, scatter_cb);
         }
         else
         {
             cb_ = cb;
+            scatter_cb_ = scatter_cb;
         }
     }
 
@@ -352,6 +358,7 @@ namespace xt_media_client
         }
 
         rpi->rtp_total_bytes = rtp_total_bytes_;
+        rpi->rtp_incomplete_frames = rtp_incomplete_frames_;
 
         return true;
     }
@@ -387,7 +394,14 @@ namespace xt_media_client
 
             rtp_total_bytes_ += block.size;
 
-            if (NULL != cb_)
+            //տƴ֡ɢ㲥ʱΪƬ
+            frame_scatter_dump_callback_t *scatter_cb = scatter_cb_;
+            if (NULL != scatter_cb)
+            {
+                frame_iovec_t iov = { rtp_frame_buf_->data(), block.size };
+                scatter_cb->on_frame_scatter_dump(&iov, 1, block.size, frame.frametype, frame.datatype, block.timestamp, block.ssrc);
+            }
+            else if (NULL != cb_)
             {
                 cb_->on_frame_dump(rtp_frame_buf_->data(), block.size, frame.frametype, frame.datatype, block.timestamp, block.ssrc);
             }
@@ -411,6 +425,12 @@ namespace xt_media_client
 			{
 				break;
 			}
+			//2Ϊ嵽Ĳ֡һͬ֡һ֡ϲ
+			if (ret == 2)
+			{
+				++rtp_incomplete_frames_;
+				break;
+			}
         }
 		/*uint8_t buf[RTP_PACKAGE_MAX_SIZE];
 		uint32_t len = sizeof(buf);
@@ -516,6 +536,22 @@ namespace xt_media_client
 
         return ret;
     }
+
+    int rtp_sink_impl::pump_demux_rtp(rtp_sink_impl *sink, rtp_pkt_t *pkt, uint32_t len, const rv_rtp_param &p, const rv_net_address &address)
+    {
+        int ret = -1;
+        if (NULL != sink)
+        {
+            rtp_unpack_ptr unpacker = sink->payload_to_unpacker_.get_unpacker(p.payload);
+            if (unpacker)
+            {
+                ret = 0;
+                unpacker->pump_rtp_packet(pkt, pkt->data() + p.sByte, len - p.sByte, p);
+            }
+        }
+
+        return ret;
+    }
 	
 	void rtp_sink_impl::s_report_receive_handler(const rtcp_send_report *sr, void *context)
     {
@@ -47,7 +47,7 @@ namespace xt_media_client
 		bool add_unpacker(int payload, const rtp_unpack_ptr& unpacker);
 		rtp_unpack_ptr get_unpacker(int payload);
 		bool empty() const;
-		void register_frame_dump_callback(frame_data_dump_callback_t *cb);
+		void register_frame_dump_callback(frame_data_dump_callback_t *cb, frame_scatter_dump_callback_t *scatter_cb = NULL);
 	private:
 		mutable spinlock_t mutex_;
 		typedef boost::unordered_map<int, rtp_unpack_ptr> unpacker_map_t;
@@ -62,7 +62,7 @@ namespace xt_media_client
         ~rtp_sink_impl();
 
         bool open_rtp(const char *ip, uint16_t rtp_port, uint16_t rtcp_port,open_rtp_mode open_mode, bool demux, uint32_t& demuxid, const multicast_param_t *multicast, rv_context demux_handler);
-        void active_rtp(frame_data_dump_callback_t *cb);
+        void active_rtp(frame_data_dump_callback_t *cb, frame_scatter_dump_callback_t *scatter_cb = NULL);
         void close_rtp();
         bool add_remote_address(const char *ip, uint16_t rtp_port, uint16_t rtcp_port, bool demux, uint32_t demuxid);
         //bool get_rtcp_rr(rtcp_recv_report_t *rr) const;
@@ -78,6 +78,8 @@ namespace xt_media_client
 
 		msink_handle* get_handle();
 		static int pump_demux_rtp(rtp_sink_impl *sink, void *buf, uint32_t len, const rv_rtp_param &p, const rv_net_address &address);
+		//ڰpktڣɢ֡ʱ֡а
+		static int pump_demux_rtp(rtp_sink_impl *sink, rtp_pkt_t *pkt, uint32_t len, const rv_rtp_param &p, const rv_net_address &address);
 
     private:
         bool is_open() const;
@@ -100,6 +102,7 @@ namespace xt_media_client
         msink_handle handle_;
 
         frame_data_dump_callback_t *cb_;
+        frame_scatter_dump_callback_t *scatter_cb_;
 		payload_to_unpacker_t payload_to_unpacker_;
 
         std::auto_ptr<rtp_buf_t> rtp_frame_buf_;
@@ -108,6 +111,7 @@ namespace xt_media_client
 		bool is_demux_;
 
         uint64_t rtp_total_bytes_;
+        uint64_t rtp_incomplete_frames_;
 		rtcp_report_callback_t *rtcp_cb_;
     };
 
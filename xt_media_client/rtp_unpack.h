@@ -13,12 +13,18 @@
 namespace xt_media_client
 {
     class frame_data_dump_callback_t;
+    class frame_scatter_dump_callback_t;
+    class rtp_pkt_t;
 
     class MEDIA_CLIENT_NO_VTABLE rtp_unpack_t
     {
     public:
         virtual bool pump_rtp_raw_data(uint8_t *data, uint32_t length, const rv_rtp_param& params) = 0;
+        //dataλڰpktڣɢ֡ʱаö
+        virtual bool pump_rtp_packet(rtp_pkt_t *pkt, uint8_t *data, uint32_t length, const rv_rtp_param& params) = 0;
         virtual void register_frame_dump_callback(frame_data_dump_callback_t *cb) = 0;
+        //עɢ֡صǿʱ֡ƴΪڴ
+        virtual void register_frame_scatter_callback(frame_scatter_dump_callback_t *cb) = 0;
 		virtual void dump_rtp_frame_data(uint8_t *data, uint32_t length, const rv_rtp_param& params)=0;
     protected:
         virtual ~rtp_unpack_t() {}
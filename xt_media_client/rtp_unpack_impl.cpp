@@ -13,6 +13,8 @@ namespace xt_media_client
 {
     rtp_unpack_direct_impl::rtp_unpack_direct_impl(uint32_t frame_type, uint32_t data_type)
         :cb_(NULL),
+        scatter_cb_(NULL),
+        cur_pkt_(NULL),
         frame_type_(frame_type),
         data_type_(data_type)
     {}
@@ -23,14 +25,33 @@ namespace xt_media_client
         return true;
     }
 
+    bool rtp_unpack_direct_impl::pump_rtp_packet(rtp_pkt_t *pkt, uint8_t *data, uint32_t length, const rv_rtp_param &params)
+    {
+        cur_pkt_ = pkt;
+        bool ret = pump_rtp_raw_data(data, length, params);
+        cur_pkt_ = NULL;
+        return ret;
+    }
+
     void rtp_unpack_direct_impl::register_frame_dump_callback(frame_data_dump_callback_t *cb)
     {
         cb_ = cb;
     }
 
+    void rtp_unpack_direct_impl::register_frame_scatter_callback(frame_scatter_dump_callback_t *cb)
+    {
+        scatter_cb_ = cb;
+    }
+
     void rtp_unpack_direct_impl::dump_rtp_frame_data(uint8_t *data, uint32_t length, const rv_rtp_param &params)
     {
-        if (NULL != cb_)
+        frame_scatter_dump_callback_t *scatter_cb = scatter_cb_;
+        if (NULL != scatter_cb)
+        {
+            frame_iovec_t iov = { data, length };
+            scatter_cb->on_frame_scatter_dump(&iov, 1, length, frame_type_, data_type_, params.timestamp, params.sSrc);
+        }
+        else if (NULL != cb_)
         {
             cb_->on_frame_dump(data, length, frame_type_, data_type_, params.timestamp, params.sSrc);
         }
@@ -64,7 +85,7 @@ namespace xt_media_client
         }
 
         unpack_state_ = unpack_stat_start;
-        rtp_priv_frame_.rewind();
+        rtp_priv_frame_.rewind(NULL != scatter_cb_);
         priv_timestamp() = params.timestamp;
 
         return true;
@@ -144,14 +165,43 @@ namespace xt_media_client
     void rtp_unpack_priv_impl::dump_rtp_frame_data(const rv_rtp_param& params)
     {
         rtp_priv_frame_.fit_priv_size();
+        rtp_priv_frame_.learn_frame_size();
         priv_chunk_count()++;
-        rtp_unpack_direct_impl::dump_rtp_frame_data(rtp_priv_frame_.data(), rtp_priv_frame_.length(), params);
+
+        frame_scatter_dump_callback_t *scatter_cb = scatter_cb_;
+        if (!rtp_priv_frame_.scatter())
+        {
+            rtp_unpack_direct_impl::dump_rtp_frame_data(rtp_priv_frame_.data(), rtp_priv_frame_.length(), params);
+        }
+        else if (NULL != scatter_cb)
+        {
+            uint32_t iovcnt = 0;
+            const frame_iovec_t *iov = rtp_priv_frame_.iov(iovcnt);
+            scatter_cb->on_frame_scatter_dump(iov, iovcnt, rtp_priv_frame_.length(), frame_type_, data_type_, params.timestamp, params.sSrc);
+        }
+        //֡ע˷ɢصʱƴӺ֡
+        else if (NULL != cb_)
+        {
+            rtp_buf_t flat(rtp_priv_frame_.length(), RTP_FRAME_MAX_SIZE);
+            if (rtp_priv_frame_.flatten(flat))
+            {
+                cb_->on_frame_dump(flat.data(), flat.length(), frame_type_, data_type_, params.timestamp, params.sSrc);
+            }
+        }
+
+        //󼴹黹飬һ֡ʼ
+        rtp_priv_frame_.release_pkts();
         unpack_state_ = unpack_stat_end;
     }
 
     bool rtp_unpack_priv_impl::write_rtp_raw_data(const uint8_t *data, uint32_t length)
     {
-        return (0 != rtp_priv_frame_.write_rtp_raw_data(data, length));
+        return (0 != rtp_priv_frame_.write_rtp_raw_data(data, length, cur_pkt_));
+    }
+
+    bool rtp_unpack_priv_impl::write_static_data(const uint8_t *data, uint32_t length)
+    {
+        return (0 != rtp_priv_frame_.write_static_data(data, length));
     }
 
     uint32_t& rtp_unpack_priv_impl::priv_timestamp()
@@ -201,7 +251,7 @@ namespace xt_media_client
     void rtp_unpack_video_priv_impl::write_start_sequence()
     {
         static const uint8_t _start_sequence[] = { 0, 0, 0, 1 };
-        write_rtp_raw_data(_start_sequence, sizeof(_start_sequence));
+        write_static_data(_start_sequence, sizeof(_start_sequence));
     }
 
     void rtp_unpack_video_priv_impl::set_frame_type(uint32_t frame_type)
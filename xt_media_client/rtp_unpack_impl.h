@@ -36,11 +36,15 @@ namespace xt_media_client
         rtp_unpack_direct_impl(uint32_t frame_type, uint32_t data_type);
 
         bool pump_rtp_raw_data(uint8_t *data, uint32_t length, const rv_rtp_param& params);
+        bool pump_rtp_packet(rtp_pkt_t *pkt, uint8_t *data, uint32_t length, const rv_rtp_param& params);
         void register_frame_dump_callback(frame_data_dump_callback_t *cb);
+        void register_frame_scatter_callback(frame_scatter_dump_callback_t *cb);
 
     protected:
         void dump_rtp_frame_data(uint8_t *data, uint32_t length, const rv_rtp_param& params);
         frame_data_dump_callback_t *cb_;
+        frame_scatter_dump_callback_t *scatter_cb_;
+        rtp_pkt_t *cur_pkt_;        //֡İ飬ԭʼݱʱΪ
         uint32_t frame_type_;
         uint32_t data_type_;
     };
@@ -49,7 +53,9 @@ namespace xt_media_client
     {
     public:
         rtp_priv_frame_data_t(uint32_t buf_capacity, uint32_t buf_max_bound, uint32_t priv_header_frame_type)
-            :buf_(buf_capacity, buf_max_bound)
+            :buf_(buf_capacity, buf_max_bound),
+            slices_(buf_max_bound),
+            scatter_(false)
         {
             rewind();
 
@@ -68,7 +74,7 @@ namespace xt_media_client
 
         void fit_priv_size()
         {
-            uint32_t total = buf_.length();
+            uint32_t total = length();
             if (total > sizeof(rtp_priv_header_t))
             {
                 get_priv_header()->uDataSize = total - sizeof(rtp_priv_header_t);
@@ -79,15 +85,80 @@ namespace xt_media_client
             }
         }
 
-        uint32_t write_rtp_raw_data(const uint8_t *payload, uint32_t len)
+        //ɢģʽλڰpktڵĸֻã࿽֡
+        uint32_t write_rtp_raw_data(const uint8_t *payload, uint32_t len, rtp_pkt_t *pkt = NULL)
         {
+            if (!scatter_)
+            {
+                return buf_.write(payload, len);
+            }
+
+            if ((NULL != pkt) && pkt->contains(payload, len))
+            {
+                return slices_.ref(payload, len, pkt) ? len : 0;
+            }
+
+            uint32_t offset = buf_.length();
+            if (0 == buf_.write(payload, len))
+            {
+                return 0;
+            }
+            return slices_.copy(offset, len) ? len : 0;
+        }
+
+        //д뾲̬(ʼ)ɢģʽֻò
+        uint32_t write_static_data(const uint8_t *payload, uint32_t len)
+        {
+            if (scatter_)
+            {
+                return slices_.ref(payload, len, NULL) ? len : 0;
+            }
             return buf_.write(payload, len);
         }
 
-        void rewind()
+        //֡ʼʱ˽ͷֵ֡Ԥѡ֡ʽ(֡ڲл)
+        void rewind(bool scatter = false)
+        {
+            scatter_ = scatter;
+            buf_.rewind(sizeof(rtp_priv_header_t));
+            slices_.rewind();
+        }
+
+        //¼֡֡еĳȣɢģʽֻ˽ͷɢ
+        void learn_frame_size()
+        {
+            buf_.learn(buf_.length());
+        }
+
+        bool scatter() const
+        {
+            return scatter_;
+        }
+
+        void release_pkts()
+        {
+            slices_.rewind();
+        }
+
+        //ɢ֡ƬΣƬΪ˽ͷ
+        const frame_iovec_t *iov(uint32_t &iovcnt)
+        {
+            return slices_.iov(buf_.data(), sizeof(rtp_priv_header_t), iovcnt);
+        }
+
+        //ɢ֡ƴӵout֡ע˷ɢصʱ֡
+        bool flatten(rtp_buf_t &out)
         {
-            buf_.rewind();
-            buf_.seek(sizeof(rtp_priv_header_t));
+            uint32_t iovcnt = 0;
+            const frame_iovec_t *v = iov(iovcnt);
+            for (uint32_t i = 0; i < iovcnt; ++i)
+            {
+                if ((v[i].length > 0) && (0 == out.write(v[i].data, v[i].length)))
+                {
+                    return false;
+                }
+            }
+            return true;
         }
 
         uint8_t *data()
@@ -97,11 +168,18 @@ namespace xt_media_client
 
         uint32_t length() const
         {
-            return buf_.length();
+            return scatter_ ? (sizeof(rtp_priv_header_t) + slices_.length()) : buf_.length();
+        }
+
+        uint32_t grows() const
+        {
+            return buf_.grows();
         }
 
     private:
         rtp_buf_t buf_;
+        rtp_buf_slices_t slices_;
+        bool scatter_;
     };
 
     class rtp_unpack_priv_impl : public rtp_unpack_direct_impl
@@ -124,6 +202,12 @@ namespace xt_media_client
         {}
 
         bool pump_rtp_raw_data(uint8_t *data, uint32_t length, const rv_rtp_param& params);
+
+        //֡֡ݴ̬Ӧ
+        uint32_t frame_grows() const
+        {
+            return rtp_priv_frame_.grows();
+        }
     protected:
         void on_lost_frame();
 
@@ -139,6 +223,7 @@ namespace xt_media_client
 
         void dump_rtp_frame_data(const rv_rtp_param& params);
         bool write_rtp_raw_data(const uint8_t *data, uint32_t length);
+        bool write_static_data(const uint8_t *data, uint32_t length);
 
         uint32_t& priv_timestamp();
         uint32_t& priv_chunk_count();
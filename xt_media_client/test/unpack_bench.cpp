@@ -0,0 +1,587 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   unpack_bench.cpp
+// H264/H265֡ܲԣΪ4K/30fpsRTP¼ļ
+//
+// 1¼ļʽÿRTPǰ4ֽڴ˳ȣΪRTP(12ֽRTPͷ)
+//    ָ¼ļʱһ4K/30fps(ÿһ1~1.5MBĵslice I֡
+//    Ϊ40~80KB4 slice P֡MTU 1400FU-A/FUƬ)дļֱ֮ӻط
+// 2̬һ·֡ѭط¼ļÿGOP½֡֡ظã
+//    ɢֻ֡аã֡frame_iov_writeת(Удʱļرȶ)
+//    طͬ⸴̰߳Ѱа飬̬ɢļʱֶ֡תʱļ(ÿֽض)
+//    ֡writeɢ֡writevԱȣ߶ں˿
+// 3֡¡30fpsʵʱıɵ޶Աȣ
+//    ɵУ֡ԭʼAnnex-Bֽһ
+// 4֡֡ݴ̬ʱֳݼʧ(δܿGOP)
+//
+// ÷unpack_bench [seconds] [h264|h265] [recording]
+///////////////////////////////////////////////////////////////////////////////////////////
+#include "rtp_unpack_h264.h"
+#include "rtp_unpack_h265.h"
+#include "rtp_sink.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace xt_media_client;
+
+//֡־
+void md_log(const media_client_log_level_t, const char *, ...) {}
+
+namespace
+{
+	const uint32_t MTU_PAYLOAD = 1400;
+	const uint32_t FPS = 30;
+	const uint32_t GOP_FRAMES = 30;
+	const uint32_t SLICES = 4;
+	const uint32_t RTP_HEAD = 12;
+	const uint32_t PRIV_HEAD = sizeof(rtp_priv_header_t);
+
+	struct packet_t
+	{
+		uint32_t offset;		//RTP¼ƻеƫ
+		uint32_t length;
+	};
+
+	struct recording_t
+	{
+		std::vector<uint8_t> data;
+		std::vector<packet_t> packets;
+		std::vector<uint32_t> gop_starts;	//ÿGOPװ
+		std::vector<uint32_t> gop_nals;		//ÿGOP׸NAL
+		std::vector<uint64_t> nal_hashes;	//ʱȡ¼ļΪ
+		uint32_t frames;
+		uint64_t payload_bytes;
+	};
+
+	uint64_t fnv1a(uint64_t h, const void *data, uint32_t len)
+	{
+		const uint8_t *p = static_cast<const uint8_t *>(data);
+		for (uint32_t i = 0; i < len; ++i)
+		{
+			h ^= p[i];
+			h *= 1099511628211ULL;
+		}
+		return h;
+	}
+
+	const uint64_t FNV_BASIS = 1469598103934665603ULL;
+
+	double now_ms()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+	}
+
+	void add_packet(recording_t &rec, const uint8_t *payload_head, uint32_t head_len,
+		const uint8_t *payload, uint32_t len, uint16_t seq, uint32_t ts, bool marker, uint8_t pt)
+	{
+		uint32_t total = RTP_HEAD + head_len + len;
+		uint32_t offset = (uint32_t)rec.data.size();
+		rec.data.resize(offset + 4 + total);
+		uint8_t *p = &rec.data[offset];
+		p[0] = (uint8_t)(total >> 24); p[1] = (uint8_t)(total >> 16); p[2] = (uint8_t)(total >> 8); p[3] = (uint8_t)total;
+		p += 4;
+		p[0] = 0x80;
+		p[1] = (uint8_t)((marker ? 0x80 : 0) | pt);
+		p[2] = (uint8_t)(seq >> 8); p[3] = (uint8_t)seq;
+		p[4] = (uint8_t)(ts >> 24); p[5] = (uint8_t)(ts >> 16); p[6] = (uint8_t)(ts >> 8); p[7] = (uint8_t)ts;
+		p[8] = 0x12; p[9] = 0x34; p[10] = 0x56; p[11] = 0x78;
+		if (head_len) memcpy(p + RTP_HEAD, payload_head, head_len);
+		memcpy(p + RTP_HEAD + head_len, payload, len);
+		packet_t pk = { offset + 4, total };
+		rec.packets.push_back(pk);
+	}
+
+	//NALRTPְMTUĵNALH264 FU-A(RFC 6184)/H265 FU(RFC 7798)
+	void packetize_nal(recording_t &rec, bool h265, const std::vector<uint8_t> &nal,
+		uint16_t &seq, uint32_t ts, bool last_nal)
+	{
+		uint32_t nal_head = h265 ? 2 : 1;
+		if (nal.size() <= MTU_PAYLOAD)
+		{
+			add_packet(rec, NULL, 0, &nal[0], (uint32_t)nal.size(), seq++, ts, last_nal, 96);
+			return;
+		}
+
+		uint8_t head[3];
+		uint32_t head_len;
+		uint8_t type;
+		if (h265)
+		{
+			type = (nal[0] >> 1) & 0x3F;
+			head[0] = (uint8_t)((nal[0] & 0x81) | (49 << 1));
+			head[1] = nal[1];
+			head_len = 3;
+		}
+		else
+		{
+			type = nal[0] & 0x1F;
+			head[0] = (uint8_t)((nal[0] & 0xE0) | 28);
+			head_len = 2;
+		}
+
+		uint32_t off = nal_head;
+		uint32_t chunk = MTU_PAYLOAD - head_len;
+		while (off < nal.size())
+		{
+			uint32_t n = (uint32_t)nal.size() - off;
+			if (n > chunk) n = chunk;
+			bool first = (off == nal_head);
+			bool last = (off + n == nal.size());
+			head[head_len - 1] = (uint8_t)((first ? 0x80 : 0) | (last ? 0x40 : 0) | type);
+			add_packet(rec, head, head_len, &nal[off], n, seq++, ts, last && last_nal, 96);
+			off += n;
+		}
+	}
+
+	void synthesize(recording_t &rec, bool h265, uint32_t seconds)
+	{
+		srand(7);
+		uint16_t seq = 0;
+		uint32_t ts = 0;
+		for (uint32_t f = 0; f < seconds * FPS; ++f)
+		{
+			bool key = (0 == f % GOP_FRAMES);
+			if (key)
+			{
+				rec.gop_starts.push_back((uint32_t)rec.packets.size());
+				rec.gop_nals.push_back((uint32_t)rec.nal_hashes.size());
+			}
+
+			std::vector<std::vector<uint8_t> > nals;
+			if (key)
+			{
+				const uint8_t h264_ps[2][4] = { {0x67, 0x64, 0x00, 0x33}, {0x68, 0xEE, 0x3C, 0x80} };
+				const uint8_t h265_ps[3][4] = { {0x40, 0x01, 0x0C, 0x01}, {0x42, 0x01, 0x01, 0x01}, {0x44, 0x01, 0xC1, 0x72} };
+				uint32_t count = h265 ? 3 : 2;
+				for (uint32_t k = 0; k < count; ++k)
+				{
+					const uint8_t *ps = h265 ? h265_ps[k] : h264_ps[k];
+					nals.push_back(std::vector<uint8_t>(ps, ps + 4));
+				}
+			}
+
+			uint32_t size = key ? 1000000 + rand() % 500000 : 40000 + rand() % 40000;
+			uint32_t slices = key ? 1 : SLICES;
+			for (uint32_t s = 0; s < slices; ++s)
+			{
+				std::vector<uint8_t> nal(size / slices);
+				for (size_t i = 0; i < nal.size(); ++i) nal[i] = (uint8_t)rand();
+				if (h265)
+				{
+					nal[0] = key ? (19 << 1) : (1 << 1);	//IDR_W_RADL / TRAIL_R
+					nal[1] = 0x01;
+				}
+				else
+				{
+					nal[0] = key ? 0x65 : 0x41;
+				}
+				nals.push_back(nal);
+			}
+
+			//֡NALΪ00 00 00 01NAL
+			const uint8_t sc[] = { 0, 0, 0, 1 };
+			for (size_t k = 0; k < nals.size(); ++k)
+			{
+				uint64_t h = fnv1a(FNV_BASIS, sc, 4);
+				rec.nal_hashes.push_back(fnv1a(h, &nals[k][0], (uint32_t)nals[k].size()));
+				packetize_nal(rec, h265, nals[k], seq, ts, k + 1 == nals.size());
+				rec.payload_bytes += nals[k].size();
+			}
+			ts += 90000 / FPS;
+		}
+		rec.frames = seconds * FPS;
+	}
+
+	bool save(const recording_t &rec, const char *path)
+	{
+		FILE *fp = fopen(path, "wb");
+		if (!fp) return false;
+		bool ok = (rec.data.size() == fwrite(&rec.data[0], 1, rec.data.size(), fp));
+		fclose(fp);
+		return ok;
+	}
+
+	//ȡ¼ļRTPͷͳ֡GOP
+	bool load(recording_t &rec, const char *path, bool h265)
+	{
+		FILE *fp = fopen(path, "rb");
+		if (!fp) return false;
+		fseek(fp, 0, SEEK_END);
+		long size = ftell(fp);
+		fseek(fp, 0, SEEK_SET);
+		rec.data.resize(size > 0 ? size : 0);
+		bool ok = (size > 0) && ((size_t)size == fread(&rec.data[0], 1, size, fp));
+		fclose(fp);
+		if (!ok) return false;
+
+		rec.frames = 0;
+		rec.payload_bytes = 0;
+		bool frame_start = true;
+		for (uint32_t off = 0; off + 4 <= rec.data.size(); )
+		{
+			const uint8_t *p = &rec.data[off];
+			uint32_t len = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+			if (len < RTP_HEAD + 2 || off + 4 + len > rec.data.size()) return false;
+			packet_t pk = { off + 4, len };
+			rec.packets.push_back(pk);
+
+			const uint8_t *rtp = p + 4;
+			uint32_t head = RTP_HEAD + (rtp[0] & 0x0F) * 4;
+			if (frame_start && head < len)
+			{
+				uint8_t type = h265 ? ((rtp[head] >> 1) & 0x3F) : (rtp[head] & 0x1F);
+				bool key = h265 ? (32 == type || (49 == type && head + 2 < len && ((rtp[head + 2] & 0x3F) >= 16 && (rtp[head + 2] & 0x3F) <= 21)))
+					: (7 == type || (28 == type && head + 1 < len && 5 == (rtp[head + 1] & 0x1F)));
+				if (key) rec.gop_starts.push_back((uint32_t)rec.packets.size() - 1);
+			}
+			frame_start = (0 != (rtp[1] & 0x80));
+			if (frame_start) ++rec.frames;
+			rec.payload_bytes += len - head;
+			off += 4 + len;
+		}
+		if (rec.gop_starts.empty() || 0 != rec.gop_starts[0]) rec.gop_starts.insert(rec.gop_starts.begin(), 0);
+		return !rec.packets.empty();
+	}
+
+	//֡ͳƣУNALȶֵʱֻ
+	class nal_counter : public frame_data_dump_callback_t
+	{
+	public:
+		explicit nal_counter(const std::vector<uint64_t> &expect)
+			: verify(true), fd(-1), next(0), checked(0), bytes(0), mismatched(0), m_expect(expect) {}
+
+		void on_frame_dump(void *data, uint32_t length, uint32_t, uint32_t, uint32_t, uint32_t)
+		{
+			if (verify && !m_expect.empty())
+			{
+				uint64_t h = (length >= PRIV_HEAD) ? fnv1a(FNV_BASIS, static_cast<uint8_t *>(data) + PRIV_HEAD, length - PRIV_HEAD) : 0;
+				if (next >= m_expect.size() || h != m_expect[next]) ++mismatched;
+				++checked;
+			}
+			if (fd >= 0)
+			{
+				frame_iovec_t iov = { data, length };
+				if (!frame_iov_write(fd, &iov, 1)) ++mismatched;
+			}
+			++next;
+			bytes += length;
+		}
+
+		bool verify;
+		int fd;				//>=0ʱ֡ת
+		size_t next;		//һNAL
+		uint64_t checked;
+		uint64_t bytes;
+		uint64_t mismatched;
+
+	private:
+		const std::vector<uint64_t> &m_expect;
+	};
+
+	//impl֡ʵ֣ڶȡ֡ݴ
+	//ɢ֡֡תfdУƬNALȶ
+	class iov_forwarder : public frame_scatter_dump_callback_t
+	{
+	public:
+		explicit iov_forwarder(const std::vector<uint64_t> &expect)
+			: verify(true), fd(-1), next(0), checked(0), bytes(0), slices(0), mismatched(0), m_expect(expect) {}
+
+		void on_frame_scatter_dump(const frame_iovec_t *iov, uint32_t iovcnt, uint32_t length, uint32_t, uint32_t, uint32_t, uint32_t)
+		{
+			if (verify && !m_expect.empty())
+			{
+				uint64_t h = FNV_BASIS;
+				uint32_t total = 0;
+				for (uint32_t i = 0; i < iovcnt; ++i)
+				{
+					if (i > 0) h = fnv1a(h, iov[i].data, iov[i].length);
+					total += iov[i].length;
+				}
+				if (iovcnt < 1 || iov[0].length != PRIV_HEAD || total != length
+					|| next >= m_expect.size() || h != m_expect[next]) ++mismatched;
+				++checked;
+			}
+			if (fd >= 0 && !frame_iov_write(fd, iov, iovcnt)) ++mismatched;
+			++next;
+			bytes += length;
+			slices += iovcnt;
+		}
+
+		bool verify;
+		int fd;
+		size_t next;
+		uint64_t checked;
+		uint64_t bytes;
+		uint64_t slices;
+		uint64_t mismatched;
+
+	private:
+		const std::vector<uint64_t> &m_expect;
+	};
+
+	//תļ˽ͷзNALȶԣزһµ֡
+	uint64_t check_forwarded(int fd, const std::vector<uint64_t> &expect, uint64_t frames)
+	{
+		off_t size = lseek(fd, 0, SEEK_END);
+		std::vector<uint8_t> data(size > 0 ? size : 0);
+		if (data.empty() || (ssize_t)data.size() != pread(fd, &data[0], data.size(), 0)) return frames ? frames : 1;
+
+		uint64_t bad = 0;
+		size_t n = 0;
+		for (size_t off = 0; off + PRIV_HEAD <= data.size(); ++n)
+		{
+			//֡⣬˽ͷһ
+			rtp_priv_header_t head;
+			memcpy(&head, &data[off], sizeof(head));
+			if (CHUNK_HEADER_FOURCC != head.uFourCC || off + PRIV_HEAD + head.uDataSize > data.size()) return bad + 1;
+			if (n >= expect.size() || fnv1a(FNV_BASIS, &data[off + PRIV_HEAD], head.uDataSize) != expect[n]) ++bad;
+			off += PRIV_HEAD + head.uDataSize;
+		}
+		return bad + ((n == frames) ? 0 : 1);
+	}
+
+	rtp_unpack_ptr create_unpacker(bool h265, rtp_unpack_priv_impl *&impl)
+	{
+		if (h265)
+		{
+			rtp_unpack_h265_impl *p = new rtp_unpack_h265_impl();
+			impl = p;
+			return rtp_unpack_ptr(p);
+		}
+		rtp_unpack_h264_impl *p = new rtp_unpack_h264_impl();
+		impl = p;
+		return rtp_unpack_ptr(p);
+	}
+
+	//·طţа(ͬ⸴߳)󽻸֡˻ظõĽջ壬
+	//ػطŵ֡(marker)
+	uint32_t replay(const rtp_unpack_ptr &unpacker, const recording_t &rec, uint32_t from, uint32_t to,
+		uint16_t seq_base, std::vector<uint8_t> &rx)
+	{
+		uint32_t frames = 0;
+		for (uint32_t i = from; i < to; ++i)
+		{
+			const packet_t &pk = rec.packets[i];
+			rtp_pkt_t *pkt = (pk.length <= rtp_pkt_t::size()) ? rtp_pkt_t::alloc() : NULL;
+			uint8_t *buf = pkt ? pkt->data() : &rx[0];
+			memcpy(buf, &rec.data[pk.offset], pk.length);
+
+			const uint8_t *rtp = buf;
+			rv_rtp_param params;
+			memset(&params, 0, sizeof(params));
+			params.marker = (0 != (rtp[1] & 0x80));
+			params.payload = rtp[1] & 0x7F;
+			params.sequenceNumber = (uint16_t)((((uint32_t)rtp[2] << 8) | rtp[3]) + seq_base);
+			params.timestamp = ((uint32_t)rtp[4] << 24) | ((uint32_t)rtp[5] << 16) | ((uint32_t)rtp[6] << 8) | rtp[7];
+			params.sSrc = ((uint32_t)rtp[8] << 24) | ((uint32_t)rtp[9] << 16) | ((uint32_t)rtp[10] << 8) | rtp[11];
+			params.sByte = RTP_HEAD + (rtp[0] & 0x0F) * 4;
+			params.len = pk.length;
+
+			if (pkt)
+			{
+				unpacker->pump_rtp_packet(pkt, buf + params.sByte, pk.length - params.sByte, params);
+				pkt->release();
+			}
+			else
+			{
+				unpacker->pump_rtp_raw_data(buf + params.sByte, pk.length - params.sByte, params);
+			}
+			if (params.marker) ++frames;
+		}
+		return frames;
+	}
+
+	//ضתļһִͷд
+	void truncate_forward(int fd)
+	{
+		if (fd >= 0 && 0 == ftruncate(fd, 0)) lseek(fd, 0, SEEK_SET);
+	}
+
+	void report(const char *name, uint64_t frames, uint64_t bytes, double ms, uint64_t grows)
+	{
+		double fps = frames * 1000.0 / ms;
+		printf("%-8s %8llu frames %9.1f fps %8.1f MB/s  x%.1f realtime  %.1f us/frame  %llu grows\n",
+			name, (unsigned long long)frames, fps, bytes / 1048576.0 * 1000.0 / ms, fps / FPS, ms * 1000.0 / frames,
+			(unsigned long long)grows);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int seconds = (argc > 1) ? atoi(argv[1]) : 5;
+	bool h265 = (argc > 2) && (0 == strcmp(argv[2], "h265"));
+	const char *path = (argc > 3) ? argv[3] : NULL;
+
+	recording_t rec;
+	rec.frames = 0;
+	rec.payload_bytes = 0;
+	if (path && load(rec, path, h265))
+	{
+		printf("recording %s: %u packets, %u frames, %u GOPs\n", path,
+			(uint32_t)rec.packets.size(), rec.frames, (uint32_t)rec.gop_starts.size());
+	}
+	else
+	{
+		rec = recording_t();
+		synthesize(rec, h265, 4);
+		if (path && save(rec, path)) printf("recorded %s\n", path);
+		printf("4K/30fps %s: %u packets, %u frames, %.1f MB per pass\n", h265 ? "H265" : "H264",
+			(uint32_t)rec.packets.size(), rec.frames, rec.payload_bytes / 1048576.0);
+	}
+
+	std::vector<uint8_t> rx(64 * 1024);
+	uint64_t errors = 0;
+
+	//ޣֻѸɿԤ֡壬ÿ֡ͷд
+	{
+		std::vector<uint8_t> frame(RTP_VIDEO_FRAME_MAX_SIZE);
+		uint64_t bytes = 0;
+		uint64_t passes = 0;
+		double begin = now_ms();
+		do
+		{
+			uint32_t pos = 0;
+			for (size_t i = 0; i < rec.packets.size(); ++i)
+			{
+				const packet_t &pk = rec.packets[i];
+				memcpy(&rx[0], &rec.data[pk.offset], pk.length);
+				uint32_t n = pk.length - RTP_HEAD;
+				if (pos + n > frame.size()) pos = 0;
+				memcpy(&frame[pos], &rx[RTP_HEAD], n);
+				pos = (rx[1] & 0x80) ? 0 : pos + n;
+				bytes += n;
+			}
+			++passes;
+		} while (now_ms() - begin < seconds * 1000.0);
+		report("memcpy", passes * rec.frames, bytes, now_ms() - begin, 0);
+	}
+
+	//̬һ·֡ſѧϰ֮֡ļʱֲӦ֡ݣ֡writeת
+	{
+		nal_counter counter(rec.nal_hashes);
+		rtp_unpack_priv_impl *impl = NULL;
+		rtp_unpack_ptr unpacker = create_unpacker(h265, impl);
+		unpacker->register_frame_dump_callback(&counter);
+		FILE *tmp = tmpfile();
+		uint64_t frames = 0;
+		uint64_t bytes = 0;
+		uint32_t grows = 0;
+		uint16_t seq_base = 0;
+		double begin = now_ms();
+		for (uint32_t pass = 0; pass < 2 || now_ms() - begin < seconds * 1000.0; ++pass)
+		{
+			if (1 == pass)
+			{
+				counter.verify = false;
+				counter.fd = tmp ? fileno(tmp) : -1;
+				bytes = counter.bytes;
+				grows = impl->frame_grows();
+				begin = now_ms();
+			}
+			counter.next = 0;
+			truncate_forward(counter.fd);
+			frames += replay(unpacker, rec, 0, (uint32_t)rec.packets.size(), seq_base, rx);
+			seq_base = (uint16_t)(seq_base + rec.packets.size());
+			if (0 == pass) frames = 0;
+		}
+		double ms = now_ms() - begin;
+		grows = impl->frame_grows() - grows;
+		unpacker.reset();
+		report("steady", frames, counter.bytes - bytes, ms, grows);
+		errors += counter.mismatched + grows;
+		if (grows) printf("  frame buffer grew %u times after the first pass\n", grows);
+		if (counter.mismatched) printf("  %llu of %llu NALs differ from the source or failed to forward\n",
+			(unsigned long long)counter.mismatched, (unsigned long long)counter.checked);
+		if (tmp) fclose(tmp);
+	}
+
+	//ÿGOP½֡֡ظã֡δѧϰ֡׸I֡
+	{
+		nal_counter counter(rec.nal_hashes);
+		std::vector<uint32_t> bounds(rec.gop_starts);
+		bounds.push_back((uint32_t)rec.packets.size());
+		uint64_t frames = 0;
+		uint64_t bytes = 0;
+		uint64_t grows = 0;
+		double begin = now_ms();
+		for (uint32_t pass = 0; pass < 2 || now_ms() - begin < seconds * 1000.0; ++pass)
+		{
+			if (1 == pass)
+			{
+				counter.verify = false;
+				bytes = counter.bytes;
+				frames = 0;
+				grows = 0;
+				begin = now_ms();
+			}
+			for (size_t g = 0; g + 1 < bounds.size(); ++g)
+			{
+				if (!rec.gop_nals.empty()) counter.next = rec.gop_nals[g];
+				rtp_unpack_priv_impl *impl = NULL;
+				rtp_unpack_ptr unpacker = create_unpacker(h265, impl);
+				unpacker->register_frame_dump_callback(&counter);
+				frames += replay(unpacker, rec, bounds[g], bounds[g + 1], 0, rx);
+				grows += impl->frame_grows();
+			}
+		}
+		report("reopen", frames, counter.bytes - bytes, now_ms() - begin, grows);
+		errors += counter.mismatched;
+		if (counter.mismatched) printf("  %llu of %llu NALs differ from the source\n",
+			(unsigned long long)counter.mismatched, (unsigned long long)counter.checked);
+	}
+
+	//ɢ֡аã֡writevתУдʱļرȶ
+	{
+		iov_forwarder forwarder(rec.nal_hashes);
+		rtp_unpack_priv_impl *impl = NULL;
+		rtp_unpack_ptr unpacker = create_unpacker(h265, impl);
+		unpacker->register_frame_scatter_callback(&forwarder);
+		FILE *tmp = tmpfile();
+		forwarder.fd = tmp ? fileno(tmp) : -1;
+		uint64_t frames = 0;
+		uint64_t bytes = 0;
+		uint64_t slices = 0;
+		uint16_t seq_base = 0;
+		double begin = now_ms();
+		for (uint32_t pass = 0; pass < 2 || now_ms() - begin < seconds * 1000.0; ++pass)
+		{
+			if (1 == pass)
+			{
+				if (!rec.nal_hashes.empty() && forwarder.fd >= 0)
+				{
+					uint64_t bad = check_forwarded(forwarder.fd, rec.nal_hashes, forwarder.next);
+					if (bad) printf("  %llu forwarded frames differ from the source\n", (unsigned long long)bad);
+					errors += bad;
+				}
+				forwarder.verify = false;
+				bytes = forwarder.bytes;
+				slices = forwarder.slices;
+				begin = now_ms();
+			}
+			forwarder.next = 0;
+			truncate_forward(forwarder.fd);
+			frames += replay(unpacker, rec, 0, (uint32_t)rec.packets.size(), seq_base, rx);
+			seq_base = (uint16_t)(seq_base + rec.packets.size());
+			if (0 == pass) frames = 0;
+		}
+		double ms = now_ms() - begin;
+		uint32_t grows = impl->frame_grows();
+		unpacker.reset();
+		report("scatter", frames, forwarder.bytes - bytes, ms, grows);
+		printf("  %.1f slices/frame written with writev\n", (double)(forwarder.slices - slices) / (frames ? frames : 1));
+		errors += forwarder.mismatched;
+		if (forwarder.mismatched) printf("  %llu of %llu NALs differ from the source or failed to forward\n",
+			(unsigned long long)forwarder.mismatched, (unsigned long long)forwarder.checked);
+		if (tmp) fclose(tmp);
+	}
+
+	printf("%s\n", (0 == errors) ? "PASS" : "FAIL");
+	return (0 == errors) ? 0 : 1;
+}
@@ -318,6 +318,41 @@ extern "C"
         return impl->play(cb, ctx);
     }
 
+    xt_media_client_status_t xt_media_client_play_iov(xt_media_link_handle_t handle, xt_media_client_frame_iov_callback_t cb, void *ctx)
+    {
+        media_link_t *impl = media_link_factory::query_link(handle);
+        if (NULL == impl)
+        {
+            return MEDIA_CLIENT_STATUS_LINK_NOT_EXISTS;
+        }
+
+        return impl->play_iov(cb, ctx);
+    }
+
+    //תصctxΪfd
+    static void XT_MEDIA_CLIENT_STDCALL s_forward_frame(void *ctx, xt_media_link_handle_t link, const xt_media_client_iovec_t *iov, uint32_t iovcnt, uint32_t length, uint32_t frame_type, uint32_t data_type, uint32_t timestamp, uint32_t ssrc)
+    {
+        int fd = (int)(intptr_t)ctx;
+        if (!frame_iov_write(fd, iov, iovcnt))
+        {
+            md_log(md_log_error, "xt_media_client_forward:write fail,fd[%d] length[%u] timestamp[%u]", fd, length, timestamp);
+        }
+    }
+
+    xt_media_client_status_t xt_media_client_forward(xt_media_link_handle_t handle, int fd)
+    {
+#ifdef _WIN32
+        return MEDIA_CLIENT_STATUS_NOT_SUPPORTED;
+#else
+        if (fd < 0)
+        {
+            return MEDIA_CLIENT_STATUS_BADPARAM;
+        }
+
+        return xt_media_client_play_iov(handle, &s_forward_frame, (void *)(intptr_t)fd);
+#endif
+    }
+
     xt_media_client_status_t xt_media_client_pause(xt_media_link_handle_t handle)
     {
         media_link_t *impl = media_link_factory::query_link(handle);
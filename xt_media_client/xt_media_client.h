@@ -27,6 +27,24 @@ extern "C"
 
     XT_MEDIA_CLIENT_API xt_media_client_status_t xt_media_client_get_header(xt_media_link_handle_t handle, uint8_t *data, uint32_t *length);
     XT_MEDIA_CLIENT_API xt_media_client_status_t xt_media_client_play(xt_media_link_handle_t handle, xt_media_client_frame_callback_t cb, void *ctx);
+
+	/*************************************
+	ܣɢ֡㲥⸴·H264/H265/AAC֡ƴӸɣֱýյRTP
+	          ·ԵƬ֡
+	˵
+			handle豸Ӿ
+			cb      ɢ֡صÿռע
+			ctx     û
+	ֵxt_media_client_status_t */
+    XT_MEDIA_CLIENT_API xt_media_client_status_t xt_media_client_play_iov(xt_media_link_handle_t handle, xt_media_client_frame_iov_callback_t cb, void *ctx);
+
+	/*************************************
+	ܣ㲥ÿ֡(˽ͷ+)writevֱдfdƴ֡
+	˵
+			handle豸Ӿ
+			fd      socketܵļ÷ر
+	ֵxt_media_client_status_twindows²֧ */
+    XT_MEDIA_CLIENT_API xt_media_client_status_t xt_media_client_forward(xt_media_link_handle_t handle, int fd);
     XT_MEDIA_CLIENT_API xt_media_client_status_t xt_media_client_pause(xt_media_link_handle_t handle);
     XT_MEDIA_CLIENT_API xt_media_client_status_t xt_media_client_seek(xt_media_link_handle_t handle, double npt, float scale, uint32_t *seq, uint32_t *timestamp);
 
@@ -665,6 +665,16 @@ extern "C"
 
     typedef void (XT_MEDIA_CLIENT_STDCALL *xt_media_client_frame_callback_t)(void *ctx, xt_media_link_handle_t link, void *data, uint32_t length, uint32_t frame_type, uint32_t data_type, uint32_t timestamp, uint32_t ssrc);
 
+    //ɢ֡Ƭ
+    typedef struct _xt_media_client_iovec_t
+    {
+        const void *data;
+        uint32_t length;
+    } xt_media_client_iovec_t;
+
+    //ɢ֡صiov[0]Ϊ˽ͷƬֱýյRTPڻصڼЧlengthΪƬܳ
+    typedef void (XT_MEDIA_CLIENT_STDCALL *xt_media_client_frame_iov_callback_t)(void *ctx, xt_media_link_handle_t link, const xt_media_client_iovec_t *iov, uint32_t iovcnt, uint32_t length, uint32_t frame_type, uint32_t data_type, uint32_t timestamp, uint32_t ssrc);
+
     typedef long (XT_MEDIA_CLIENT_STDCALL *regist_call_back_t)(const char *ip, uint16_t port, const uint8_t *data, uint32_t length);
 
     typedef struct _xt_sink_info_t
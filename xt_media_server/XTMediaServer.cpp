@@ -1529,6 +1529,20 @@ int xt_get_connect_info(connect_info_t out_cinfo[],uint32_t& connect_num)
     return CRunInfoMgr::instance()->get_connect_info(out_cinfo,connect_num);
 }
 
+int xt_get_demux_stats(demux_stats_t& stats)
+{
+    xt_demux_stats mp_stats;
+    ::mp_query_demux_stats(&mp_stats);
+
+    stats.sessions = mp_stats.sessions;
+    stats.buckets = mp_stats.buckets;
+    stats.max_probe = mp_stats.max_probe;
+    stats.lookups = mp_stats.lookups;
+    stats.collisions = mp_stats.collisions;
+    stats.open_fails = mp_stats.open_fails;
+    return 0;
+}
+
 int xt_regist(const char* sz_ids, const char* sz_server_ip, unsigned short server_port,uint32_t millisec)
 {
 #ifndef CLOSE_SESSION
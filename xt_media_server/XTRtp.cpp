@@ -142,22 +142,29 @@ rv_bool XTRtp::rtcp_rawdata_cb(
     if (FMT == 4 && 
         PT == 206)//FIR
     {
+        bool found = false;
         unsigned int chanid = 0;
         do 
         {
-            std::map<unsigned int, Rtp_Handle>::iterator itr	= instance()->m_rtpHandles.begin();
-            for (;itr != instance()->m_rtpHandles.end();++itr)
+            XTRtpTable::reader rd(instance()->m_rtpHandles);
+            for (unsigned int i = 0; i < rd.size(); ++i)
             {
-                Rtp_Handle &r = itr->second;
-                if (r.hmsink.hmsink == sink)
+                Rtp_Slot *slot = rd.get(i);
+                if (slot && slot->rtp.hmsink.hmsink == sink)
                 {
-                    chanid = itr->first;
-                    xt_fir_cb(chanid);
+                    chanid = i;
+                    found = true;
                     break;
                 }
             }
 
         } while (false);
+
+        //˳ٽٻصصпܽXTRtpļӿ
+        if (found)
+        {
+            xt_fir_cb(chanid);
+        }
     }
 
     return true;
@@ -207,6 +214,13 @@ int XTRtp::init(unsigned int num_chan,
                 bool use_traffic_shapping)
 {
     boost::unique_lock<boost::shared_mutex> lock(m_mutex); 
+
+    //ظinituninitѴ򿪵ķ͵Ԫ޷
+    if (!m_rtpHandles.create(num_chan))
+    {
+        std::cout << "XTRtp::init fail:already initialized" << std::endl;
+        return -1;
+    }
     m_sink_single = sink_single;
 
     //õϵͳCPU
@@ -221,6 +235,8 @@ int XTRtp::init(unsigned int num_chan,
     if (!ret)
     {
         std::cout << "init_mp_caster fail" << std::endl;
+        std::vector<Rtp_Slot*> slots;
+        m_rtpHandles.retire_all(slots);
         return -1;
     }
 
@@ -298,7 +314,8 @@ int XTRtp::init(unsigned int num_chan,
         bcmp_descriptor.msink_multicast_rtcp_ttl = 0;
         bcmp_descriptor.multiplex = multiplex;
 
-        Rtp_Handle rtp;	
+        Rtp_Slot *slot = new Rtp_Slot;
+        Rtp_Handle &rtp = slot->rtp;
         rtp.multiplex = multiplex;
         rtp.port = address.port;
         rtp.payload = 96;
@@ -308,6 +325,7 @@ int XTRtp::init(unsigned int num_chan,
         if(!ret)	
         {
             std::cout << "open_bc_mp fail:num="  << i << std::endl;
+            delete slot;
             return i;
         }
 
@@ -321,7 +339,7 @@ int XTRtp::init(unsigned int num_chan,
         xtm_set_snd_port(i, address.port, multiplex, rtp.multid);
 #endif
 
-        m_rtpHandles[i] = rtp;
+        m_rtpHandles.publish(i, slot);
     }
 
     return num_chan;
@@ -332,15 +350,15 @@ int XTRtp::uninit()
     bool ret = false;
     boost::unique_lock<boost::shared_mutex> lock(m_mutex); 
 
-    std::map<unsigned int, Rtp_Handle>::iterator itr = m_rtpHandles.begin();
-    for (;itr != m_rtpHandles.end(); ++itr)
+    //ºȴ;˳ٹرշ͵Ԫ
+    std::vector<Rtp_Slot*> slots;
+    m_rtpHandles.retire_all(slots);
+    for (std::vector<Rtp_Slot*>::iterator itr = slots.begin();itr != slots.end(); ++itr)
     {
-        Rtp_Handle &rtp = itr->second;
-        ret = close_mp(&rtp.hmp);
+        ret = close_mp(&(*itr)->rtp.hmp);
+        delete *itr;
     }
 
-    m_rtpHandles.clear();
-
     end_mp_caster();
 
     return ((ret==true) ? (int)0 : (int)-1);
@@ -350,22 +368,21 @@ void XTRtp::set_payload(unsigned long chanid, int payload, bool update)
 {
     boost::unique_lock<boost::shared_mutex> lock(m_mutex);
 
-    std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(chanid);
-    if(it == m_rtpHandles.end())
+    XTRtpTable::reader rd(m_rtpHandles);
+    Rtp_Slot *slot = rd.get(chanid);
+    if (!slot)
     {
         return;
     }
 
-    Rtp_Handle &rtp = it->second;
-
     if (update)
     {
-        rtp.payload = payload;
+        slot->payload.store(payload, boost::memory_order_relaxed);
     }
     else
     {
-        rtp.payload_old = payload;
-        rtp.payload = payload;
+        slot->payload_old.store(payload, boost::memory_order_relaxed);
+        slot->payload.store(payload, boost::memory_order_relaxed);
     }
 }
 
@@ -375,10 +392,12 @@ int XTRtp::update_resend_flag(const int flag)
     do 
     {
         mp_h_s hmp={0};
-        std::map<unsigned int, Rtp_Handle>::iterator itr = m_rtpHandles.begin();
-        for(; m_rtpHandles.end() != itr; ++itr)
+        XTRtpTable::reader rd(m_rtpHandles);
+        for (unsigned int i = 0; i < rd.size(); ++i)
         {
-            hmp.hmp = itr->second.hmp.hmp;
+            Rtp_Slot *slot = rd.get(i);
+            if (!slot) continue;
+            hmp.hmp = slot->rtp.hmp.hmp;
             ::update_resend_flag(&hmp,flag);
         }
 
@@ -396,10 +415,12 @@ void XTRtp::set_file_patha(const char * file)
     do 
     {
         mp_h_s hmp={0};
-        std::map<unsigned int, Rtp_Handle>::iterator itr = m_rtpHandles.begin();
-        for(int i=0; m_rtpHandles.end() != itr; ++i,++itr)
+        XTRtpTable::reader rd(m_rtpHandles);
+        for (unsigned int i = 0; i < rd.size(); ++i)
         {
-            hmp.hmp = itr->second.hmp.hmp;
+            Rtp_Slot *slot = rd.get(i);
+            if (!slot) continue;
+            hmp.hmp = slot->rtp.hmp.hmp;
 
             char file_path[MAX_PATH] = "";
             ::sprintf(file_path,"%s_%d", file, i);
@@ -413,25 +434,27 @@ void XTRtp::reset_payload(unsigned long chanid)
 {
     boost::unique_lock<boost::shared_mutex> lock(m_mutex);
 
-    std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(chanid);
-    if(it == m_rtpHandles.end())
+    XTRtpTable::reader rd(m_rtpHandles);
+    Rtp_Slot *slot = rd.get(chanid);
+    if (!slot)
     {
         return;
     }
-    it->second.payload = it->second.payload_old;	
+    slot->payload.store(slot->payload_old.load(boost::memory_order_relaxed), boost::memory_order_relaxed);
 }
 
 int XTRtp::get_payload(unsigned long chanid)
 {
 	boost::unique_lock<boost::shared_mutex> lock(m_mutex);
 
-	std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(chanid);
-	if(it == m_rtpHandles.end())
+	XTRtpTable::reader rd(m_rtpHandles);
+	Rtp_Slot *slot = rd.get(chanid);
+	if (!slot)
 	{
 		return 96;
 	}
 	
-	return it->second.payload;
+	return slot->payload.load(boost::memory_order_relaxed);
 }
 
 int XTRtp::add_send(long chanid,
@@ -448,14 +471,15 @@ int XTRtp::add_send(long chanid,
     MEDIA_SVR_PRINT(level_info, "add_send:chanid[%d] ip[%s] port[%d] linkid[%d] mode[%d] ssrc[%d] demux[%d] demuxid[%d]",
         chanid,ip.c_str(),port,linkid,mode,ssrc,multiplex,multid);
 
-    std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(chanid);
-    if(it == m_rtpHandles.end())
+    XTRtpTable::reader rd(m_rtpHandles);
+    Rtp_Slot *slot = rd.get(chanid);
+    if (!slot)
     {
-        MEDIA_SVR_PRINT(level_info, "add_send fail:chanid[%d] rtp_num[%d]",chanid,m_rtpHandles.size());
+        MEDIA_SVR_PRINT(level_info, "add_send fail:chanid[%d] rtp_num[%d]",chanid,rd.size());
         return -1;
     }
 
-    Rtp_Handle &rtp = it->second;
+    Rtp_Handle &rtp = slot->rtp;
 
     rtp_sink_descriptor sink_desc;	
     sink_desc.rtcp_opt = MP_TRUE;
@@ -527,15 +551,16 @@ int XTRtp::_del_send(unsigned long chanid,
     MEDIA_SVR_PRINT(level_info, "del send:chanid[%d] ip[%s] port[%d] mode[%d] demux[%d] demuxid[%d]",
         chanid,ip.c_str(),port,mode,multiplex,multid);
 
-    std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(chanid);
-    if(it == m_rtpHandles.end())
+    XTRtpTable::reader rd(m_rtpHandles);
+    Rtp_Slot *slot = rd.get(chanid);
+    if (!slot)
     {
         MEDIA_SVR_PRINT(level_info, "del send fail(not find):chanid[%d] ip[%s] port[%d] mode[%d] demux[%d] demuxid[%d]",
             chanid,ip.c_str(),port,mode,multiplex,multid);
         return -1;
     }
 
-    Rtp_Handle &rtp = it->second;
+    Rtp_Handle &rtp = slot->rtp;
 
     Rtp_Sink sink;
     sink.chanid = chanid;
@@ -762,14 +787,14 @@ int XTRtp::get_sink(unsigned long chanid, Rtp_Sink &sink)
 
 int XTRtp::get_rtp(void *hmp, unsigned long &chanid, Rtp_Handle &rtp)
 {
-    std::map<unsigned int, Rtp_Handle>::iterator itr	= m_rtpHandles.begin();
-    for (;itr != m_rtpHandles.end();++itr)
+    XTRtpTable::reader rd(m_rtpHandles);
+    for (unsigned int i = 0; i < rd.size(); ++i)
     {
-        Rtp_Handle &r = itr->second;
-        if (r.hmp.hmp == hmp)
+        Rtp_Slot *slot = rd.get(i);
+        if (slot && slot->rtp.hmp.hmp == hmp)
         {
-            chanid = itr->first;
-            rtp = r;
+            chanid = i;
+            rtp = slot->handle();
             return 0;
         }
     }
@@ -783,9 +808,9 @@ int XTRtp::send_data(const xt_track_t& track, char *buff, unsigned long len, lon
     int ret_code = -1;
     do
     {
-        boost::shared_lock<boost::shared_mutex> lock(m_mutex);
-        std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(track.chanid);
-        if(m_rtpHandles.end() == it) break;
+        XTRtpTable::reader rd(m_rtpHandles);
+        Rtp_Slot *slot = rd.get(track.chanid);
+        if (!slot) break;
         XTFrameInfo FrameInfo;
         FrameInfo.verify = 0xA1A2A3A4;        //Уλ
         FrameInfo.frametype = track.frametype;
@@ -795,11 +820,11 @@ int XTRtp::send_data(const xt_track_t& track, char *buff, unsigned long len, lon
         mp_bool pump_ret = MP_FALSE;
         if (is_std)
         {
-            pump_ret = ::pump_frame_in(&it->second.hmp, &it->second.hmssrc, (uint8_t*)buff, len, MP_FALSE, 0, it->second.payload, FrameInfo,0,true,0,0);
+            pump_ret = ::pump_frame_in(&slot->rtp.hmp, &slot->rtp.hmssrc, (uint8_t*)buff, len, MP_FALSE, 0, slot->payload.load(boost::memory_order_relaxed), FrameInfo,0,true,0,0);
         }
         else
         {
-            pump_ret = ::pump_frame_in(&it->second.hmp, &it->second.hmssrc, (uint8_t*)buff, len, MP_FALSE, 0, it->second.payload,FrameInfo,0,false,0,0);
+            pump_ret = ::pump_frame_in(&slot->rtp.hmp, &slot->rtp.hmssrc, (uint8_t*)buff, len, MP_FALSE, 0, slot->payload.load(boost::memory_order_relaxed),FrameInfo,0,false,0,0);
         }
 
         if (MP_FALSE == pump_ret)
@@ -814,14 +839,14 @@ int XTRtp::send_data(const xt_track_t& track, char *buff, unsigned long len, lon
 
 int XTRtp::send_data(unsigned long chanid, char *buff, unsigned long len, int frame_type, long device_type, bool is_std)
 {
-    boost::shared_lock<boost::shared_mutex> lock(m_mutex);
-    std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(chanid);
-    if(it == m_rtpHandles.end())
+    XTRtpTable::reader rd(m_rtpHandles);
+    Rtp_Slot *slot = rd.get(chanid);
+    if (!slot)
     {
         return -1;
     }
 
-    Rtp_Handle &rtp = it->second;
+    Rtp_Handle &rtp = slot->rtp;
 
     XTFrameInfo FrameInfo;	
     FrameInfo.verify = 0xA1A2A3A4;		//Уλ
@@ -837,7 +862,7 @@ int XTRtp::send_data(unsigned long chanid, char *buff, unsigned long len, int fr
             len, 
             MP_FALSE, 
             0, 
-            rtp.payload,
+            slot->payload.load(boost::memory_order_relaxed),
             FrameInfo,0,true,0,0);
     }
     else
@@ -848,7 +873,7 @@ int XTRtp::send_data(unsigned long chanid, char *buff, unsigned long len, int fr
             len, 
             MP_FALSE, 
             0, 
-            rtp.payload,
+            slot->payload.load(boost::memory_order_relaxed),
             FrameInfo,0,false,0,0);
     }
 
@@ -870,9 +895,9 @@ int XTRtp::send_data_in_stamp(const xt_track_t& track,           // ת
     int ret_code = -1;
     do 
     {
-        boost::shared_lock<boost::shared_mutex> lock(m_mutex);
-        std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(track.chanid);
-        if(m_rtpHandles.end() == it) break;
+        XTRtpTable::reader rd(m_rtpHandles);
+        Rtp_Slot *slot = rd.get(track.chanid);
+        if (!slot) break;
 
         XTFrameInfo FrameInfo;
         FrameInfo.verify = 0xA1A2A3A4;        // Уλ
@@ -884,11 +909,11 @@ int XTRtp::send_data_in_stamp(const xt_track_t& track,           // ת
         mp_bool pump_ret = MP_FALSE;
         if (is_std)
         {
-            pump_ret = ::pump_frame_in(&it->second.hmp, &it->second.hmssrc, (uint8_t*)buff, len, frameTS_opt, in_time_stamp, it->second.payload, FrameInfo,priority,true,use_ssrc,ssrc);
+            pump_ret = ::pump_frame_in(&slot->rtp.hmp, &slot->rtp.hmssrc, (uint8_t*)buff, len, frameTS_opt, in_time_stamp, slot->payload.load(boost::memory_order_relaxed), FrameInfo,priority,true,use_ssrc,ssrc);
         }
         else
         {
-            pump_ret = ::pump_frame_in(&it->second.hmp, &it->second.hmssrc, (uint8_t*)buff, len, frameTS_opt, in_time_stamp, it->second.payload, FrameInfo,priority,false,use_ssrc,ssrc);
+            pump_ret = ::pump_frame_in(&slot->rtp.hmp, &slot->rtp.hmssrc, (uint8_t*)buff, len, frameTS_opt, in_time_stamp, slot->payload.load(boost::memory_order_relaxed), FrameInfo,priority,false,use_ssrc,ssrc);
         }
 
         if (MP_FALSE == pump_ret)
@@ -916,9 +941,9 @@ int XTRtp::send_rtp_in_stamp(const xt_track_t& track,           // ת
 	int ret_code = -1;
 	do 
 	{
-		boost::shared_lock<boost::shared_mutex> lock(m_mutex);
-		std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(track.chanid);
-		if(m_rtpHandles.end() == it) break;
+		XTRtpTable::reader rd(m_rtpHandles);
+		Rtp_Slot *slot = rd.get(track.chanid);
+		if (!slot) break;
 
 		XTFrameInfo FrameInfo;
 		FrameInfo.verify = 0xA1A2A3A4;        // Уλ
@@ -930,11 +955,11 @@ int XTRtp::send_rtp_in_stamp(const xt_track_t& track,           // ת
 		mp_bool pump_ret = MP_FALSE;
 		if (is_std)//buffʵΪblockָ
 		{
-			pump_ret = ::pump_rtp_in2(&it->second.hmp, &it->second.hmssrc, buff);
+			pump_ret = ::pump_rtp_in2(&slot->rtp.hmp, &slot->rtp.hmssrc, buff);
 		}
 		else
 		{
-			pump_ret = ::pump_rtp_in2(&it->second.hmp, &it->second.hmssrc, buff);
+			pump_ret = ::pump_rtp_in2(&slot->rtp.hmp, &slot->rtp.hmssrc, buff);
 		}
 
 		if (MP_FALSE == pump_ret)
@@ -958,15 +983,14 @@ int XTRtp::send_data_in_stamp(unsigned long chanid,              // ͨ
                               uint8_t priority,                  // ȼ
                               bool is_std /*= false*/)           // ׼rtp
 {
-    boost::shared_lock<boost::shared_mutex> lock(m_mutex); 
-
-    std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(chanid);
-    if(it == m_rtpHandles.end())
+    XTRtpTable::reader rd(m_rtpHandles);
+    Rtp_Slot *slot = rd.get(chanid);
+    if (!slot)
     {
         return -1;
     }
 
-    Rtp_Handle &rtp = it->second;
+    Rtp_Handle &rtp = slot->rtp;
 
     XTFrameInfo FrameInfo;	
     FrameInfo.verify = 0xA1A2A3A4;		//Уλ
@@ -988,7 +1012,7 @@ int XTRtp::send_data_in_stamp(unsigned long chanid,              // ͨ
             len, 
             frameTS_opt, 
             in_time_stamp, 
-            rtp.payload,
+            slot->payload.load(boost::memory_order_relaxed),
             FrameInfo,priority,true,0,0);
     }
     else
@@ -999,7 +1023,7 @@ int XTRtp::send_data_in_stamp(unsigned long chanid,              // ͨ
             len, 
             frameTS_opt, 
             in_time_stamp, 
-            rtp.payload,
+            slot->payload.load(boost::memory_order_relaxed),
             FrameInfo,priority,false,0,0);
     }
 
@@ -1022,9 +1046,9 @@ int XTRtp::send_data_in_stamp_ps(const xt_track_t& track,           // ת
     int ret_code = -1;
     do 
     {
-        boost::shared_lock<boost::shared_mutex> lock(m_mutex);
-        std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(track.chanid);
-        if(m_rtpHandles.end() == it) break;
+        XTRtpTable::reader rd(m_rtpHandles);
+        Rtp_Slot *slot = rd.get(track.chanid);
+        if (!slot) break;
 
         XTFrameInfo FrameInfo;
         FrameInfo.verify = 0xA1A2A3A4;        // Уλ
@@ -1036,11 +1060,11 @@ int XTRtp::send_data_in_stamp_ps(const xt_track_t& track,           // ת
         mp_bool pump_ret = MP_FALSE;
         if (is_std)
         {
-            pump_ret = ::pump_frame_in(&it->second.hmp, &it->second.hmssrc, (uint8_t*)buff, len, frameTS_opt, in_time_stamp, it->second.payload, FrameInfo,priority,true,usr_ssrc,ssrc);
+            pump_ret = ::pump_frame_in(&slot->rtp.hmp, &slot->rtp.hmssrc, (uint8_t*)buff, len, frameTS_opt, in_time_stamp, slot->payload.load(boost::memory_order_relaxed), FrameInfo,priority,true,usr_ssrc,ssrc);
         }
         else
         {
-            pump_ret = ::pump_frame_in(&it->second.hmp, &it->second.hmssrc, (uint8_t*)buff, len, frameTS_opt, in_time_stamp, it->second.payload, FrameInfo,priority,false,0,0);
+            pump_ret = ::pump_frame_in(&slot->rtp.hmp, &slot->rtp.hmssrc, (uint8_t*)buff, len, frameTS_opt, in_time_stamp, slot->payload.load(boost::memory_order_relaxed), FrameInfo,priority,false,0,0);
         }
 
         if (MP_FALSE == pump_ret)
@@ -1056,15 +1080,14 @@ int XTRtp::send_data_in_stamp_ps(const xt_track_t& track,           // ת
 
 int XTRtp::get_sink_sn(long chanid, unsigned short *sn)
 {
-	boost::shared_lock<boost::shared_mutex> lock(m_mutex); 
-
-	std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(chanid);
-	if (it == m_rtpHandles.end())
+	XTRtpTable::reader rd(m_rtpHandles);
+	Rtp_Slot *slot = rd.get(chanid);
+	if (!slot)
 	{
 		return -1;
 	}
 
-	Rtp_Handle rtp = it->second;
+	Rtp_Handle rtp = slot->rtp;
 
 	int ret = ::get_sink_sn(&rtp.hmp, sn);
 	if (ret < 0)
@@ -1077,15 +1100,14 @@ int XTRtp::get_sink_sn(long chanid, unsigned short *sn)
 
 int XTRtp::get_rtp(unsigned long chanid, Rtp_Handle &rtp)
 {
-    boost::shared_lock<boost::shared_mutex> lock(m_mutex); 
-
-    std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(chanid);
-    if (it == m_rtpHandles.end())
+    XTRtpTable::reader rd(m_rtpHandles);
+    Rtp_Slot *slot = rd.get(chanid);
+    if (!slot)
     {
         return -1;
     }
 
-    rtp = it->second;
+    rtp = slot->handle();
     return 0;
 }
 
@@ -1101,17 +1123,18 @@ static void mp_network_changed_cb(void *ctx, mp_handle hmp, uint32_t bitrate, ui
 
 int XTRtp::register_network_changed_callback(int chan, xt_network_changed_callback_t cb, void *ctx)
 {
-    boost::shared_lock<boost::shared_mutex> lock(m_mutex);
-    std::map<unsigned int, Rtp_Handle>::iterator it = m_rtpHandles.find(chan);
-    if (m_rtpHandles.end() == it)
+    boost::unique_lock<boost::shared_mutex> lock(m_mutex);
+    XTRtpTable::reader rd(m_rtpHandles);
+    Rtp_Slot *slot = rd.get(chan);
+    if (!slot)
     {
         return -1;
     }
 
-    it->second.cb = cb;
-    it->second.ctx = ctx;
+    slot->rtp.cb = cb;
+    slot->rtp.ctx = ctx;
 
-    mp_register_network_changed_callback(it->second.hmp.hmp, mp_network_changed_cb, &(it->second));
+    mp_register_network_changed_callback(slot->rtp.hmp.hmp, mp_network_changed_cb, &(slot->rtp));
     return 0;
 }
 #endif
@@ -12,6 +12,8 @@
 #include <list>
 
 #include <boost/thread/thread.hpp>
+#include <boost/atomic.hpp>
+#include "XTRtpTable.h"
 #include "h_xtmediaserver.h"
 
 enum Rtp_Mode 
@@ -38,6 +40,25 @@ struct  Rtp_Handle
 #endif
 };
 
+// rtp͵Ԫ(ͱУinituninitڼַ)
+struct Rtp_Slot
+{
+    Rtp_Handle          rtp;            // ͵Ԫ(ԭΪ׼)
+    boost::atomic<int>  payload;        // new
+    boost::atomic<int>  payload_old;    // old
+
+    Rtp_Slot():payload(96),payload_old(96)
+    {}
+
+    Rtp_Handle handle() const
+    {
+        Rtp_Handle h = rtp;
+        h.payload = payload.load(boost::memory_order_relaxed);
+        h.payload_old = payload_old.load(boost::memory_order_relaxed);
+        return h;
+    }
+};
+
 // תڵ
 struct Rtp_Sink 
 {
@@ -276,7 +297,7 @@ private:
         unsigned int multid); 
 private:
     boost::shared_mutex			m_mutex;		//mutex
-    std::map<unsigned int, Rtp_Handle>	m_rtpHandles;	// rtpתԪ
+    XTRtpTable                          m_rtpHandles;   // rtpתԪ(ͨ±꣬·)
     std::list<Rtp_Sink>					m_rtpSinks;		// rtpתڵ
 
     bool							m_sink_single;	//ͨת
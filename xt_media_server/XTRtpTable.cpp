@@ -0,0 +1,138 @@
+#include "XTRtpTable.h"
+#include <boost/thread/thread.hpp>
+
+#if defined(_OS_WINDOWS) || defined(_WIN32)
+#define XTRTP_THREAD_LOCAL __declspec(thread)
+#else
+#define XTRTP_THREAD_LOCAL __thread
+#endif
+
+//̶߳߷Ƭţ߳״ζʱ䣬1ʼ
+static XTRTP_THREAD_LOCAL uint32_t s_reader_stripe_id = 0;
+static boost::atomic<uint32_t> s_reader_stripe_seq(0);
+
+static inline uint32_t current_reader_stripe()
+{
+    if (0 == s_reader_stripe_id)
+    {
+        s_reader_stripe_id = ++s_reader_stripe_seq;
+    }
+    return (s_reader_stripe_id - 1) % XTRTP_EPOCH_STRIPES;
+}
+
+XTRtpTable::XTRtpTable()
+:m_array(NULL)
+,m_epoch(0)
+{
+    for (uint32_t i = 0; i < XTRTP_EPOCH_STRIPES; ++i)
+    {
+        m_stripes[i].readers[0].store(0, boost::memory_order_relaxed);
+        m_stripes[i].readers[1].store(0, boost::memory_order_relaxed);
+    }
+}
+
+XTRtpTable::~XTRtpTable()
+{
+    //˳ʱжߣXTRtp::uninit
+    chan_array *array = m_array.exchange(NULL, boost::memory_order_relaxed);
+    if (array)
+    {
+        delete [] array->slots;
+        delete array;
+    }
+}
+
+bool XTRtpTable::create(unsigned int num)
+{
+    //ǻй©ѷĲͷ͵Ԫ
+    if (m_array.load(boost::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    chan_array *array = new chan_array;
+    array->num = num;
+    array->slots = new boost::atomic<Rtp_Slot *>[num];
+    for (unsigned int i = 0; i < num; ++i)
+    {
+        array->slots[i].store(NULL, boost::memory_order_relaxed);
+    }
+
+    m_array.store(array, boost::memory_order_seq_cst);
+    return true;
+}
+
+void XTRtpTable::publish(unsigned int chanid, Rtp_Slot *slot)
+{
+    chan_array *array = m_array.load(boost::memory_order_relaxed);
+    if (!array || chanid >= array->num)
+    {
+        return;
+    }
+
+    array->slots[chanid].store(slot, boost::memory_order_release);
+}
+
+void XTRtpTable::retire_all(std::vector<Rtp_Slot *> &slots)
+{
+    chan_array *array = m_array.exchange(NULL, boost::memory_order_seq_cst);
+    if (!array)
+    {
+        return;
+    }
+
+    synchronize();
+
+    for (unsigned int i = 0; i < array->num; ++i)
+    {
+        Rtp_Slot *slot = array->slots[i].load(boost::memory_order_relaxed);
+        if (slot)
+        {
+            slots.push_back(slot);
+        }
+    }
+
+    delete [] array->slots;
+    delete array;
+}
+
+void XTRtpTable::synchronize()
+{
+    //ߵǼǵļԪǷתǰľֵԪҪȿ
+    for (int phase = 0; phase < 2; ++phase)
+    {
+        uint32_t e = m_epoch.fetch_add(1, boost::memory_order_seq_cst);
+        for (uint32_t i = 0; i < XTRTP_EPOCH_STRIPES; ++i)
+        {
+            while (0 != m_stripes[i].readers[e & 1].load(boost::memory_order_seq_cst))
+            {
+                boost::this_thread::yield();
+            }
+        }
+    }
+}
+
+XTRtpTable::reader::reader(const XTRtpTable &table)
+{
+    uint32_t e = table.m_epoch.load(boost::memory_order_seq_cst);
+    m_counter = &table.m_stripes[current_reader_stripe()].readers[e & 1];
+    m_counter->fetch_add(1, boost::memory_order_seq_cst);
+
+    //ǼǺȡ飬д߳ȵļһ
+    m_array = table.m_array.load(boost::memory_order_seq_cst);
+}
+
+XTRtpTable::reader::~reader()
+{
+    m_counter->fetch_sub(1, boost::memory_order_release);
+}
+
+Rtp_Slot *XTRtpTable::reader::get(unsigned long chanid) const
+{
+    if (!m_array || chanid >= m_array->num)
+    {
+        return NULL;
+    }
+
+    return m_array->slots[chanid].load(boost::memory_order_acquire);
+}
@@ -0,0 +1,69 @@
+#ifndef XTRTPTABLE_H__INCLUDE__
+#define XTRTPTABLE_H__INCLUDE__
+
+#include <stdint.h>
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+
+//߼Ƭ̰߳״η˳ֵƬ
+#define XTRTP_EPOCH_STRIPES 64
+
+struct Rtp_Slot;
+
+// rtp͵Ԫ
+// 1ͨż±꣬Ϊԭָ룬·
+// 2߽ʱڱ̷߳ƬϵǼǵǰԪļ˳ʱ
+// 3²ۺηתԪȴԪļٽ߻
+// 4create/retire_allɵߴ(XTRtp::m_mutexд)
+class XTRtpTable : private boost::noncopyable
+{
+    struct chan_array
+    {
+        unsigned int                num;
+        boost::atomic<Rtp_Slot *>   *slots;
+    };
+
+    struct epoch_stripe
+    {
+        boost::atomic<uint32_t> readers[2];
+        char                    pad[64 - 2 * sizeof(boost::atomic<uint32_t>)];
+    };
+
+public:
+    XTRtpTable();
+    ~XTRtpTable();
+
+    // numղ۲в(δretire_all)ʱfalse
+    bool create(unsigned int num);
+
+    // ͨ
+    void publish(unsigned int chanid, Rtp_Slot *slot);
+
+    // ²飬ȴ;˳󷵻ѳµĲۣɵ߹رͷ
+    void retire_all(std::vector<Rtp_Slot *> &slots);
+
+    // ٽǰȡĲ۲ᱻ
+    class reader : private boost::noncopyable
+    {
+    public:
+        explicit reader(const XTRtpTable &table);
+        ~reader();
+
+        Rtp_Slot *get(unsigned long chanid) const;
+        unsigned int size() const { return m_array ? m_array->num : 0; }
+
+    private:
+        boost::atomic<uint32_t> *m_counter;
+        const chan_array        *m_array;
+    };
+
+private:
+    void synchronize();
+
+    boost::atomic<chan_array *> m_array;
+    boost::atomic<uint32_t>     m_epoch;
+    mutable epoch_stripe        m_stripes[XTRTP_EPOCH_STRIPES];
+};
+
+#endif//XTRTPTABLE_H__INCLUDE__
@@ -588,6 +588,25 @@ MEDIASERVER_API uint32_t xt_get_cur_connect_num();
 **/
 MEDIASERVER_API int xt_get_connect_info(connect_info_t out_cinfo[], uint32_t& connect_num);
 
+//ûỰͳ
+typedef struct _struct_demux_stats_
+{
+    uint32_t sessions;      //ûỰ
+    uint32_t buckets;       //ϣͰ
+    uint32_t max_probe;     //ǰ̽
+    uint64_t lookups;       //Ҵ(+ر)
+    uint64_t collisions;    //ʱԽķĿͰ
+    uint64_t open_fails;    //ʧܴ
+}demux_stats_t,*pdemux_stats_t;
+
+/**
+*@name:xt_get_demux_stats
+*@ function:ȡͶ˸ûỰͳ
+*@ param[out]:demux_stats_t& stats
+*@ return: int С0Ϊʧ
+**/
+MEDIASERVER_API int xt_get_demux_stats(demux_stats_t& stats);
+
 
 //SIPЭջĶʱ
 typedef struct _struct_start_sip_timer_type_ 
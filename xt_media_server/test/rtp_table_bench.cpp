@@ -0,0 +1,207 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   rtp_table_bench.cpp
+// XTRtpTableͨҵĶ߳ܲ
+//
+// 11024ͨ1/2/4/8/16߳ͨȡ
+// 2ԭʵ(std::map + boost::shared_mutex)ԱȵβҺʱ
+// 3д̷߳retire_all/createУȡĲڶٽڲᱻ
+//    (-fsanitize=address)
+//
+// ÷rtp_table_bench [lookups_per_thread]
+///////////////////////////////////////////////////////////////////////////////////////////
+#include "XTRtpTable.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include <boost/thread.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+//ָֻͨ룬õĲֻУֶ
+struct Rtp_Slot
+{
+    enum { ALIVE = 0x5a5a5a5a, DEAD = 0xdeaddead };
+
+    Rtp_Slot(unsigned long id) : magic(ALIVE), chanid(id), payload(96) {}
+    ~Rtp_Slot() { magic = DEAD; }
+
+    volatile uint32_t magic;
+    unsigned long chanid;
+    boost::atomic<int> payload;
+};
+
+namespace
+{
+    const unsigned int CHANNELS = 1024;
+    const unsigned int CHURN_READERS = 8;
+    const unsigned int CHURN_CYCLES = 300;
+
+    //ԭʵ֣ͨŲmapȫֶ̳
+    struct legacy_table
+    {
+        boost::shared_mutex mutex;
+        std::map<unsigned long, Rtp_Slot *> handles;
+    };
+
+    XTRtpTable g_table;
+    legacy_table g_legacy;
+    boost::atomic<uint64_t> g_sink(0);
+    boost::atomic<uint32_t> g_errors(0);
+    volatile bool g_stop = false;
+
+    inline uint32_t next_rand(uint32_t &seed)
+    {
+        seed = seed * 1103515245u + 12345u;
+        return seed >> 8;
+    }
+
+    void table_worker(uint32_t id, uint32_t lookups)
+    {
+        uint32_t seed = id * 2654435761u + 1;
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < lookups; ++i)
+        {
+            XTRtpTable::reader rd(g_table);
+            Rtp_Slot *slot = rd.get(next_rand(seed) % CHANNELS);
+            if (slot)
+            {
+                sum += slot->payload.load(boost::memory_order_relaxed);
+            }
+        }
+        g_sink += sum;
+    }
+
+    void legacy_worker(uint32_t id, uint32_t lookups)
+    {
+        uint32_t seed = id * 2654435761u + 1;
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < lookups; ++i)
+        {
+            boost::shared_lock<boost::shared_mutex> lock(g_legacy.mutex);
+            std::map<unsigned long, Rtp_Slot *>::iterator itr = g_legacy.handles.find(next_rand(seed) % CHANNELS);
+            if (itr != g_legacy.handles.end())
+            {
+                sum += itr->second->payload.load(boost::memory_order_relaxed);
+            }
+        }
+        g_sink += sum;
+    }
+
+    //ǽʱ䰴ȫ̲߳ƽʱ(ns)µĵ
+    double run(void (*worker)(uint32_t, uint32_t), uint32_t threads, uint32_t lookups)
+    {
+        boost::posix_time::ptime begin = boost::posix_time::microsec_clock::universal_time();
+        boost::thread_group group;
+        for (uint32_t i = 0; i < threads; ++i)
+        {
+            group.create_thread(boost::bind(worker, i, lookups));
+        }
+        group.join_all();
+        boost::posix_time::time_duration d = boost::posix_time::microsec_clock::universal_time() - begin;
+        return (double)d.total_microseconds() * 1000.0 / ((double)lookups * threads);
+    }
+
+    void fill(XTRtpTable &table)
+    {
+        table.create(CHANNELS);
+        for (unsigned int i = 0; i < CHANNELS; ++i)
+        {
+            table.publish(i, new Rtp_Slot(i));
+        }
+    }
+
+    void clear(XTRtpTable &table)
+    {
+        std::vector<Rtp_Slot *> slots;
+        table.retire_all(slots);
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+            delete slots[i];
+        }
+    }
+
+    void churn_reader(uint32_t id)
+    {
+        uint32_t seed = id * 69069u + 3;
+        while (!g_stop)
+        {
+            XTRtpTable::reader rd(g_table);
+            unsigned long chanid = next_rand(seed) % CHANNELS;
+            Rtp_Slot *slot = rd.get(chanid);
+            if (!slot)
+            {
+                continue;
+            }
+            //ٽڲ۲ᱻ
+            for (int i = 0; i < 8; ++i)
+            {
+                if (slot->magic != Rtp_Slot::ALIVE || slot->chanid != chanid)
+                {
+                    ++g_errors;
+                    break;
+                }
+            }
+        }
+    }
+
+    int run_churn()
+    {
+        g_stop = false;
+        boost::thread_group readers;
+        for (uint32_t i = 0; i < CHURN_READERS; ++i)
+        {
+            readers.create_thread(boost::bind(churn_reader, i));
+        }
+
+        uint32_t double_create = 0;
+        for (uint32_t c = 0; c < CHURN_CYCLES; ++c)
+        {
+            fill(g_table);
+            //δretire_allǰٴcreateܸ
+            if (g_table.create(CHANNELS))
+            {
+                ++double_create;
+            }
+            boost::this_thread::yield();
+            clear(g_table);
+        }
+        g_stop = true;
+        readers.join_all();
+
+        printf("churn: %u readers, %u create/retire cycles, errors %u, double create accepted %u\n",
+            CHURN_READERS, CHURN_CYCLES, g_errors.load(), double_create);
+        return (0 == g_errors.load() && 0 == double_create) ? 0 : 1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t lookups = (argc > 1) ? (uint32_t)atoi(argv[1]) : 2000000;
+
+    fill(g_table);
+    for (unsigned int i = 0; i < CHANNELS; ++i)
+    {
+        g_legacy.handles[i] = new Rtp_Slot(i);
+    }
+
+    printf("%u channels, %u lookups per thread, %u cpus\n", CHANNELS, lookups, boost::thread::hardware_concurrency());
+    const uint32_t threads[] = { 1, 2, 4, 8, 16 };
+    for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); ++i)
+    {
+        double table_ns = run(table_worker, threads[i], lookups);
+        double legacy_ns = run(legacy_worker, threads[i], lookups);
+        printf("%2u threads: %6.1f ns/lookup (table) vs %6.1f ns/lookup (map+shared_mutex), %.1fx\n",
+            threads[i], table_ns, legacy_ns, legacy_ns / table_ns);
+    }
+
+    clear(g_table);
+    for (unsigned int i = 0; i < CHANNELS; ++i)
+    {
+        delete g_legacy.handles[i];
+    }
+
+    int ret = run_churn();
+    printf("%s\n", (0 == ret) ? "PASS" : "FAIL");
+    return ret;
+}
@@ -1790,21 +1790,15 @@ on_server_invite_message_response(void *ctx, xt_sip_server_invite_handle_t h, xt
 int xt_session_sip::get_strmid(const char *sdp, unsigned short len)
 {
     int streamid = -1;
-    xt_sdp::parse_buffer_t pb(sdp, len); 
-    xt_sdp::sdp_session_t xsdp;
-    try
-    {
-        xsdp.parse(pb);
-    }
-    catch(...)
+    xt_sdp::sdp_view_t xsdp;
+    if (!xsdp.parse(sdp, len))
     {
         return -1;
     }
-    const std::list<std::string>& vals = xsdp.attribute_helper_.get_values("streamid");
-    if (vals.size() > 0)
+    const xt_sdp::sdp_attr_ref_t *val = xsdp.find_attribute("streamid");
+    if (NULL != val)
     {
-        std::list<std::string>::const_iterator itr = vals.begin();
-        streamid = ::atoi((*itr).c_str());
+        streamid = (int)val->value.to_ulong();
     }
     return streamid;
 }
@@ -1816,23 +1810,19 @@ int xt_session_sip::get_media_info(const char *sdp, unsigned short len, session_
         DEBUG_LOG("get_media_info err sdp is empty!\n");
         return -1;
     }
-    xt_sdp::parse_buffer_t pb(sdp, len); 
-    xt_sdp::sdp_session_t xsdp;
-    try
-    {
-        xsdp.parse(pb);
-    }
-    catch(...)
+    xt_sdp::sdp_view_t view;
+    if (!view.parse(sdp, len))
     {
         return -1;
     }
+    xt_sdp::sdp_session_adapter_t xsdp(view);
 
     bool demux = false;
     unsigned int demuxid = 0;
     std::list<std::string> lst_vale;
-    if (xsdp.attribute_helper_.exists("rtpport-mux") && xsdp.attribute_helper_.exists("muxid"))
+    if (xsdp.exists("rtpport-mux") && xsdp.exists("muxid"))
     {
-        lst_vale = xsdp.attribute_helper_.get_values("muxid");
+        lst_vale = xsdp.get_values("muxid");
         if (!lst_vale.empty())
         {
             demux = true;
@@ -1842,11 +1832,11 @@ int xt_session_sip::get_media_info(const char *sdp, unsigned short len, session_
         }
     }
 
-    sdp_session_t::medium_container_t &media = xsdp.media_;
-    sdp_session_t::medium_container_t::iterator itr = media.begin();
+    const sdp_session_adapter_t::medium_container_t &media = xsdp.media();
+    sdp_session_adapter_t::medium_container_t::const_iterator itr = media.begin();
     for (int i=0;itr!=media.end()&&i<MAX_TRACK;++itr,++i)
     {
-        if (itr->exists("rtpport-mux") || xsdp.attribute_helper_.exists("rtpport-mux"))
+        if (itr->exists("rtpport-mux") || xsdp.exists("rtpport-mux"))
         {
             lst_vale = itr->get_values("muxid");
             if (!lst_vale.empty())
@@ -1864,18 +1854,14 @@ int xt_session_sip::get_media_info(const char *sdp, unsigned short len, session_
             demuxid = 0; 
         }
 
-        sdp_session_t::medium_t &medium = *itr;
-        std::string ip1 = xsdp.connection_.address().c_str();
-        std::string ip2 = xsdp.origin_.address().c_str();
+        const sdp_session_adapter_t::medium_t &medium = *itr;
+        std::string ip1 = xsdp.connection().address().c_str();
+        std::string ip2 = xsdp.origin().address().c_str();
         std::string ip3 = "";
-        std::string ip4 = "";
-        if (medium.connections_.size() > 0)
-        {
-            ip3 = (*(medium.connections_.begin())).address();
-        }
-        if (medium.session_)
+        std::string ip4 = xsdp.connection().address();
+        if (medium.get_medium_connections().size() > 0)
         {
-            ip4 = medium.session_->connection_.address();
+            ip3 = medium.get_medium_connections().front().address();
         }
 
         std::string ip_session = ip3;
@@ -1906,9 +1892,9 @@ int xt_session_sip::get_media_info(const char *sdp, unsigned short len, session_
         session.tracks.push_back(track);
     }
 
-    session.username = xsdp.origin_.user();
-    session.ip = xsdp.connection_.address(); 
-    session.sessionid = xsdp.origin_.session_id();
+    session.username = xsdp.origin().user();
+    session.ip = xsdp.connection().address(); 
+    session.sessionid = xsdp.origin().session_id();
     return 0;
 }
 
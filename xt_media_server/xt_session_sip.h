@@ -5,6 +5,8 @@
 #include "sdp.h"
 #include "xtXml.h"
 #include "parse_buffer.h"
+#include "sdp_view.h"
+#include "sdp_adapter.h"
 #include <boost/thread.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/atomic/atomic.hpp>
@@ -1,218 +1,258 @@
-#include "ReSendMan.h"
-#include <../rv_adapter/rv_api.h>
-#include "mp_caster.h"
+#include "ReSendMan.h"
+#include <../rv_adapter/rv_api.h>
+#include "mp_caster.h"
 #include "msink_rv_rtp.h"
+#include "sink_common.h"
 #include <stdio.h>
-#include <stdarg.h>
-
-#ifdef _ANDROID
-#include "xt_config_cxx.h"
-#endif
-
-extern void writeLogV(int nLogLevel, const char* szLogName,const char* szLogFmt, va_list vArgList);
-extern void writeLog(int nLevel, const char* szLogName, const char* szLogFmt, ...);
-
-#define MAX_RESEND_LEN	1024	//  󻺳峤
-#define MAX_RESEND_AU	1024  	//  Ȩ
-#define DEFAULT_RESEND	1		//  Ȩ
-
-#ifdef _ANDROID
-ReSendMan::ReSendMan(void)
-:m_sink(NULL),
-m_nSeg(MAX_RESEND_LEN)
-,m_nMaxAu(MAX_RESEND_AU)
-,m_nPackResend(DEFAULT_RESEND)
-,m_size_seg(0)
-{    m_nSeg = xt_config::router_module::get<int>("config.caster_cfg.ReSendLen",MAX_RESEND_LEN);
-    m_nMaxAu = xt_config::router_module::get<int>("config.caster_cfg.ReSendAu",MAX_RESEND_AU);
-    m_nPackResend = xt_config::router_module::get<int>("config.caster_cfg.packresend",DEFAULT_RESEND);
-}
-#else
-ReSendMan::ReSendMan(void)
-:m_sink(NULL),
-m_nSeg(MAX_RESEND_LEN)
-,m_nAu(MAX_RESEND_AU)
-,m_nMaxAu(MAX_RESEND_AU)
-,m_nPackResend(DEFAULT_RESEND)
-,m_size_seg(0)
-{    m_nSeg = config::_()->ReSendLen(MAX_RESEND_LEN);    m_nMaxAu = config::_()->ReSendAu(MAX_RESEND_AU);
-    m_nPackResend = config::_()->packresend(DEFAULT_RESEND);
-}
-#endif
-
-ReSendMan::~ReSendMan(void)
-{
-    clrSeg();
-}
-
-// 黺
-void ReSendMan::addSeg(rtp_block *rtp)
-{
-    uint16_t sn = 0;
-    if (!rtp)
-    {
-        return;
-    }
-    sn = rtp->m_rtp_param.sequenceNumber;
-
-    //////////////////////////////////////////////////////////////////////////
-	uint32_t header_exlen = 0;
-    uint32_t offset = rtp->m_rtp_param.sByte;
-    if (rtp->m_rtp_param.extensionBit && rtp->m_rtp_param.extensionLength>=1 && rtp->m_rtp_param.extensionData)
-    {
-        uint32_t exData[64];
-        ::memcpy(exData, rtp->m_rtp_param.extensionData, 4*rtp->m_rtp_param.extensionLength);
-        ::memcpy(rtp->m_exHead+1, exData, 4*rtp->m_rtp_param.extensionLength);
-
-        rtp->m_rtp_param.extensionLength += 1;
-        rtp->m_rtp_param.sByte += 4;
-		header_exlen = 4;
-    }
-    else
-    {
-        rtp->m_rtp_param.extensionBit = true;
-        rtp->m_rtp_param.extensionLength = 1;
-        rtp->m_rtp_param.sByte += 8;
-		header_exlen = 8;
-    }
-	//شͷԶ
-    uint32_t resend = 0x00AABBCC;
-    rtp->m_exHead[0] = resend;
-    rtp->m_rtp_param.extensionData = rtp->m_exHead;
-
-    uint8_t * raw_data = 0;
-    tghelper::byte_block * bind_block = rtp->get_bind_block();
-    if (bind_block)
-    {
-        raw_data = bind_block->get_raw();
-    }
-    else
-    {
-        raw_data = rtp->get_raw();
-    }
-
-    if (raw_data)
-    {
-        uint8_t data[5120];//m_rtp_param.sByteı
-        ::memcpy(data, raw_data+offset, rtp->payload_size());
-        ::memcpy(raw_data+rtp->m_rtp_param.sByte, data, rtp->payload_size());
-		//rtp̶ͷչӣpayloadݺƣʵʲparamУʱڿͷ
-		/*int last_index = rtp->payload_totalsize()-1;
-		for (int i=0;i<rtp->payload_size();i++)
-		{
-			raw_data[last_index-i+header_exlen] = raw_data[last_index-i];
-		}*/
-    }
-
-    rtp->set_params(rtp->payload_size(), rtp->m_rtp_param.sByte);
-    //////////////////////////////////////////////////////////////////////////*/
-
-    boost::unique_lock<boost::recursive_mutex> lock(m_mSeg);
-
-    if (m_nSeg <= 0)
-    {
-        rtp->release();
-    }
-    else if (m_size_seg > m_nSeg)
-    {
-        vector<rtp_block*>::iterator itr = m_vecSegment.begin();
-        rtp_block *seg = m_vecSegment[0];
-        if (seg)
-        {
-            seg->release();
-        }
-
-        m_vecSegment.erase(itr);
-        m_vecSegment.push_back(rtp);
-    }
-    else
-    {
-        m_vecSegment.push_back(rtp);
-        m_size_seg += 1;
-    }
-
-    m_nAu +=1;
-    if (m_nAu > m_nMaxAu)
-    {
-        m_nAu = m_nMaxAu;
-    }
-}
-
-// ջ
-void ReSendMan::clrSeg()
-{
-    boost::unique_lock<boost::recursive_mutex> lock(m_mSeg);
-
-    vector<rtp_block*>::iterator itr = m_vecSegment.begin();
-    for (;itr != m_vecSegment.end();++itr)
-    {
-        rtp_block *rtp = *itr;
-        if (rtp)
-        {
-            rtp->release();
-        }
-    }
-    m_vecSegment.clear();
-    m_size_seg = 0;
-}
-
-// ط
-void ReSendMan::reSend(uint16_t sn)
-{
-    boost::unique_lock<boost::recursive_mutex> lock(m_mSeg);
-
-    if (m_nAu < m_nPackResend)
-    {
-        writeLog(5,"طʧ","ûȨ[%d]", m_nMaxAu);
-        return;
-    }
-
-    m_nAu -= m_nPackResend;
-
-    rtp_block *seg = NULL;
-    if (m_size_seg > 0)
-    {
-        uint16_t sn0 = m_vecSegment[0]->m_rtp_param.sequenceNumber;
-        uint16_t index = ::abs(sn-sn0);
-        if (index > 32767)
-        {
-            index = 65536 - index;
-        }
-        if (index < m_size_seg)
-        {
-            seg = m_vecSegment[index];
-        }
-
-        if (!seg)
-        {
-            writeLog(5,"طʧ","û[%d]", sn);
-        }
-    }
-
-    /*list<rtp_block*>::reverse_iterator itr = m_vecSegment.rbegin();
-    for (;itr != m_vecSegment.rend();++itr)
-    {
-    rtp_block *tmp = *itr;
-    if (tmp && tmp->m_rtp_param.sequenceNumber==sn)
-    {
-    seg = tmp;
-    break;
-    }
-    }*/
-
-    if (m_sink && seg && seg->m_rtp_param.sequenceNumber==sn)
-    {
-        writeLog(5,"ط","طSN[%d]", seg->m_rtp_param.sequenceNumber);
-
-        //((msink_rv_rtp*)m_sink)->write_to_rv_adapter(seg, true);
-		//һظ飬شİҲͨ
-		seg->m_resend = true;
-		((msink_rv_rtp*)m_sink)->internel_write_to_rv_adapter(seg);
-		//::write_rtp(&((msink_rv_rtp*)m_sink)->m_hrv, seg->get_raw(), seg->payload_totalsize(), &(seg->m_rtp_param));
-    }
-    else
-    {
-        writeLog(5,"طʧ","û[%d]", sn);
-        return;
-    }
+#include <stdarg.h>
+
+#ifdef _ANDROID
+#include "xt_config_cxx.h"
+#endif
+
+extern void writeLogV(int nLogLevel, const char* szLogName,const char* szLogFmt, va_list vArgList);
+extern void writeLog(int nLevel, const char* szLogName, const char* szLogFmt, ...);
+
+#define MAX_RESEND_LEN	1024	//  󻺳峤
+#define RESEND_MARK		0x00AABBCC	//  شͷԶ
+
+ReSendMan::ReSendMan(void)
+:m_cap(0)
+,m_head(0)
+,m_tail(0)
+,m_size_seg(0)
+,m_nSeg(MAX_RESEND_LEN)
+,m_sink(NULL)
+,m_budget(MSINK_RESEND_BUDGET_BURST)
+{
+#ifdef _ANDROID
+    m_nSeg = xt_config::router_module::get<int>("config.caster_cfg.ReSendLen",MAX_RESEND_LEN);
+#else
+    m_nSeg = config::_()->ReSendLen(MAX_RESEND_LEN);
+#endif
+
+    //ȡ2ݣsnƺslotһһӦ
+    m_cap = 1;
+    while (m_cap < m_nSeg && m_cap < 32768)
+    {
+        m_cap <<= 1;
+    }
+
+    seg_t seg;
+    ::memset(&seg, 0, sizeof(seg));
+    m_segs.assign(m_cap, seg);
+}
+
+ReSendMan::~ReSendMan(void)
+{
+    clrSeg();
+}
+
+void ReSendMan::_release(seg_t &seg)
+{
+    if (seg.rtp)
+    {
+        seg.rtp->release();
+        seg.rtp = NULL;
+        --m_size_seg;
+    }
+}
+
+// snʼͷŹڵİ
+void ReSendMan::_expire(unsigned long now)
+{
+    while (m_size_seg > 0)
+    {
+        seg_t &seg = _slot(m_head);
+        if (seg.rtp && seg.sn == m_head)
+        {
+            if (now - seg.tick < MSINK_RESEND_EXPIRE_MS)
+            {
+                break;
+            }
+            _release(seg);
+        }
+
+        if (m_head == m_tail)
+        {
+            break;
+        }
+        ++m_head;
+    }
+}
+
+// 黺
+void ReSendMan::addSeg(rtp_block *rtp)
+{
+    if (!rtp)
+    {
+        return;
+    }
+
+    if (m_nSeg <= 0)
+    {
+        rtp->release();
+        return;
+    }
+
+    uint16_t sn = rtp->m_rtp_param.sequenceNumber;
+    unsigned long now = GetTickCount();
+
+    boost::mutex::scoped_lock lock(m_mSeg);
+
+    if (0 == m_size_seg)
+    {
+        m_head = sn;
+        m_tail = sn;
+    }
+    else if ((int16_t)(sn - m_tail) > 0)
+    {
+        if ((uint16_t)(sn - m_tail) >= m_cap)
+        {
+            //sn䳬ɰȫ
+            for (uint32_t i = 0; i < m_cap; ++i)
+            {
+                _release(m_segs[i]);
+            }
+            m_head = sn;
+        }
+        else
+        {
+            //ǰƣİ
+            while ((uint16_t)(sn - m_head) >= m_cap)
+            {
+                seg_t &old = _slot(m_head);
+                if (old.sn == m_head)
+                {
+                    _release(old);
+                }
+                ++m_head;
+            }
+        }
+        m_tail = sn;
+    }
+    else if ((int16_t)(sn - m_head) < 0)
+    {
+        //Ȼİ
+        rtp->release();
+        return;
+    }
+
+    seg_t &seg = _slot(sn);
+    _release(seg);
+
+    seg.rtp = rtp;
+    seg.sn = sn;
+    seg.len = rtp->payload_totalsize();
+    seg.tick = now;
+    ::memcpy(&seg.param, &rtp->m_rtp_param, sizeof(rv_rtp_param));
+    seg.ex_len = 0;
+    if (seg.param.extensionBit && seg.param.extensionLength > 0 && seg.param.extensionData)
+    {
+        seg.ex_len = seg.param.extensionLength;
+        if (seg.ex_len > MSINK_RESEND_EX_WORDS - 1)
+        {
+            seg.ex_len = MSINK_RESEND_EX_WORDS - 1;
+        }
+        ::memcpy(seg.ex, seg.param.extensionData, 4 * seg.ex_len);
+    }
+    ++m_size_seg;
+
+    //ش
+    m_budget += seg.len * MSINK_RESEND_BUDGET_PERCENT / 100;
+    if (m_budget > MSINK_RESEND_BUDGET_BURST)
+    {
+        m_budget = MSINK_RESEND_BUDGET_BURST;
+    }
+
+    _expire(now);
+}
+
+// ջ
+void ReSendMan::clrSeg()
+{
+    boost::mutex::scoped_lock lock(m_mSeg);
+
+    for (uint32_t i = 0; i < m_cap; ++i)
+    {
+        _release(m_segs[i]);
+    }
+    m_size_seg = 0;
+    m_budget = MSINK_RESEND_BUDGET_BURST;
+}
+
+// ط
+void ReSendMan::reSend(uint16_t sn)
+{
+    rtp_block *rtp = NULL;
+    rv_rtp_param param;
+    uint32_t ex[MSINK_RESEND_EX_WORDS];
+    uint32_t ex_len = 0;
+
+    {
+        boost::mutex::scoped_lock lock(m_mSeg);
+
+        seg_t &seg = _slot(sn);
+        if (!m_sink || !seg.rtp || seg.sn != sn)
+        {
+            writeLog(5,"طʧ","û[%d]", sn);
+            return;
+        }
+
+        if (GetTickCount() - seg.tick >= MSINK_RESEND_EXPIRE_MS)
+        {
+            writeLog(5,"طʧ","ݹ[%d]", sn);
+            return;
+        }
+
+        if (m_budget < seg.len)
+        {
+            writeLog(5,"طʧ","شȲ[%d] sn[%d]", m_budget, sn);
+            return;
+        }
+        m_budget -= seg.len;
+
+        //úⷢͣڼslotɱ°
+        rtp = seg.rtp;
+        rtp->assign();
+        ::memcpy(&param, &seg.param, sizeof(rv_rtp_param));
+        ex_len = seg.ex_len;
+        ::memcpy(ex + 1, seg.ex, 4 * ex_len);
+    }
+
+    writeLog(5,"ط","طSN[%d]", sn);
+
+    //ԭѷشʱдشչͷƬʱԤռ䣬ԭز
+    ex[0] = RESEND_MARK;
+    ::memcpy(rtp->m_exHead, ex, 4 * (ex_len + 1));
+    param.extensionBit = true;
+    param.extensionLength = ex_len + 1;
+    param.extensionData = rtp->m_exHead;
+    rtp->set_rtp_param(&param);
+    rtp->reserve_rtp_head();
+
+    //һظ飬شİҲͨ
+    rtp->m_resend = true;
+    ((msink_rv_rtp*)m_sink)->internel_write_to_rv_adapter(rtp);
+
+    rtp->release();
+}
+
+// λͼط
+void ReSendMan::reSendFci(const uint8_t *fci, uint32_t len)
+{
+    for (uint32_t pos = 0; pos + 4 <= len; pos += 4)
+    {
+        uint16_t pid = (uint16_t)((fci[pos] << 8) | fci[pos + 1]);
+        uint16_t blp = (uint16_t)((fci[pos + 2] << 8) | fci[pos + 3]);
+
+        reSend(pid);
+        for (uint16_t i = 0; i < 16; ++i)
+        {
+            if (blp & (1 << i))
+            {
+                reSend((uint16_t)(pid + i + 1));
+            }
+        }
+    }
 }
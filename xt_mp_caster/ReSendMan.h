@@ -1,11 +1,15 @@
 #pragma once
 #include <map>
-#include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/mutex.hpp>
 #include "mp.h"
 
 using namespace std;
 using namespace xt_mp_caster;
 
+//ѷRTPش
+//1sn & (-1)Ķԭʼö
+//2شչͷشʱд룬뻺ʱ޸İ
+//3MSINK_RESEND_EXPIRE_MSİششֽܷԤ
 class ReSendMan
 {
 public:
@@ -15,7 +19,7 @@ public:
 public:
     void setSink(void *sink){m_sink = sink;}
 
-    // 黺
+    // 黺壬ӹrtpһ
     void addSeg(rtp_block *rtp);
 
     // ջ
@@ -24,26 +28,43 @@ public:
     // ط
     void reSend(uint16_t sn);
 
+    // RFC 4585 Generic NACKFCI(PID+BLP)ط
+    void reSendFci(const uint8_t *fci, uint32_t len);
+
 private:
-    // 
-    vector<rtp_block*> m_vecSegment;
-    int m_size_seg;
+    struct seg_t
+    {
+        rtp_block *rtp;
+        uint16_t sn;
+        uint32_t len;
+        unsigned long tick;
+        rv_rtp_param param;
+        uint32_t ex_len;
+        uint32_t ex[MSINK_RESEND_EX_WORDS];
+    };
+
+    inline seg_t &_slot(uint16_t sn) { return m_segs[sn & (m_cap - 1)]; }
+    void _release(seg_t &seg);
+    void _expire(unsigned long now);
+
+    // 廷
+    vector<seg_t> m_segs;
+    uint32_t m_cap;
+
+    // δڵsnsn
+    uint16_t m_head;
+    uint16_t m_tail;
+    uint32_t m_size_seg;
 
     // 峤
     unsigned long m_nSeg;
 
     // ̱߳()
-    boost::recursive_mutex	m_mSeg;
+    boost::mutex m_mSeg;
 
     // ·
     void *m_sink;
 
-    // طȨ
-    unsigned int m_nAu;
-
-    // Ȩ
-    unsigned int m_nMaxAu;
-
-    // ش
-    int m_nPackResend;
+    // شֽԤ
+    uint32_t m_budget;
 };
@@ -2,11 +2,20 @@
 #include <../rv_adapter/rv_api.h>
 #include <string.h>
 
+#define EMPTY_BUCKET 0xFFFFFFFF
+#define MIN_BUCKETS  1024
+
 XTDemuxMan XTDemuxMan::m_self;
 XTDemuxMan::XTDemuxMan(void)
-:m_numOfDemuxs(1)
-,m_numOfSessions(128)
+:m_free_head(EMPTY_BUCKET)
+,m_buckets(MIN_BUCKETS, EMPTY_BUCKET)
+,m_used(0)
+,m_lookups(0)
+,m_collisions(0)
+,m_open_fails(0)
 ,m_bInit(false)
+,m_numOfDemuxs(1)
+,m_numOfSessions(128)
 {
 }
 
@@ -44,6 +53,7 @@ bool XTDemuxMan::create_demux(rv_session_descriptor *descriptor, int numOfSessio
     {
         numOfSessions = MAX_NUM_SESSIONS;
     }
+    demux->maxSessions = numOfSessions;
 
     demux->demux = ::demux_construct(numOfSessions, &demux->handle);
 
@@ -51,7 +61,7 @@ bool XTDemuxMan::create_demux(rv_session_descriptor *descriptor, int numOfSessio
 
      uint32_t multid = 0;
      ::open_demux_session(descriptor, demux->demux, &multid, &demux->bindHandle);
- 
+
      m_vecDemux.push_back(demux);
 
     return true;
@@ -106,6 +116,11 @@ void XTDemuxMan::uninit()
 
     m_vecDemux.clear();
 
+    m_records.clear();
+    m_free_head = EMPTY_BUCKET;
+    m_buckets.assign(MIN_BUCKETS, EMPTY_BUCKET);
+    m_used = 0;
+
     m_bInit = false;
 }
 
@@ -113,13 +128,14 @@ _XTDemux* XTDemuxMan::get_demux()
 {
     boost::unique_lock<boost::recursive_mutex> lock(m_mutex);
 
+    //ȡûỰδĸ
     _XTDemux *d = NULL;
     int num = MAX_NUM_SESSIONS;
     std::vector<_XTDemux*>::iterator itr = m_vecDemux.begin();
     for (;itr != m_vecDemux.end();++itr)
     {
         _XTDemux* demux = *itr;
-        if (!demux)
+        if (!demux || demux->numOfSessions >= demux->maxSessions)
         {
             continue;
         }
@@ -135,36 +151,123 @@ _XTDemux* XTDemuxMan::get_demux()
     return d;
 }
 
-void XTDemuxMan::add_session(_XTDemux *demux, rv_handler_s *hrv)
+uint32_t XTDemuxMan::alloc_record()
 {
-    boost::unique_lock<boost::recursive_mutex> lock(m_mutex);
-    if (!hrv)
+    if (EMPTY_BUCKET == m_free_head)
     {
-        return;
+        m_records.push_back(_XTDemuxSession());
+        return (uint32_t)(m_records.size() - 1);
     }
 
-    std::vector<_XTDemux*>::iterator itr = m_vecDemux.begin();
-    for (;itr != m_vecDemux.end();++itr)
+    uint32_t rec = m_free_head;
+    m_free_head = m_records[rec].next_free;
+    return rec;
+}
+
+void XTDemuxMan::free_record(uint32_t rec)
+{
+    ::memset(&m_records[rec], 0, sizeof(_XTDemuxSession));
+    m_records[rec].next_free = m_free_head;
+    m_free_head = rec;
+}
+
+uint32_t XTDemuxMan::hash_multid(uint32_t multid)
+{
+    //multiplexIDλΪЭջ±꣬䣬˷ɢдɢ
+    uint32_t h = multid * 0x9E3779B1u;
+    return h ^ (h >> 16);
+}
+
+void XTDemuxMan::bucket_insert(uint32_t rec)
+{
+    uint32_t mask = (uint32_t)m_buckets.size() - 1;
+    uint32_t pos = hash_multid(m_records[rec].multid) & mask;
+
+    ++m_lookups;
+    while (EMPTY_BUCKET != m_buckets[pos])
     {
-        _XTDemux* d = *itr;
-        if (!d || d!=demux)
+        ++m_collisions;
+        pos = (pos + 1) & mask;
+    }
+
+    m_buckets[pos] = rec;
+}
+
+void XTDemuxMan::bucket_erase(uint32_t pos)
+{
+    //̽ɾѺͬʼͰ(pos, j]ڵǰƣĹ
+    uint32_t mask = (uint32_t)m_buckets.size() - 1;
+    uint32_t i = pos;
+    uint32_t j = pos;
+    for (;;)
+    {
+        j = (j + 1) & mask;
+        if (EMPTY_BUCKET == m_buckets[j])
+        {
+            break;
+        }
+
+        uint32_t k = hash_multid(m_records[m_buckets[j]].multid) & mask;
+        bool stay = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+        if (stay)
         {
             continue;
         }
 
-        for (int nS = 0;nS < MAX_NUM_SESSIONS;++nS)
+        m_buckets[i] = m_buckets[j];
+        i = j;
+    }
+
+    m_buckets[i] = EMPTY_BUCKET;
+}
+
+void XTDemuxMan::bucket_grow()
+{
+    std::vector<uint32_t> old;
+    old.swap(m_buckets);
+    m_buckets.assign(old.size() * 2, EMPTY_BUCKET);
+
+    //ɢвͳ
+    uint64_t lookups = m_lookups;
+    uint64_t collisions = m_collisions;
+    for (std::vector<uint32_t>::iterator itr = old.begin();itr != old.end();++itr)
+    {
+        if (EMPTY_BUCKET != *itr)
         {
-            rv_handler_s &handle = d->subHandle[nS];
-            if (!handle.hrtp)
-            {
-                ::memcpy(&handle, hrv, sizeof(rv_handler_s));
-                break;
-            }
+            bucket_insert(*itr);
         }
     }
+    m_lookups = lookups;
+    m_collisions = collisions;
+}
+
+void XTDemuxMan::add_session(_XTDemux *demux, uint32_t multid, rv_handler_s *hrv)
+{
+    boost::unique_lock<boost::recursive_mutex> lock(m_mutex);
+    if (!demux || !hrv)
+    {
+        return;
+    }
+
+    //ʱ1/2
+    if ((m_used + 1) * 2 > m_buckets.size())
+    {
+        bucket_grow();
+    }
+
+    uint32_t rec = alloc_record();
+    _XTDemuxSession &s = m_records[rec];
+    s.multid = multid;
+    s.demux = demux;
+    ::memcpy(&s.handle, hrv, sizeof(rv_handler_s));
+    s.next_free = EMPTY_BUCKET;
+
+    bucket_insert(rec);
+    ++m_used;
+    ++demux->numOfSessions;
 }
 
-void XTDemuxMan::del_session(rv_handler_s *hrv)
+void XTDemuxMan::del_session(rv_handler_s *hrv, uint32_t multid)
 {
     boost::unique_lock<boost::recursive_mutex> lock(m_mutex);
 
@@ -173,45 +276,40 @@ void XTDemuxMan::del_session(rv_handler_s *hrv)
         return;
     }
 
-    std::vector<_XTDemux*>::iterator itr = m_vecDemux.begin();
-    for (;itr != m_vecDemux.end();++itr)
-    {
-        _XTDemux* demux = *itr;
-        if (!demux)
-        {
-            continue;
-        }
+    //ͬö˿ڵmultiplexIDͬӾ
+    uint32_t mask = (uint32_t)m_buckets.size() - 1;
+    uint32_t pos = hash_multid(multid) & mask;
 
-        for (int nS = 0;nS < MAX_NUM_SESSIONS;++nS)
+    ++m_lookups;
+    while (EMPTY_BUCKET != m_buckets[pos])
+    {
+        uint32_t rec = m_buckets[pos];
+        _XTDemuxSession &s = m_records[rec];
+        if (s.multid == multid && s.handle.hrtp == hrv->hrtp)
         {
-            rv_handler_s &handle = demux->subHandle[nS];
-            if (handle.hrtp == hrv->hrtp)
+            if (s.demux && s.demux->numOfSessions > 0)
             {
-                ::memset(&handle, 0, sizeof(rv_handler_s));
-                break;
+                --s.demux->numOfSessions;
             }
+            free_record(rec);
+            bucket_erase(pos);
+            --m_used;
+            return;
         }
+
+        ++m_collisions;
+        pos = (pos + 1) & mask;
     }
 }
 
 int XTDemuxMan::get_session(_XTDemux* demux)
 {
-    int num = 0;
     if (!demux)
     {
         return 0;
     }
 
-    for (int nS = 0;nS < MAX_NUM_SESSIONS;++nS)
-    {
-        rv_handler_s &handle = demux->subHandle[nS];
-        if (handle.hrtp)
-        {
-            num++;
-        }
-    }
-
-    return num;
+    return demux->numOfSessions;
 }
 
 bool XTDemuxMan::open_session(rv_session_descriptor *descriptor, uint32_t *multiplexID, rv_handler_s *hrv)
@@ -250,21 +348,56 @@ bool XTDemuxMan::open_session(rv_session_descriptor *descriptor, uint32_t *multi
         ret = ::open_demux_session(descriptor, demux->demux, multiplexID, hrv);
         if (ret)
         {
-            add_session(demux, hrv);
+            add_session(demux, *multiplexID, hrv);
         }
     }
 
+    if (!ret)
+    {
+        ++m_open_fails;
+    }
+
     return ret;
 }
 
-void XTDemuxMan::close_session(rv_handler_s *hrv)
+void XTDemuxMan::close_session(rv_handler_s *hrv, uint32_t multiplexID)
 {
     if (!hrv)
     {
         return;
     }
 
-    del_session(hrv);
+    del_session(hrv, multiplexID);
 
     ::close_demux_session(hrv);
 }
+
+void XTDemuxMan::get_stats(xt_demux_stats &stats)
+{
+    boost::unique_lock<boost::recursive_mutex> lock(m_mutex);
+
+    stats.sessions = m_used;
+    stats.buckets = (uint32_t)m_buckets.size();
+    stats.lookups = m_lookups;
+    stats.collisions = m_collisions;
+    stats.open_fails = m_open_fails;
+
+    //̽밴ɨ
+    uint32_t mask = stats.buckets - 1;
+    stats.max_probe = 0;
+    for (uint32_t pos = 0;pos < stats.buckets;++pos)
+    {
+        uint32_t rec = m_buckets[pos];
+        if (EMPTY_BUCKET == rec)
+        {
+            continue;
+        }
+
+        uint32_t home = hash_multid(m_records[rec].multid) & mask;
+        uint32_t probe = (pos - home) & mask;
+        if (probe > stats.max_probe)
+        {
+            stats.max_probe = probe;
+        }
+    }
+}
@@ -1,23 +1,35 @@
 #pragma once
 
 #include <vector>
+#include <stdint.h>
 #include <../rv_adapter/rv_def.h>
+#include "xt_mp_caster_def.h"
 #include <boost/thread/recursive_mutex.hpp>
 
 using namespace std;
 
-#define MAX_NUM_SESSIONS 1024 //ûỰ
+#define MAX_NUM_SESSIONS (1 << 20) //ö˿ڻỰ(ЭջmultiplexID20λ±һ)
 
 // Ϣ
 struct _XTDemux
 {
     void* demux;								//þ
-    int numOfSessions;							//ûỰ
+    int numOfSessions;							//øûỰ
+    int maxSessions;							//ûỰ
     rv_handler_s handle;						//ûỰ
-    rv_handler_s subHandle[MAX_NUM_SESSIONS];	//ûỰӾ
     rv_handler_s bindHandle;					//ûỰӾ(ֹdemuxͷ)
     rv_net_address addr;						//󶨵ַ
 };
+
+// ûỰ¼
+struct _XTDemuxSession
+{
+    uint32_t multid;							//ID
+    _XTDemux *demux;							//
+    rv_handler_s handle;						//ûỰӾ
+    uint32_t next_free;							//һ
+};
+
 class XTDemuxMan
 {
 private:
@@ -31,10 +43,20 @@ private:
     void delete_demux(_XTDemux *demux);
 
     _XTDemux* get_demux();
-    void add_session(_XTDemux *demux, rv_handler_s *hrv);
-    void del_session(rv_handler_s *hrv);
+    void add_session(_XTDemux *demux, uint32_t multid, rv_handler_s *hrv);
+    void del_session(rv_handler_s *hrv, uint32_t multid);
     int get_session(_XTDemux* demux);
 
+    // Ự¼()
+    uint32_t alloc_record();
+    void free_record(uint32_t rec);
+
+    // ϣ(̽⣬ɾʱ)
+    static uint32_t hash_multid(uint32_t multid);
+    void bucket_insert(uint32_t rec);
+    void bucket_erase(uint32_t pos);
+    void bucket_grow();
+
 public:
     static XTDemuxMan* instance(){return &m_self;}
 
@@ -42,12 +64,27 @@ public:
     void uninit();
 
     bool open_session(rv_session_descriptor *descriptor, uint32_t *multiplexID, rv_handler_s *hrv);
-    void close_session(rv_handler_s *hrv);
+    void close_session(rv_handler_s *hrv, uint32_t multiplexID);
+
+    void get_stats(xt_demux_stats &stats);
 
 private:
     // Ϣ
     std::vector<_XTDemux*> m_vecDemux;
 
+    // Ự¼أm_free_headΪͷ
+    std::vector<_XTDemuxSession> m_records;
+    uint32_t m_free_head;
+
+    // ID->Ự¼±꣬ͰΪEMPTY_BUCKETͰΪ2
+    std::vector<uint32_t> m_buckets;
+    uint32_t m_used;
+
+    // ͳ
+    uint64_t m_lookups;
+    uint64_t m_collisions;
+    uint64_t m_open_fails;
+
     // mutex
     boost::recursive_mutex m_mutex;
 
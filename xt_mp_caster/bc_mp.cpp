@@ -62,7 +62,12 @@ namespace xt_mp_caster
         m_active(false),
         m_last_pesudo_ts(0),
         m_last_pesudo_rtp_ts(0),
-        m_last_frame_in_rtp_sn(0)
+        m_last_frame_in_rtp_sn(0),
+        m_ps_muxer(),
+        m_ps_audio_valid(false),
+        m_ps_audio_ts(0),
+        m_ps_audio_ticks(0),
+        m_ps_g711_type(PS_STREAM_G711A)
 #ifdef _USE_RTP_SEND_CONTROLLER
         ,m_bitrate_controller()
         ,m_network_changed_callback(NULL)
@@ -82,6 +87,8 @@ namespace xt_mp_caster
         m_active = false;
         m_bReady = false;
         m_last_pesudo_ts = 0;
+        m_ps_muxer.reset();
+        m_ps_audio_valid = false;
     }
 
     void bc_mp::recycle_release_event()
@@ -99,6 +106,14 @@ namespace xt_mp_caster
 #endif
         nRTP_MAX_SIZE = nRTP_MAX_SIZE>256 ? nRTP_MAX_SIZE:1400;
 
+        //G711A/֡в(ΪOV_G711)õRTP̬ѡȱʡPCMA
+#ifdef _ANDROID
+        int g711_payload = xt_config::router_module::get<int>("config.caster_cfg.ps_g711_payload", 8);
+#else
+        int g711_payload = config::_()->ps_g711_payload(8);
+#endif
+        m_ps_g711_type = (0 == g711_payload) ? PS_STREAM_G711U : PS_STREAM_G711A;
+
 #ifdef _USE_RTP_SEND_CONTROLLER
 #ifdef _ANDROID
         uint32_t start_bitrate = xt_config::router_module::get<uint32_t>("config.caster_cfg.bitrate_controller.start_bitrate", 8 * 1024 * 1024 * 8);
@@ -477,7 +492,12 @@ namespace xt_mp_caster
                 SHeader head;
                 int len = sizeof(SHeader);
                 ::memcpy(&head, frame, len);
-                if (info.frametype==OV_AAC)
+                if (PS_RTP_STREAM == info.streamtype &&
+                    (OV_AAC == info.frametype || OV_H265 == info.frametype || OV_G711 == info.frametype))
+                {
+                    return pump_frame_in_ps(hmssrc, frame+LEN_XTHEAD, framesize-LEN_XTHEAD, head.uTimeStamp, framePayload, info.frametype, priority, use_ssrc, ssrc);
+                }
+                else if (info.frametype==OV_AAC)
                 {
                     return pump_frame_in_aac(hmssrc, frame+LEN_XTHEAD, framesize-LEN_XTHEAD, head.uTimeStamp, framePayload,priority,use_ssrc,ssrc);
                 }
@@ -554,7 +574,7 @@ namespace xt_mp_caster
             uint32_t pack_nums = m_rtp_pool.calc_slice_nums(
                 framesize,
                 nRTP_MAX_SIZE, //MP_PSEUDO_RTP_MAX_SIZE,
-                MP_PSEUDO_RTP_HEAD_SIZE);
+                MP_PSEUDO_RTP_PAYLOAD_OFFSET);
             bRet = m_rtp_pool.try_alloc_any_items(mrtp, pack_nums, false);
             if (!bRet)
             {
@@ -564,7 +584,7 @@ namespace xt_mp_caster
 
             mrtp->m_bFrameInfo = true;
             ::memcpy(&mrtp->m_infoFrame, &info, sizeof(XTFrameInfo));
-            bRet = mrtp->write(frame, framesize, nRTP_MAX_SIZE/*MP_PSEUDO_RTP_MAX_SIZE*/, MP_PSEUDO_RTP_HEAD_SIZE);
+            bRet = mrtp->write(frame, framesize, nRTP_MAX_SIZE/*MP_PSEUDO_RTP_MAX_SIZE*/, MP_PSEUDO_RTP_PAYLOAD_OFFSET);
             if (!bRet)
             {
                 mrtp->release();
@@ -575,7 +595,7 @@ namespace xt_mp_caster
             rv_rtp_param rtp_param;
             ::construct_rv_rtp_param(&rtp_param);
             
-            rtp_param.sByte = MP_PSEUDO_RTP_HEAD_SIZE;
+            rtp_param.sByte = MP_PSEUDO_RTP_PAYLOAD_OFFSET;
             //ṩⲿsequenceNumber
             rtp_param.sequenceNumber = m_last_frame_in_rtp_sn;
             m_last_frame_in_rtp_sn += pack_nums;
@@ -695,7 +715,7 @@ namespace xt_mp_caster
         rv_rtp_param rtp_param;
         ::construct_rv_rtp_param(&rtp_param);
         
-        rtp_param.sByte = MP_PSEUDO_RTP_HEAD_SIZE;
+        rtp_param.sByte = MP_PSEUDO_RTP_PAYLOAD_OFFSET;
 
         //ṩⲿsequenceNumber
         rtp_param.sequenceNumber = m_last_frame_in_rtp_sn;
@@ -728,7 +748,7 @@ namespace xt_mp_caster
             return false;
         }
 
-        uint32_t maxPayload = mtu - MP_PSEUDO_RTP_HEAD_SIZE;
+        uint32_t maxPayload = mtu - MP_PSEUDO_RTP_PAYLOAD_OFFSET;
         uint32_t len = framesize;
         uint8_t *data = frame;
         uint8_t off = 0;
@@ -752,7 +772,7 @@ namespace xt_mp_caster
 
             memcpy(packet + AU_HEADER_SIZE, data + off, maxPayload);
 
-            rtp->write(packet, framesize+AU_HEADER_SIZE, MP_PSEUDO_RTP_HEAD_SIZE);
+            rtp->write(packet, framesize+AU_HEADER_SIZE, MP_PSEUDO_RTP_PAYLOAD_OFFSET);
 
             mrtp->push_byte_block(rtp);
             rtp->release();
@@ -773,7 +793,7 @@ namespace xt_mp_caster
 
             memcpy(packet + AU_HEADER_SIZE, data + off, len);
 
-            rtp->write(packet, framesize+AU_HEADER_SIZE, MP_PSEUDO_RTP_HEAD_SIZE);
+            rtp->write(packet, framesize+AU_HEADER_SIZE, MP_PSEUDO_RTP_PAYLOAD_OFFSET);
 
             mrtp->push_byte_block(rtp);
             rtp->release();
@@ -834,7 +854,7 @@ namespace xt_mp_caster
         else if(stream_mode == MP_PS_MODE)
         {
             // 
-            ret = frame_unpack_ps(mrtp, frame, framesize, nRTP_MAX_SIZE, frameTS);
+            ret = frame_unpack_ps(mrtp, frame, framesize, nRTP_MAX_SIZE, OV_H264, frameTS);
         }
 
         if (!ret)
@@ -851,7 +871,7 @@ namespace xt_mp_caster
 
         ::construct_rv_rtp_param(&rtp_param);
 
-        rtp_param.sByte = MP_PSEUDO_RTP_HEAD_SIZE;
+        rtp_param.sByte = MP_PSEUDO_RTP_PAYLOAD_OFFSET;
 
         //ṩⲿsequenceNumber
         rtp_param.sequenceNumber = m_last_frame_in_rtp_sn;
@@ -877,58 +897,16 @@ namespace xt_mp_caster
         return bRet;
     }
 
-    mp_bool bc_mp::pes_unpack_rtp(rtp_mblock *mrtp, uint8_t *pes_slice, uint32_t slice_size, uint32_t mtu, uint32_t frameTS)
-    {
-        if (!mrtp || !pes_slice)
-        {
-            return false;
-        }
-
-        if (slice_size == 0)
-        {
-            return false;
-        }
-
-        int nSize = 0;
-        int offset = 0;
-        uint8_t *buffer = pes_slice;
-        int maxPayload = mtu - RTP_HDR_LEN;
-
-        while(slice_size > 0)
-        {
-            nSize = ((slice_size>maxPayload)?maxPayload:slice_size);
-
-            rtp_block *rtp = m_rtp_pool.force_alloc_any();
-            if (!rtp)
-            {
-                return false;
-            }
-
-            rtp->assign();
-            rtp->m_bFrameInfo = false;
-
-            rtp->write(buffer+offset, nSize, MP_PSEUDO_RTP_HEAD_SIZE);
-            mrtp->push_byte_block(rtp);
-            rtp->release();
-
-            offset +=nSize;
-            slice_size -= nSize;
-
-        }
-        return true;
- 
-    }
-
-    mp_bool bc_mp::pump_frame_h264_to_ps(		
+    mp_bool bc_mp::pump_frame_in_ps(
         MP_IN mssrc *hmssrc,			//Ŀmssrc
         MP_IN uint8_t *frame,			//֡(ȥ˽ͷ)
         MP_IN uint32_t framesize,		//֡
-        MP_IN uint32_t frameTS,			//ʱ(˽ͷ)			  
+        MP_IN uint32_t frameTS,			//ʱ(˽ͷ)
         MP_IN uint8_t  framePayload,    // 96
+        MP_IN uint32_t frametype,       // OV_H264/OV_H265/OV_G711/OV_AAC
         MP_IN uint8_t priority,
-        MP_IN uint8_t stream_mode,
         MP_IN bool use_ssrc,
-        MP_IN uint32_t ssrc)	
+        MP_IN uint32_t ssrc)
     {
         bool bRet = true;
 
@@ -942,8 +920,8 @@ namespace xt_mp_caster
             return false;
         }
 
-        //˹ע
-        if (0 == static_cast<msink_rv_rtp *>(m_msinks.front())->get_viewer())
+        //޷Ͷ˻˹ע
+        if (m_msinks.empty() || 0 == static_cast<msink_rv_rtp *>(m_msinks.front())->get_viewer())
         {
             return false;
         }
@@ -955,122 +933,40 @@ namespace xt_mp_caster
             //Է䷽ʽm_mrtp_pool̬չ
             mrtp = static_cast<rtp_mblock *>(
                 tghelper::recycle_pool_build_item<rtp_mblock>(&m_mrtp_pool, false));
-
         }
 
         mrtp->assign();
         mrtp->m_bFrameInfo = false;
 
-
-        static uint32_t maxPayload;
-        static int  nSizePos=0;
-
-        static char temp[65536];
-        static char Pos = 0;
-
-        uint8_t *first_frame_char = frame;
-
-        //ȥ0010001
-        while (('\0' == *first_frame_char) && (framesize > 0))
+        //PSRTPʱͳһΪ90kHzƵʱڴ˻
+        if (!frame_unpack_ps(mrtp, frame, framesize, nRTP_MAX_SIZE, frametype, frameTS))
         {
-            first_frame_char++;
-        }
-
-        if (('\1' == *first_frame_char) && (framesize > 0))
-        {
-            first_frame_char++;
-        }
-
-        uint32_t nal = *first_frame_char;
-        uint8_t naltype = nal & 0x1f;
-
-        if(is_NALU_SPS(naltype) || is_NALU_PPS(naltype) || is_NALU_SEI(naltype))
-        {
-            printf("naltpye : [%d]\n",naltype);
-            memcpy(temp+PS_I_ALL_LEN+Pos,frame,framesize);
-            Pos += framesize;
-            return true;
-        }
-        else if(is_NALU_IDR(naltype))
-        {
-
-            // 1 package for ps header   
-            gb28181_make_ps_header(temp + nSizePos, (unsigned long long)frameTS);  
-            nSizePos += PS_HDR_LEN;
-
-            // I֡Ļϵͳͷ  
-            gb28181_make_sys_header(temp + nSizePos);  
-            nSizePos += SYS_HDR_LEN;
-
-            // psmͷ (Ҳmap)  
-            gb28181_make_psm_header(temp + nSizePos);  
-            nSizePos += PSM_HDR_LEN;
-
+            mrtp->release();
+            return false;
         }
-		else
-		{
-            // 1 package for ps header   
-            gb28181_make_ps_header(temp + nSizePos, (unsigned long long)frameTS);  
-            nSizePos += PS_HDR_LEN;			
-			
-		}
-
-		maxPayload = PS_PES_PAYLOAD_SIZE - nSizePos - PES_HDR_LEN - Pos;
-		int nSize = 0;
-		uint32_t offset = 0;
-		uint32_t start = 1;
-
-		while(framesize > 0)
-		{
-			if(start = 0)
-			{
-				nSizePos = 0;
-				Pos = 0;
-				maxPayload = PS_PES_PAYLOAD_SIZE - PES_HDR_LEN;
-			}
-			nSize = ((framesize>maxPayload)?maxPayload:framesize);
-			
-			// pesͷ  
-			gb28181_make_pes_header(temp+nSizePos, 0xE0, nSize, 
-									(unsigned long long)frameTS, (unsigned long long)frameTS);
-			nSizePos += PES_HDR_LEN;
-
-			memcpy(temp+nSizePos+Pos,frame+offset,nSize);
-			pes_unpack_rtp(mrtp, (uint8_t *)temp, nSize+nSizePos+Pos, nRTP_MAX_SIZE, frameTS);
-
-			offset += nSize;
-			framesize -= nSize;
-			start = 0;
-
-		}
-
-		nSizePos = 0;
-		Pos = 0;		
-
 
         int pack_nums = mrtp->get_container().size();
-        printf("get rtp pack num :[%d]\n",pack_nums);
 
         //αrtpͷϢ
         rv_rtp_param rtp_param;
         ::construct_rv_rtp_param(&rtp_param);
-        rtp_param.sByte = MP_PSEUDO_RTP_HEAD_SIZE;
+        rtp_param.sByte = MP_PSEUDO_RTP_PAYLOAD_OFFSET;
 
         //ṩⲿsequenceNumber
         rtp_param.sequenceNumber = m_last_frame_in_rtp_sn;
         m_last_frame_in_rtp_sn += pack_nums;
         rtp_param.payload = framePayload;
-
-        //ϳڲʱʽ
         rtp_param.timestamp = frameTS;
 
         mrtp->set_rtp_param(&rtp_param);
         mrtp->m_priority = priority;
         mrtp->m_use_ssrc = use_ssrc;
         mrtp->m_ssrc = ssrc;
+#ifdef USE_POST_TASK
         bRet = static_cast<mssrc_frame *>(hmssrc)->pump_frame_in(mrtp);
-
-        mrtp->release();
+#else
+        bRet = static_cast<mssrc_frame *>(hmssrc)->pump_frames_out(static_cast<msink_rv_rtp *>(m_msinks.front()),mrtp,0xFFFFFFFF);
+#endif
 
         return bRet;
     }
@@ -1128,7 +1024,7 @@ namespace xt_mp_caster
             rv_rtp_param rtp_param;
             ::construct_rv_rtp_param(&rtp_param);
 
-            rtp_param.sByte = MP_PSEUDO_RTP_HEAD_SIZE;
+            rtp_param.sByte = MP_PSEUDO_RTP_PAYLOAD_OFFSET;
 
             //ṩⲿsequenceNumber
             rtp_param.sequenceNumber = m_last_frame_in_rtp_sn;
@@ -1172,7 +1068,7 @@ namespace xt_mp_caster
             return false;
         }
 
-        uint32_t maxPayload = mtu - MP_PSEUDO_RTP_HEAD_SIZE;
+        uint32_t maxPayload = mtu - MP_PSEUDO_RTP_PAYLOAD_OFFSET;
 
 		//ȥ0010001
 		while (('\0' == *frame) && (framesize > 0))
@@ -1198,7 +1094,7 @@ namespace xt_mp_caster
 
             rtp->assign();
             rtp->m_bFrameInfo = false;
-            rtp->write(frame, framesize, MP_PSEUDO_RTP_HEAD_SIZE);
+            rtp->write(frame, framesize, MP_PSEUDO_RTP_PAYLOAD_OFFSET);
             mrtp->push_byte_block(rtp);
             //rtp->release();
         }
@@ -1208,7 +1104,7 @@ namespace xt_mp_caster
             frame++;
             framesize--;
 
-            maxPayload = mtu - MP_PSEUDO_RTP_HEAD_SIZE - H264HEADERSIZE;
+            maxPayload = mtu - MP_PSEUDO_RTP_PAYLOAD_OFFSET - H264HEADERSIZE;
 
             uint32_t start = 1;          /* Start value used for FU header     */
             uint32_t end   = 0;          /* End value used for FU header       */
@@ -1236,7 +1132,7 @@ namespace xt_mp_caster
                 {
                     rtp->assign();
                     rtp->m_bFrameInfo = false;
-                    rtp->write(data, rtpPayload+H264HEADERSIZE, MP_PSEUDO_RTP_HEAD_SIZE);
+                    rtp->write(data, rtpPayload+H264HEADERSIZE, MP_PSEUDO_RTP_PAYLOAD_OFFSET);
 
                     mrtp->push_byte_block(rtp);
                     //rtp->release();
@@ -1251,128 +1147,117 @@ namespace xt_mp_caster
         return true;
     }
 
-    mp_bool bc_mp::frame_unpack_ps(rtp_mblock *mrtp, uint8_t *frame, uint32_t framesize, uint32_t mtu, uint32_t frameTS)
+    //PSƬֱдrtp_blockм֡
+    class rtp_ps_sink : public ps_slice_sink
     {
-        if (!mrtp || !frame)
+    public:
+        rtp_ps_sink(inner::rtp_pool &pool, rtp_mblock *mrtp, uint32_t mtu)
+            : m_pool(pool), m_mrtp(mrtp), m_mtu(mtu), m_rtp(NULL)
         {
-            return false;
         }
 
-        if (framesize < 5)
+        virtual ~rtp_ps_sink()
         {
-            return false;
+            //װ;ʧʱδύķƬ
+            if (m_rtp)
+            {
+                m_rtp->release();
+            }
         }
 
-        static uint32_t maxPayload;
-        static int  nSizePos=0;
-
-        static char temp[4096];
-        static char Pos = 0;
+        virtual uint8_t *alloc_slice(uint32_t &capacity)
+        {
+            m_rtp = m_pool.force_alloc_any();
+            if (!m_rtp)
+            {
+                return NULL;
+            }
 
-        uint8_t *first_frame_char = frame;
+            m_rtp->assign();
+            m_rtp->m_bFrameInfo = false;
 
-        //ȥ0010001
-        while (('\0' == *temp) && (framesize > 0))
-        {
-            first_frame_char++;
+            //ְ·һ£mtu۳αRTPͷչͷԤ
+            capacity = m_mtu - MP_PSEUDO_RTP_PAYLOAD_OFFSET;
+            if (capacity + MP_PSEUDO_RTP_PAYLOAD_OFFSET > m_rtp->size())
+            {
+                capacity = m_rtp->size() - MP_PSEUDO_RTP_PAYLOAD_OFFSET;
+            }
+            return m_rtp->get_raw() + MP_PSEUDO_RTP_PAYLOAD_OFFSET;
         }
 
-        if (('\1' == *temp) && (framesize > 0))
+        virtual bool commit_slice(uint32_t size)
         {
-            first_frame_char++;
-        }
-
-        uint32_t nal = *first_frame_char;
-        uint8_t naltype = nal & 0x1f;
+            if (!m_rtp)
+            {
+                return false;
+            }
 
-        if(is_NALU_SPS(naltype) || is_NALU_PPS(naltype) || is_NALU_SEI(naltype))
-        {
-            memcpy(temp+PS_I_ALL_LEN+Pos,frame,framesize);
-            Pos += framesize;
+            m_rtp->set_params(size, MP_PSEUDO_RTP_PAYLOAD_OFFSET);
+            m_mrtp->push_byte_block(m_rtp);
+            m_rtp->release();
+            m_rtp = NULL;
             return true;
         }
-        else if(is_NALU_IDR(naltype))
-        {
 
-            // 1 package for ps header   
-            gb28181_make_ps_header(temp + nSizePos, (unsigned long long)frameTS);  
-            nSizePos += PS_HDR_LEN;
+    private:
+        inner::rtp_pool &m_pool;
+        rtp_mblock *m_mrtp;
+        uint32_t m_mtu;
+        rtp_block *m_rtp;
+    };
 
-            // I֡Ļϵͳͷ  
-            gb28181_make_sys_header(temp + nSizePos);  
-            nSizePos += SYS_HDR_LEN;
-
-            // psmͷ (Ҳmap)  
-            gb28181_make_psm_header(temp + nSizePos);  
-            nSizePos += PSM_HDR_LEN;
+    mp_bool bc_mp::frame_unpack_ps(rtp_mblock *mrtp, uint8_t *frame, uint32_t framesize, uint32_t mtu, uint32_t frametype, uint32_t &frameTS)
+    {
+        if (!mrtp || !frame || 0 == framesize)
+        {
+            return false;
+        }
 
-            maxPayload = mtu - RTP_HDR_LEN - nSizePos - PES_HDR_LEN - Pos;
+        rtp_ps_sink sink(m_rtp_pool, mrtp, mtu);
 
+        if (OV_H264 == frametype || OV_H265 == frametype)
+        {
+            uint8_t stream_type = (OV_H265 == frametype) ? PS_STREAM_H265 : PS_STREAM_H264;
+            return m_ps_muxer.mux_video(&sink, stream_type, frame, framesize, frameTS);
         }
 
-        if (framesize <= maxPayload)
+        uint32_t clock = 8000;
+        uint8_t stream_type = m_ps_g711_type;
+        if (OV_AAC == frametype)
         {
-            //ÿ֡ĳȲҪshortͣ˾͵÷Ƭѭз  
-           // nSize = (nFrameLen > PS_PES_PAYLOAD_SIZE) ? PS_PES_PAYLOAD_SIZE : nFrameLen;  
-            // pesͷ  
-            //(pPacker->s64CurPts / 100), (pPacker->s64CurPts/300)
-            gb28181_make_pes_header(temp+nSizePos, 0xE0, framesize+Pos, (unsigned long long)frameTS, (unsigned long long)frameTS);
-            nSizePos += PES_HDR_LEN;
-
-            memcpy(temp+nSizePos+Pos, frame, framesize);
-
-            rtp_block *rtp = m_rtp_pool.force_alloc_any();
-            if (!rtp)
+            //ȡADTSͷADTSʱȱʡ8kHz
+            static const uint32_t aac_rates[16] = {96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050,
+                16000, 12000, 11025, 8000, 7350, 8000, 8000, 8000};
+            stream_type = PS_STREAM_AAC;
+            if (framesize >= 7 && 0xFF == frame[0] && 0xF0 == (frame[1] & 0xF0))
             {
-                return false;
+                clock = aac_rates[(frame[2] >> 2) & 0x0F];
             }
+        }
+        else if (OV_G711 != frametype)
+        {
+            return false;
+        }
 
-            rtp->assign();
-            rtp->m_bFrameInfo = false;
-
-            rtp->write(temp, framesize+Pos+nSizePos, MP_PSEUDO_RTP_HEAD_SIZE);
-            mrtp->push_byte_block(rtp);
-            rtp->release();
+        //ۼԭʼʱӣ32λʱ֡Ư
+        if (!m_ps_audio_valid)
+        {
+            m_ps_audio_valid = true;
+            m_ps_audio_ticks = frameTS;
         }
         else
         {
-            uint32_t start = 1;          /* Start value used for FU header     */
-            uint32_t end   = 0;          /* End value used for FU header       */
-            uint32_t offset = 0;
-
-            while (end == 0)
-            {
-                if(!start)
-                {
-                    nSizePos = 0;
-                    Pos = 0;
-                    maxPayload = mtu - MP_PSEUDO_RTP_HEAD_SIZE - PES_HDR_LEN;
-                }
-
-                uint32_t rtpPayload = maxPayload < framesize ? maxPayload : framesize;
-                if (framesize == rtpPayload)
-                    end = 1;
-
-                gb28181_make_pes_header(temp + nSizePos, 0xE0, rtpPayload, (unsigned long long)frameTS, (unsigned long long)frameTS);
-                nSizePos += PES_HDR_LEN;
-                ::memcpy(temp + nSizePos + Pos, frame+offset, rtpPayload);
-
-                rtp_block *rtp = m_rtp_pool.force_alloc_any();
-                if (rtp)
-                {
-                    rtp->assign();
-                    rtp->m_bFrameInfo = false;
-                    rtp->write(temp, rtpPayload + nSizePos + Pos, MP_PSEUDO_RTP_HEAD_SIZE);
-                    mrtp->push_byte_block(rtp);
-                    rtp->release();
-                }
+            m_ps_audio_ticks += (uint32_t)(frameTS - m_ps_audio_ts);
+        }
+        m_ps_audio_ts = frameTS;
 
-                framesize -= rtpPayload;
-                offset   += rtpPayload;
-                start    = 0;
-            }
+        uint64_t pts = m_ps_audio_ticks * 90000 / clock;
+        if (!m_ps_muxer.mux_audio(&sink, stream_type, frame, framesize, pts))
+        {
+            return false;
         }
 
+        frameTS = (uint32_t)pts;
         return true;
     }
 
@@ -1394,7 +1279,7 @@ namespace xt_mp_caster
             framesize--;
         }
 
-        int max_payload_size = mtu - MP_PSEUDO_RTP_HEAD_SIZE;
+        int max_payload_size = mtu - MP_PSEUDO_RTP_PAYLOAD_OFFSET;
         const uint8_t *buf = frame;
         int len = framesize;
         int rtp_payload_size = max_payload_size - RTP_HEVC_HEADERS_SIZE;
@@ -1412,7 +1297,7 @@ namespace xt_mp_caster
                 rtp->assign();
                 rtp->m_bFrameInfo = false;
 
-                rtp->write(buf, len, MP_PSEUDO_RTP_HEAD_SIZE);
+                rtp->write(buf, len, MP_PSEUDO_RTP_PAYLOAD_OFFSET);
                 mrtp->push_byte_block(rtp);
                 rtp->release();
             }
@@ -1467,7 +1352,7 @@ namespace xt_mp_caster
                 {
                     rtp->assign();
                     rtp->m_bFrameInfo = false;
-                    rtp->write(send_data,max_payload_size, MP_PSEUDO_RTP_HEAD_SIZE);
+                    rtp->write(send_data,max_payload_size, MP_PSEUDO_RTP_PAYLOAD_OFFSET);
                     mrtp->push_byte_block(rtp);
                     rtp->release();
                 }
@@ -1496,7 +1381,7 @@ namespace xt_mp_caster
             {
                 rtp->assign();
                 rtp->m_bFrameInfo = false;
-                rtp->write(send_data, len+RTP_HEVC_HEADERS_SIZE, MP_PSEUDO_RTP_HEAD_SIZE);
+                rtp->write(send_data, len+RTP_HEVC_HEADERS_SIZE, MP_PSEUDO_RTP_PAYLOAD_OFFSET);
                 mrtp->push_byte_block(rtp);
                 rtp->release();
             }
@@ -14,6 +14,7 @@
 #include "mssrc_rtp.h"
 #include "msink_rv_rtp.h"
 #include "rtp_packet_block.h"
+#include "mp_28181_ps.h"
 #ifdef _USE_RTP_SEND_CONTROLLER
 #include "send_side_controller.h"
 #include "xt_mp_caster_api.h"
@@ -108,17 +109,18 @@ namespace xt_mp_caster
 
 		mp_bool frame_unpack(rtp_mblock *mrtp, uint8_t *frame, uint32_t framesize, uint32_t mtu,MP_IN uint32_t frameTS,			//ʱ(˽ͷ)			  
 			MP_IN uint8_t  framePayload);
-        mp_bool frame_unpack_ps(rtp_mblock *mrtp, uint8_t *frame, uint32_t framesize, uint32_t mtu, uint32_t frameTS);
-        mp_bool pes_unpack_rtp(rtp_mblock *mrtp, uint8_t *pes_slice, uint32_t slice_size, uint32_t mtu, uint32_t frameTS);
+        mp_bool frame_unpack_ps(rtp_mblock *mrtp, uint8_t *frame, uint32_t framesize, uint32_t mtu, uint32_t frametype, uint32_t &frameTS);
         mp_bool frame_unpack_hevc(rtp_mblock *mrtp, uint8_t *frame, uint32_t framesize, uint32_t mtu);
-        mp_bool pump_frame_h264_to_ps(		
+
+        //PSװ֧ͣH264/H265/G711/AAC
+        mp_bool pump_frame_in_ps(
             MP_IN mssrc *hmssrc,			//Ŀmssrc
             MP_IN uint8_t *frame,			//֡(ȥ˽ͷ)
             MP_IN uint32_t framesize,		//֡
-            MP_IN uint32_t frameTS,			//ʱ(˽ͷ)			  
+            MP_IN uint32_t frameTS,			//ʱ(˽ͷ)
             MP_IN uint8_t  framePayload,    // 96
+            MP_IN uint32_t frametype,       // OV_H264/OV_H265/OV_G711/OV_AAC
             MP_IN uint8_t priority,
-            MP_IN uint8_t stream_mode,
             MP_IN bool use_ssrc,
             MP_IN uint32_t ssrc);
 
@@ -159,6 +161,13 @@ namespace xt_mp_caster
         uint32_t m_last_pesudo_rtp_ts;
         uint16_t m_last_frame_in_rtp_sn;
 
+        //PSװƵʱۼƺ㵽90kHz
+        mp_28181_ps m_ps_muxer;
+        bool m_ps_audio_valid;
+        uint32_t m_ps_audio_ts;
+        uint64_t m_ps_audio_ticks;
+        uint8_t m_ps_g711_type;		//G711ƵPSM(A/)
+
 #ifdef _USE_RTP_SEND_CONTROLLER
         std::auto_ptr<bitrate_controller_t> m_bitrate_controller;
         mp_network_changed_callback_t m_network_changed_callback;
@@ -104,6 +104,11 @@ uint32_t config::max_rtcp_priod_thr(const uint32_t val_default)
     return get_node_value<uint32_t>(val_default,"max_rtcp_priod_thr");
 }
 
+int config::ps_g711_payload(const int val_default)
+{
+    return get_node_value<int>(val_default,"ps_g711_payload");
+}
+
 int config::logLevel(const int val_default)
 {
     return get_node_value<int>(val_default,"logLevel");
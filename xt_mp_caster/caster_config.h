@@ -69,6 +69,8 @@ public:
     uint32_t max_bitrate(const uint32_t val_default);
     uint32_t max_rtt_thr(const uint32_t val_default);
     uint32_t max_rtcp_priod_thr(const uint32_t val_default);
+    //<!--PSG711ƵRTP̬ 8:PCMA 0:PCMU-->
+    int ps_g711_payload(const int val_default);
 
 public:
     int logLevel(const int val_default);
@@ -211,6 +211,25 @@ namespace xt_mp_caster
             }
         }
         inline byte_block *get_bind_block() { return m_bind_block; }
+
+        //RTPͷչͷЭջsByteǰд˴֤sByteǰԤռ㹻
+        //طƬİԤMP_PSEUDO_RTP_EXT_HEADROOMתⲿRTPԤʱźƸ
+        bool reserve_rtp_head()
+        {
+            byte_block *data = m_bind_block ? m_bind_block : this;
+            uint32_t sbyte = (uint32_t)m_rtp_param.sByte;
+            if (sbyte > data->payload_totalsize()) return false;
+            uint32_t head = MP_PSEUDO_RTP_HEAD_SIZE;
+            if (m_rtp_param.extensionBit)
+            {
+                head += 4 + (m_rtp_param.extensionLength << 2);
+            }
+            data->set_params(data->payload_totalsize() - sbyte, sbyte);
+            if (!data->reserve_headroom(head)) return false;
+            m_rtp_param.sByte = data->payload_offset();
+            set_params(data->payload_size(), data->payload_offset());
+            return true;
+        }
     public:
         rv_rtp_param m_rtp_param;
 
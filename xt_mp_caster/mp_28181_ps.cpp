@@ -1,308 +1,441 @@
 
-//#include <iostream>
 #include <stdio.h>
 #include <string.h>
 #include "mp_28181_ps.h"
-//using namespace std;
 
-#if 0
-int main(void)
+//ƵطϵͳͷPSMļ
+#define PS_AUDIO_PSM_INTERVAL 50
+
+bool is_Iframe(unsigned char nal_type)
+{
+    return ((NALU_IDR == nal_type) || (NALU_SEI == nal_type) || (NALU_SPS == nal_type) || (NALU_PPS == nal_type));
+}
+
+bool is_NALU_SPS(unsigned char nal_type)
 {
-    unsigned char pData[4*1024];
+    return (NALU_SPS == nal_type);
+}
 
-    bits_buffer_s   bitsBuffer;  
-    bitsBuffer.i_size = PS_HDR_LEN;   
-    bitsBuffer.i_data = 0;  
-    // ƣ10000000 Ϊ˺һֽڵÿһλвС˿ֽ  
-    bitsBuffer.i_mask = 0x80;
+bool is_NALU_PPS(unsigned char nal_type)
+{
+    return (NALU_PPS == nal_type);
+}
 
-    bitsBuffer.p_data = (unsigned char *)(pData);  
-    memset(bitsBuffer.p_data, 0, PS_HDR_LEN);  
+bool is_NALU_SEI(unsigned char nal_type)
+{
+    return (NALU_SEI == nal_type);
+}
 
-    bits_write(&bitsBuffer, 32, 0x000001BA);
+bool is_NALU_IDR(unsigned char nal_type)
+{
+    return (NALU_IDR == nal_type);
+}
 
-    for(int i=0;i<4;i++)
+/***
+*@remark:   CRC32/MPEG-2PSMؽʱ
+*/
+static uint32_t crc32_mpeg(const uint8_t *data, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFF;
+    for (uint32_t i = 0; i < len; ++i)
     {
-        printf("pData[%d]::%0x\n", i, pData[i]);
+        crc ^= (uint32_t)data[i] << 24;
+        for (int k = 0; k < 8; ++k)
+        {
+            crc = (crc & 0x80000000) ? ((crc << 1) ^ 0x04C11DB7) : (crc << 1);
+        }
     }
+    return crc;
+}
 
+/***
+*@remark:   33λʱPTSʽд5ֽ prefix(4) ts[32..30] 1 ts[29..15] 1 ts[14..0] 1
+*/
+static inline void put_pes_ts(uint8_t *p, uint8_t prefix, uint64_t ts)
+{
+    uint64_t v = ((uint64_t)prefix << 36)
+        | (((ts >> 30) & 0x07) << 33) | ((uint64_t)1 << 32)
+        | (((ts >> 15) & 0x7FFF) << 17) | (1 << 16)
+        | ((ts & 0x7FFF) << 1) | 1;
+    p[0] = (uint8_t)(v >> 32);
+    put_be32(p + 1, (uint32_t)v);
+}
 
-    return 0;
+mp_28181_ps::mp_28181_ps()
+{
+    /*pack header: start code | SCR(6) | mux_rate(22) '11' | reserved '11111' stuffing 0*/
+    put_be32(m_ps_tmpl, 0x000001BA);
+    ::memset(m_ps_tmpl + 4, 0, 6);
+    uint32_t mux_rate = 255;
+    m_ps_tmpl[10] = (uint8_t)(mux_rate >> 14);
+    put_be16(m_ps_tmpl + 11, (uint16_t)((mux_rate << 2) | 0x03));
+    m_ps_tmpl[13] = 0xF8;
+
+    /*pes header: start code | packet_len | '10' data_alignment | PTS_flag | header_data_length | PTS*/
+    put_be32(m_pes_tmpl, 0x000001E0);
+    put_be16(m_pes_tmpl + 4, 0);
+    m_pes_tmpl[6] = 0x84;
+    m_pes_tmpl[7] = 0x80;
+    m_pes_tmpl[8] = 5;
+    ::memset(m_pes_tmpl + 9, 0, 5);
+
+    m_video_type = PS_STREAM_NONE;
+    m_audio_type = PS_STREAM_NONE;
+    m_psm_version = 0;
+    build_sys_psm();
+
+    reset();
 }
 
-#endif
+mp_28181_ps::~mp_28181_ps()
+{
+}
 
-bool is_Iframe(unsigned char nal_type)
+void mp_28181_ps::reset()
 {
-    return ((NALU_IDR == nal_type) || (NALU_SEI == nal_type) || (NALU_SPS == nal_type) || (NALU_PPS == nal_type));
+    m_has_video_pack = false;
+    m_last_video_pts = 0;
+    m_key_in_pack = false;
+    m_audio_packs = 0;
 }
 
-bool is_NALU_SPS(unsigned char nal_type)
+void mp_28181_ps::update_psm(uint8_t video_type, uint8_t audio_type)
 {
-    return (NALU_SPS == nal_type);
+    if (video_type == m_video_type && audio_type == m_audio_type)
+    {
+        return;
+    }
+
+    m_video_type = video_type;
+    m_audio_type = audio_type;
+    m_psm_version = (m_psm_version + 1) & 0x1F;
+    build_sys_psm();
+
+    //ɱ仯һؼ֡ЯPSM
+    m_key_in_pack = false;
+    m_audio_packs = 0;
 }
 
-bool is_NALU_PPS(unsigned char nal_type)
+void mp_28181_ps::build_sys_psm()
 {
-    return (NALU_PPS == nal_type);
+    uint8_t streams = (PS_STREAM_NONE != m_video_type ? 1 : 0) + (PS_STREAM_NONE != m_audio_type ? 1 : 0);
+
+    /*system header*/
+    m_sys_len = 12 + 3 * streams;
+    uint8_t *p = m_sys_tmpl;
+    put_be32(p, 0x000001BB);
+    put_be16(p + 4, (uint16_t)(m_sys_len - 6));
+    uint32_t rate_bound = 50000;
+    p[6] = (uint8_t)(0x80 | (rate_bound >> 15));                    /*marker | rate_bound[21..15]*/
+    put_be16(p + 7, (uint16_t)(((rate_bound & 0x7FFF) << 1) | 1));   /*rate_bound[14..0] | marker*/
+    p[9] = (uint8_t)(((PS_STREAM_NONE != m_audio_type ? 1 : 0) << 2) | 0x01);   /*audio_bound | fixed 0 | CSPS 1*/
+    p[10] = (uint8_t)(0xE0 | (PS_STREAM_NONE != m_video_type ? 1 : 0));         /*audio/video lock | marker | video_bound*/
+    p[11] = 0x7F;                                                   /*packet_rate_restriction 0 | reserved*/
+    p += 12;
+    if (PS_STREAM_NONE != m_video_type)
+    {
+        p[0] = PS_VIDEO_STREAM_ID;
+        put_be16(p + 1, 0xC000 | 0x2000 | 2048);                     /*'11' | scale 1 | size_bound*/
+        p += 3;
+    }
+    if (PS_STREAM_NONE != m_audio_type)
+    {
+        p[0] = PS_AUDIO_STREAM_ID;
+        put_be16(p + 1, 0xC000 | 512);                               /*'11' | scale 0 | size_bound*/
+        p += 3;
+    }
+
+    /*program stream map*/
+    m_psm_len = 16 + 4 * streams;
+    p = m_psm_tmpl;
+    put_be32(p, 0x000001BC);
+    put_be16(p + 4, (uint16_t)(m_psm_len - 6));
+    p[6] = (uint8_t)(0xE0 | m_psm_version);                         /*current_next 1 | reserved | version*/
+    p[7] = 0xFF;                                                    /*reserved | marker*/
+    put_be16(p + 8, 0);                                             /*program_stream_info_length*/
+    put_be16(p + 10, (uint16_t)(4 * streams));                      /*elementary_stream_map_length*/
+    p += 12;
+    if (PS_STREAM_NONE != m_video_type)
+    {
+        p[0] = m_video_type;
+        p[1] = PS_VIDEO_STREAM_ID;
+        put_be16(p + 2, 0);
+        p += 4;
+    }
+    if (PS_STREAM_NONE != m_audio_type)
+    {
+        p[0] = m_audio_type;
+        p[1] = PS_AUDIO_STREAM_ID;
+        put_be16(p + 2, 0);
+        p += 4;
+    }
+    put_be32(p, crc32_mpeg(m_psm_tmpl, m_psm_len - 4));
 }
 
-bool is_NALU_SEI(unsigned char nal_type)
+uint32_t mp_28181_ps::make_ps_header(uint8_t *dst, uint64_t scr)
 {
-    return (NALU_SEI == nal_type);
+    ::memcpy(dst, m_ps_tmpl, PS_HDR_LEN);
+
+    /*'01' SCR[32..30] 1 SCR[29..15] 1 SCR[14..0] 1 SCR_ext(9)=0 1*/
+    uint64_t v = ((uint64_t)1 << 46)
+        | (((scr >> 30) & 0x07) << 43) | ((uint64_t)1 << 42)
+        | (((scr >> 15) & 0x7FFF) << 27) | ((uint64_t)1 << 26)
+        | ((scr & 0x7FFF) << 11) | (1 << 10)
+        | 1;
+    put_be16(dst + 4, (uint16_t)(v >> 32));
+    put_be32(dst + 6, (uint32_t)v);
+    return PS_HDR_LEN;
 }
 
-bool is_NALU_IDR(unsigned char nal_type)
+uint32_t mp_28181_ps::make_sys_header(uint8_t *dst)
 {
-    return (NALU_IDR == nal_type);
+    ::memcpy(dst, m_sys_tmpl, m_sys_len);
+    return m_sys_len;
+}
+
+uint32_t mp_28181_ps::make_psm_header(uint8_t *dst)
+{
+    ::memcpy(dst, m_psm_tmpl, m_psm_len);
+    return m_psm_len;
+}
+
+uint32_t mp_28181_ps::make_pes_header(uint8_t *dst, uint8_t stream_id, uint32_t payload_len, bool has_pts, uint64_t pts)
+{
+    if (!has_pts)
+    {
+        ::memcpy(dst, m_pes_tmpl, PES_NOPTS_HDR_LEN);
+        dst[3] = stream_id;
+        put_be16(dst + 4, (uint16_t)(payload_len + 3));
+        dst[6] = 0x80;
+        dst[7] = 0x00;
+        dst[8] = 0;
+        return PES_NOPTS_HDR_LEN;
+    }
+
+    ::memcpy(dst, m_pes_tmpl, PES_HDR_LEN);
+    dst[3] = stream_id;
+    put_be16(dst + 4, (uint16_t)(payload_len + PES_HDR_LEN - 6));
+    put_pes_ts(dst + 9, 0x02, pts);
+    return PES_HDR_LEN;
 }
 
+bool mp_28181_ps::is_key_frame(uint8_t stream_type, const uint8_t *frame, uint32_t framesize)
+{
+    uint32_t i = 0;
+    bool has_start_code = (framesize >= 3 && 0 == frame[0] && 0 == frame[1] && (1 == frame[2] || (framesize >= 4 && 0 == frame[2] && 1 == frame[3])));
+
+    while (i < framesize)
+    {
+        //λһNALͷ
+        if (has_start_code)
+        {
+            while (i + 3 <= framesize && !(0 == frame[i] && 0 == frame[i+1] && 1 == frame[i+2]))
+            {
+                ++i;
+            }
+            if (i + 3 >= framesize)
+            {
+                break;
+            }
+            i += 3;
+        }
+
+        uint8_t nal = frame[i];
+        if (PS_STREAM_H265 == stream_type)
+        {
+            uint8_t type = (nal >> 1) & 0x3F;
+            if (32 == type || 33 == type || (type >= 16 && type <= 23))
+            {
+                return true;
+            }
+            if (type < 32)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            uint8_t type = nal & 0x1F;
+            if (is_NALU_SPS(type) || is_NALU_IDR(type))
+            {
+                return true;
+            }
+            if (type >= NALU_NON_IDR && type < NALU_IDR)
+            {
+                return false;
+            }
+        }
+
+        if (!has_start_code)
+        {
+            break;
+        }
+    }
+
+    return false;
+}
 
-/*@param :  pData      [in] Ҫ͵Ƶ 
-4.	 *          nFrameLen  [in] ݵĳ 
-5.	 *          pPacker    [in] ݰһЩϢʱrtpbuff͵socketϢ 
-6.	 *          stream_type[in]  0 Ƶ 1 Ƶ 
-7.	 *@return:  0 success others failed 
-8.	*/  
-#if 0
-int gb28181_streampackageForH264(char *pData, int nFrameLen, Data_Info_s* pPacker, int stream_type)  
-{  
-    char szTempPacketHead[256];  
-    int  nSizePos = 0;  
-    int  nSize = 0;       
-    char *pBuff = NULL;  
-    memset(szTempPacketHead, 0, 256);  
-    // 1 package for ps header   
-    gb28181_make_ps_header(szTempPacketHead + nSizePos, pPacker->s64CurPts);  
-    nSizePos += PS_HDR_LEN;   
-    //2 system header   
-    if( pPacker->IFrame == 1 )  
-    {  
-        // I֡Ļϵͳͷ  
-        gb28181_make_sys_header(szTempPacketHead + nSizePos);  
-        nSizePos += SYS_HDR_LEN;  
-        //طǲI֡p֡mapģòֻI֡Ҳû  
-        //      gb28181_make_psm_header(szTempPacketHead + nSizePos);  
-        //nSizePos += PSM_HDR_LEN;  
-    }  
-
-    // psmͷ (Ҳmap)  
-    gb28181_make_psm_header(szTempPacketHead + nSizePos);  
-    nSizePos += PSM_HDR_LEN;  
-    //rtpͳȥĻݾֻҪƬְֻмpesͷrtpͷ  
-    if(gb28181_send_rtp_pack(szTempPacketHead, nSizePos, 0, pPacker) != 0 )  
-        return -1;    
-    // ƶΪ˷㿽pesͷ  
-    //Ϊ˼ٺƵݵĴ˷ѿռ䣬ƶʵʴʱҪעַǷԽԼǵ  
-    pBuff = pData - PES_HDR_LEN;  
-    while(nFrameLen > 0)  
-    {  
-        //ÿ֡ĳȲҪshortͣ˾͵÷Ƭѭз  
-        nSize = (nFrameLen > PS_PES_PAYLOAD_SIZE) ? PS_PES_PAYLOAD_SIZE : nFrameLen;  
-        // pesͷ  
-        gb28181_make_pes_header(pBuff, stream_type ? 0xC0:0xE0, nSize, (pPacker->s64CurPts / 100), (pPacker->s64CurPts/300));  
-
-        //rtpͷ  
-        if( gb28181_send_rtp_pack(pBuff, nSize + PES_HDR_LEN, ((nSize == nFrameLen)?1:0), pPacker) != 0 )  
-        {  
-            printf("gb28181_send_pack failed!\n");  
-            return -1;  
-        }  
-        //Ƭÿη͵ƶָ  
-        nFrameLen -= nSize;  
-        //ҲֻƶnSize,Ϊwhileƶpesͷȣpesͷ  
-        pBuff     += nSize;  
-
-    }  
-    return 0;  
-}  
-
-#endif
-
-
-/*** 
-*@remark:   psͷķװ,ľݵдѾռλԲο׼ 
-*@param :   pData  [in] psͷݵĵַ 
-*           s64Src [in] ʱ 
-*@return:   0 success, others failed 
-*/  
-int gb28181_make_ps_header(char *pData, unsigned long long s64Scr)  
-{  
-    unsigned long long lScrExt = (s64Scr) % 100;      
-    s64Scr = s64Scr / 100;  
-    // 100sdpЭ鷵صvideoƵ90000֡25֡/sÿε3600,  
-    // ʵӦøԼʱԱ֤ʱΪ3600ɣ  
-    //ﲻԵĻͿܵ¿  
-    bits_buffer_s   bitsBuffer;  
-    bitsBuffer.i_size = PS_HDR_LEN;   
-    bitsBuffer.i_data = 0;  
-    bitsBuffer.i_mask = 0x80; // ƣ10000000 Ϊ˺һֽڵÿһλвС˿ֽ  
-    bitsBuffer.p_data = (unsigned char *)(pData);  
-    memset(bitsBuffer.p_data, 0, PS_HDR_LEN);  
-    bits_write(&bitsBuffer, 32, 0x000001BA);            /*start codes*/  
-    bits_write(&bitsBuffer, 2,  1);                     /*marker bits '01b'*/  
-    bits_write(&bitsBuffer, 3,  (s64Scr>>30)&0x07);     /*System clock [32..30]*/  
-    bits_write(&bitsBuffer, 1,  1);                     /*marker bit*/  
-    bits_write(&bitsBuffer, 15, (s64Scr>>15)&0x7FFF);   /*System clock [29..15]*/  
-    bits_write(&bitsBuffer, 1,  1);                     /*marker bit*/  
-    bits_write(&bitsBuffer, 15, s64Scr&0x7fff);         /*System clock [29..15]*/  
-    bits_write(&bitsBuffer, 1,  1);                     /*marker bit*/  
-    bits_write(&bitsBuffer, 9,  lScrExt&0x01ff);        /*System clock [14..0]*/  
-    bits_write(&bitsBuffer, 1,  1);                     /*marker bit*/  
-    bits_write(&bitsBuffer, 22, (255)&0x3fffff);        /*bit rate(n units of 50 bytes per second.)*/  
-    bits_write(&bitsBuffer, 2,  3);                     /*marker bits '11'*/  
-    bits_write(&bitsBuffer, 5,  0x1f);                  /*reserved(reserved for future use)*/  
-    bits_write(&bitsBuffer, 3,  0);                     /*stuffing length*/  
-    return 0;  
-}  
-
-/*** 
-*@remark:   sysͷķװ,ľݵдѾռλԲο׼ 
-*@param :   pData  [in] psͷݵĵַ 
-*@return:   0 success, others failed 
-*/  
-int gb28181_make_sys_header(char *pData)  
-{  
-    bits_buffer_s   bitsBuffer;  
-    bitsBuffer.i_size = SYS_HDR_LEN;  
-    bitsBuffer.i_data = 0;  
-    bitsBuffer.i_mask = 0x80;  
-    bitsBuffer.p_data = (unsigned char *)(pData);  
-    memset(bitsBuffer.p_data, 0, SYS_HDR_LEN);  
-    /*system header*/  
-    bits_write( &bitsBuffer, 32, 0x000001BB);   /*start code*/  
-    bits_write( &bitsBuffer, 16, SYS_HDR_LEN-6);/*header_length ʾֽںĳȣͷҲǴ˼*/  
-    bits_write( &bitsBuffer, 1,  1);            /*marker_bit*/  
-    bits_write( &bitsBuffer, 22, 50000);        /*rate_bound*/  //ģ3959
-    bits_write( &bitsBuffer, 1,  1);            /*marker_bit*/  
-    bits_write( &bitsBuffer, 6,  1);            /*audio_bound*/  //ģ1
-    bits_write( &bitsBuffer, 1,  0);            /*fixed_flag */  //ģ0
-    bits_write( &bitsBuffer, 1,  1);            /*CSPS_flag */   //1
-    bits_write( &bitsBuffer, 1,  1);            /*system_audio_lock_flag*/  //1
-    bits_write( &bitsBuffer, 1,  1);            /*system_video_lock_flag*/  //1
-    bits_write( &bitsBuffer, 1,  1);            /*marker_bit*/  
-    bits_write( &bitsBuffer, 5,  1);            /*video_bound*/  //0
-    bits_write( &bitsBuffer, 1,  0);            /*dif from mpeg1*/  //0
-    bits_write( &bitsBuffer, 7,  0x7F);         /*reserver*/  //0x17
-    /*audio stream bound*/  
-    bits_write( &bitsBuffer, 8,  0xC0);         /*stream_id*/  //0xfe
-    bits_write( &bitsBuffer, 2,  3);            /*marker_bit */  //00
-    bits_write( &bitsBuffer, 1,  0);            /*PSTD_buffer_bound_scale*/  //0
-    bits_write( &bitsBuffer, 13, 512);          /*PSTD_buffer_size_bound*/  //
-    /*video stream bound*/  
-    bits_write( &bitsBuffer, 8,  0xE0);         /*stream_id*/  
-    bits_write( &bitsBuffer, 2,  3);            /*marker_bit */  
-    bits_write( &bitsBuffer, 1,  1);            /*PSTD_buffer_bound_scale*/  
-    bits_write( &bitsBuffer, 13, 2048);         /*PSTD_buffer_size_bound*/  
-
-    return 0;  
-}  
-
-/*** 
-*@remark:   psmͷķװ,ľݵдѾռλԲο׼ 
-*@param :   pData  [in] psͷݵĵַ 
-*@return:   0 success, others failed 
-*/  
- 
-int gb28181_make_psm_header(char *pData)  
-{  
-    bits_buffer_s   bitsBuffer;  
-    bitsBuffer.i_size = PSM_HDR_LEN;   
-    bitsBuffer.i_data = 0;  
-    bitsBuffer.i_mask = 0x80;  
-    bitsBuffer.p_data = (unsigned char *)(pData);  
-    memset(bitsBuffer.p_data, 0, PSM_HDR_LEN);  
-    bits_write(&bitsBuffer, 24,0x000001);   /*start code*/  
-    bits_write(&bitsBuffer, 8, 0xBC);       /*map stream id*/  
-    bits_write(&bitsBuffer, 16,18);         /*program stream map length*/   
-    bits_write(&bitsBuffer, 1, 1);          /*current next indicator */  
-    bits_write(&bitsBuffer, 2, 3);          /*reserved*/  
-    bits_write(&bitsBuffer, 5, 0);          /*program stream map version*/  
-    bits_write(&bitsBuffer, 7, 0x7F);       /*reserved */  
-    bits_write(&bitsBuffer, 1, 1);          /*marker bit */  
-    bits_write(&bitsBuffer, 16,0);          /*programe stream info length*/  
-    bits_write(&bitsBuffer, 16, 8);         /*elementary stream map length  is*/  
-    /*audio*/  
-    bits_write(&bitsBuffer, 8, 0x90);       /*stream_type*/  
-    bits_write(&bitsBuffer, 8, 0xC0);       /*elementary_stream_id*/  
-    bits_write(&bitsBuffer, 16, 0);         /*elementary_stream_info_length is*/  
-    /*video*/  
-    bits_write(&bitsBuffer, 8, 0x1B);       /*stream_type*/  
-    bits_write(&bitsBuffer, 8, 0xE0);       /*elementary_stream_id*/  
-    bits_write(&bitsBuffer, 16, 0);         /*elementary_stream_info_length */  
-    /*crc (2e b9 0f 3d)*/  
-    bits_write(&bitsBuffer, 8, 0x45);       /*crc (24~31) bits*/  
-    bits_write(&bitsBuffer, 8, 0xBD);       /*crc (16~23) bits*/  
-    bits_write(&bitsBuffer, 8, 0xDC);       /*crc (8~15) bits*/  
-    bits_write(&bitsBuffer, 8, 0xF4);       /*crc (0~7) bits*/  
-
-    return 0;
-}  
-
-
-/*** 
-*@remark:   pesͷķװ,ľݵдѾռλԲο׼ 
-*@param :   pData      [in] psͷݵĵַ 
-*           stream_id  [in]  
-*           paylaod_len[in] س 
-*           pts        [in] ʱ 
-*           dts        [in] 
-*@return:   0 success, others failed 
-*/  
-int gb28181_make_pes_header(char *pData, int stream_id, int payload_len, unsigned long long pts, unsigned long long dts)  
-{  
-    bits_buffer_s   bitsBuffer;  
-    bitsBuffer.i_size = PES_HDR_LEN;  
-    bitsBuffer.i_data = 0;  
-    bitsBuffer.i_mask = 0x80;  
-    bitsBuffer.p_data = (unsigned char *)(pData);  
-    memset(bitsBuffer.p_data, 0, PES_HDR_LEN);  
-    /*system header*/  
-    bits_write( &bitsBuffer, 24,0x000001);  /*start code*/  
-    bits_write( &bitsBuffer, 8, (stream_id));   /*streamID*/  
-    bits_write( &bitsBuffer, 16,(payload_len)+13);  /*packet_len*/ //ָpesݳȺ͸ֽںĳȺ  
-    bits_write( &bitsBuffer, 2, 2 );        /*'10'*/  
-    bits_write( &bitsBuffer, 2, 0 );        /*scrambling_control*/  
-    bits_write( &bitsBuffer, 1, 0 );        /*priority*/  
-    bits_write( &bitsBuffer, 1, 0 );        /*data_alignment_indicator*/  //1
-    bits_write( &bitsBuffer, 1, 0 );        /*copyright*/  
-    bits_write( &bitsBuffer, 1, 0 );        /*original_or_copy*/  
-    bits_write( &bitsBuffer, 1, 1 );        /*PTS_flag*/  
-    bits_write( &bitsBuffer, 1, 1 );        /*DTS_flag*/  
-    bits_write( &bitsBuffer, 1, 0 );        /*ESCR_flag*/  
-    bits_write( &bitsBuffer, 1, 0 );        /*ES_rate_flag*/  
-    bits_write( &bitsBuffer, 1, 0 );        /*DSM_trick_mode_flag*/  
-    bits_write( &bitsBuffer, 1, 0 );        /*additional_copy_info_flag*/  
-    bits_write( &bitsBuffer, 1, 0 );        /*PES_CRC_flag*/  
-    bits_write( &bitsBuffer, 1, 0 );        /*PES_extension_flag*/  
-    bits_write( &bitsBuffer, 8, 10);        /*header_data_length*/   
-    // ָ PES еĿѡֶκκֽռõֶֽ֮ǰ  
-    //ָֽ޿ѡֶΡ  
-
-    /*PTS,DTS*/   
-    bits_write( &bitsBuffer, 4, 3 );                    /*'0011'*/  
-    bits_write( &bitsBuffer, 3, ((pts)>>30)&0x07 );     /*PTS[32..30]*/  
-    bits_write( &bitsBuffer, 1, 1 );  
-    bits_write( &bitsBuffer, 15,((pts)>>15)&0x7FFF);    /*PTS[29..15]*/  
-    bits_write( &bitsBuffer, 1, 1 );  
-    bits_write( &bitsBuffer, 15,(pts)&0x7FFF);          /*PTS[14..0]*/  
-    bits_write( &bitsBuffer, 1, 1 );  
-    bits_write( &bitsBuffer, 4, 1 );                    /*'0001'*/  
-    bits_write( &bitsBuffer, 3, ((dts)>>30)&0x07 );     /*DTS[32..30]*/  
-    bits_write( &bitsBuffer, 1, 1 );  
-    bits_write( &bitsBuffer, 15,((dts)>>15)&0x7FFF);    /*DTS[29..15]*/  
-    bits_write( &bitsBuffer, 1, 1 );  
-    bits_write( &bitsBuffer, 15,(dts)&0x7FFF);          /*DTS[14..0]*/  
-    bits_write( &bitsBuffer, 1, 1 );  
-
-    return 0;  
-}  
+bool mp_28181_ps::cursor_flush(slice_cursor &c)
+{
+    if (0 == c.used)
+    {
+        return true;
+    }
 
+    bool ret = c.sink->commit_slice(c.used);
+    c.p = NULL;
+    c.left = 0;
+    c.used = 0;
+    return ret;
+}
 
+bool mp_28181_ps::cursor_put(slice_cursor &c, const uint8_t *src, uint32_t len)
+{
+    while (len > 0)
+    {
+        if (0 == c.left)
+        {
+            if (!cursor_flush(c))
+            {
+                return false;
+            }
+
+            c.p = c.sink->alloc_slice(c.left);
+            if (!c.p || 0 == c.left)
+            {
+                return false;
+            }
+        }
+
+        uint32_t n = (len < c.left) ? len : c.left;
+        ::memcpy(c.p, src, n);
+        c.p += n;
+        c.left -= n;
+        c.used += n;
+        src += n;
+        len -= n;
+    }
 
+    return true;
+}
 
+bool mp_28181_ps::put_pes(slice_cursor &c, uint8_t stream_id, const uint8_t *frame, uint32_t framesize,
+                          uint64_t pts, const uint8_t *prefix, uint32_t prefix_len)
+{
+    //PESֶΪ16λ֡ΪPES׸ЯPTS
+    uint8_t hdr[PES_HDR_LEN];
+    uint32_t offset = 0;
+    bool first = true;
+    while (first || offset < framesize)
+    {
+        uint32_t pre = first ? prefix_len : 0;
+        uint32_t chunk = framesize - offset;
+        if (chunk + pre > PS_PES_PAYLOAD_SIZE)
+        {
+            chunk = PS_PES_PAYLOAD_SIZE - pre;
+        }
+
+        uint32_t n = make_pes_header(hdr, stream_id, pre + chunk, first, pts);
+        if (!cursor_put(c, hdr, n))
+        {
+            return false;
+        }
+        if (pre > 0 && !cursor_put(c, prefix, pre))
+        {
+            return false;
+        }
+        if (!cursor_put(c, frame + offset, chunk))
+        {
+            return false;
+        }
+
+        offset += chunk;
+        first = false;
+    }
 
+    return true;
+}
 
+bool mp_28181_ps::mux_video(ps_slice_sink *sink, uint8_t stream_type, const uint8_t *frame, uint32_t framesize, uint64_t pts)
+{
+    if (!sink || !frame || 0 == framesize)
+    {
+        return false;
+    }
 
+    update_psm(stream_type, m_audio_type);
 
+    bool key = is_key_frame(stream_type, frame, framesize);
+    bool new_pack = !m_has_video_pack || pts != m_last_video_pts;
 
+    //ϵͳͷpackͷͬһpackں󵽵ĹؼNALpack
+    if (key && !m_key_in_pack)
+    {
+        new_pack = true;
+    }
+
+    uint8_t hdr[PS_HDR_LEN + SYS_HDR_LEN + PSM_HDR_LEN];
+    uint32_t n = 0;
+    if (new_pack)
+    {
+        n += make_ps_header(hdr, pts);
+        m_has_video_pack = true;
+        m_last_video_pts = pts;
+        m_key_in_pack = false;
+
+        if (key)
+        {
+            n += make_sys_header(hdr + n);
+            n += make_psm_header(hdr + n);
+            m_key_in_pack = true;
+        }
+    }
+
+    //PSƵΪAnnex-Bʽȱʼʱ
+    static const uint8_t start_code[4] = {0, 0, 0, 1};
+    bool has_start_code = (framesize >= 3 && 0 == frame[0] && 0 == frame[1] && (1 == frame[2] || (framesize >= 4 && 0 == frame[2] && 1 == frame[3])));
+
+    slice_cursor c = {sink, NULL, 0, 0};
+    if (!cursor_put(c, hdr, n))
+    {
+        return false;
+    }
+    if (!put_pes(c, PS_VIDEO_STREAM_ID, frame, framesize, pts, start_code, has_start_code ? 0 : 4))
+    {
+        return false;
+    }
+
+    return cursor_flush(c);
+}
+
+bool mp_28181_ps::mux_audio(ps_slice_sink *sink, uint8_t stream_type, const uint8_t *frame, uint32_t framesize, uint64_t pts)
+{
+    if (!sink || !frame || 0 == framesize)
+    {
+        return false;
+    }
+
+    update_psm(m_video_type, stream_type);
+
+    uint8_t hdr[PS_HDR_LEN + SYS_HDR_LEN + PSM_HDR_LEN];
+    uint32_t n = make_ps_header(hdr, pts);
+
+    //ƵʱPSMƵؼ֡·
+    if (PS_STREAM_NONE == m_video_type && 0 == (m_audio_packs++ % PS_AUDIO_PSM_INTERVAL))
+    {
+        n += make_sys_header(hdr + n);
+        n += make_psm_header(hdr + n);
+    }
+
+    slice_cursor c = {sink, NULL, 0, 0};
+    if (!cursor_put(c, hdr, n))
+    {
+        return false;
+    }
+    if (!put_pes(c, PS_AUDIO_STREAM_ID, frame, framesize, pts, NULL, 0))
+    {
+        return false;
+    }
+
+    return cursor_flush(c);
+}
@@ -1,17 +1,32 @@
-
 #ifndef GB28181_PS_H
 #define GB28181_PS_H
 
+#include <stdint.h>
 
-#define PS_HDR_LEN  14  
-#define SYS_HDR_LEN 18  
-#define PSM_HDR_LEN 24  
-#define PES_HDR_LEN 19  
+#define PS_HDR_LEN  14
+#define SYS_HDR_LEN 18      //Ƶ·ʱĳȣ·Ϊ15
+#define PSM_HDR_LEN 24      //Ƶ·ʱĳȣ·Ϊ20
+#define PES_HDR_LEN 14
+#define PES_NOPTS_HDR_LEN 9
 #define RTP_HDR_LEN 12
 #define PS_I_ALL_LEN (PS_HDR_LEN+SYS_HDR_LEN+PSM_HDR_LEN+PES_HDR_LEN)
 #define PS_P_ALL_LEN (PS_HDR_LEN+PES_HDR_LEN)
 #define PS_PES_PAYLOAD_SIZE 65000
 
+//PSеĻID
+#define PS_VIDEO_STREAM_ID  0xE0
+#define PS_AUDIO_STREAM_ID  0xC0
+
+//PSMеstream_type
+enum ps_stream_type
+{
+    PS_STREAM_NONE  = 0x00,
+    PS_STREAM_AAC   = 0x0F,
+    PS_STREAM_H264  = 0x1B,
+    PS_STREAM_H265  = 0x24,
+    PS_STREAM_G711A = 0x90,
+    PS_STREAM_G711U = 0x91,
+};
 
 enum H264_nalu_type
 {
@@ -33,44 +48,21 @@ enum H264_nalu_type
     NALU_Subset_SPS
 };
 
-typedef struct bits_buffer
+/***
+*@remark:  д룬ͷֶһдλƴװ
+*/
+inline void put_be16(uint8_t *p, uint16_t v)
 {
-    unsigned char i_size;
-    unsigned char i_data;
-    unsigned char i_mask;
-    unsigned char *p_data;
-
-}bits_buffer_s;
-
-/*** 
-*@remark:  ݰλһһѹ 
-*@param :  buffer   [in]  ѹݵbuffer 
-*          count    [in]  Ҫѹռλ 
-*          bits     [in]  ѹֵ 
-*/  
-inline void bits_write(bits_buffer_s *buffer, int count, unsigned long bits)  
-{  
-    bits_buffer_s *p_buffer = (buffer);  
-    int i_count = (count);  
-    unsigned long i_bits = (bits);  
-    while( i_count > 0 )  
-    {  
-        i_count--;  
-        if( ( i_bits >> i_count )&0x01 ) 
-        {  
-            p_buffer->p_data[p_buffer->i_data] |= p_buffer->i_mask;  
-        }  
-        else  
-        { 
-            p_buffer->p_data[p_buffer->i_data] &= ~p_buffer->i_mask;  
-        }  
-        p_buffer->i_mask >>= 1;         /*һֽڵһλ󣬲ڶλ*/  
-        if( p_buffer->i_mask == 0 )     /*ѭһֽڵ8λ¿ʼһλ*/  
-        {  
-            p_buffer->i_data++;  
-            p_buffer->i_mask = 0x80;  
-        }  
-    }  
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+inline void put_be32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
 }
 
 bool is_Iframe(unsigned char nal_type);
@@ -83,50 +75,87 @@ bool is_NALU_SEI(unsigned char nal_type);
 
 bool is_NALU_IDR(unsigned char nal_type);
 
-/*** 
-*@remark:   psͷķװ,ľݵдѾռλԲο׼ 
-*@param :   pData  [in] psͷݵĵַ 
-*           s64Src [in] ʱ 
-*@return:   0 success, others failed 
-*/  
-int gb28181_make_ps_header(char *pData, unsigned long long s64Scr);
-
-/*** 
-*@remark:   sysͷķװ,ľݵдѾռλԲο׼ 
-*@param :   pData  [in] psͷݵĵַ 
-*@return:   0 success, others failed 
-*/  
-int gb28181_make_sys_header(char *pData);
-
-/*** 
-*@remark:   psmͷķװ,ľݵдѾռλԲο׼ 
-*@param :   pData  [in] psͷݵĵַ 
-*@return:   0 success, others failed 
-*/  
-int gb28181_make_psm_header(char *pData);
-
-/*** 
-*@remark:   pesͷķװ,ľݵдѾռλԲο׼ 
-*@param :   pData      [in] psͷݵĵַ 
-*           stream_id  [in]  
-*           paylaod_len[in] س 
-*           pts        [in] ʱ 
-*           dts        [in] 
-*@return:   0 success, others failed 
-*/  
-int gb28181_make_pes_header(char *pData, int stream_id, int payload_len, unsigned long long pts, unsigned long long dts);
-
+/***
+*@remark:   PSƬװmtuƬֱдƬ
+*/
+class ps_slice_sink
+{
+public:
+    virtual ~ps_slice_sink() {}
 
+    //һƬؿдַcapacityΪ÷Ƭдֽ
+    virtual uint8_t *alloc_slice(uint32_t &capacity) = 0;
 
+    //ύǰƬsizeΪʵдֽ
+    virtual bool commit_slice(uint32_t size) = 0;
+};
 
+/***
+*@remark:   GB28181 PSװ
+*           1packͷ/ϵͳͷ/PSM/PESͷΪԤģ壬װʱԭλ޸ʱͳ
+*           2ɴֱ֡дƬм֡
+*           3Ƶ֧H264/H265Ƶ֧G711/AAC(ADTS)ʱΪ90kHz
+*/
 class mp_28181_ps
 {
 public:
     mp_28181_ps();
     ~mp_28181_ps();
+
+    void reset();
+
+    //Ƶ֡װframeΪAnnex-BʽΪNAL֡
+    bool mux_video(ps_slice_sink *sink, uint8_t stream_type, const uint8_t *frame, uint32_t framesize, uint64_t pts);
+
+    //Ƶ֡װÿ֡һpack
+    bool mux_audio(ps_slice_sink *sink, uint8_t stream_type, const uint8_t *frame, uint32_t framesize, uint64_t pts);
+
+    //ͷд룬д볤
+    uint32_t make_ps_header(uint8_t *dst, uint64_t scr);
+    uint32_t make_sys_header(uint8_t *dst);
+    uint32_t make_psm_header(uint8_t *dst);
+    uint32_t make_pes_header(uint8_t *dst, uint8_t stream_id, uint32_t payload_len, bool has_pts, uint64_t pts);
+
+    //жƵ֡Ƿ񺬹ؼ֡(IDR/IRAP)ֻɨ赽һVCL NAL
+    static bool is_key_frame(uint8_t stream_type, const uint8_t *frame, uint32_t framesize);
+
 private:
-    int a;
+    //PSMͱ仯ʱؽģ岢汾
+    void update_psm(uint8_t video_type, uint8_t audio_type);
+    void build_sys_psm();
+
+    //PESƬд
+    struct slice_cursor
+    {
+        ps_slice_sink *sink;
+        uint8_t *p;
+        uint32_t left;
+        uint32_t used;
+    };
+    bool cursor_put(slice_cursor &c, const uint8_t *src, uint32_t len);
+    bool cursor_flush(slice_cursor &c);
+    bool put_pes(slice_cursor &c, uint8_t stream_id, const uint8_t *frame, uint32_t framesize,
+        uint64_t pts, const uint8_t *prefix, uint32_t prefix_len);
 
+private:
+    uint8_t m_ps_tmpl[PS_HDR_LEN];
+    uint8_t m_sys_tmpl[SYS_HDR_LEN];
+    uint8_t m_psm_tmpl[PSM_HDR_LEN];
+    uint8_t m_pes_tmpl[PES_HDR_LEN];
+    uint32_t m_sys_len;
+    uint32_t m_psm_len;
+
+    uint8_t m_video_type;
+    uint8_t m_audio_type;
+    uint8_t m_psm_version;
+
+    //ͬһʱĶNALͬһpackؼֻ֡packײһϵͳͷPSM
+    bool m_has_video_pack;
+    uint64_t m_last_video_pts;
+    bool m_key_in_pack;
+
+    //ƵʱÿpackطϵͳͷPSM
+    uint32_t m_audio_packs;
 };
 
 #endif
@@ -118,6 +118,7 @@ namespace xt_mp_caster
             m_use_traffic_shapping = descriptor->use_traffic_shapping;
             if (m_use_traffic_shapping)
             {
+                m_timer_mgr.add_timer(&m_flow_pacer);
                 m_timer_mgr.start(1);
             }
 #endif  //_USE_RTP_TRAFFIC_SHAPING
@@ -143,6 +144,7 @@ namespace xt_mp_caster
         if (m_use_traffic_shapping)
         {
             m_timer_mgr.stop();
+            m_timer_mgr.remove_timer(&m_flow_pacer);
         }
 #endif
         //ڲȫԴ
@@ -537,6 +539,11 @@ namespace xt_mp_caster
         return m_timer_mgr;
     }
 
+    flow_pacer_t& caster::get_flow_pacer()
+    {
+        return m_flow_pacer;
+    }
+
     bool caster::use_traffic_shapping() const
     {
         return m_use_traffic_shapping;
@@ -24,6 +24,7 @@
 
 #ifdef _USE_RTP_TRAFFIC_SHAPING
 #include "msec_timer.h"
+#include "traffic_shaping.h"
 #endif
 
 namespace xt_mp_caster
@@ -144,6 +145,7 @@ namespace xt_mp_caster
 
 #ifdef _USE_RTP_TRAFFIC_SHAPING
         deadline_timer_mgr_t& get_timer_mgr();
+        flow_pacer_t& get_flow_pacer();
         bool use_traffic_shapping() const;
 #endif
     public:
@@ -154,6 +156,8 @@ namespace xt_mp_caster
 
 #ifdef _USE_RTP_TRAFFIC_SHAPING
         deadline_timer_mgr_t m_timer_mgr;
+        //һm_timer_mgr
+        flow_pacer_t m_flow_pacer;
         bool m_use_traffic_shapping;
 #endif
 
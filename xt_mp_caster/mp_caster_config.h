@@ -43,6 +43,10 @@
 #define MP_PSEUDO_PAYLOAD_TYPE	96
 #define MP_PSEUDO_RTP_MAX_SIZE	1400
 #define MP_PSEUDO_RTP_HEAD_SIZE	16
+//RTP˽չͷԤռ䣺չͷ4ֽ + ֡Ϣ/ȼ4 + ش1
+//ƬʱǰԤÿռ䣬ʱչͷЭջڸǰ͵дٺƸ
+#define MP_PSEUDO_RTP_EXT_HEADROOM	24
+#define MP_PSEUDO_RTP_PAYLOAD_OFFSET	(MP_PSEUDO_RTP_HEAD_SIZE + MP_PSEUDO_RTP_EXT_HEADROOM)
 #define MP_PSEUDO_TS_CLOCK		90
 
 //Caster EngineڲʱСֵͬϵͳֵ
@@ -51,6 +55,29 @@
 #define MP_MSSRC_TASK_LOCK_TM		1
 #define MP_MSINK_TASK_LOCK_TM		1
 
+//msink_rv_rtpδʱһ֡RTPrv_adapter
+#define MSINK_RV_RTP_SEND_BATCH		64
+
+//RTPץļ(xt_set_file_path)첽дãΪpcapʽ
+//Ԥļ¼д߳ʱ߳
+#define MSINK_RTP_DUMP_RECORD_NUM		1024
+//дļСһдһ
+#define MSINK_RTP_DUMP_CHUNK_SIZE		(256 * 1024)
+//δдĿʱ()
+#define MSINK_RTP_DUMP_FLUSH_SECONDS	1
+//С(ֽ)ʱ()зļзֺļΪpath.1path.2...0ʾз
+#define MSINK_RTP_DUMP_ROTATE_BYTES		0
+#define MSINK_RTP_DUMP_ROTATE_SECONDS	0
+
+//ش(ReSendMan)
+//ѷͰıʱ()Ӧðش
+#define MSINK_RESEND_EXPIRE_MS			2000
+//شԤ㣺ÿNֽڻN*PERCENT/100ֽڵشȣΪBURSTֽ
+#define MSINK_RESEND_BUDGET_PERCENT		30
+#define MSINK_RESEND_BUDGET_BURST		(512 * 1024)
+//RTPչͷ(ش)
+#define MSINK_RESEND_EX_WORDS			16
+
 
 //FIFO
 /*
@@ -85,6 +85,8 @@ bool msink_rv_rtp::open(rv_net_address local_address,
                         )
 {
     m_file_path = "";
+    m_dump_ip = 0;
+    m_dump_port = 0;
 
 #ifdef _ANDROID
     m_nReSend = xt_config::router_module::get<int>("config.caster_cfg.resend",1);
@@ -211,7 +213,7 @@ void msink_rv_rtp::close()
 
     if (m_multiplex)
     {
-        XTDemuxMan::instance()->close_session(&m_hrv);
+        XTDemuxMan::instance()->close_session(&m_hrv, m_multiplexID);
         ::construct_rv_handler(&m_hrv);
     }
     else
@@ -345,6 +347,15 @@ void msink_rv_rtp::pump_mrtp_out(rtp_mblock *mrtp)
 		rtp->m_priority = mrtp->m_priority;
 		rtp->m_use_ssrc = mrtp->m_use_ssrc;
 		rtp->m_ssrc = mrtp->m_ssrc;
+
+		//δʱ֡RTPͣϵͳô
+#ifdef _USE_RTP_TRAFFIC_SHAPING
+		bool batch = (NULL == m_traffic_shaping.get());
+#else
+		bool batch = true;
+#endif
+		rtp_block *rtps[MSINK_RV_RTP_SEND_BATCH];
+		uint32_t nrtp = 0;
 		while (rtp)
 		{
 			rtp->set_rtp_param(&mrtp->m_rtp_param);
@@ -358,19 +369,52 @@ void msink_rv_rtp::pump_mrtp_out(rtp_mblock *mrtp)
 				rtp->m_rtp_param.marker = RV_ADAPTER_TRUE;
 			}
 
-			write_to_rv_adapter(rtp);
-
-			if (m_nReSend <= 0)
+			if (batch)
 			{
-				rtp->release();
+				rtp->m_resend = false;
+				rtps[nrtp++] = rtp;
+				if (MSINK_RV_RTP_SEND_BATCH == nrtp)
+				{
+					flush_batch_rtps(rtps, nrtp);
+					nrtp = 0;
+				}
 			}
+			else
+			{
+				write_to_rv_adapter(rtp);
+
+				if (m_nReSend <= 0)
+				{
+					rtp->release();
+				}
 
-			rtp->release();
+				rtp->release();
+			}
 			rtp = static_cast<rtp_block *>(mrtp->pop_byte_block());
 		}
 
+		if (nrtp > 0)
+		{
+			flush_batch_rtps(rtps, nrtp);
+		}
+
 	} while (false);
 }
+
+void msink_rv_rtp::flush_batch_rtps(rtp_block **rtps, uint32_t count)
+{
+	internel_write_to_rv_adapter(rtps, count);
+
+	//ͷŹһ£شʱReSendManһ
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		if (m_nReSend <= 0)
+		{
+			rtps[i]->release();
+		}
+		rtps[i]->release();
+	}
+}
 void msink_rv_rtp::pump_rtp_out()
 {
     //RTPдrv_adapter
@@ -644,15 +688,24 @@ rv_bool msink_rv_rtp::OnRtcpAppEventHandler_CB(
         {
             if (sink->m_nReSend>0 && sink->m_active && userData && userDataLen>=4)
             {
-                uint32_t snsize= userDataLen;
+                uint32_t snsize= userDataLen / sizeof(uint32_t);
 
-                uint32_t *p = reinterpret_cast<uint32_t *>(userData);
                 for (uint32_t i=0;i< snsize; i++)
                 {
-                    uint32_t sn = p[i];
+                    uint32_t sn;
+                    ::memcpy(&sn, userData + i * sizeof(uint32_t), sizeof(uint32_t));
                     sink->m_manReSend.reSend(sn);
                 }
             }
+            break;
+        }
+    case 4://NACK FCI(PID+BLP)
+        {
+            if (sink->m_nReSend>0 && sink->m_active && userData && userDataLen>=4)
+            {
+                sink->m_manReSend.reSendFci(userData, userDataLen);
+            }
+            break;
         }
     default:
         {
@@ -694,14 +747,26 @@ rv_bool msink_rv_rtp::OnRtcpRawBufferReceived_CB(
 
 void msink_rv_rtp::set_file_path(const char *file)
 {
-    if (!file)
+    boost::shared_ptr<rtp_dump_t> dump;
+    if (!file || !file[0])
     {
         m_file_path = "";
     }
     else
     {
         m_file_path = file;
+
+        //αIPͷʹñ˵ַץļа˿ָ·sink
+        rv_net_ipv4 addr;
+        construct_rv_net_ipv4(&addr);
+        convert_rvnet_to_ipv4(&addr, &m_local_address);
+        m_dump_ip = addr.ip;
+        m_dump_port = addr.port;
+
+        dump = rtp_dump_t::open(m_file_path);
     }
+
+    boost::atomic_store(&m_dump, dump);
 }
 
 uint32_t bitfieldSet(
@@ -734,7 +799,8 @@ void ConvertToNetwork(void *src, void *dest ,int32_t pos, int32_t n)
 }
 void msink_rv_rtp::write_file(rtp_block *rtp)
 {
-    if (m_file_path.empty())
+    boost::shared_ptr<rtp_dump_t> dump = boost::atomic_load(&m_dump);
+    if (!dump)
     {
         return;
     }
@@ -770,40 +836,31 @@ void msink_rv_rtp::write_file(rtp_block *rtp)
     header[0]=bitfieldSet(header[0],p->payload,16,7);
     header[0]=bitfieldSet(header[0],p->sequenceNumber,0,16);
     header[1]=p->timestamp;
-    header[2]=get_rtp_ssrc(&m_hrv);;
+    header[2]=get_rtp_ssrc(&m_hrv);
 
-    /*if (p->extensionBit)
-    {
-    header[3] = 0;
-    header[3] = bitfieldSet(header[3], p->extensionLength,  0,16);
-    header[3] = bitfieldSet(header[3], p->extensionProfile,16,16);
-    if (p->extensionLength>0)
+    //չͷheaderʱдץļ
+    uint32_t head_words = 3;
+    if (p->extensionBit && p->extensionData && p->extensionLength <= 12)
     {
-    uint32_t count = 0;
-    for (count=0;count<p->extensionLength;count++)
-    {
-    header[4+count] = p->extensionData[count];
-    }
-    }
-    ConvertToNetwork(header, 0, 4 + p->extensionLength);
+        header[3] = 0;
+        header[3] = bitfieldSet(header[3], p->extensionLength,  0,16);
+        header[3] = bitfieldSet(header[3], p->extensionProfile,16,16);
+        for (uint32_t count = 0; count < p->extensionLength; count++)
+        {
+            header[4+count] = p->extensionData[count];
+        }
+        head_words = 4 + p->extensionLength;
     }
-    else*/
+    else
     {
-        // converts an array of 4-byte integers from host format to network format
-        ConvertToNetwork(header, header_n, 0, 3);
+        header[0]=bitfieldSet(header[0],0,28,1);
     }
-    //////////////////////////////////////////////////////////////////////////*/
 
-    FILE *pF = ::fopen(m_file_path.c_str(), "ab");
-    if (pF)
-    {
-        uint32_t len_data = 12+raw_len;
-        ::fwrite(&len_data, sizeof(len_data), 1, pF);
-        ::fwrite(header_n, 12, 1, pF);
-        ::fwrite(raw_data+off_set, raw_len, 1, pF);
-        ::fclose(pF);
-    }
+    // converts an array of 4-byte integers from host format to network format
+    ConvertToNetwork(header, header_n, 0, head_words);
+    //////////////////////////////////////////////////////////////////////////*/
 
+    dump->write((uint8_t *)header_n, head_words * 4, raw_data + off_set, raw_len, m_dump_ip, m_dump_port);
 }
 
 void msink_rv_rtp::rv_write_rtp(rtp_block *rtp)
@@ -826,23 +883,54 @@ void msink_rv_rtp::rv_write_rtp(rtp_block *rtp)
 #endif
 	if (m_nReSend>0 && m_bReady && m_active)
 	{
-		//شڴ濽棬ΪҪ޸sinkڴ
-		rtp_block *rtp2 = m_rtp_pool.force_alloc_any();
-		if (rtp2)
-		{
-			rtp2->assign();
-			rtp2->m_bFrameInfo = false;
-
-			//rtp->read(rtp2->get_raw(), rtp2->size());
-			rtp2->copy(rtp);
-
-			//rtp2->set_params(rtp->m_rtp_param.len-rtp->m_rtp_param.sByte,rtp->m_rtp_param.sByte);
-			rtp2->set_rtp_param(&(rtp->m_rtp_param));
-		}
-		m_manReSend.addSeg(rtp2);
+		//شֻãReSendMan뻺ʱ޸sinkڴ
+		rtp->assign();
+		m_manReSend.addSeg(rtp);
 	}
 }
 void msink_rv_rtp::internel_write_to_rv_adapter(rtp_block *rtp)
+{
+    uint8_t * raw_data = internel_prepare_rtp(rtp);
+
+	::write_rtp(&m_hrv, raw_data, rtp->payload_totalsize(), &(rtp->m_rtp_param));
+
+    if (m_nReSend>0 && m_bReady && m_active)
+    {
+        if (!rtp->m_resend)
+        {
+            m_manReSend.addSeg(rtp);
+        }
+    }
+}
+
+void msink_rv_rtp::internel_write_to_rv_adapter(rtp_block **rtps, uint32_t count)
+{
+    rv_rtp_send_item items[MSINK_RV_RTP_SEND_BATCH];
+    if (count > MSINK_RV_RTP_SEND_BATCH) count = MSINK_RV_RTP_SEND_BATCH;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        rtp_block *rtp = rtps[i];
+        items[i].buf = internel_prepare_rtp(rtp);
+        items[i].buf_len = rtp->payload_totalsize();
+        ::memcpy(&items[i].param, &(rtp->m_rtp_param), sizeof(rv_rtp_param));
+    }
+
+    ::write_rtp_batch(&m_hrv, items, count);
+
+    if (m_nReSend>0 && m_bReady && m_active)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!rtps[i]->m_resend)
+            {
+                m_manReSend.addSeg(rtps[i]);
+            }
+        }
+    }
+}
+
+uint8_t *msink_rv_rtp::internel_prepare_rtp(rtp_block *rtp)
 {
     if (rtp && !rtp->m_resend)
     {
@@ -850,19 +938,15 @@ void msink_rv_rtp::internel_write_to_rv_adapter(rtp_block *rtp)
     }
 
     uint8_t * raw_data = 0;
-    uint32_t  raw_len  = 0;
-    uint8_t data[5120];
 
     tghelper::byte_block * bind_block = rtp->get_bind_block();
     if (bind_block)
     {
         raw_data = bind_block->get_raw();
-        raw_len  = bind_block->payload_totalsize();
     }
     else
     {
         raw_data = rtp->get_raw();
-        raw_len  = rtp->payload_totalsize();
     }
 
     if (rtp->m_use_ssrc)
@@ -889,12 +973,6 @@ void msink_rv_rtp::internel_write_to_rv_adapter(rtp_block *rtp)
             rtp->m_exHead[1] = rtp->m_infoFrame.frametype;
             rtp->m_exHead[2] = rtp->m_infoFrame.datatype;
             rtp->m_exHead[3] = rtp->m_priority;
-
-            ::memcpy(data, raw_data+rtp->m_rtp_param.sByte, rtp->payload_size());
-            ::memcpy(raw_data+rtp->m_rtp_param.sByte+20, data, rtp->payload_size());
-
-            rtp->m_rtp_param.sByte += 20;
-            rtp->set_params(rtp->payload_size(), rtp->m_rtp_param.sByte);
         }
         else
         {
@@ -903,13 +981,8 @@ void msink_rv_rtp::internel_write_to_rv_adapter(rtp_block *rtp)
             rtp->m_exHead[0] = rtp->m_infoFrame.verify;
             rtp->m_exHead[1] = rtp->m_infoFrame.frametype;
             rtp->m_exHead[2] = rtp->m_infoFrame.datatype;
-
-            ::memcpy(data, raw_data+rtp->m_rtp_param.sByte, rtp->payload_size());
-            ::memcpy(raw_data+rtp->m_rtp_param.sByte+16, data, rtp->payload_size());
-
-            rtp->m_rtp_param.sByte += 16;
-            rtp->set_params(rtp->payload_size(), rtp->m_rtp_param.sByte);
         }
+        rtp->reserve_rtp_head();
     }
     else if (m_open_pri > 0)
     {
@@ -917,23 +990,10 @@ void msink_rv_rtp::internel_write_to_rv_adapter(rtp_block *rtp)
         rtp->m_rtp_param.extensionLength = 1;
         rtp->m_rtp_param.extensionData = rtp->m_exHead;
         rtp->m_exHead[0] = rtp->m_priority;
-
-        ::memcpy(data, raw_data+rtp->m_rtp_param.sByte, rtp->payload_size());
-        ::memcpy(raw_data+rtp->m_rtp_param.sByte+8, data, rtp->payload_size());
-
-        rtp->m_rtp_param.sByte += 8;
-        rtp->set_params(rtp->payload_size(), rtp->m_rtp_param.sByte);
+        rtp->reserve_rtp_head();
     }
 
-	::write_rtp(&m_hrv, raw_data, rtp->payload_totalsize(), &(rtp->m_rtp_param));
-
-    if (m_nReSend>0 && m_bReady && m_active)
-    {
-        if (!rtp->m_resend)
-        {
-            m_manReSend.addSeg(rtp);
-        }
-    }
+    return raw_data;
 }
 
 #ifdef _USE_RTP_TRAFFIC_SHAPING
@@ -22,6 +22,7 @@
 #ifdef _USE_RTP_SEND_CONTROLLER
 #include "send_side_controller.h"
 #endif
+#include "rtp_dump.h"
 
 #define MAX_RTP_PACK	10240
 
@@ -167,6 +168,9 @@ namespace xt_mp_caster
         //rv_adapter
         void write_to_rv_adapter(rtp_block *rtp, bool bReSend = false);
 
+        //дռRTPpump_mrtp_outͷ
+        void flush_batch_rtps(rtp_block **rtps, uint32_t count);
+
     public:
         tghelper::recycle_queue m_fifo;
         rv_net_address m_local_address;
@@ -195,6 +199,11 @@ namespace xt_mp_caster
 
 		std::string m_file_path;
 
+		//ץļд󣬷߳set_file_path֮ͨatomic_load/atomic_store
+		boost::shared_ptr<rtp_dump_t> m_dump;
+		uint32_t m_dump_ip;
+		uint16_t m_dump_port;
+
     public:
         // RTCPص
         pSink_RtcpCB m_pSink_RtcpCB;
@@ -223,6 +232,10 @@ namespace xt_mp_caster
 
     public:
 		void internel_write_to_rv_adapter(rtp_block *rtp);
+		//дһ֡RTPrtpsеİ
+		void internel_write_to_rv_adapter(rtp_block **rtps, uint32_t count);
+		//дļssrcչͷش͵
+		uint8_t *internel_prepare_rtp(rtp_block *rtp);
 		inner::rtp_pool m_rtp_pool; //ڴأɿƲrtp_block
 		void rv_write_rtp(rtp_block *rtp);
 #ifdef _USE_RTP_TRAFFIC_SHAPING
@@ -0,0 +1,310 @@
+#include "rtp_dump.h"
+#include <string.h>
+#include <map>
+#include <sstream>
+
+#include "boost/weak_ptr.hpp"
+#include "boost/bind.hpp"
+#include "boost/date_time/posix_time/posix_time.hpp"
+
+#define _RTP_DUMP_CHUNK_ALIGN           4096
+
+namespace
+{
+    boost::mutex g_dump_mutex;
+    std::map<std::string, boost::weak_ptr<rtp_dump_t> > g_dumps;
+
+    inline void put_be16(uint8_t *p, uint16_t v)
+    {
+        p[0] = (uint8_t)(v >> 8);
+        p[1] = (uint8_t)v;
+    }
+
+    //pcapȫļͷֶΰֽдmagicʶ
+    struct pcap_file_head_t
+    {
+        uint32_t magic;
+        uint16_t version_major;
+        uint16_t version_minor;
+        int32_t  thiszone;
+        uint32_t sigfigs;
+        uint32_t snaplen;
+        uint32_t network;
+    };
+
+    struct pcap_record_head_t
+    {
+        uint32_t ts_sec;
+        uint32_t ts_usec;
+        uint32_t incl_len;
+        uint32_t orig_len;
+    };
+}
+
+boost::shared_ptr<rtp_dump_t> rtp_dump_t::open(const std::string &path)
+{
+    boost::mutex::scoped_lock lock(g_dump_mutex);
+
+    boost::shared_ptr<rtp_dump_t> dump = g_dumps[path].lock();
+    if (!dump)
+    {
+        dump.reset(new rtp_dump_t(path));
+        g_dumps[path] = dump;
+    }
+
+    return dump;
+}
+
+rtp_dump_t::rtp_dump_t(const std::string &path)
+:path_(path),
+file_(NULL),
+file_index_(0),
+file_bytes_(0),
+file_open_time_(0),
+chunk_raw_(NULL),
+chunk_(NULL),
+chunk_len_(0),
+records_(NULL),
+free_(MSINK_RTP_DUMP_RECORD_NUM),
+pending_(MSINK_RTP_DUMP_RECORD_NUM),
+run_(true),
+dropped_(0),
+ip_id_(0),
+thread_(NULL)
+{
+    //дļ鰴ҳ
+    chunk_raw_ = new uint8_t[MSINK_RTP_DUMP_CHUNK_SIZE + _RTP_DUMP_CHUNK_ALIGN];
+    chunk_ = (uint8_t *)(((uintptr_t)chunk_raw_ + _RTP_DUMP_CHUNK_ALIGN - 1) & ~(uintptr_t)(_RTP_DUMP_CHUNK_ALIGN - 1));
+
+    records_ = new record_t[MSINK_RTP_DUMP_RECORD_NUM];
+    for (uint32_t i = 0; i < MSINK_RTP_DUMP_RECORD_NUM; ++i)
+    {
+        free_.bounded_push(&records_[i]);
+    }
+
+    thread_ = new boost::thread(boost::bind(&rtp_dump_t::thread_work, this));
+}
+
+rtp_dump_t::~rtp_dump_t()
+{
+    //һͷźŻʱд뷽д߳ſնк˳
+    run_ = false;
+    if (thread_)
+    {
+        thread_->join();
+        delete thread_;
+        thread_ = NULL;
+    }
+
+    delete [] records_;
+    delete [] chunk_raw_;
+}
+
+bool rtp_dump_t::write(const uint8_t *head, uint32_t head_len, const uint8_t *payload, uint32_t payload_len,
+                       uint32_t src_ip, uint16_t src_port)
+{
+    uint32_t rtp_len = head_len + payload_len;
+    if (IP_UDP_HEAD_SIZE + rtp_len > RECORD_DATA_SIZE)
+    {
+        return false;
+    }
+
+    record_t *rec = NULL;
+    if (!free_.pop(rec))
+    {
+        ++dropped_;
+        return false;
+    }
+
+    boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+    static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+    boost::posix_time::time_duration since = now - epoch;
+    rec->ts_sec = (uint32_t)since.total_seconds();
+    rec->ts_usec = (uint32_t)(since.total_microseconds() % 1000000);
+    rec->len = IP_UDP_HEAD_SIZE + rtp_len;
+
+    //αIPv4ͷĿĵַ0
+    uint8_t *ip = rec->data;
+    ::memset(ip, 0, IP_UDP_HEAD_SIZE);
+    ip[0] = 0x45;
+    put_be16(ip + 2, (uint16_t)rec->len);
+    put_be16(ip + 4, (uint16_t)ip_id_.fetch_add(1, boost::memory_order_relaxed));
+    ip[8] = 64;
+    ip[9] = 17;
+    ::memcpy(ip + 12, &src_ip, 4);
+
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < 20; i += 2)
+    {
+        sum += ((uint32_t)ip[i] << 8) | ip[i + 1];
+    }
+    while (sum >> 16)
+    {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+    put_be16(ip + 10, (uint16_t)~sum);
+
+    //UDPͷУ0ʾУ
+    uint8_t *udp = ip + 20;
+    put_be16(udp, src_port);
+    put_be16(udp + 2, src_port);
+    put_be16(udp + 4, (uint16_t)(8 + rtp_len));
+
+    ::memcpy(rec->data + IP_UDP_HEAD_SIZE, head, head_len);
+    ::memcpy(rec->data + IP_UDP_HEAD_SIZE + head_len, payload, payload_len);
+
+    //¼һ£ʧ
+    pending_.bounded_push(rec);
+
+    return true;
+}
+
+void rtp_dump_t::thread_work()
+{
+    time_t last_flush = ::time(NULL);
+
+    for (;;)
+    {
+        bool stop = !run_;
+
+        uint32_t nums = 0;
+        record_t *rec = NULL;
+        while (pending_.pop(rec))
+        {
+            append(rec);
+            free_.bounded_push(rec);
+            ++nums;
+        }
+
+        //δĿMSINK_RTP_DUMP_FLUSH_SECONDS
+        time_t now = ::time(NULL);
+        if (chunk_len_ > 0 && (stop || now - last_flush >= MSINK_RTP_DUMP_FLUSH_SECONDS))
+        {
+            flush_chunk();
+        }
+        if (chunk_len_ == 0)
+        {
+            last_flush = now;
+        }
+
+        if (stop)
+        {
+            break;
+        }
+
+        if (0 == nums)
+        {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(CASTER_ENGINE_TIMER_SLICE));
+        }
+    }
+
+    close_file();
+}
+
+void rtp_dump_t::append(const record_t *rec)
+{
+    uint32_t need = sizeof(pcap_record_head_t) + rec->len;
+    if (chunk_len_ + need > MSINK_RTP_DUMP_CHUNK_SIZE)
+    {
+        flush_chunk();
+    }
+
+    pcap_record_head_t head;
+    head.ts_sec = rec->ts_sec;
+    head.ts_usec = rec->ts_usec;
+    head.incl_len = rec->len;
+    head.orig_len = rec->len;
+
+    ::memcpy(chunk_ + chunk_len_, &head, sizeof(head));
+    ::memcpy(chunk_ + chunk_len_ + sizeof(head), rec->data, rec->len);
+    chunk_len_ += need;
+}
+
+void rtp_dump_t::flush_chunk()
+{
+    if (chunk_len_ == 0)
+    {
+        return;
+    }
+
+    //Сʱзļֻڿ߽л֤ÿļpcap
+    if (file_)
+    {
+        bool rotate = false;
+        if (MSINK_RTP_DUMP_ROTATE_BYTES > 0 && file_bytes_ >= (uint64_t)MSINK_RTP_DUMP_ROTATE_BYTES)
+        {
+            rotate = true;
+        }
+        if (MSINK_RTP_DUMP_ROTATE_SECONDS > 0 && ::time(NULL) - file_open_time_ >= MSINK_RTP_DUMP_ROTATE_SECONDS)
+        {
+            rotate = true;
+        }
+        if (rotate)
+        {
+            close_file();
+            ++file_index_;
+        }
+    }
+
+    if (!file_ && !open_file())
+    {
+        //ļ򲻿ʱ飬д̶߳ѻ
+        chunk_len_ = 0;
+        return;
+    }
+
+    file_bytes_ += ::fwrite(chunk_, 1, chunk_len_, file_);
+    ::fflush(file_);
+    chunk_len_ = 0;
+}
+
+bool rtp_dump_t::open_file()
+{
+    std::string name = path_;
+    if (file_index_ > 0)
+    {
+        std::ostringstream os;
+        os << path_ << "." << file_index_;
+        name = os.str();
+    }
+
+    file_ = ::fopen(name.c_str(), "ab");
+    if (!file_)
+    {
+        return false;
+    }
+
+    //رstdio壬дchunk_
+    ::setvbuf(file_, NULL, _IONBF, 0);
+
+    ::fseek(file_, 0, SEEK_END);
+    long size = ::ftell(file_);
+    file_bytes_ = size > 0 ? (uint64_t)size : 0;
+    file_open_time_ = ::time(NULL);
+
+    //ļдpcapȫͷļ׷
+    if (0 == file_bytes_)
+    {
+        pcap_file_head_t head;
+        head.magic = 0xa1b2c3d4;
+        head.version_major = 2;
+        head.version_minor = 4;
+        head.thiszone = 0;
+        head.sigfigs = 0;
+        head.snaplen = 65535;
+        head.network = 101; //LINKTYPE_RAW
+        file_bytes_ += ::fwrite(&head, 1, sizeof(head), file_);
+    }
+
+    return true;
+}
+
+void rtp_dump_t::close_file()
+{
+    if (file_)
+    {
+        ::fclose(file_);
+        file_ = NULL;
+    }
+    file_bytes_ = 0;
+}
@@ -0,0 +1,76 @@
+#ifndef _RTP_DUMP_H_INCLUDED
+#define _RTP_DUMP_H_INCLUDED
+
+#include <stdio.h>
+#include <time.h>
+#include <string>
+#include "mp_caster_config.h"
+
+#include "boost/noncopyable.hpp"
+#include "boost/shared_ptr.hpp"
+#include "boost/thread.hpp"
+#include "boost/lockfree/queue.hpp"
+#include "boost/atomic.hpp"
+
+//RTPץļ첽д
+//ֻ߳һڴ濽ӣ̨߳дļ
+//ļΪpcapʽ(LINKTYPE_RAW)ÿRTPǰαIPv4/UDPͷWiresharkжԸUDP˿Decode As RTPɷ
+class rtp_dump_t : private boost::noncopyable
+{
+public:
+    //ͬһ·Ķsinkһд
+    static boost::shared_ptr<rtp_dump_t> open(const std::string &path);
+    ~rtp_dump_t();
+
+    //headΪRTPͷ(չͷ)src_ipΪֽsrc_portΪֽ
+    //м¼ľʱðfalse߳
+    bool write(const uint8_t *head, uint32_t head_len, const uint8_t *payload, uint32_t payload_len,
+        uint32_t src_ip, uint16_t src_port);
+
+    uint32_t dropped() const { return dropped_; }
+
+private:
+    enum
+    {
+        IP_UDP_HEAD_SIZE = 28,
+        RECORD_DATA_SIZE = IP_UDP_HEAD_SIZE + MP_BLOCK_POOL_SIZE + 64,
+    };
+
+    struct record_t
+    {
+        uint32_t ts_sec;
+        uint32_t ts_usec;
+        uint32_t len;
+        uint8_t data[RECORD_DATA_SIZE];
+    };
+
+    explicit rtp_dump_t(const std::string &path);
+
+    void thread_work();
+    void append(const record_t *rec);
+    void flush_chunk();
+    bool open_file();
+    void close_file();
+
+    std::string path_;
+
+    //³Աֻд߳з
+    FILE *file_;
+    uint32_t file_index_;
+    uint64_t file_bytes_;
+    time_t file_open_time_;
+    uint8_t *chunk_raw_;
+    uint8_t *chunk_;
+    uint32_t chunk_len_;
+
+    record_t *records_;
+    boost::lockfree::queue<record_t *> free_;
+    boost::lockfree::queue<record_t *> pending_;
+
+    boost::atomic_bool run_;
+    boost::atomic_uint32_t dropped_;
+    boost::atomic_uint16_t ip_id_;
+    boost::thread *thread_;
+};
+
+#endif //_RTP_DUMP_H_INCLUDED
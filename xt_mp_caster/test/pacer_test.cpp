@@ -0,0 +1,314 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   pacer_test.cpp
+// ȫַͽ(flow_pacer_t)Ļظز
+//
+// 1N(Ĭ5000)԰֡RTPСİ߳ÿ1msƽһʱ
+// 2ÿĳصUDP̣߳ն˰ͳڰĵ
+// 3밴ʼȽϣֵ׼p99ƫԲηʽһζԱ
+//
+// ÷pacer_test [sinks] [seconds] [port]
+///////////////////////////////////////////////////////////////////////////////////////////
+#include "mp_caster.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <algorithm>
+#include <vector>
+#include <boost/thread.hpp>
+
+//traffic_shaping.cpptraffic_shaping_wrapper_tcasterԲcaster˴ṩ׮
+namespace xt_mp_caster
+{
+	static flow_pacer_t g_pacer;
+	caster *caster::self() { return NULL; }
+	flow_pacer_t& caster::get_flow_pacer() { return g_pacer; }
+}
+
+namespace
+{
+	const uint32_t FRAME_PACKETS = 10;
+	const uint32_t PACKET_SIZE = 200;
+	const uint32_t FRAME_INTERVAL_MS = 1000;
+	const uint32_t FLOW_SPEED = 4000;
+	//traffic_shaping.cpp_TRAFFIC_SHAPING_FLOW_OUT_MULTIPLEһ
+	const double EXPECTED_GAP_US = PACKET_SIZE * 1000000.0 / (1.2 * FLOW_SPEED);
+
+	int64_t now_us()
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	}
+
+	struct test_packet
+	{
+		uint32_t sink;
+		uint32_t seq;
+	};
+
+	class test_op : public i_flow_op_t
+	{
+	public:
+		void release(void *flow) { delete static_cast<test_packet *>(flow); }
+		size_type size(void *) const { return PACKET_SIZE; }
+		uint32_t priority(void *) const { return 0; }
+	};
+
+	//صڽֱ߳sendto
+	class udp_out : public flow_out_callback_t
+	{
+	public:
+		udp_out() : m_sock(-1) {}
+		void on_flow_out(void *flow)
+		{
+			char buf[PACKET_SIZE];
+			memset(buf, 0, sizeof(buf));
+			memcpy(buf, flow, sizeof(test_packet));
+			::sendto(m_sock, buf, sizeof(buf), 0, (struct sockaddr *)&m_to, sizeof(m_to));
+		}
+
+		int m_sock;
+		struct sockaddr_in m_to;
+	};
+
+	struct sink_stat
+	{
+		sink_stat() : last_seq(0xffffffff), last_us(0), received(0) {}
+		uint32_t last_seq;
+		int64_t last_us;
+		uint32_t received;
+	};
+
+	volatile bool g_stop_pacer = false;
+	volatile bool g_stop_recv = false;
+
+	void pacer_thread(flow_pacer_t *pacer)
+	{
+		while (!g_stop_pacer)
+		{
+			pacer->advance(get_tick_count());
+			boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+		}
+	}
+
+	void recv_thread(int sock, std::vector<sink_stat> *stats, std::vector<int32_t> *gaps)
+	{
+		char buf[PACKET_SIZE];
+		while (!g_stop_recv)
+		{
+			int n = ::recv(sock, buf, sizeof(buf), 0);
+			if (n < (int)sizeof(test_packet))
+			{
+				continue;
+			}
+
+			int64_t t = now_us();
+			test_packet pkt;
+			memcpy(&pkt, buf, sizeof(pkt));
+			if (pkt.sink >= stats->size())
+			{
+				continue;
+			}
+
+			//ֻͳͬһ֡ڰļ֡װ߷ʱ̾
+			sink_stat &s = (*stats)[pkt.sink];
+			if (s.last_seq + 1 == pkt.seq && 0 != pkt.seq % FRAME_PACKETS)
+			{
+				gaps->push_back((int32_t)(t - s.last_us));
+			}
+			s.last_seq = pkt.seq;
+			s.last_us = t;
+			++s.received;
+		}
+	}
+
+	struct run_result
+	{
+		uint64_t sent;
+		uint64_t received;
+		double mean_us;
+		double stddev_us;
+		double p99_dev_us;
+	};
+
+	bool run(uint32_t sinks, int seconds, int port, bool paced, run_result &result)
+	{
+		int rsock = ::socket(AF_INET, SOCK_DGRAM, 0);
+		int ssock = ::socket(AF_INET, SOCK_DGRAM, 0);
+		int rcvbuf = 32 * 1024 * 1024;
+		::setsockopt(rsock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+		struct timeval tv = { 0, 100000 };
+		::setsockopt(rsock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+		struct sockaddr_in addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons((unsigned short)port);
+		if (0 != ::bind(rsock, (struct sockaddr *)&addr, sizeof(addr)))
+		{
+			printf("ERROR: can not bind port %d\n", port);
+			::close(rsock);
+			::close(ssock);
+			return false;
+		}
+
+		test_op op;
+		udp_out out;
+		out.m_sock = ssock;
+		out.m_to = addr;
+
+		flow_pacer_t pacer;
+		std::vector<flow_bucket_impl *> buckets;
+		for (uint32_t i = 0; i < sinks; ++i)
+		{
+			flow_bucket_impl *bucket = new flow_bucket_impl(FLOW_SPEED, 4 * FRAME_PACKETS, &op, &pacer);
+			bucket->register_callback(&out);
+			//Σflow_inֱӳ
+			if (!paced)
+			{
+				bucket->disable_for_time(3600 * 1000);
+			}
+			buckets.push_back(bucket);
+		}
+
+		std::vector<sink_stat> stats(sinks);
+		std::vector<int32_t> gaps;
+		gaps.reserve((size_t)sinks * FRAME_PACKETS * (seconds + 1) * 1000 / FRAME_INTERVAL_MS);
+
+		g_stop_pacer = false;
+		g_stop_recv = false;
+		boost::thread receiver(boost::bind(recv_thread, rsock, &stats, &gaps));
+		boost::thread ticker(boost::bind(pacer_thread, &pacer));
+
+		//ߣ֡֡ھȴ
+		uint64_t sent = 0;
+		uint32_t frames = (uint32_t)seconds * 1000 / FRAME_INTERVAL_MS;
+		std::vector<uint32_t> next_frame(sinks, 0);
+		int64_t begin = now_us();
+		for (;;)
+		{
+			int64_t elapsed = now_us() - begin;
+			bool done = true;
+			for (uint32_t i = 0; i < sinks; ++i)
+			{
+				if (next_frame[i] >= frames)
+				{
+					continue;
+				}
+				done = false;
+
+				int64_t due = (int64_t)next_frame[i] * FRAME_INTERVAL_MS * 1000 + (int64_t)i * FRAME_INTERVAL_MS * 1000 / sinks;
+				if (due > elapsed)
+				{
+					continue;
+				}
+
+				for (uint32_t p = 0; p < FRAME_PACKETS; ++p)
+				{
+					test_packet *pkt = new test_packet;
+					pkt->sink = i;
+					pkt->seq = next_frame[i] * FRAME_PACKETS + p;
+					if (buckets[i]->flow_in(pkt))
+					{
+						++sent;
+					}
+					else
+					{
+						delete pkt;
+					}
+				}
+				++next_frame[i];
+			}
+			if (done)
+			{
+				break;
+			}
+			boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+		}
+
+		//ȴһ֡ʷ
+		boost::this_thread::sleep(boost::posix_time::milliseconds(FRAME_INTERVAL_MS));
+		g_stop_pacer = true;
+		ticker.join();
+		boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+		g_stop_recv = true;
+		receiver.join();
+
+		for (uint32_t i = 0; i < sinks; ++i)
+		{
+			delete buckets[i];
+		}
+		::close(rsock);
+		::close(ssock);
+
+		result.sent = sent;
+		result.received = 0;
+		for (uint32_t i = 0; i < sinks; ++i)
+		{
+			result.received += stats[i].received;
+		}
+
+		double sum = 0.0;
+		double sq = 0.0;
+		std::vector<int32_t> dev(gaps.size());
+		for (size_t i = 0; i < gaps.size(); ++i)
+		{
+			sum += gaps[i];
+			double d = gaps[i] - EXPECTED_GAP_US;
+			sq += d * d;
+			dev[i] = (int32_t)fabs(d);
+		}
+		size_t n = gaps.empty() ? 1 : gaps.size();
+		result.mean_us = sum / n;
+		result.stddev_us = sqrt(sq / n);
+		std::sort(dev.begin(), dev.end());
+		result.p99_dev_us = dev.empty() ? 0.0 : dev[dev.size() * 99 / 100];
+		return true;
+	}
+
+	void print(const char *mode, const run_result &r)
+	{
+		printf("%-7s sent %llu, received %llu, gap mean %.2f ms (expected %.2f ms), stddev %.2f ms, p99 deviation %.2f ms\n",
+			mode, (unsigned long long)r.sent, (unsigned long long)r.received,
+			r.mean_us / 1000.0, EXPECTED_GAP_US / 1000.0, r.stddev_us / 1000.0, r.p99_dev_us / 1000.0);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t sinks = (argc > 1) ? (uint32_t)atoi(argv[1]) : 5000;
+	int seconds = (argc > 2) ? atoi(argv[2]) : 5;
+	int port = (argc > 3) ? atoi(argv[3]) : 23000;
+	if (0 == sinks || seconds <= 0)
+	{
+		printf("usage: pacer_test [sinks] [seconds] [port]\n");
+		return 1;
+	}
+
+	printf("%u sinks, %u packets of %u bytes per %u ms frame, %u bytes/s per sink\n",
+		sinks, FRAME_PACKETS, PACKET_SIZE, FRAME_INTERVAL_MS, FLOW_SPEED);
+
+	run_result paced;
+	run_result direct;
+	if (!run(sinks, seconds, port, true, paced) || !run(sinks, seconds, port, false, direct))
+	{
+		return 1;
+	}
+	print("paced", paced);
+	print("direct", direct);
+
+	//Ϊ1ms̵߳ȶʱƫԼΪ
+	bool ok = (paced.sent == paced.received)
+		&& (fabs(paced.mean_us - EXPECTED_GAP_US) < EXPECTED_GAP_US * 0.05)
+		&& (paced.p99_dev_us < EXPECTED_GAP_US / 4);
+	printf("%s\n", ok ? "PASS" : "FAIL");
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,300 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   ps_mux_test.cpp
+// mp_28181_psװķװ/װ
+//
+// 1bc_mpķƬ(mtu - MP_PSEUDO_RTP_PAYLOAD_OFFSET)ռPSƬƴӺñļе
+//    οװpackͷϵͳͷPSM(УCRC32)PES
+// 2H264/H265Ƶ(PESȵIDR벻ʼNAL33λʱ)
+//    G711A/G711UƵϷװԼAACƵ
+// 3ֽڱȽϻԭĻȽPTSPSMе
+//
+// ÷ps_mux_test
+///////////////////////////////////////////////////////////////////////////////////////////
+#include "mp_28181_ps.h"
+#include "mp_caster_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+	uint32_t g_errors = 0;
+
+	#define CHECK(cond) do { if (!(cond)) { ++g_errors; printf("  check failed: %s (line %d)\n", #cond, __LINE__); } } while (0)
+
+	const uint64_t PTS_MASK = (1ULL << 33) - 1;
+
+	//ռƬģrtp_ps_sinkķƬ
+	class vector_sink : public ps_slice_sink
+	{
+	public:
+		explicit vector_sink(uint32_t capacity) : m_slices(0), m_capacity(capacity), m_open(false) {}
+
+		virtual uint8_t *alloc_slice(uint32_t &capacity)
+		{
+			CHECK(!m_open);
+			m_open = true;
+			capacity = m_capacity;
+			return m_buf;
+		}
+
+		virtual bool commit_slice(uint32_t size)
+		{
+			CHECK(m_open && size > 0 && size <= m_capacity);
+			m_open = false;
+			m_stream.insert(m_stream.end(), m_buf, m_buf + size);
+			++m_slices;
+			return true;
+		}
+
+		std::vector<uint8_t> m_stream;
+		uint32_t m_slices;
+
+	private:
+		uint32_t m_capacity;
+		bool m_open;
+		uint8_t m_buf[4096];
+	};
+
+	uint32_t crc32_mpeg2(const uint8_t *data, uint32_t len)
+	{
+		uint32_t crc = 0xFFFFFFFF;
+		for (uint32_t i = 0; i < len; ++i)
+		{
+			crc ^= (uint32_t)data[i] << 24;
+			for (int k = 0; k < 8; ++k)
+			{
+				crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : (crc << 1);
+			}
+		}
+		return crc;
+	}
+
+	uint64_t read_pts(const uint8_t *p)
+	{
+		return ((uint64_t)((p[0] >> 1) & 0x07) << 30) | ((uint64_t)p[1] << 22) |
+			((uint64_t)(p[2] >> 1) << 15) | ((uint64_t)p[3] << 7) | (p[4] >> 1);
+	}
+
+	//οװֱֻ֧װṹ
+	struct ps_demuxer
+	{
+		std::vector<uint8_t> es[256];
+		std::vector<uint64_t> pts[256];
+		uint8_t types[256];
+		uint32_t packs, sys_headers, psms;
+
+		ps_demuxer() : packs(0), sys_headers(0), psms(0) { memset(types, 0, sizeof(types)); }
+
+		void run(const std::vector<uint8_t> &s)
+		{
+			size_t i = 0;
+			while (i + 6 <= s.size())
+			{
+				const uint8_t *p = &s[i];
+				if (0 != p[0] || 0 != p[1] || 1 != p[2])
+				{
+					CHECK(!"start code");
+					return;
+				}
+
+				if (0xBA == p[3])
+				{
+					//MPEG-2 packͷλ
+					CHECK(0x44 == (p[4] & 0xC4) && (p[6] & 0x04) && (p[8] & 0x04) && (p[9] & 0x01));
+					CHECK(0x03 == (p[12] & 0x03));
+					++packs;
+					i += PS_HDR_LEN + (p[13] & 0x07);
+					continue;
+				}
+
+				uint32_t len = ((uint32_t)p[4] << 8) | p[5];
+				CHECK(i + 6 + len <= s.size());
+				if (i + 6 + len > s.size()) return;
+
+				if (0xBB == p[3])
+				{
+					++sys_headers;
+				}
+				else if (0xBC == p[3])
+				{
+					++psms;
+					CHECK(0 == crc32_mpeg2(p, len + 6));
+					uint32_t info_len = ((uint32_t)p[8] << 8) | p[9];
+					uint32_t map_len = ((uint32_t)p[10 + info_len] << 8) | p[11 + info_len];
+					const uint8_t *m = p + 12 + info_len;
+					for (uint32_t k = 0; k + 4 <= map_len; )
+					{
+						types[m[k + 1]] = m[k];
+						k += 4 + (((uint32_t)m[k + 2] << 8) | m[k + 3]);
+					}
+				}
+				else if (p[3] >= 0xC0 && p[3] <= 0xEF)
+				{
+					CHECK(0x80 == (p[6] & 0xC0));
+					uint32_t hdr_len = p[8];
+					if (p[7] & 0x80)
+					{
+						CHECK(0x02 == (p[9] >> 4));
+						pts[p[3]].push_back(read_pts(p + 9));
+					}
+					es[p[3]].insert(es[p[3]].end(), p + 9 + hdr_len, p + 6 + len);
+				}
+				else
+				{
+					CHECK(!"stream id");
+				}
+				i += 6 + len;
+			}
+			CHECK(i == s.size());
+		}
+	};
+
+	void random_fill(std::vector<uint8_t> &buf, size_t from)
+	{
+		//ڲ0αʼ
+		for (size_t k = from; k < buf.size(); ++k) buf[k] = (uint8_t)(rand() | 1);
+	}
+
+	//ǰ100֡H264100֡H265ÿ֡һ֡G711
+	void run_av(uint32_t mtu, uint8_t g711_type)
+	{
+		mp_28181_ps muxer;
+		vector_sink sink(mtu - MP_PSEUDO_RTP_PAYLOAD_OFFSET);
+		std::vector<uint8_t> video_es, audio_es;
+		std::vector<uint64_t> video_pts, audio_pts;
+
+		for (int f = 0; f < 200; ++f)
+		{
+			bool h265 = f >= 100;
+			uint8_t stream_type = h265 ? PS_STREAM_H265 : PS_STREAM_H264;
+			//150֡ʱԽ33λ
+			uint64_t pts = (f > 150) ? (PTS_MASK - 7200 + (uint64_t)(f - 150) * 3600) & PTS_MASK : 900000 + (uint64_t)f * 3600;
+
+			std::vector<std::vector<uint8_t> > nals;
+			if (0 == f % 50)
+			{
+				uint8_t sps[] = {0, 0, 0, 1, (uint8_t)(h265 ? 0x42 : 0x67), 1, 2, 3};
+				uint8_t pps[] = {0, 0, 1, (uint8_t)(h265 ? 0x44 : 0x68), 4, 5};
+				nals.push_back(std::vector<uint8_t>(sps, sps + sizeof(sps)));
+				nals.push_back(std::vector<uint8_t>(pps, pps + sizeof(pps)));
+
+				//50֡IDRPS_PES_PAYLOAD_SIZEɶPES
+				std::vector<uint8_t> idr((50 == f) ? 200000 : 5000);
+				idr[3] = 1;
+				idr[4] = h265 ? 0x26 : 0x65;
+				random_fill(idr, 5);
+				nals.push_back(idr);
+			}
+			else
+			{
+				std::vector<uint8_t> nal(100 + rand() % 3000);
+				size_t head = 0;
+				if (f % 3)
+				{
+					nal[2] = 1;
+					head = 3;
+				}
+				nal[head] = h265 ? 0x02 : 0x41;
+				random_fill(nal, head + 1);
+				nals.push_back(nal);
+			}
+
+			for (size_t n = 0; n < nals.size(); ++n)
+			{
+				CHECK(muxer.mux_video(&sink, stream_type, &nals[n][0], (uint32_t)nals[n].size(), pts));
+				//ʼNALɷװ00 00 00 01
+				if (0 != nals[n][0])
+				{
+					const uint8_t sc[] = {0, 0, 0, 1};
+					video_es.insert(video_es.end(), sc, sc + 4);
+				}
+				video_es.insert(video_es.end(), nals[n].begin(), nals[n].end());
+			}
+			video_pts.push_back(pts);
+
+			std::vector<uint8_t> pcm(160);
+			for (size_t k = 0; k < pcm.size(); ++k) pcm[k] = (uint8_t)rand();
+			uint64_t apts = (pts + 1800) & PTS_MASK;
+			CHECK(muxer.mux_audio(&sink, g711_type, &pcm[0], (uint32_t)pcm.size(), apts));
+			audio_es.insert(audio_es.end(), pcm.begin(), pcm.end());
+			audio_pts.push_back(apts);
+		}
+
+		ps_demuxer demux;
+		demux.run(sink.m_stream);
+
+		//ͬһ֡ĶNALһPTSֵPESֻ׸PTS
+		std::vector<uint64_t> got_pts;
+		for (size_t k = 0; k < demux.pts[PS_VIDEO_STREAM_ID].size(); ++k)
+		{
+			if (got_pts.empty() || got_pts.back() != demux.pts[PS_VIDEO_STREAM_ID][k])
+			{
+				got_pts.push_back(demux.pts[PS_VIDEO_STREAM_ID][k]);
+			}
+		}
+
+		bool video_ok = demux.es[PS_VIDEO_STREAM_ID] == video_es;
+		bool audio_ok = demux.es[PS_AUDIO_STREAM_ID] == audio_es;
+		CHECK(video_ok);
+		CHECK(audio_ok);
+		CHECK(got_pts == video_pts);
+		CHECK(demux.pts[PS_AUDIO_STREAM_ID] == audio_pts);
+		CHECK(PS_STREAM_H265 == demux.types[PS_VIDEO_STREAM_ID]);
+		CHECK(g711_type == demux.types[PS_AUDIO_STREAM_ID]);
+		CHECK(demux.psms > 0 && demux.sys_headers == demux.psms);
+
+		printf("mtu %4u %s: %u slices, %u packs, %u psm, video %s, audio %s\n",
+			mtu, (PS_STREAM_G711U == g711_type) ? "g711u" : "g711a", sink.m_slices, demux.packs, demux.psms,
+			video_ok ? "ok" : "MISMATCH", audio_ok ? "ok" : "MISMATCH");
+	}
+
+	//AACƵʱϵͳͷPSMƵ·
+	void run_aac()
+	{
+		mp_28181_ps muxer;
+		vector_sink sink(MP_PSEUDO_RTP_MAX_SIZE - MP_PSEUDO_RTP_PAYLOAD_OFFSET);
+		std::vector<uint8_t> audio_es;
+		std::vector<uint64_t> audio_pts;
+		for (int f = 0; f < 120; ++f)
+		{
+			std::vector<uint8_t> adts(300);
+			adts[0] = 0xFF;
+			adts[1] = 0xF1;
+			for (size_t k = 2; k < adts.size(); ++k) adts[k] = (uint8_t)rand();
+			uint64_t pts = (uint64_t)f * 1920;
+			CHECK(muxer.mux_audio(&sink, PS_STREAM_AAC, &adts[0], (uint32_t)adts.size(), pts));
+			audio_es.insert(audio_es.end(), adts.begin(), adts.end());
+			audio_pts.push_back(pts);
+		}
+
+		ps_demuxer demux;
+		demux.run(sink.m_stream);
+		bool audio_ok = demux.es[PS_AUDIO_STREAM_ID] == audio_es;
+		CHECK(audio_ok);
+		CHECK(demux.pts[PS_AUDIO_STREAM_ID] == audio_pts);
+		CHECK(PS_STREAM_AAC == demux.types[PS_AUDIO_STREAM_ID]);
+		CHECK(0 == demux.types[PS_VIDEO_STREAM_ID]);
+		CHECK(demux.psms > 0);
+
+		printf("aac only: %u slices, %u packs, %u psm, audio %s\n",
+			sink.m_slices, demux.packs, demux.psms, audio_ok ? "ok" : "MISMATCH");
+	}
+}
+
+int main()
+{
+	srand(1);
+	const uint32_t mtus[] = {300, 900, MP_PSEUDO_RTP_MAX_SIZE, 1500};
+	for (size_t i = 0; i < sizeof(mtus) / sizeof(mtus[0]); ++i)
+	{
+		run_av(mtus[i], PS_STREAM_G711A);
+		run_av(mtus[i], PS_STREAM_G711U);
+	}
+	run_aac();
+
+	printf("%s\n", (0 == g_errors) ? "PASS" : "FAIL");
+	return (0 == g_errors) ? 0 : 1;
+}
@@ -4,6 +4,10 @@
 #include "mp_caster.h"
 
 #define _TRAFFIC_SHAPING_FLOW_OUT_MULTIPLE          1.2
+//ηһʱ෢͵İⵥռס
+#define _TRAFFIC_SHAPING_PACE_BURST                 64
+//ʱӳʱಹʱ(us)
+#define _TRAFFIC_SHAPING_PACE_SLACK_US              1000
 
 traffic_shaping_t::traffic_shaping_t(i_flow_bucket_t *flow_bucket, i_speed_calc_t *speed_calc, i_flow_op_t *op)
 :flow_bucket_(flow_bucket),
@@ -45,24 +49,247 @@ void traffic_shaping_t::on_network_changed(uint32_t speed)
     }
 }
 
-flow_bucket_impl::flow_bucket_impl(uint32_t init_speed, uint32_t max_flow_num, i_flow_op_t *op)
+flow_pacer_t::flow_pacer_t()
+:current_(0),
+started_(false),
+incoming_(1024)
+{
+    ::memset(wheel_, 0, sizeof(wheel_));
+}
+
+flow_pacer_t::~flow_pacer_t()
+{}
+
+void flow_pacer_t::wakeup(flow_bucket_impl *bucket)
+{
+    //ӣɽ߳һĹʱ
+    incoming_.push(bucket);
+}
+
+void flow_pacer_t::detach(flow_bucket_impl *bucket)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+
+    //֤incoming_вٲ
+    drain_incoming(current_);
+    if (NULL != bucket->head_)
+    {
+        unlink(bucket);
+    }
+
+    //˺flow_inٻѽ
+    bucket->armed_ = true;
+    bucket->pacer_ = NULL;
+}
+
+uint32_t flow_pacer_t::on_expires()
+{
+    advance(get_tick_count());
+    return 1;
+}
+
+void flow_pacer_t::advance(tick_count_t now)
+{
+    boost::mutex::scoped_lock lock(mutex_);
+
+    if (!started_)
+    {
+        current_ = now;
+        started_ = true;
+    }
+
+    drain_incoming(now);
+
+    while (current_ <= now)
+    {
+        uint32_t index = static_cast<uint32_t>(current_) & (WHEEL_SIZE0 - 1);
+        if (0 == index)
+        {
+            //µһȦϲӦе
+            uint32_t index1 = static_cast<uint32_t>(current_ >> WHEEL_BITS0) & (WHEEL_SIZE - 1);
+            if (0 == index1)
+            {
+                cascade(2, static_cast<uint32_t>(current_ >> (WHEEL_BITS0 + WHEEL_BITS)) & (WHEEL_SIZE - 1));
+            }
+            cascade(1, index1);
+        }
+
+        flow_bucket_impl *bucket = wheel_[0][index];
+        wheel_[0][index] = NULL;
+        while (NULL != bucket)
+        {
+            flow_bucket_impl *next = bucket->next_;
+            bucket->prev_ = NULL;
+            bucket->next_ = NULL;
+            bucket->head_ = NULL;
+
+            run_bucket(bucket, now);
+            bucket = next;
+        }
+
+        ++current_;
+    }
+}
+
+void flow_pacer_t::drain_incoming(tick_count_t now)
+{
+    flow_bucket_impl *bucket = NULL;
+    while (incoming_.pop(bucket))
+    {
+        //ڼ䲻ۻͶ
+        int64_t now_us = now * 1000;
+        if (bucket->next_send_us_ < now_us)
+        {
+            bucket->next_send_us_ = now_us;
+        }
+        insert(bucket, (bucket->next_send_us_ + 999) / 1000);
+    }
+}
+
+void flow_pacer_t::insert(flow_bucket_impl *bucket, tick_count_t due)
+{
+    if (due < current_)
+    {
+        due = current_;
+    }
+
+    tick_count_t delta = due - current_;
+    flow_bucket_impl **head = NULL;
+    if (delta < WHEEL_SIZE0)
+    {
+        head = &wheel_[0][static_cast<uint32_t>(due) & (WHEEL_SIZE0 - 1)];
+    }
+    else if (delta < WHEEL_SIZE0 * WHEEL_SIZE)
+    {
+        head = &wheel_[1][static_cast<uint32_t>(due >> WHEEL_BITS0) & (WHEEL_SIZE - 1)];
+    }
+    else
+    {
+        if (delta >= WHEEL_SIZE0 * WHEEL_SIZE * WHEEL_SIZE)
+        {
+            due = current_ + WHEEL_SIZE0 * WHEEL_SIZE * WHEEL_SIZE - 1;
+        }
+        head = &wheel_[2][static_cast<uint32_t>(due >> (WHEEL_BITS0 + WHEEL_BITS)) & (WHEEL_SIZE - 1)];
+    }
+
+    bucket->due_ = due;
+    bucket->prev_ = NULL;
+    bucket->next_ = *head;
+    if (NULL != *head)
+    {
+        (*head)->prev_ = bucket;
+    }
+    *head = bucket;
+    bucket->head_ = head;
+}
+
+void flow_pacer_t::unlink(flow_bucket_impl *bucket)
+{
+    if (NULL != bucket->prev_)
+    {
+        bucket->prev_->next_ = bucket->next_;
+    }
+    else
+    {
+        *bucket->head_ = bucket->next_;
+    }
+
+    if (NULL != bucket->next_)
+    {
+        bucket->next_->prev_ = bucket->prev_;
+    }
+
+    bucket->prev_ = NULL;
+    bucket->next_ = NULL;
+    bucket->head_ = NULL;
+}
+
+void flow_pacer_t::cascade(uint32_t level, uint32_t index)
+{
+    flow_bucket_impl *bucket = wheel_[level][index];
+    wheel_[level][index] = NULL;
+    while (NULL != bucket)
+    {
+        flow_bucket_impl *next = bucket->next_;
+        insert(bucket, bucket->due_);
+        bucket = next;
+    }
+}
+
+void flow_pacer_t::run_bucket(flow_bucket_impl *bucket, tick_count_t now)
+{
+    if (bucket->pace(now * 1000))
+    {
+        //һĿɷʱ䣬Ƴٵһ
+        tick_count_t due = (bucket->next_send_us_ + 999) / 1000;
+        if (due <= now)
+        {
+            due = now + 1;
+        }
+        insert(bucket, due);
+        return;
+    }
+
+    bucket->armed_ = false;
+
+    //ÿǰ߿ѷݵδѽ
+    if (!bucket->flows_.empty() && !bucket->armed_.exchange(true))
+    {
+        insert(bucket, now + 1);
+    }
+}
+
+flow_bucket_impl::flow_bucket_impl(uint32_t init_speed, uint32_t max_flow_num, i_flow_op_t *op, flow_pacer_t *pacer)
 :flows_(max_flow_num),
 op_(op),
 cb_(NULL),
 speed_(init_speed),
-disabled_deadline_ms_(0)
+disabled_deadline_ms_(0),
+pacer_(pacer),
+armed_(false),
+next_send_us_(0),
+due_(0),
+prev_(NULL),
+next_(NULL),
+head_(NULL)
 {}
 
+flow_bucket_impl::~flow_bucket_impl()
+{
+    if (NULL != pacer_)
+    {
+        pacer_->detach(this);
+    }
+
+    void *flow = NULL;
+    while (flows_.pop(flow))
+    {
+        if (NULL != op_)
+        {
+            op_->release(flow);
+        }
+    }
+}
+
 bool flow_bucket_impl::flow_in(void *flow)
 {
-    if (in_disabled_time())
+    if (in_disabled_time() || (NULL == pacer_))
     {
         return (0 != flow_out_directly(flow));
     }
-    else
+
+    if (!flows_.bounded_push(flow))
     {
-        return flows_.bounded_push(flow);
+        return false;
     }
+
+    //ɿձΪǿʱ
+    if (!armed_.exchange(true))
+    {
+        pacer_->wakeup(this);
+    }
+
+    return true;
 }
 
 uint32_t flow_bucket_impl::flow_out_directly(void *flow)
@@ -110,33 +337,36 @@ void flow_bucket_impl::disable_for_time(uint32_t ms)
     disabled_deadline_ms_ = get_tick_count() + ms;
 }
 
-uint32_t flow_bucket_impl::on_expires()
+bool flow_bucket_impl::pace(int64_t now_us)
 {
-    uint32_t total_bytes = 0;
+    //ಹһǷµİⶨʱӳٺͻ
+    if (next_send_us_ < now_us - _TRAFFIC_SHAPING_PACE_SLACK_US)
+    {
+        next_send_us_ = now_us - _TRAFFIC_SHAPING_PACE_SLACK_US;
+    }
 
-    while (true)
+    uint32_t speed = speed_;
+    for (uint32_t i = 0; i < _TRAFFIC_SHAPING_PACE_BURST; ++i)
     {
-        void *flow = NULL;
-        if (!flows_.pop(flow))
+        if (next_send_us_ > now_us)
         {
-            break;
+            return true;
         }
 
-        total_bytes += flow_out_directly(flow);
-
-        uint32_t expires = 0;
-        if (speed_ >= 0)
+        void *flow = NULL;
+        if (!flows_.pop(flow))
         {
-            expires = static_cast<uint32_t>(total_bytes * 1000 / (_TRAFFIC_SHAPING_FLOW_OUT_MULTIPLE * speed_));
+            return false;
         }
 
-        if (expires > 0)
+        uint32_t size_of_flow = flow_out_directly(flow);
+        if (speed > 0)
         {
-            return expires;
+            next_send_us_ += static_cast<int64_t>(size_of_flow * 1000000.0 / (_TRAFFIC_SHAPING_FLOW_OUT_MULTIPLE * speed));
         }
     }
 
-    return 0;
+    return true;
 }
 
 speed_calc_window_impl::speed_calc_window_impl(uint16_t num_of_windows, uint16_t calc_ms_priod)
@@ -251,12 +481,10 @@ public:
 };
 
 traffic_shaping_wrapper_t::traffic_shaping_wrapper_t(uint32_t init_speed, uint32_t max_flow_num, uint16_t num_of_windows, uint16_t calc_ms_priod)
-:flow_bucket_impl(init_speed, max_flow_num, rtp_op_impl::create()),
+:flow_bucket_impl(init_speed, max_flow_num, rtp_op_impl::create(), &xt_mp_caster::caster::self()->get_flow_pacer()),
 speed_calc_window_impl(num_of_windows, calc_ms_priod),
 traffic_shaping_t(this, this, rtp_op_impl::create())
-{
-    xt_mp_caster::caster::self()->get_timer_mgr().add_timer(this);
-}
+{}
 
 #endif	//_USE_RTP_TRAFFIC_SHAPING
 
@@ -7,6 +7,7 @@
 #include "boost/lockfree/queue.hpp"
 #include "boost/atomic.hpp"
 #include "boost/circular_buffer.hpp"
+#include "boost/thread/mutex.hpp"
 
 class i_flow_op_t
 {
@@ -74,17 +75,66 @@ private:
     i_flow_op_t *op_;
 };
 
-class flow_bucket_impl : public i_flow_bucket_t, public deadline_timer_callback_t
+class flow_bucket_impl;
+
+//ȫַͽ
+//һֲʱ֣caster1msʱ
+//ÿĿʼһοɷʱʱ֣//ھΪO(1)޹
+class flow_pacer_t : public deadline_timer_callback_t
 {
 public:
-    flow_bucket_impl(uint32_t init_speed, uint32_t max_flow_num, i_flow_op_t *op);
+    enum
+    {
+        WHEEL_BITS0 = 8,
+        WHEEL_BITS = 6,
+        WHEEL_SIZE0 = 1 << WHEEL_BITS0,     //0ÿ1ms
+        WHEEL_SIZE = 1 << WHEEL_BITS,       //ϲÿΪ²һȦ
+        WHEEL_LEVELS = 3,
+    };
+
+    flow_pacer_t();
+    ~flow_pacer_t();
+
+    //ɿձΪǿʱã߳
+    void wakeup(flow_bucket_impl *bucket);
+
+    //ǰãغٷʸ
+    void detach(flow_bucket_impl *bucket);
+
+    //ƽʱnow(ms)͵ڵһεü
+    uint32_t on_expires();
+    void advance(tick_count_t now);
+
+private:
+    void drain_incoming(tick_count_t now);
+    void insert(flow_bucket_impl *bucket, tick_count_t due);
+    void unlink(flow_bucket_impl *bucket);
+    void cascade(uint32_t level, uint32_t index);
+    void run_bucket(flow_bucket_impl *bucket, tick_count_t now);
+
+    flow_bucket_impl *wheel_[WHEEL_LEVELS][WHEEL_SIZE0];
+    tick_count_t current_;
+    bool started_;
+
+    boost::lockfree::queue<flow_bucket_impl *> incoming_;
+    boost::mutex mutex_;
+};
+
+class flow_bucket_impl : public i_flow_bucket_t
+{
+public:
+    flow_bucket_impl(uint32_t init_speed, uint32_t max_flow_num, i_flow_op_t *op, flow_pacer_t *pacer);
+    ~flow_bucket_impl();
 
     bool flow_in(void *flow);
     void register_callback(flow_out_callback_t *cb);
     void update_speed(uint32_t speed);
     void disable_for_time(uint32_t ms);
 private:
-    uint32_t on_expires();
+    friend class flow_pacer_t;
+
+    //̵߳ãnext_send_us_now_usİضǷ
+    bool pace(int64_t now_us);
     uint32_t flow_out_directly(void *flow);
     bool in_disabled_time();
 
@@ -95,6 +145,15 @@ private:
     boost::atomic_uint32_t speed_;
 
     volatile int64_t disabled_deadline_ms_;
+
+    //³Աɽά
+    flow_pacer_t *pacer_;
+    boost::atomic_bool armed_;      //ڽ(ֻ)
+    int64_t next_send_us_;
+    tick_count_t due_;
+    flow_bucket_impl *prev_;
+    flow_bucket_impl *next_;
+    flow_bucket_impl **head_;       //ʱָNULLʾδ
 };
 
 class speed_calc_window_impl : public i_speed_calc_t
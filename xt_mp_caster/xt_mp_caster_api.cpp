@@ -12,6 +12,7 @@
 #include "bc_mp.h"
 #include <../rv_adapter/rv_api.h>
 #include "msink_rv_rtp.h"
+#include "XTDemuxMan.h"
 #include <stdarg.h>
 #include <stdio.h>
 
@@ -449,6 +450,16 @@ void mp_set_file_path(MP_IN mp_h	hmp,
 	mp->set_file_path(file);
 }
 
+void mp_query_demux_stats(MP_OUT xt_demux_stats *stats)
+{
+	if (!stats)
+	{
+		return;
+	}
+
+	XTDemuxMan::instance()->get_stats(*stats);
+}
+
 #ifdef _USE_RTP_SEND_CONTROLLER
 void mp_register_network_changed_callback(mp_handle hmp, mp_network_changed_callback_t cb, void *ctx)
 {
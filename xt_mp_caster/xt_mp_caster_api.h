@@ -161,6 +161,9 @@ XT_MP_CASTER_API void set_raddr_cb(mp_h	hmp, raddr_cb cb);
 XT_MP_CASTER_API void mp_set_file_path(MP_IN mp_h	hmp,				//Ŀmp
 									MP_IN const char *file);		//ļ·
 
+// ѯûỰͳ
+XT_MP_CASTER_API void mp_query_demux_stats(MP_OUT xt_demux_stats *stats);
+
 #ifdef _USE_RTP_SEND_CONTROLLER
 typedef void (*mp_network_changed_callback_t)(void *ctx, mp_handle hmp, uint32_t bitrate, uint32_t fraction_lost, uint32_t rtt);
 XT_MP_CASTER_API void mp_register_network_changed_callback(mp_handle hmp, mp_network_changed_callback_t cb, void *ctx);
@@ -168,6 +168,17 @@ extern "C" {
     }XTFrameInfo;
 
     typedef void (*raddr_cb)(void *hmp,rv_net_address *addr);
+
+    //ûỰͳ
+    typedef struct xt_demux_stats_
+    {
+        uint32_t sessions;				//ûỰ
+        uint32_t buckets;				//ϣͰ
+        uint32_t max_probe;				//ǰ̽
+        uint64_t lookups;				//Ҵ(+ر)
+        uint64_t collisions;			//ʱԽķĿͰ
+        uint64_t open_fails;			//ʧܴ
+    } xt_demux_stats;
 #ifdef __cplusplus
 }
 #endif
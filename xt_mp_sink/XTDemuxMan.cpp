@@ -4,9 +4,10 @@
 
 XTDemuxMan XTDemuxMan::m_self;
 XTDemuxMan::XTDemuxMan(void)
-:m_numOfDemuxs(1)
+:m_bInit(false)
+,m_numOfDemuxs(1)
 ,m_numOfSessions(128)
-,m_bInit(false)
+,m_numOfShards(1)
 {
 }
 
@@ -14,10 +15,11 @@ XTDemuxMan::~XTDemuxMan(void)
 {
 }
 
-void XTDemuxMan::init(int numOfDemux, int numOfSessions)
+void XTDemuxMan::init(int numOfDemux, int numOfSessions, int numOfShards)
 {
 	m_numOfDemuxs = numOfDemux;
 	m_numOfSessions = numOfSessions;
+	m_numOfShards = numOfShards < 1 ? 1 : numOfShards;
 }
 
 bool XTDemuxMan::create_demux(rv_session_descriptor *descriptor, int numOfSessions,unsigned short port)
@@ -41,6 +43,13 @@ bool XTDemuxMan::create_demux(rv_session_descriptor *descriptor, int numOfSessio
 		return false;
 	}
 
+	//ȰƬ򿪣ƽ̨ں˲֧ʱ˻ص׽
+	if (m_numOfShards > 1 && create_demux_shards(descriptor, numOfSessions, port))
+	{
+		delete demux;
+		return true;
+	}
+
 	::memset(demux,0,sizeof(_XTDemux));
     bool ret = RV_ADAPTER_TRUE ==::open_session2(descriptor, &demux->handle) ? true : false;
 	if (!ret)
@@ -72,6 +81,78 @@ bool XTDemuxMan::create_demux(rv_session_descriptor *descriptor, int numOfSessio
 	return true;
 }
 
+bool XTDemuxMan::create_demux_shards(rv_session_descriptor *descriptor, int numOfSessions,unsigned short port)
+{
+	if (numOfSessions > MAX_NUM_SESSIONS)
+	{
+		numOfSessions = MAX_NUM_SESSIONS;
+	}
+
+	//ͬһ˿ڴm_numOfShardsƬһñں˰IDѱ͵Ƭ
+	uint32_t shards = (uint32_t)m_numOfShards;
+	std::vector<_XTDemux*> vecShard;
+	for (uint32_t nS = 0;nS < shards;++nS)
+	{
+		_XTDemux *demux = new _XTDemux;
+		::memset(demux,0,sizeof(_XTDemux));
+		demux->port = port;
+		demux->shard = nS;
+		demux->shards = shards;
+
+		if (RV_ADAPTER_TRUE != ::open_session_shard(descriptor, nS, shards, &demux->handle))
+		{
+			delete demux;
+			break;
+		}
+
+		demux->demux = ::demux_construct(numOfSessions, &demux->handle);
+		if (!demux->demux)
+		{
+			::close_session2(&demux->handle);
+			delete demux;
+			break;
+		}
+
+		::memcpy(&demux->addr, &descriptor->local_address, sizeof(rv_net_address));
+
+		uint32_t multid = 0;
+		::open_demux_session_shard(descriptor, demux->demux, nS, shards, &multid, &demux->bindHandle);
+
+		vecShard.push_back(demux);
+	}
+
+	if (vecShard.size() != shards)
+	{
+		for (std::vector<_XTDemux*>::iterator itr = vecShard.begin();itr != vecShard.end();++itr)
+		{
+			destroy_demux(*itr);
+		}
+		return false;
+	}
+
+	m_vecDemux.insert(m_vecDemux.end(), vecShard.begin(), vecShard.end());
+	return true;
+}
+
+void XTDemuxMan::destroy_demux(_XTDemux *demux)
+{
+	if (!demux)
+	{
+		return;
+	}
+
+	if (demux->bindHandle.hrtp)
+	{
+		::close_demux_session(&demux->bindHandle);
+	}
+	::close_session2(&demux->handle);
+	if (demux->demux)
+	{
+		::demux_deconstruct(demux->demux);
+	}
+	delete demux;
+}
+
 void XTDemuxMan::delete_demux(_XTDemux *demux)
 {
 	boost::unique_lock<boost::recursive_mutex> lock(m_mutex);
@@ -263,7 +344,14 @@ bool XTDemuxMan::open_session(rv_session_descriptor *descriptor, uint32_t *multi
 	if (demux)
 	{
 		::memcpy(&descriptor->local_address, &demux->addr, sizeof(rv_net_address));
-        ret = RV_ADAPTER_TRUE  == ::open_demux_session(descriptor, demux->demux, multiplexID, hrv) ? true : false;
+		if (demux->shards > 1)
+		{
+			ret = RV_ADAPTER_TRUE == ::open_demux_session_shard(descriptor, demux->demux, demux->shard, demux->shards, multiplexID, hrv) ? true : false;
+		}
+		else
+		{
+			ret = RV_ADAPTER_TRUE  == ::open_demux_session(descriptor, demux->demux, multiplexID, hrv) ? true : false;
+		}
 		if (ret)
 		{
 			add_session(demux, hrv);
@@ -19,6 +19,8 @@ struct _XTDemux
 	rv_handler_s bindHandle;					//ûỰӾ(ֹdemuxͷ)
 	rv_net_address addr;						//󶨵ַ
 	unsigned short port;                     //ö˿
+	uint32_t shard;								//Ƭ
+	uint32_t shards;							//˿ڷƬ1ʾδƬ
 };
 class XTDemuxMan
 {
@@ -30,6 +32,8 @@ private:
 	static XTDemuxMan m_self;
 
 	bool create_demux(rv_session_descriptor *descriptor_session, int numOfSessions,unsigned short port);
+	bool create_demux_shards(rv_session_descriptor *descriptor_session, int numOfSessions,unsigned short port);
+	void destroy_demux(_XTDemux *demux);
 	void delete_demux(_XTDemux *demux);
 
 	_XTDemux* get_demux(unsigned short port);
@@ -40,7 +44,7 @@ private:
 public:
 	static XTDemuxMan* instance(){return &m_self;}
 
-	void init(int numOfDemux, int numOfSessions);
+	void init(int numOfDemux, int numOfSessions, int numOfShards = 1);
 	void uninit();
 
 	bool open_session(rv_session_descriptor *descriptor, uint32_t *multiplexID, rv_handler_s *hrv,unsigned short port);
@@ -58,5 +62,8 @@ private:
 
 	int m_numOfDemuxs;
 	int m_numOfSessions;
+
+	// ö˿ڷƬ(SO_REUSEPORTÿƬһrv߳)
+	int m_numOfShards;
 };
 #endif //#ifndef XTDEMUMAN_H__
@@ -0,0 +1,178 @@
+#include "entity_table.h"
+#include <boost/thread/thread.hpp>
+
+namespace xt_mp_sink
+{
+	entity_table *entity_table::inst()
+	{
+		//״δsinkǰ죬˳̬˳
+		static entity_table *table = new entity_table;
+		return table;
+	}
+
+	entity_table::entity_table()
+	:m_size(0),
+	m_nchunks(0)
+	{
+		for (uint32_t i = 0; i < ENTITY_TABLE_MAX_CHUNKS; ++i)
+		{
+			m_chunks[i].store(NULL, boost::memory_order_relaxed);
+		}
+	}
+
+	entity_table::~entity_table()
+	{
+		for (uint32_t i = 0; i < m_nchunks; ++i)
+		{
+			delete [] m_chunks[i].load(boost::memory_order_relaxed);
+		}
+	}
+
+	entity_table::slot *entity_table::find(uint32_t index) const
+	{
+		uint32_t chunk = index / ENTITY_TABLE_CHUNK_SIZE;
+		if (chunk >= ENTITY_TABLE_MAX_CHUNKS)
+		{
+			return NULL;
+		}
+
+		slot *slots = m_chunks[chunk].load(boost::memory_order_acquire);
+		if (NULL == slots)
+		{
+			return NULL;
+		}
+
+		return &slots[index % ENTITY_TABLE_CHUNK_SIZE];
+	}
+
+	mp_handle entity_table::add(mp_entity *entity)
+	{
+		uint32_t index = 0;
+		{
+			boost::mutex::scoped_lock lock(m_mutex);
+			if (m_free.empty())
+			{
+				if (m_nchunks >= ENTITY_TABLE_MAX_CHUNKS)
+				{
+					return NULL;
+				}
+
+				slot *slots = new slot[ENTITY_TABLE_CHUNK_SIZE];
+				for (uint32_t i = 0; i < ENTITY_TABLE_CHUNK_SIZE; ++i)
+				{
+					slots[i].gen.store(0, boost::memory_order_relaxed);
+					slots[i].refs.store(0, boost::memory_order_relaxed);
+					slots[i].entity.store(NULL, boost::memory_order_relaxed);
+					m_free.push_back(m_nchunks * ENTITY_TABLE_CHUNK_SIZE + i);
+				}
+				m_chunks[m_nchunks].store(slots, boost::memory_order_release);
+				++m_nchunks;
+			}
+
+			index = m_free.front();
+			m_free.pop_front();
+		}
+
+		slot *s = find(index);
+		s->entity.store(entity, boost::memory_order_relaxed);
+
+		//ż->entity
+		uint32_t gen = s->gen.load(boost::memory_order_relaxed) + 1;
+		s->gen.store(gen, boost::memory_order_release);
+		++m_size;
+
+		return make_handle(index, gen);
+	}
+
+	mp_entity *entity_table::remove(mp_handle h)
+	{
+		slot *s = find(handle_index(h));
+		if (NULL == s)
+		{
+			return NULL;
+		}
+
+		//رͬһʱֻһɹ
+		uint32_t gen = s->gen.load();
+		do
+		{
+			if (0 == (gen & 1) || make_handle(handle_index(h), gen) != h)
+			{
+				return NULL;
+			}
+		} while (!s->gen.compare_exchange_weak(gen, gen + 1));
+
+		//guardȼУȸĴٶã߾Ϊ˳һ£©;guard
+		while (s->refs.load() != 0)
+		{
+			boost::this_thread::yield();
+		}
+
+		mp_entity *entity = s->entity.load(boost::memory_order_relaxed);
+		--m_size;
+
+		boost::mutex::scoped_lock lock(m_mutex);
+		m_free.push_back(handle_index(h));
+
+		return entity;
+	}
+
+	bool entity_table::is_valid(mp_handle h) const
+	{
+		slot *s = find(handle_index(h));
+		if (NULL == s)
+		{
+			return false;
+		}
+
+		uint32_t gen = s->gen.load(boost::memory_order_acquire);
+		return (gen & 1) && make_handle(handle_index(h), gen) == h;
+	}
+
+	mp_entity *entity_table::get(mp_handle h) const
+	{
+		slot *s = find(handle_index(h));
+		if (NULL == s)
+		{
+			return NULL;
+		}
+
+		uint32_t gen = s->gen.load(boost::memory_order_acquire);
+		if (0 == (gen & 1) || make_handle(handle_index(h), gen) != h)
+		{
+			return NULL;
+		}
+
+		return s->entity.load(boost::memory_order_relaxed);
+	}
+
+	entity_table::guard::guard(mp_handle h)
+	:m_slot(NULL),
+	m_entity(NULL)
+	{
+		slot *s = inst()->find(handle_index(h));
+		if (NULL == s)
+		{
+			return;
+		}
+
+		++s->refs;
+		uint32_t gen = s->gen.load();
+		if (0 == (gen & 1) || make_handle(handle_index(h), gen) != h)
+		{
+			s->refs.fetch_sub(1, boost::memory_order_release);
+			return;
+		}
+
+		m_slot = s;
+		m_entity = s->entity.load(boost::memory_order_relaxed);
+	}
+
+	entity_table::guard::~guard()
+	{
+		if (m_slot)
+		{
+			m_slot->refs.fetch_sub(1, boost::memory_order_release);
+		}
+	}
+}
@@ -0,0 +1,92 @@
+#ifndef ENTITY_TABLE_H
+#define ENTITY_TABLE_H
+
+#include <stdint.h>
+#include <deque>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/noncopyable.hpp>
+#include "xt_mp_sink_def.h"
+
+// = ENTITY_TABLE_CHUNK_SIZE * ENTITY_TABLE_MAX_CHUNKSۺռ16λ
+#define ENTITY_TABLE_CHUNK_SIZE		1024
+#define ENTITY_TABLE_MAX_CHUNKS		64
+
+namespace xt_mp_sink
+{
+	class mp_entity;
+
+	//sink
+	//1 = ( << 16) | ۺţΪʾãΪNULL
+	//2УֻһԭӶ۵Ĵ
+	//3صڼguardסۣremoveϴٵȴ;guard˳غʵɰȫرպ
+	//4۰ҲͷţͷŵĲۺȽȳãͬһۺθõļ
+	class entity_table : private boost::noncopyable
+	{
+		struct slot;
+
+	public:
+		static entity_table *inst();
+
+		//ۣNULL
+		mp_handle add(mp_entity *entity);
+
+		//Ͼȴ;guard˳ʵ壻ʧЧNULL
+		mp_entity *remove(mp_handle h);
+
+		bool is_valid(mp_handle h) const;
+
+		//סۣAPIʹ
+		mp_entity *get(mp_handle h) const;
+
+		uint32_t size() const { return m_size; }
+
+		//صжסۣǰʵ岻ᱻر
+		class guard : private boost::noncopyable
+		{
+		public:
+			explicit guard(mp_handle h);
+			~guard();
+
+			mp_entity *get() const { return m_entity; }
+			operator bool() const { return m_entity != NULL; }
+			mp_entity *operator->() const { return m_entity; }
+
+		private:
+			slot *m_slot;
+			mp_entity *m_entity;
+		};
+
+	private:
+		struct slot
+		{
+			boost::atomic<uint32_t> gen;
+			boost::atomic<uint32_t> refs;
+			boost::atomic<mp_entity *> entity;
+		};
+
+		entity_table();
+		~entity_table();
+
+		static mp_handle make_handle(uint32_t index, uint32_t gen)
+		{
+			return (mp_handle)(((uintptr_t)gen << 16) | index);
+		}
+		static uint32_t handle_index(mp_handle h)
+		{
+			return (uint32_t)((uintptr_t)h & 0xffff);
+		}
+
+		slot *find(uint32_t index) const;
+
+		boost::atomic<slot *> m_chunks[ENTITY_TABLE_MAX_CHUNKS];
+		boost::atomic<uint32_t> m_size;
+
+		//³Աm_mutexֻڴ򿪹رʱ
+		boost::mutex m_mutex;
+		uint32_t m_nchunks;
+		std::deque<uint32_t> m_free;
+	};
+}
+
+#endif //ENTITY_TABLE_H
@@ -0,0 +1,296 @@
+#include "jitter_buffer.h"
+
+namespace xt_mp_sink
+{
+	jitter_buffer::jitter_buffer()
+	{
+		m_cfg.min_delay_ms = JITTER_DEF_MIN_DELAY_MS;
+		m_cfg.max_delay_ms = JITTER_DEF_MAX_DELAY_MS;
+		m_cfg.jitter_factor = JITTER_DEF_FACTOR;
+		m_cfg.clock_rate = JITTER_DEF_CLOCK_RATE;
+		m_cfg.drop_incomplete = 0;
+		m_max_packets = 512;
+		m_max_frames = 15;
+		m_late = 0;
+		m_discarded = 0;
+		m_concealed = 0;
+		reset();
+	}
+
+	void jitter_buffer::configure(const jitter_config &cfg)
+	{
+		m_cfg = cfg;
+		if (m_cfg.clock_rate == 0)
+		{
+			m_cfg.clock_rate = JITTER_DEF_CLOCK_RATE;
+		}
+		if (m_cfg.max_delay_ms < m_cfg.min_delay_ms)
+		{
+			m_cfg.max_delay_ms = m_cfg.min_delay_ms;
+		}
+	}
+
+	void jitter_buffer::set_limits(uint32_t max_packets, uint32_t max_frames)
+	{
+		m_max_packets = max_packets > 0 ? max_packets : 1;
+		m_max_frames = max_frames > 0 ? max_frames : 1;
+	}
+
+	void jitter_buffer::reset()
+	{
+		m_slots.clear();
+		m_out.clear();
+		m_next_sn = 0;
+		m_scan_sn = 0;
+		m_marks = 0;
+		m_has_transit = false;
+		m_transit = 0;
+		m_jitter = 0;
+		m_has_ts = false;
+		m_last_ts = 0;
+		m_frame_ms = JITTER_DEF_FRAME_MS;
+	}
+
+	void jitter_buffer::sync(uint16_t last_sn)
+	{
+		m_slots.clear();
+		m_marks = 0;
+		m_next_sn = (uint16_t)(last_sn + 1);
+		m_scan_sn = m_next_sn;
+	}
+
+	void jitter_buffer::_update_jitter(const rv_rtp_param &param, uint32_t now)
+	{
+		//ʱ任㵽RTPʱλ
+		uint32_t arrival = (uint32_t)((uint64_t)now * m_cfg.clock_rate / 1000);
+		uint32_t transit = arrival - param.timestamp;
+		if (m_has_transit)
+		{
+			int32_t d = (int32_t)(transit - m_transit);
+			if (d < 0)
+			{
+				d = -d;
+			}
+			//J += (|D| - J) / 16
+			m_jitter += (uint32_t)d - ((m_jitter + 8) >> 4);
+		}
+		m_transit = transit;
+		m_has_transit = true;
+	}
+
+	void jitter_buffer::_update_frame_interval(uint32_t timestamp)
+	{
+		if (m_has_ts)
+		{
+			//ʱˣ
+			int32_t d = (int32_t)(timestamp - m_last_ts);
+			if (d <= 0)
+			{
+				return;
+			}
+			//1Ϊʱ
+			if ((uint32_t)d < m_cfg.clock_rate)
+			{
+				m_frame_ms = (uint32_t)((uint64_t)d * 1000 / m_cfg.clock_rate);
+			}
+		}
+		m_last_ts = timestamp;
+		m_has_ts = true;
+	}
+
+	uint32_t jitter_buffer::target_delay() const
+	{
+		uint64_t jitter_ms = ((uint64_t)m_jitter * 1000 / m_cfg.clock_rate) >> 4;
+		uint64_t target = jitter_ms * m_cfg.jitter_factor;
+		if (target < m_frame_ms)
+		{
+			target = m_frame_ms;
+		}
+		if (target < m_cfg.min_delay_ms)
+		{
+			target = m_cfg.min_delay_ms;
+		}
+		if (target > m_cfg.max_delay_ms)
+		{
+			target = m_cfg.max_delay_ms;
+		}
+		return (uint32_t)target;
+	}
+
+	bool jitter_buffer::insert(rtp_block *block, bool resend, uint32_t now)
+	{
+		uint16_t sn = block->m_rtp_param.sequenceNumber;
+
+		//ԽλõİΪٵ
+		if ((int16_t)(sn - m_next_sn) < 0)
+		{
+			++m_late;
+			return false;
+		}
+
+		slot_t slot = { block, now };
+		if (!m_slots.insert(std::make_pair(sn, slot)).second)
+		{
+			return false;
+		}
+
+		if (block->m_rtp_param.marker == 1)
+		{
+			++m_marks;
+		}
+
+		//شĵʱ䲻ӳ綶
+		if (!resend)
+		{
+			_update_jitter(block->m_rtp_param, now);
+			_update_frame_interval(block->m_rtp_param.timestamp);
+		}
+
+		return true;
+	}
+
+	bool jitter_buffer::_head_complete()
+	{
+		for (;;)
+		{
+			slot_map::iterator itr = m_slots.find(m_scan_sn);
+			if (itr == m_slots.end())
+			{
+				return false;
+			}
+			++m_scan_sn;
+			if (itr->second.block->m_rtp_param.marker == 1)
+			{
+				//˵mark֮_release_headƽ
+				--m_scan_sn;
+				return true;
+			}
+		}
+	}
+
+	void jitter_buffer::_release_head(bool complete)
+	{
+		slot_map::iterator itr = m_slots.begin();
+		if (itr == m_slots.end())
+		{
+			return;
+		}
+
+		bool drop = !complete && m_cfg.drop_incomplete;
+		uint32_t ts = itr->second.block->m_rtp_param.timestamp;
+		uint16_t last = itr->first;
+		out_t out = { NULL, FRAME_CONTINUE };
+
+		//֡mark֡ȡͬһʱΣmark
+		while (itr != m_slots.end() && (complete || itr->second.block->m_rtp_param.timestamp == ts))
+		{
+			rtp_block *block = itr->second.block;
+			bool marker = (block->m_rtp_param.marker == 1);
+			last = itr->first;
+			m_slots.erase(itr++);
+
+			if (marker)
+			{
+				--m_marks;
+			}
+
+			if (drop)
+			{
+				++m_discarded;
+			}
+			else
+			{
+				if (out.block)
+				{
+					m_out.push_back(out);
+				}
+				out.block = block;
+			}
+
+			if (marker)
+			{
+				break;
+			}
+		}
+
+		if (out.block)
+		{
+			out.end = complete ? FRAME_COMPLETE : FRAME_INCOMPLETE;
+			m_out.push_back(out);
+		}
+
+		if (!complete && !drop)
+		{
+			++m_concealed;
+		}
+
+		m_next_sn = (uint16_t)(last + 1);
+		m_scan_sn = m_next_sn;
+	}
+
+	void jitter_buffer::_trim_output()
+	{
+		//ϲδʱȡʱɵ֤ز
+		while (!m_out.empty() && m_out.size() + m_slots.size() > m_max_packets)
+		{
+			m_out.pop_front();
+			++m_discarded;
+		}
+	}
+
+	uint32_t jitter_buffer::release(uint32_t now)
+	{
+		uint32_t frames = 0;
+		while (!m_slots.empty())
+		{
+			if (_head_complete())
+			{
+				_release_head(true);
+				++frames;
+				continue;
+			}
+
+			//װȴĿʱ򻺴泬
+			const slot_t &head = m_slots.begin()->second;
+			bool expired = (int32_t)(now - head.arrival) >= (int32_t)target_delay();
+			bool overflow = m_slots.size() > m_max_packets || m_marks > m_max_frames;
+			if (!expired && !overflow)
+			{
+				break;
+			}
+
+			bool drop = m_cfg.drop_incomplete != 0;
+			_release_head(false);
+			if (!drop)
+			{
+				++frames;
+			}
+		}
+
+		_trim_output();
+		return frames;
+	}
+
+	long jitter_buffer::pop(rtp_block *&block)
+	{
+		if (m_out.empty())
+		{
+			return -2;
+		}
+
+		out_t out = m_out.front();
+		m_out.pop_front();
+		block = out.block;
+		return out.end;
+	}
+
+	void jitter_buffer::report(jitter_report &rpt) const
+	{
+		rpt.jitter_ms = (uint32_t)(((uint64_t)m_jitter * 1000 / m_cfg.clock_rate) >> 4);
+		rpt.target_delay_ms = target_delay();
+		rpt.buffered_packets = (uint32_t)m_slots.size();
+		rpt.late = m_late;
+		rpt.discarded = m_discarded;
+		rpt.concealed = m_concealed;
+	}
+}
@@ -0,0 +1,135 @@
+#ifndef JITTER_BUFFER_H
+#define JITTER_BUFFER_H
+
+#include <stdint.h>
+#include <map>
+#include <deque>
+#include "rtp_packet_block.h"
+#include "xt_mp_sink_def.h"
+
+//Ŀ겥ʱĬֵ(ms)
+#ifndef JITTER_DEF_MIN_DELAY_MS
+#define JITTER_DEF_MIN_DELAY_MS		0
+#endif
+#ifndef JITTER_DEF_MAX_DELAY_MS
+#define JITTER_DEF_MAX_DELAY_MS		400
+#endif
+#ifndef JITTER_DEF_FACTOR
+#define JITTER_DEF_FACTOR			4
+#endif
+#ifndef JITTER_DEF_CLOCK_RATE
+#define JITTER_DEF_CLOCK_RATE		90000
+#endif
+//δ֡ǰĿʱ(ms)
+#ifndef JITTER_DEF_FRAME_MS
+#define JITTER_DEF_FRAME_MS			40
+#endif
+
+namespace xt_mp_sink
+{
+	//Ӧ
+	//1RFC 3550ƵJĿ겥ʱ = clamp(max(J * factor, ֡), min_delay, max_delay)
+	//   ٵһ֡Ϊ0ʱĶ֡Ҳһ͵
+	//2֡յmarkȵװʱ+Ŀʱ
+	//3/֡ʱǰͷŶ֡֡
+	//4̰߳ȫɵ߼
+	class jitter_buffer
+	{
+	public:
+		//popֵ
+		enum
+		{
+			FRAME_CONTINUE = 0,		//֡ڰ
+			FRAME_COMPLETE = 1,		//֡һ
+			FRAME_INCOMPLETE = 2,	//֡һ
+		};
+
+		jitter_buffer();
+
+		void configure(const jitter_config &cfg);
+		const jitter_config& config() const { return m_cfg; }
+
+		//max_packetsܳشСmax_framesΪ֡
+		void set_limits(uint32_t max_packets, uint32_t max_frames);
+
+		void reset();
+
+		//last_snΪһʼ֡
+		void sync(uint16_t last_sn);
+		uint16_t last_sn() const { return (uint16_t)(m_next_sn - 1); }
+
+		//һnowΪʱӣfalseʾٵظδ
+		bool insert(rtp_block *block, bool resend, uint32_t now);
+
+		//֡͵֡У֡
+		uint32_t release(uint32_t now);
+
+		//ȡеһݷ-2
+		long pop(rtp_block *&block);
+
+		uint32_t target_delay() const;
+		void report(jitter_report &rpt) const;
+
+	private:
+		class sn_cmp
+		{
+		public:
+			bool operator()(uint16_t sn1, uint16_t sn2) const
+			{
+				return (int16_t)(sn1 - sn2) < 0;
+			}
+		};
+
+		struct slot_t
+		{
+			rtp_block *block;
+			uint32_t arrival;
+		};
+
+		struct out_t
+		{
+			rtp_block *block;
+			uint8_t end;
+		};
+
+		typedef std::map<uint16_t, slot_t, sn_cmp> slot_map;
+
+		void _update_jitter(const rv_rtp_param &param, uint32_t now);
+		void _update_frame_interval(uint32_t timestamp);
+
+		//֡m_next_snյmark
+		bool _head_complete();
+
+		//֡completeΪfalseʱ
+		void _release_head(bool complete);
+
+		void _trim_output();
+
+		jitter_config m_cfg;
+		uint32_t m_max_packets;
+		uint32_t m_max_frames;
+
+		slot_map m_slots;
+		std::deque<out_t> m_out;
+
+		uint16_t m_next_sn;		//һsn
+		uint16_t m_scan_sn;		//m_next_snȷһsn
+		uint32_t m_marks;		//еmark
+
+		//RFC 3550(ʱλx16)
+		bool m_has_transit;
+		uint32_t m_transit;
+		uint32_t m_jitter;
+
+		//һʱǰļ(ms)
+		bool m_has_ts;
+		uint32_t m_last_ts;
+		uint32_t m_frame_ms;
+
+		uint32_t m_late;
+		uint32_t m_discarded;
+		uint32_t m_concealed;
+	};
+}
+
+#endif //JITTER_BUFFER_H
@@ -7,6 +7,7 @@
 #include <sys/types.h>
 #include "sink_config.h"
 #include "xt_av_check.h"
+#include <tghelper/crc32.h>
 
 #define MP_PSEUDO_TS_CLOCK		90
 #define MAX_DROP	1024
@@ -111,10 +112,6 @@ namespace xt_mp_sink
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 #endif //#ifdef use_recycle_entity_pool_func__
 
-    boost::recursive_mutex mp_entity::m_mEntity;
-    boost::recursive_mutex mp_entity::m_mEntityClose;
-    std::set<mp_handle> mp_entity::m_setSinkHandleMrg;
-
     uint32_t bitfieldSet(
         uint32_t    value,
         uint32_t    bitfield,
@@ -129,15 +126,14 @@ namespace xt_mp_sink
 	//Ǹrtpӿ
     void mp_entity::OnRtpReceiveEvent( rv_handler hrv,rv_context context )
     {
-
-        mp_entity *pThis = static_cast<mp_entity*>(context);
-        if(NULL == pThis)
+        entity_table::guard pThis(context);
+        if(!pThis)
         {
             DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::OnRtpReceiveEvent invalid!");
             return;
         }
 
-        DEBUG_LOG(SINK_DATA,LL_NORMAL_INFO,"mp_entity::OnRtpReceiveEvent | recv data of the rv libs ptr_this[%p]",pThis);
+        DEBUG_LOG(SINK_DATA,LL_NORMAL_INFO,"mp_entity::OnRtpReceiveEvent | recv data of the rv libs ptr_this[%p]",pThis.get());
 
         //һˮ
         if (pThis->m_isDirectOutput && VGA_ORDER>0)
@@ -147,10 +143,10 @@ namespace xt_mp_sink
 			{
 				pThis->m_pump_flags = false;
 				pThis->assign();
-				if (!sink_inst::sink_singleton()->tp_inst()->schedule( boost::bind(&mp_entity::pump_rtp_in_sj, pThis,hrv)))
+				if (!pThis->m_strand.post(&mp_entity::serial_pump_rtp_in_sj, hrv))
 				{
 					pThis->release();
-					DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::7| ptr_this[%p] sink_singleton()->tp_inst()->schedule fail!",pThis);
+					DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::7| ptr_this[%p] m_strand.post fail!",pThis.get());
 				}
 			}
         }
@@ -165,14 +161,10 @@ namespace xt_mp_sink
         uint32_t size )
     {
         return;//edit bu zhouzx 2015/11/26
-        boost::recursive_mutex::scoped_lock lock2(m_mEntityClose);
-
-        mp_entity *pThis = static_cast<mp_entity*>(context);
-        if(pThis == null) return;
-
-        if (!xt_mp_sink::mp_entity::is_valid(pThis))
+        entity_table::guard pThis(context);
+        if (!pThis)
         {
-            DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::OnRtcpSendEvent entity valid [%p]",pThis);
+            DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::OnRtcpSendEvent entity valid [%p]",context);
             return;
         }
 
@@ -183,12 +175,8 @@ namespace xt_mp_sink
         uint32_t ssrc,uint8_t *rtcpPack, uint32_t size ,
 		uint8_t *ip,uint16_t port,rv_bool multiplex,uint32_t multid)
     {
-        boost::recursive_mutex::scoped_lock lock2(m_mEntityClose);
-
-        mp_entity *pThis = static_cast<mp_entity*>(context);
-        if(pThis == null) return;
-
-        if (!xt_mp_sink::mp_entity::is_valid(pThis))
+        entity_table::guard pThis(context);
+        if (!pThis)
         {
             return;
         }
@@ -209,14 +197,10 @@ namespace xt_mp_sink
         RV_IN  uint8_t*       userData,
         RV_IN  uint32_t       userDataLen)
     {
-        boost::recursive_mutex::scoped_lock lock2(m_mEntityClose);
-
-        mp_entity *pThis = static_cast<mp_entity*>(context);
-        if(pThis == null) return true;
-
-        if (!xt_mp_sink::mp_entity::is_valid(pThis))
+        entity_table::guard pThis(context);
+        if (!pThis)
         {
-            DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::OnRtcpAppEventHandler_CB entity valid [%p]",pThis);
+            DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::OnRtcpAppEventHandler_CB entity valid [%p]",context);
             return true;
         }
 
@@ -302,13 +286,14 @@ namespace xt_mp_sink
         , m_tForceRR(1)
         , m_fir_seq(0)
         , m_ref(0)
+        , m_hself(NULL)
     { 
         ::memset(&m_handle, 0, sizeof(m_handle));
         //::memset(&m_rcvSeg, 0, sizeof(m_rcvSeg));
         ::memset(&m_srcaddr, 0, sizeof(m_srcaddr));
 
 		m_block_index = 0;
-		wait_frames =0;
+		m_bSetJitter = false;
 		m_pump_flags = true;
 		m_block_pool = new rtp_block[LEN_RTP_CACHE];//2M
     }
@@ -336,11 +321,46 @@ namespace xt_mp_sink
 
 		return 0;
 	}
+
+	long mp_entity::mp_set_jitter(const jitter_config &cfg)
+	{
+		boost::unique_lock<boost::recursive_mutex> lock(m_member_variable_mutex);
+		m_bSetJitter = true;
+		m_jitter.configure(cfg);
+		return 0;
+	}
+
+	long mp_entity::mp_query_jitter(jitter_report &report)
+	{
+		boost::unique_lock<boost::recursive_mutex> lock(m_member_variable_mutex);
+		m_jitter.report(report);
+		return 0;
+	}
+
+	long mp_entity::mp_query_sched(sched_report *data, sched_report *post)
+	{
+		if (data)
+		{
+			m_strand.report(*data);
+		}
+		if (post)
+		{
+			m_post_strand.report(*post);
+		}
+		return 0;
+	}
+
+	void mp_entity::serial_pump_rtp_in_sj(void *ctx, void *hrv)
+	{
+		static_cast<mp_entity*>(ctx)->pump_rtp_in_sj(static_cast<rv_handler>(hrv));
+	}
+
     uint32_t mp_entity::mp_open(xt_mp_descriptor* mp_des,p_msink_handle handle, bool multiplex, uint32_t *multid, bool bOpend)
     {
         DEBUG_LOG(SINK_CALL,LL_INFO,"mp_open|ptr_entity[%p] port[%d] start....",this,mp_des->local_address.port);
         int num = 1;
         int sub = 1024;
+        int shards = sink_config::inst()->multiplex_shards(1);
 
         g_log = sink_config::inst()->log_level(-1);
         m_nLostCfg = sink_config::inst()->lost(-1);
@@ -370,6 +390,20 @@ namespace xt_mp_sink
         /////////////////////////////////////////////////////////////////////////////////////////////////////////
 
         LEN_RTP_CACHE = LEN_RTP_CACHE>256? LEN_RTP_CACHE:256;
+
+        //ͨӿùٴļлȡ
+        if (!m_bSetJitter)
+        {
+            jitter_config jcfg;
+            jcfg.min_delay_ms = std::max(sink_config::inst()->jitter_min_delay(JITTER_DEF_MIN_DELAY_MS), 0);
+            jcfg.max_delay_ms = std::max(sink_config::inst()->jitter_max_delay(JITTER_DEF_MAX_DELAY_MS), 0);
+            jcfg.jitter_factor = std::max(sink_config::inst()->jitter_factor(JITTER_DEF_FACTOR), 0);
+            jcfg.clock_rate = std::max(sink_config::inst()->jitter_clock(JITTER_DEF_CLOCK_RATE), 0);
+            jcfg.drop_incomplete = sink_config::inst()->jitter_drop_incomplete(0);
+            m_jitter.configure(jcfg);
+        }
+        //뻺湲m_block_pool֮Ͳ׷ϳصѭдλ
+        m_jitter.set_limits(LEN_RTP_CACHE/2, m_waitFrames);
         m_port = mp_des->local_address.port;  //////// \\\\\\\\ ־
         
         //boost::unique_lock<boost::recursive_mutex> lock(m_mutex);
@@ -382,10 +416,15 @@ namespace xt_mp_sink
         m_bManualRtcp = mp_des->manual_rtcp == 1 ? true : false;
         m_isDirectOutput = mp_des->is_direct_output == 1 ? true : false;
 
+        //հ֡ݶִУ֡صͶݶִУͬһʵԴ
+        m_strand.bind(sink_inst::sink_singleton()->tp_inst(), this);
+        m_post_strand.bind(sink_inst::sink_singleton()->post_tp_inst(), this);
+
         rv_session_descriptor des;
         construct_rv_session_descriptor(&des);
         _construct_rv_address(mp_des->local_address.ip_address,mp_des->local_address.port,&des.local_address);
-        des.context = this;
+        //صΪرպ;صУʧܼأٷʵ
+        des.context = m_hself;
         des.user_context = this;
         des.manual_rtcp = mp_des->manual_rtcp;
         des.onRtpRcvEvent = mp_entity::OnRtpReceiveEvent;
@@ -408,7 +447,7 @@ namespace xt_mp_sink
                 m_bMultiplex = true;
 
                 //ʼ
-                XTDemuxMan::instance()->init(num,sub);
+                XTDemuxMan::instance()->init(num,sub,shards);
                 DEBUG_LOG(SINK_CALL,LL_INFO,"mp_open open_session 1!");
                 if (!bOpend)
                 {
@@ -501,6 +540,7 @@ namespace xt_mp_sink
         m_lastSn = 0;
         m_bInitLast = false;
         m_listAck.clear();
+        m_nack.reset();
     }
 
     uint32_t mp_entity::mp_close()
@@ -522,6 +562,8 @@ namespace xt_mp_sink
             DEBUG_LOG(SINK_CALL,LL_INFO,"mp_entity::mp_close | sink_inst::sink_singleton()->del_ent[%p] end !", this);
 
             while(this->use_count() > 1) boost::this_thread::yield();
+            m_strand.wait_idle();
+            m_post_strand.wait_idle();
             DEBUG_LOG(SINK_CALL,LL_INFO,"mp_entity::mp_close | ptr_this[%p]  wait m_ref end start close...",this);
 
             if (m_bMultiplex)
@@ -564,77 +606,6 @@ namespace xt_mp_sink
         return ret;
     }
 
-    // 㶪ʧ
-    void mp_entity::CalLost(std::vector<uint16_t> &listLost, uint16_t sn1, uint16_t sn2)
-    {
-        if (sn1>sn2 && (sn1-sn2)<MAX_DROP)
-        {
-            DEBUG_LOG("sink_calcerr",LL_INFO,"mp_entity::CalLost | ptr_this[%p] sn1[%d] - sn2[%d]",this,sn1, sn2);
-        }
-        else if (sn1<sn2 && (sn2-sn1)>MAX_DROP)
-        {
-            DEBUG_LOG("sink_calcerr",LL_INFO,"mp_entity::CalLost | ptr_this[%p] sn1[%d] - sn2[%d]",this,sn1, sn2);
-        }
-        else if (sn1 == sn2)//sn1 last_sn,sn2 curr_sn
-        {
-        }
-        else if (sn1 < sn2)
-        {
-            for (uint16_t nS = sn1+1;nS < sn2;++nS)
-            {
-                RcvSeg seg;
-                seg.sn = nS;
-                seg.time = 0;
-                listLost.push_back(nS);
-                if (listLost.size() > MAX_DROP)
-                {
-                    break;
-                }
-
-                if (nS == MAX_SN)
-                {
-                    break;
-                }
-            }
-        }
-        else if (sn1 > sn2)
-        {
-            for (uint16_t nS = sn1+1;sn1!=MAX_SN && nS<=MAX_SN;++nS)
-            {
-                RcvSeg seg;
-                seg.sn = nS;
-                seg.time = 0;
-                listLost.push_back(nS);
-                if (listLost.size() > MAX_DROP)
-                {
-                    break;
-                }
-
-                if (nS == MAX_SN)
-                {
-                    break;
-                }
-            }
-
-            for (uint16_t nS = 0;nS < sn2;++nS)
-            {
-                RcvSeg seg;
-                seg.sn = nS;
-                seg.time = 0;
-                listLost.push_back(nS);
-                if (listLost.size() > MAX_DROP)
-                {
-                    break;
-                }
-
-                if (nS == MAX_SN)
-                {
-                    break;
-                }
-            }
-        }
-    }
-
     // SNȽ
     bool mp_entity::IsSmaller(uint16_t sn1, uint16_t sn2)
     {
@@ -688,96 +659,16 @@ namespace xt_mp_sink
         return false;
     }
 
-    unsigned long  crctable[256] =
-    {
-        0X00000000L,  0X04c11db7L,  0X09823b6eL,  0X0d4326d9L,  
-        0X130476dcL,  0X17c56b6bL,  0X1a864db2L,  0X1e475005L,  
-        0X2608edb8L,  0X22c9f00fL,  0X2f8ad6d6L,  0X2b4bcb61L,  
-        0X350c9b64L,  0X31cd86d3L,  0X3c8ea00aL,  0X384fbdbdL,  
-        0X4c11db70L,  0X48d0c6c7L,  0X4593e01eL,  0X4152fda9L,  
-        0X5f15adacL,  0X5bd4b01bL,  0X569796c2L,  0X52568b75L,
-        0X6a1936c8L,  0X6ed82b7fL,  0X639b0da6L,  0X675a1011L,  
-        0X791d4014L,  0X7ddc5da3L,  0X709f7b7aL,  0X745e66cdL,  
-        0X9823b6e0L,  0X9ce2ab57L,  0X91a18d8eL,  0X95609039L,  
-        0X8b27c03cL,  0X8fe6dd8bL,  0X82a5fb52L,  0X8664e6e5L,  
-        0Xbe2b5b58L,  0Xbaea46efL,  0Xb7a96036L,  0Xb3687d81L,  
-        0Xad2f2d84L,  0Xa9ee3033L,  0Xa4ad16eaL,  0Xa06c0b5dL,
-        0Xd4326d90L,  0Xd0f37027L,  0Xddb056feL,  0Xd9714b49L,  
-        0Xc7361b4cL,  0Xc3f706fbL,  0Xceb42022L,  0Xca753d95L,  
-        0Xf23a8028L,  0Xf6fb9d9fL,  0Xfbb8bb46L,  0Xff79a6f1L,  
-        0Xe13ef6f4L,  0Xe5ffeb43L,  0Xe8bccd9aL,  0Xec7dd02dL,  
-        0X34867077L,  0X30476dc0L,  0X3d044b19L,  0X39c556aeL,  
-        0X278206abL,  0X23431b1cL,  0X2e003dc5L,  0X2ac12072L,  
-        0X128e9dcfL,  0X164f8078L,  0X1b0ca6a1L,  0X1fcdbb16L,  
-        0X018aeb13L,  0X054bf6a4L,  0X0808d07dL,  0X0cc9cdcaL,  
-        0X7897ab07L,  0X7c56b6b0L,  0X71159069L,  0X75d48ddeL,  
-        0X6b93dddbL,  0X6f52c06cL,  0X6211e6b5L,  0X66d0fb02L,  
-        0X5e9f46bfL,  0X5a5e5b08L,  0X571d7dd1L,  0X53dc6066L,
-        0X4d9b3063L,  0X495a2dd4L,  0X44190b0dL,  0X40d816baL,  
-        0Xaca5c697L,  0Xa864db20L,  0Xa527fdf9L,  0Xa1e6e04eL,  
-        0Xbfa1b04bL,  0Xbb60adfcL,  0Xb6238b25L,  0Xb2e29692L,  
-        0X8aad2b2fL,  0X8e6c3698L,  0X832f1041L,  0X87ee0df6L,  
-        0X99a95df3L,  0X9d684044L,  0X902b669dL,  0X94ea7b2aL,  
-        0Xe0b41de7L,  0Xe4750050L,  0Xe9362689L,  0Xedf73b3eL,
-        0Xf3b06b3bL,  0Xf771768cL,  0Xfa325055L,  0Xfef34de2L,  
-        0Xc6bcf05fL,  0Xc27dede8L,  0Xcf3ecb31L,  0Xcbffd686L,  
-        0Xd5b88683L,  0Xd1799b34L,  0Xdc3abdedL,  0Xd8fba05aL,  
-        0X690ce0eeL,  0X6dcdfd59L,  0X608edb80L,  0X644fc637L,  
-        0X7a089632L,  0X7ec98b85L,  0X738aad5cL,  0X774bb0ebL,  
-        0X4f040d56L,  0X4bc510e1L,  0X46863638L,  0X42472b8fL,  
-        0X5c007b8aL,  0X58c1663dL,  0X558240e4L,  0X51435d53L,  
-        0X251d3b9eL,  0X21dc2629L,  0X2c9f00f0L,  0X285e1d47L,  
-        0X36194d42L,  0X32d850f5L,  0X3f9b762cL,  0X3b5a6b9bL,  
-        0X0315d626L,  0X07d4cb91L,  0X0a97ed48L,  0X0e56f0ffL,  
-        0X1011a0faL,  0X14d0bd4dL,  0X19939b94L,  0X1d528623L,
-        0Xf12f560eL,  0Xf5ee4bb9L,  0Xf8ad6d60L,  0Xfc6c70d7L,  
-        0Xe22b20d2L,  0Xe6ea3d65L,  0Xeba91bbcL,  0Xef68060bL,  
-        0Xd727bbb6L,  0Xd3e6a601L,  0Xdea580d8L,  0Xda649d6fL,  
-        0Xc423cd6aL,  0Xc0e2d0ddL,  0Xcda1f604L,  0Xc960ebb3L,  
-        0Xbd3e8d7eL,  0Xb9ff90c9L,  0Xb4bcb610L,  0Xb07daba7L,  
-        0Xae3afba2L,  0Xaafbe615L,  0Xa7b8c0ccL,  0Xa379dd7bL,
-        0X9b3660c6L,  0X9ff77d71L,  0X92b45ba8L,  0X9675461fL,  
-        0X8832161aL,  0X8cf30badL,  0X81b02d74L,  0X857130c3L,  
-        0X5d8a9099L,  0X594b8d2eL,  0X5408abf7L,  0X50c9b640L,  
-        0X4e8ee645L,  0X4a4ffbf2L,  0X470cdd2bL,  0X43cdc09cL,  
-        0X7b827d21L,  0X7f436096L,  0X7200464fL,  0X76c15bf8L,  
-        0X68860bfdL,  0X6c47164aL,  0X61043093L,  0X65c52d24L,  
-        0X119b4be9L,  0X155a565eL,  0X18197087L,  0X1cd86d30L,  
-        0X029f3d35L,  0X065e2082L,  0X0b1d065bL,  0X0fdc1becL,  
-        0X3793a651L,  0X3352bbe6L,  0X3e119d3fL,  0X3ad08088L,  
-        0X2497d08dL,  0X2056cd3aL,  0X2d15ebe3L,  0X29d4f654L,  
-        0Xc5a92679L,  0Xc1683bceL,  0Xcc2b1d17L,  0Xc8ea00a0L,
-        0Xd6ad50a5L,  0Xd26c4d12L,  0Xdf2f6bcbL,  0Xdbee767cL,
-        0Xe3a1cbc1L,  0Xe760d676L,  0Xea23f0afL,  0Xeee2ed18L,
-        0Xf0a5bd1dL,  0Xf464a0aaL,  0Xf9278673L,  0Xfde69bc4L,
-        0X89b8fd09L,  0X8d79e0beL,  0X803ac667L,  0X84fbdbd0L,
-        0X9abc8bd5L,  0X9e7d9662L,  0X933eb0bbL,  0X97ffad0cL,
-        0Xafb010b1L,  0Xab710d06L,  0Xa6322bdfL,  0Xa2f33668L,
-        0Xbcb4666dL,  0Xb8757bdaL,  0Xb5365d03L,  0Xb1f740b4L
-    };
-    unsigned long CRC_32( unsigned char * aData, unsigned long aSize )
-    {
-        unsigned long crc32 = 0;
-        unsigned long tabitem;
-        while(aSize--)
-        {
-            tabitem = ( crc32 >> 24 ) ^ *(aData++);
-            crc32   = ( crc32 << 8 )  ^ crctable[tabitem];
-        }
-
-        return crc32;
-    }
-
 	//˽
     void mp_entity::pump_rtp_in(rv_handler hrv)
     {
         //boost::unique_lock<boost::recursive_mutex> lock(m_mutex);
         DEBUG_LOG(SINK_DATA,LL_NORMAL_INFO,"mp_entity::pump_rtp_in | ptr_this[%p] recv data start...",this);
-        rv_rtp_param param;
-        ::construct_rv_rtp_param(&param);
         this->assign();
         bool post_task = true;
-        do 
+        rtp_packet_block* blocks[MP_RTP_RECV_BATCH];
+        rv_rtp_recv_item items[MP_RTP_RECV_BATCH];
+        do
         {
             //////////////////////////////////////////////////////////////////////////
             if (m_rtp_fifo.size() > LEN_RTP_CACHE)
@@ -794,23 +685,33 @@ namespace xt_mp_sink
             }
             //////////////////////////////////////////////////////////////////////////*/
 
-            static uint32_t tickCount = GetTickCount();
-            rtp_packet_block* block = alloc_rtp_block();
-            if (block == NULL)
+            //ջ壬һζsocketѵĶ
+            uint32_t nblock = 0;
+            for (; nblock < MP_RTP_RECV_BATCH; ++nblock)
+            {
+                rtp_packet_block* block = alloc_rtp_block();
+                if (block == NULL)
+                {
+                    break;
+                }
+                block->assign();
+                block->m_bFrame = false;
+                blocks[nblock] = block;
+                ::memset(&items[nblock], 0, sizeof(rv_rtp_recv_item));
+                items[nblock].buf = block->get_raw();
+                items[nblock].buf_len = block->size();
+            }
+            if (nblock == 0)
             {
                 DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::pump_rtp_in | ptr_this[%p] get memory fail!",this);
                 this->release();
                 return;
             }
 
-            block->assign();
-            block->m_bFrame = false;
-            rv_net_address addr;
-            ::memset(&param, 0, sizeof(rv_rtp_param));
-            rv_bool read_result = read_rtp(hrv,block->get_raw(),block->size(),&param,&addr);
-            do 
+            uint32_t nread = read_rtp_batch(hrv,items,nblock);
+            do
             {
-                if (RV_ADAPTER_TRUE != read_result)
+                if (nread == 0)
                 {
                     break;
                 }
@@ -819,7 +720,7 @@ namespace xt_mp_sink
                     std::size_t _tp_nums = sink_inst::sink_singleton()->tp_inst()->pending();
                     std::size_t _post_tp_nums = sink_inst::sink_singleton()->post_tp_inst()->pending();
                     DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::pump_rtp_in | ptr_this[%p] _tp_nums[%d] _post_tp_nums[%d] use_count fail!",this,_tp_nums,_post_tp_nums);
-                    read_result = RV_ADAPTER_FALSE;
+                    nread = 0;
                     post_task = false;
                     break;
                 }
@@ -827,10 +728,19 @@ namespace xt_mp_sink
                 if(m_state != MP_OPEN_STATE || !m_bActive)
                 {
                     DEBUG_LOG(SINK_ERROE,LL_NORMAL_INFO,"mp_entity::pump_rtp_in ptr_this[%p] not active!",this);
-                    read_result = RV_ADAPTER_FALSE;
+                    nread = 0;
                     post_task = false;
                     break;
                 }
+            } while (0);
+
+            for (uint32_t i = 0; i < nblock; ++i)
+            {
+                if (i >= nread || RV_ADAPTER_TRUE != items[i].valid)
+                {
+                    blocks[i]->release();
+                    continue;
+                }
                 //ģⶪ
                 if (m_nLostCfg>0)
                 {
@@ -838,272 +748,277 @@ namespace xt_mp_sink
                     if ((nN*m_nLostCfg)%100==0)
                     {
                         nN += 1;
-                        read_result = RV_ADAPTER_FALSE;
-                        break;
+                        blocks[i]->release();
+                        continue;
                     }
                     nN += 1;
                 }
-            } while (0);
+                _pump_rtp_block(blocks[i], items[i].param);
+            }
 
-            if(read_result == RV_ADAPTER_TRUE)
+            //δ˵socketѶ
+            if (nread < nblock)
             {
-                // ֵУ
-                if (m_rcheck_sum_cfg > 0)
-                {
-                    unsigned char *crc = block->get_raw()+ param.len-4;
+                break;
+            }
+        } while (true);
 
-                    unsigned long sum1 = 0;
-                    ::memcpy(&sum1, crc, 4);
+        //ӺֻͶһζˮ
+        if (post_task)
+        {
+            this->assign();
+            if (!m_strand.post(&mp_entity::serial_task<&mp_entity::mp_task_data_switcher>))
+            {
+                this->release();
+                DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::pump_rtp_in| ptr_this[%p] m_strand.post fail!",this);
+            }
+        }
+        this->release();
+        DEBUG_LOG(SINK_DATA,LL_NORMAL_INFO,"mp_entity::pump_rtp_in | ptr_this[%p] recv data end!",this);
+    }
 
-                    unsigned long sum2 = CRC_32(block->get_raw()+param.sByte, param.len-param.sByte-4);
-                    if (sum1 != sum2)
-                    {
-                        block->release();
-                        DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::pump_rtp_in | ptr_this[%p] checksum fail!",this);
-                        continue;
-                    }
-                    param.len -= 4;
-                }
+    //RTPSOURCE FIFOblockɱͷ
+    void mp_entity::_pump_rtp_block(rtp_packet_block* block, rv_rtp_param &param)
+    {
+        static uint32_t tickCount = GetTickCount();
+        // ֵУ
+        if (m_rcheck_sum_cfg > 0)
+        {
+            unsigned char *crc = block->get_raw()+ param.len-4;
 
-                boost::unique_lock<boost::recursive_mutex> lock(m_member_variable_mutex);
-                m_ssrc = param.sSrc;
-                if (!m_bInitLast)
+            uint32_t sum1 = 0;
+            ::memcpy(&sum1, crc, 4);
+
+            uint32_t sum2 = tghelper::crc32(block->get_raw()+param.sByte, param.len-param.sByte-4);
+            if (sum1 != sum2)
+            {
+                block->release();
+                DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::pump_rtp_in | ptr_this[%p] checksum fail!",this);
+                return;
+            }
+            param.len -= 4;
+        }
+
+        boost::unique_lock<boost::recursive_mutex> lock(m_member_variable_mutex);
+        m_ssrc = param.sSrc;
+        if (!m_bInitLast)
+        {
+            m_bInitLast = true;
+            m_lastSn = param.sequenceNumber;
+        }
+
+        if (!param.extensionBit)
+        {
+            param.extensionLength = 0;
+            param.extensionData = NULL;
+        }
+
+        //////////////////////////////////////////////////////////////////////////
+        if (param.extensionBit && param.extensionData)
+        { 
+            uint32_t info[3];
+
+            if (IsReSend(param))
+            {
+                if (param.extensionLength >= 4)
                 {
-                    m_bInitLast = true;
-                    m_lastSn = param.sequenceNumber;
+                    block->m_bFrame = true;
+                    info[0] = param.extensionData[1];
+                    info[1] = param.extensionData[2];
+                    info[2] = param.extensionData[3];
                 }
-
-                if (!param.extensionBit)
+            }
+            else
+            {
+                if (param.extensionLength >= 3)
                 {
-                    param.extensionLength = 0;
-                    param.extensionData = NULL;
+                    block->m_bFrame = true;
+                    info[0] = param.extensionData[0];
+                    info[1] = param.extensionData[1];
+                    info[2] = param.extensionData[2];
                 }
+            }
 
-                //////////////////////////////////////////////////////////////////////////
-                if (param.extensionBit && param.extensionData)
-                { 
-                    uint32_t info[3];
+            if (block->m_bFrame)
+            {
+                block->m_frame[0] = ::ntohl(info[0]);
+                block->m_frame[1] = ::ntohl(info[1]);
+                block->m_frame[2] = ::ntohl(info[2]);
+            }
+        }
+        //////////////////////////////////////////////////////////////////////////*/
 
-                    if (IsReSend(param))
-                    {
-                        if (param.extensionLength >= 4)
-                        {
-                            block->m_bFrame = true;
-                            info[0] = param.extensionData[1];
-                            info[1] = param.extensionData[2];
-                            info[2] = param.extensionData[3];
-                        }
-                    }
-                    else
-                    {
-                        if (param.extensionLength >= 3)
-                        {
-                            block->m_bFrame = true;
-                            info[0] = param.extensionData[0];
-                            info[1] = param.extensionData[1];
-                            info[2] = param.extensionData[2];
-                        }
-                    }
+        // RESEND
+        if (IsReSend(param))
+        {
+            if (m_nReSendCfg <= 0)
+            {
+                block->release();
+                DEBUG_LOG(SINK_ERROE,LL_ERROE,"drop1");
+                return;
+            }
+        }
 
-                    if (block->m_bFrame)
-                    {
-                        block->m_frame[0] = ::ntohl(info[0]);
-                        block->m_frame[1] = ::ntohl(info[1]);
-                        block->m_frame[2] = ::ntohl(info[2]);
-                    }
+        if (m_nReSendCfg>0)
+        {
+            boost::recursive_mutex::scoped_lock lock(m_mLost);
+            if (!IsReSend(param))
+            {
+                if (CalDif(m_lastSn, param.sequenceNumber)>=MAX_DROP)
+                {
+                    m_lastSn = param.sequenceNumber;
                 }
-                //////////////////////////////////////////////////////////////////////////*/
-
-                // RESEND
-                if (IsReSend(param))
+                //CalLost(m_listAck, m_lastSn, param.sequenceNumber);
+                if (m_listAck.size() > MAX_DROP)
                 {
-                    if (m_nReSendCfg <= 0)
-                    {
-                        block->release();
-                        DEBUG_LOG(SINK_ERROE,LL_ERROE,"drop1");
-                        continue;
-                    }
+                    DEBUG_LOG("sink_calcerr",LL_ERROE,"mp_entity::pump_rtp_in| ptr_this[%p] SN[%d] - [%d]",this,m_lastSn, param.sequenceNumber);
                 }
-
-                if (m_nReSendCfg>0)
+                while (m_listAck.size() > MAX_DROP)
                 {
-                    boost::recursive_mutex::scoped_lock lock(m_mLost);
-                    if (!IsReSend(param))
-                    {
-                        if (CalDif(m_lastSn, param.sequenceNumber)>=MAX_DROP)
-                        {
-                            m_lastSn = param.sequenceNumber;
-                        }
-                        //CalLost(m_listAck, m_lastSn, param.sequenceNumber);
-                        if (m_listAck.size() > MAX_DROP)
-                        {
-                            DEBUG_LOG("sink_calcerr",LL_ERROE,"mp_entity::pump_rtp_in| ptr_this[%p] SN[%d] - [%d]",this,m_lastSn, param.sequenceNumber);
-                        }
-                        while (m_listAck.size() > MAX_DROP)
-                        {
-                            m_listAck.erase(m_listAck.begin());
-                        }
-                        if (IsSmaller(m_lastSn, param.sequenceNumber))
-                        {
-                            m_lastSn = param.sequenceNumber;
-                        }
-                    }
-
-                    // 
-                    bool bReSend= false;
-                    std::vector<RcvSeg>::iterator it = m_listAck.begin();
-                    for (;it != m_listAck.end();)
-                    {
-                        RcvSeg &segA = *it;
-
-                        if (segA.sn == param.sequenceNumber)
-                        {
-                            it = m_listAck.erase(it);
-                            bReSend = true;
-                            continue;
-                        }
+                    m_listAck.erase(m_listAck.begin());
+                }
+                if (IsSmaller(m_lastSn, param.sequenceNumber))
+                {
+                    m_lastSn = param.sequenceNumber;
+                }
+            }
 
-                        if (IsSmaller(segA.sn, m_lastFrameMarkerSN))
-                        {
-                            it = m_listAck.erase(it);
-                            continue;
-                        }
+            // 
+            bool bReSend= false;
+            std::vector<RcvSeg>::iterator it = m_listAck.begin();
+            for (;it != m_listAck.end();)
+            {
+                RcvSeg &segA = *it;
 
-                        if (segA.time == 0)
-                        {
-                            segA.time = WAIT_RESEND-5;
-                        }
-                        else
-                        {
-                            segA.time += 1;
-                        }
-                        ++it;
-                    }
+                if (segA.sn == param.sequenceNumber)
+                {
+                    it = m_listAck.erase(it);
+                    bReSend = true;
+                    continue;
+                }
 
-                    if (IsReSend(param) && !bReSend)
-                    {
-                        if (param.sequenceNumber-m_lastSn>1000)
-                        {
-                            DEBUG_LOG("sink_calcerr",LL_ERROE,"mp_entity::pump_rtp_in| ptr_this[%p] SN[%d] - [%d]",this,m_lastSn, param.sequenceNumber);
-                        }
+                if (IsSmaller(segA.sn, m_lastFrameMarkerSN))
+                {
+                    it = m_listAck.erase(it);
+                    continue;
+                }
 
-                        block->release();
-                        DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::pump_rtp_in| ptr_this[%p] drop2",this);
-                        continue;
-                    }
+                if (segA.time == 0)
+                {
+                    segA.time = WAIT_RESEND-5;
                 }
+                else
+                {
+                    segA.time += 1;
+                }
+                ++it;
+            }
 
-                if (m_nReSendCfg > 0)
+            if (IsReSend(param) && !bReSend)
+            {
+                if (param.sequenceNumber-m_lastSn>1000)
                 {
-                    boost::recursive_mutex::scoped_lock lock(m_mLost);
-                    // 
-                    std::vector<RcvSeg>::iterator it = m_listAck.begin();
-                    char list_sn_buffer[1024];
-                    memset(list_sn_buffer,0x0,1024);
-                    uint32_t snsize =0;
-                    for (int nR = 0;nR<MAX_RESEND && it!=m_listAck.end();++it,++nR)
-                    {
-                        RcvSeg &segA = *it;
+                    DEBUG_LOG("sink_calcerr",LL_ERROE,"mp_entity::pump_rtp_in| ptr_this[%p] SN[%d] - [%d]",this,m_lastSn, param.sequenceNumber);
+                }
 
-                        if (segA.time >= WAIT_RESEND)
-                        {
-                            segA.time = 1;
+                block->release();
+                DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::pump_rtp_in| ptr_this[%p] drop2",this);
+                return;
+            }
+        }
 
-                            // rtcpŵbug(ʱ)
-                            //////////////////////////////////////////////////////////////////////////
-                            if (GetTickCount()-m_tmSrcAddr > m_tmSrcAddrInterval)
-                            {
-                                m_tmSrcAddr = GetTickCount();
-                                add_srcaddr();
-                            }
-                            //////////////////////////////////////////////////////////////////////////
+        if (m_nReSendCfg > 0)
+        {
+            boost::recursive_mutex::scoped_lock lock(m_mLost);
+            // 
+            std::vector<RcvSeg>::iterator it = m_listAck.begin();
+            char list_sn_buffer[1024];
+            memset(list_sn_buffer,0x0,1024);
+            uint32_t snsize =0;
+            for (int nR = 0;nR<MAX_RESEND && it!=m_listAck.end();++it,++nR)
+            {
+                RcvSeg &segA = *it;
 
-                            if (m_nReSendCfg == 1)
-                            {
-                                RtcpAppMessage msg;
-                                uint8_t name[4] = {'N','A','C','K'};
-                                msg.subtype = 1;
-                                ::memcpy(msg.name, name, sizeof(name));
+                if (segA.time >= WAIT_RESEND)
+                {
+                    segA.time = 1;
 
-                                uint32_t sn = segA.sn;
-                                msg.userData = (uint8_t*)&sn;
-                                msg.userDataLength = sizeof(uint32_t);
-                                RtcpSendApps(&m_handle, &msg, 1, false);
-                            }
-                            else
-                            {
-                                uint32_t sn = segA.sn;
-                                ::memcpy(list_sn_buffer+snsize,(uint8_t*)&sn,sizeof(sn));
-                                snsize+=sizeof(sn);
-                            }                        
-                        }
+                    // rtcpŵbug(ʱ)
+                    //////////////////////////////////////////////////////////////////////////
+                    if (GetTickCount()-m_tmSrcAddr > m_tmSrcAddrInterval)
+                    {
+                        m_tmSrcAddr = GetTickCount();
+                        add_srcaddr();
                     }
-                    //ܷͿյش
-                    if( snsize > 0 &&list_sn_buffer)
+                    //////////////////////////////////////////////////////////////////////////
+
+                    if (m_nReSendCfg == 1)
                     {
                         RtcpAppMessage msg;
                         uint8_t name[4] = {'N','A','C','K'};
-                        msg.subtype = 3;
+                        msg.subtype = 1;
                         ::memcpy(msg.name, name, sizeof(name));
 
-                        boost::recursive_mutex::scoped_lock lock2(xt_mp_sink::mp_entity::m_mEntityClose);
-                        msg.userData = (uint8_t*)&list_sn_buffer;
-                        msg.userDataLength = snsize;
-
-                        if (xt_mp_sink::mp_entity::is_valid(this))
-                        {
-                            RtcpSendApps(&m_handle, &msg, 1, false);
-                        }
+                        uint32_t sn = segA.sn;
+                        msg.userData = (uint8_t*)&sn;
+                        msg.userDataLength = sizeof(uint32_t);
+                        RtcpSendApps(&m_handle, &msg, 1, false);
                     }
+                    else
+                    {
+                        uint32_t sn = segA.sn;
+                        ::memcpy(list_sn_buffer+snsize,(uint8_t*)&sn,sizeof(sn));
+                        snsize+=sizeof(sn);
+                    }                        
                 }
+            }
+            //ܷͿյش
+            if( snsize > 0 &&list_sn_buffer)
+            {
+                RtcpAppMessage msg;
+                uint8_t name[4] = {'N','A','C','K'};
+                msg.subtype = 3;
+                ::memcpy(msg.name, name, sizeof(name));
 
-                uint32_t newTick = (GetTickCount()-tickCount)*MP_PSEUDO_TS_CLOCK;
-                if (!IsReSend(param))
-                {
-                    manual_send_rtcp_rr(&m_handle,param.sSrc,newTick,param.timestamp,param.sequenceNumber);
+                entity_table::guard alive(m_hself);
+                msg.userData = (uint8_t*)&list_sn_buffer;
+                msg.userDataLength = snsize;
 
-                    unsigned long time = GetTickCount();
-                    if (time-m_tForceRR > m_tForceLevel)
-                    {
-                        m_tForceRR = time;
-                        force_send_rtcp_rr(&m_handle, false, NULL, 0);
-                    }
-                }
-                block->set_size(param.len);
-                block->set_marker(param.marker);
-                block->set_payload_type(param.payload);
-                block->set_sbyte(param.sByte);
-                block->set_sn(param.sequenceNumber);
-                block->set_ssrc(param.sSrc);
-                block->set_ts(param.timestamp);
-                block->set_params(param.len-param.sByte,param.sByte);
-                block->set_head_param(param);
-                bool ret = m_rtp_fifo.push(block);
-                if (!ret)
+                if (alive)
                 {
-                    DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::pump_rtp_in | ptr_this[%p] m_rtp_fifo.push fail!",this);
+                    RtcpSendApps(&m_handle, &msg, 1, false);
                 }
-                block->release();
-                DEBUG_LOG("sink_rtpin",LL_NORMAL_INFO, "mp_entity::pump_rtp_in| ptr_this[%p] ȡ - sn:%d ts:%d  pt:%d ds:%d fifozize:%d", this,param.sequenceNumber,param.timestamp, param.payload, param.len,m_rtp_fifo.size());
-            }
-            else
-            {
-                block->release();
-                break;
             }
-        } while (true);
+        }
 
-        if (post_task)
+        uint32_t newTick = (GetTickCount()-tickCount)*MP_PSEUDO_TS_CLOCK;
+        if (!IsReSend(param))
         {
-            this->assign();
-            if (!sink_inst::sink_singleton()->tp_inst()->schedule(boost::bind(&mp_entity::mp_task_data_switcher,this)))
+            manual_send_rtcp_rr(&m_handle,param.sSrc,newTick,param.timestamp,param.sequenceNumber);
+
+            unsigned long time = GetTickCount();
+            if (time-m_tForceRR > m_tForceLevel)
             {
-                this->release();
-                DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::pump_rtp_in| ptr_this[%p] sink_singleton()->tp_inst()->schedule fail!",this);
+                m_tForceRR = time;
+                force_send_rtcp_rr(&m_handle, false, NULL, 0);
             }
         }
-        this->release();
-        DEBUG_LOG(SINK_DATA,LL_NORMAL_INFO,"mp_entity::pump_rtp_in | ptr_this[%p] recv data end!",this);
+        block->set_size(param.len);
+        block->set_marker(param.marker);
+        block->set_payload_type(param.payload);
+        block->set_sbyte(param.sByte);
+        block->set_sn(param.sequenceNumber);
+        block->set_ssrc(param.sSrc);
+        block->set_ts(param.timestamp);
+        block->set_params(param.len-param.sByte,param.sByte);
+        block->set_head_param(param);
+        bool ret = m_rtp_fifo.push(block);
+        if (!ret)
+        {
+            DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::pump_rtp_in | ptr_this[%p] m_rtp_fifo.push fail!",this);
+        }
+        block->release();
+        DEBUG_LOG("sink_rtpin",LL_NORMAL_INFO, "mp_entity::pump_rtp_in| ptr_this[%p] ȡ - sn:%d ts:%d  pt:%d ds:%d fifozize:%d", this,param.sequenceNumber,param.timestamp, param.payload, param.len,m_rtp_fifo.size());
     }
 
     void mp_entity::pump_rtp_in(RV_IN void *buf,
@@ -1364,11 +1279,11 @@ namespace xt_mp_sink
                         msg.subtype = 3;
                         ::memcpy(msg.name, name, sizeof(name));
 
-                        boost::recursive_mutex::scoped_lock lock2(xt_mp_sink::mp_entity::m_mEntityClose);
+                        entity_table::guard alive(m_hself);
                         msg.userData = (uint8_t*)&list_sn_buffer;
                         msg.userDataLength = snsize;
 
-                        if (xt_mp_sink::mp_entity::is_valid(this))
+                        if (alive)
                         {
                             RtcpSendApps(&m_handle, &msg, 1, false);
                         }
@@ -1408,9 +1323,9 @@ namespace xt_mp_sink
             if (post_task)
             {
                 this->assign();
-                if(!sink_inst::sink_singleton()->tp_inst()->schedule(boost::bind(&mp_entity::mp_task_data_switcher,this)))
+                if(!m_strand.post(&mp_entity::serial_task<&mp_entity::mp_task_data_switcher>))
                 {
-                    DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::pump_rtp_in 2| ptr_this[%p] sink_singleton()->tp_inst()->schedule fail!",this);
+                    DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::pump_rtp_in 2| ptr_this[%p] m_strand.post fail!",this);
                     this->release();
                 }
             }
@@ -1516,9 +1431,9 @@ namespace xt_mp_sink
         case MP_MEMORY_MSINK:
             {
                 this->assign();
-                if (!sink_inst::sink_singleton()->post_tp_inst()->schedule(boost::bind(&mp_entity::caster_data_out,this)))
+                if (!m_post_strand.post(&mp_entity::serial_task<&mp_entity::caster_data_out>))
                 {
-                    DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::4| ptr_this[%p] sink_singleton()->tp_inst()->schedule fail!",this);
+                    DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::4| ptr_this[%p] m_post_strand.post fail!",this);
                     this->release();
                 }
             }
@@ -1526,10 +1441,10 @@ namespace xt_mp_sink
         case MP_RV_RTP_MSINK:
             {
                 this->assign();
-                if (!sink_inst::sink_singleton()->tp_inst()->schedule(boost::bind(&mp_entity::send_data_out,this)))
+                if (!m_strand.post(&mp_entity::serial_task<&mp_entity::send_data_out>))
                 {
                     this->release();
-                    DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::3| ptr_this[%p] sink_singleton()->tp_inst()->schedule fail!",this);
+                    DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::3| ptr_this[%p] m_strand.post fail!",this);
                 }
             }
             break;
@@ -1555,7 +1470,7 @@ namespace xt_mp_sink
                 if(m_pRcvRtpCB != null)
                 {
                     DEBUG_LOG(SINK_DATA,LL_INFO,"mp_entity::mp_task_data_switcher | m_pRcvFrameCB ptr_this[%p] proc start...",this);
-                    m_pRcvRtpCB(this,m_pContext);
+                    m_pRcvRtpCB(m_hself,m_pContext);
                     DEBUG_LOG(SINK_DATA,LL_INFO,"mp_entity::mp_task_data_switcher | m_pRcvFrameCB ptr_this[%p] proc end!",this);
                 }
             }
@@ -1578,14 +1493,7 @@ namespace xt_mp_sink
     {
         //boost::unique_lock<boost::recursive_mutex> lock(m_mutex);
         DEBUG_LOG(SINK_DATA,LL_NORMAL_INFO,"mp_entity::caster_data_out | ptr_this[%p] start..",this);
-        if (!m_msink_task_mutex.timed_lock(
-            boost::get_system_time() +
-            boost::posix_time::millisec(MP_MSINK_TASK_LOCK_TM)))
-        {
-            this->release();
-            DEBUG_LOG(SINK_DATA,LL_NORMAL_INFO,"mp_entity::caster_data_out | ptr_this[%p] m_msink_task_mutex.timed_lock fail!",this);
-            return;
-        }
+        //ֻm_post_strandִУ
         bool bOk = false;
         do
         {
@@ -1609,7 +1517,7 @@ namespace xt_mp_sink
             {
                 DEBUG_LOG(SINK_DATA,LL_INFO,"mp_entity::caster_data_out | m_pRcvFrameCB ptr_this[%p] proc  start...",this);
                 m_nFrame++;
-                m_pRcvFrameCB(this,m_pContext);
+                m_pRcvFrameCB(m_hself,m_pContext);
                 bOk = true;
                 DEBUG_LOG(SINK_DATA,LL_INFO,"mp_entity::caster_data_out | m_pRcvFrameCB ptr_this[%p] proc end!",this);
             }
@@ -1622,18 +1530,16 @@ namespace xt_mp_sink
             if(m_mode == MP_BOTH_MSINK)
             {
                 this->assign();
-                if (!sink_inst::sink_singleton()->tp_inst()->schedule(boost::bind(&mp_entity::send_data_out,this)))
+                if (!m_strand.post(&mp_entity::serial_task<&mp_entity::send_data_out>))
                 {
                     this->release();
-                    DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::5| ptr_this[%p] sink_singleton()->tp_inst()->schedule fail!",this);
+                    DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::5| ptr_this[%p] m_strand.post fail!",this);
                 }
             }
         } while (0);
 
         if(!bOk && this != null) m_sink.clear();
 
-        m_msink_task_mutex.unlock();
-
         this->release();
 
         DEBUG_LOG(SINK_DATA,LL_NORMAL_INFO,"mp_entity::caster_data_out | ptr_this[%p] end!",this);
@@ -1643,13 +1549,7 @@ namespace xt_mp_sink
     {
         //boost::unique_lock<boost::recursive_mutex> lock(m_mutex);
         DEBUG_LOG(SINK_DATA,LL_NORMAL_INFO,"mp_entity::send_data_out | ptr_this[%p] start...",this);
-        if (!m_mforword_task_mutex.timed_lock(
-            boost::get_system_time() + boost::posix_time::millisec(MP_FORWORD_TASK_LOCK_TM)))
-        {
-            DEBUG_LOG(SINK_DATA,LL_NORMAL_INFO,"mp_entity::send_data_out | ptr_this[%p] m_mforword_task_mutex.timed_lock fail!",this);
-            this->release();
-            return;
-        }
+        //ֻm_strandִУ
         do
         {
             if(m_state != MP_OPEN_STATE || !m_bActive)
@@ -1688,38 +1588,18 @@ namespace xt_mp_sink
                 DEBUG_LOG(SINK_DATA,LL_NORMAL_INFO,"mp_entity::send_data_out() ptr_this[%p] ֡ts[%d] pt[%d] ds[%d]",this,param.timestamp, param.payload, param.len);
             }
         } while (0);
-        m_mforword_task_mutex.unlock();
         this->release();
         DEBUG_LOG(SINK_DATA,LL_NORMAL_INFO,"mp_entity::send_data_out | ptr_this[%p] end!",this);
     }
 	long mp_entity::mp_pump_out_rtp(void **p_rtp_block)
 	{
-		long ret = -1;
-		do
+		boost::unique_lock<boost::recursive_mutex> lock(m_member_variable_mutex);
+		rtp_block *rtp = NULL;
+		long ret = m_jitter.pop(rtp);
+		if (ret >= 0)
 		{
-			itr_rtp_packet_t itr = map_rtp_packets.begin();
-			if (itr==map_rtp_packets.end())
-			{
-				ret =-2;
-				break;
-			}
-
-			rtp_block *rtp = itr->second;
-			if (!rtp)
-			{
-				ret =-3;
-				break;
-			}
 			*p_rtp_block = rtp;
-			map_rtp_packets.erase(itr);
-			if (rtp->m_rtp_param.marker == 1)
-			{
-				--wait_frames;
-				ret = 1;
-				break;
-			}
-			ret = 0;
-		} while (0);
+		}
 		return ret;
 	}
     long mp_entity::mp_read_out_rtp( uint8_t *pDst,uint32_t size,rv_rtp_param *param)
@@ -1727,17 +1607,12 @@ namespace xt_mp_sink
         long ret = -1;
         do
         {
-			itr_rtp_packet_t itr = map_rtp_packets.begin();
-			if (itr==map_rtp_packets.end())
-			{
-				ret =-2;
-				break;
-			}
-			rtp_block *rtp = itr->second;
-			map_rtp_packets.erase(itr);
-			if (rtp == NULL)
+			boost::unique_lock<boost::recursive_mutex> lock(m_member_variable_mutex);
+			rtp_block *rtp = NULL;
+			long end = m_jitter.pop(rtp);
+			if (end < 0)
 			{
-				ret =-3;
+				ret = end;
 				break;
 			}
 
@@ -1752,14 +1627,8 @@ namespace xt_mp_sink
 			::memcpy(param,&(rtp->m_rtp_param),sizeof(rv_rtp_param));
 			rtp->read(pDst,size);
 
-			//ϲmarkֹͣ
-			if(rtp->m_rtp_param.marker == 1)
-			{
-				--wait_frames;
-				ret = 1;
-				break;
-			}
-			ret = 0;
+			//ϲֹ֡ͣ
+			ret = end;
         } while (0);
         return ret;
     }
@@ -1847,10 +1716,10 @@ namespace xt_mp_sink
         while (m_rtp_fifo.pop(true))
         {
         }
-		wait_frames = 0;
-		map_rtp_packets.clear();
+		m_jitter.reset();
         m_source.clear();
         m_listAck.clear();
+        m_nack.reset();
         m_bInitLast = false;
         m_lastFrameMarkerSN = LAST_FRAME_SN_INIT;
     }
@@ -2263,42 +2132,30 @@ namespace xt_mp_sink
 
     //
     ////////////////////////////////////////////////////////////////////
-    void mp_entity::add_entity(void *entity)
+    mp_handle mp_entity::add_entity(mp_entity *entity)
     {
-        boost::recursive_mutex::scoped_lock lock(m_mEntity);
-        m_setSinkHandleMrg.insert(entity);
+        entity->m_hself = entity_table::inst()->add(entity);
+        return entity->m_hself;
     }
 
-    void mp_entity::del_entity(void *entity)
+    mp_entity* mp_entity::del_entity(mp_handle h)
     {
-        boost::recursive_mutex::scoped_lock lock(m_mEntity);
-        m_setSinkHandleMrg.erase(entity);
+        return entity_table::inst()->remove(h);
     }
 
     int mp_entity::size_entity()
     {
-        int count = 0;
-
-        boost::recursive_mutex::scoped_lock lock(m_mEntity);
-        count = m_setSinkHandleMrg.size();
-
-        return count;
+        return entity_table::inst()->size();
     }
 
-    bool mp_entity::is_valid(void *entity)
+    bool mp_entity::is_valid(mp_handle h)
     {
-        if (size_entity() == 0)
-        {
-            return false;
-        }
-
-        boost::recursive_mutex::scoped_lock lock(m_mEntity);
-        if (m_setSinkHandleMrg.end() == m_setSinkHandleMrg.find(entity))
-        {
-            return false;
-        }
+        return entity_table::inst()->is_valid(h);
+    }
 
-        return true;
+    mp_entity* mp_entity::get_entity(mp_handle h)
+    {
+        return entity_table::inst()->get(h);
     }
     ///////////////////////////////////////////////////////////////////////
 	int mp_entity::do_resend(bool resend,rv_rtp_param param)
@@ -2312,14 +2169,11 @@ namespace xt_mp_sink
 
 		if (m_nReSendCfg>0)
 		{
-			//snڱ׼rtpΪмȱʧΪļ
-			if (CalDif(m_lastSn, param.sequenceNumber)>=MAX_DROP)
-			{
-				m_lastSn = param.sequenceNumber;
-			}
-			vector<uint16_t> vt_lost_sn;
-			CalLost(vt_lost_sn, m_lastSn, param.sequenceNumber);
-			lost_packet_count += vt_lost_sn.size();
+			boost::recursive_mutex::scoped_lock lock(m_mLost);
+
+			//snֿնȼΪƶڹ
+			uint32_t now = GetTickCount();
+			lost_packet_count += m_nack.on_packet(param.sequenceNumber, resend, now);
 			if (lost_packet_count > MAX_DROP)
 			{
 				DEBUG_LOG("sink_calcerr",LL_ERROE,"mp_entity::pump_rtp_in_sj| ptr_this[%p]SN[%d] - [%d]",this, param.sequenceNumber, m_lastSn);
@@ -2328,89 +2182,98 @@ namespace xt_mp_sink
 			{
 				m_lastSn = param.sequenceNumber;
 			}
-			boost::recursive_mutex::scoped_lock lock(m_mLost);
-			// 
-			std::vector<uint16_t>::iterator itr = vt_lost_sn.begin();
-			char list_sn_buffer[1024];
-			uint32_t sn_buffer_len =0;
-			for (int nR = 0;nR<MAX_RESEND && itr!=vt_lost_sn.end();++itr,++nR)
+
+			//֡λ֮ǰĶ
+			if (m_lastFrameMarkerSN != LAST_FRAME_SN_INIT)
 			{
-				// rtcpŵbug(ʱ)
-				//////////////////////////////////////////////////////////////////////////
-				if (GetTickCount()-m_tmSrcAddr > m_tmSrcAddrInterval)
-				{
-					m_tmSrcAddr = GetTickCount();
-					add_srcaddr();
-				}
-				//////////////////////////////////////////////////////////////////////////
-				//ÿηһsn
-				if (m_nReSendCfg == 1)
-				{
-					RtcpAppMessage msg;
-					uint8_t name[4] = {'N','A','C','K'};
-					msg.subtype = 1;
-					::memcpy(msg.name, name, sizeof(name));
-
-					uint32_t sn = *itr;
-					msg.userData = (uint8_t*)&sn;
-					msg.userDataLength = sizeof(uint32_t);
-					RtcpSendApps(&m_handle, &msg, 1, false);
-				}
-				else
-				{
-					uint32_t sn = *itr;
-					::memcpy(list_sn_buffer+sn_buffer_len,(uint8_t*)&sn,sizeof(sn));
-					sn_buffer_len+=sizeof(sn);
-				}        
+				m_nack.expire_before((uint16_t)(m_lastFrameMarkerSN + 1));
 			}
-			//һaapmsgͺܶඪsn
-			if( sn_buffer_len > 0 )
-			{
-				RtcpAppMessage msg;
-				uint8_t name[4] = {'N','A','C','K'};
-				msg.subtype = 3;
-				::memcpy(msg.name, name, sizeof(name));
-
-				boost::recursive_mutex::scoped_lock lock2(xt_mp_sink::mp_entity::m_mEntityClose);
-				msg.userData = (uint8_t*)&list_sn_buffer;
-				msg.userDataLength = sn_buffer_len;
 
-				if (xt_mp_sink::mp_entity::is_valid(this))
-				{
-					RtcpSendApps(&m_handle, &msg, 1, false);
-				}
+			// ݣλͼʽһFCIɴ17sn
+			std::vector<uint16_t> vt_lost_sn;
+			uint32_t max_count = (m_nReSendCfg == NACK_SUBTYPE_FCI) ? MAX_DROP : MAX_RESEND;
+			if (m_nack.collect(now, max_count, vt_lost_sn) > 0)
+			{
+				DEBUG_LOG("sink_resend",LL_NORMAL_INFO,"mp_entity::do_resend | ptr_this[%p] nack[%d] first[%d] rtt[%d] grace[%d]",
+					this, vt_lost_sn.size(), vt_lost_sn[0], m_nack.rtt(), m_nack.grace());
+				send_nack(vt_lost_sn);
 			}
 		}
 
 		return 0;
 	}
 
-	void mp_entity::erase_front_frame()
+	void mp_entity::send_nack(const std::vector<uint16_t> &sns)
 	{
-		while ( !map_rtp_packets.empty() )
+		// rtcpŵbug(ʱ)
+		//////////////////////////////////////////////////////////////////////////
+		if (GetTickCount()-m_tmSrcAddr > m_tmSrcAddrInterval)
+		{
+			m_tmSrcAddr = GetTickCount();
+			add_srcaddr();
+		}
+		//////////////////////////////////////////////////////////////////////////
+
+		RtcpAppMessage msg;
+		uint8_t name[4] = {'N','A','C','K'};
+		::memcpy(msg.name, name, sizeof(name));
+
+		entity_table::guard alive(m_hself);
+		if (!alive)
 		{
-			itr_rtp_packet_t itr = map_rtp_packets.begin();
-			if (itr==map_rtp_packets.end())
+			return;
+		}
+
+		//ÿηһsn
+		if (m_nReSendCfg == NACK_SUBTYPE_SINGLE)
+		{
+			msg.subtype = NACK_SUBTYPE_SINGLE;
+			std::vector<uint16_t>::const_iterator itr = sns.begin();
+			for (;itr != sns.end();++itr)
 			{
-				break;
+				uint32_t sn = *itr;
+				msg.userData = (uint8_t*)&sn;
+				msg.userDataLength = sizeof(uint32_t);
+				RtcpSendApps(&m_handle, &msg, 1, false);
 			}
-			rtp_block *rtp = itr->second;
-			map_rtp_packets.erase(itr++);
-			if (!rtp) break;
-			if (rtp->m_rtp_param.marker == 1)
+		}
+		//RFC 4585 Generic NACKPID+BLPһAPP64
+		else if (m_nReSendCfg == NACK_SUBTYPE_FCI)
+		{
+			std::vector<uint8_t> fci;
+			nack_tracker::encode_fci(sns, fci);
+
+			msg.subtype = NACK_SUBTYPE_FCI;
+			for (uint32_t pos = 0; pos < fci.size(); pos += 64 * 4)
 			{
-				m_lastFrameMarkerSN = rtp->m_rtp_param.sequenceNumber;
-				--wait_frames;
-				break;
+				uint32_t len = (uint32_t)fci.size() - pos;
+				if (len > 64 * 4)
+				{
+					len = 64 * 4;
+				}
+				msg.userData = &fci[pos];
+				msg.userDataLength = len;
+				RtcpSendApps(&m_handle, &msg, 1, false);
 			}
 		}
-
-		if (map_rtp_packets.empty())
+		//һaapmsgͺܶඪsn
+		else
 		{
-			m_lastFrameMarkerSN = LAST_FRAME_SN_INIT;
+			uint32_t list_sn_buffer[256];
+			uint32_t nums = 0;
+			std::vector<uint16_t>::const_iterator itr = sns.begin();
+			for (;itr != sns.end() && nums < 256;++itr)
+			{
+				list_sn_buffer[nums++] = *itr;
+			}
+
+			msg.subtype = NACK_SUBTYPE_LIST;
+			msg.userData = (uint8_t*)list_sn_buffer;
+			msg.userDataLength = nums * sizeof(uint32_t);
+			RtcpSendApps(&m_handle, &msg, 1, false);
 		}
 	}
-	
+
 	int mp_entity::check_jarless(uint16_t rtp_sn)
 	{
 		_lastseq++;//3,4,5//һΪ435
@@ -2451,6 +2314,9 @@ namespace xt_mp_sink
 
 	int mp_entity::deal_rtp_packet(uint16_t in_sn,bool in_mark,bool resend,rtp_block* block)
 	{
+		//˴ͶǴе
+		boost::unique_lock<boost::recursive_mutex> lock(m_member_variable_mutex);
+
 		// ֪һ֡£ȴһ֡mark
 		if ( m_lastFrameMarkerSN == LAST_FRAME_SN_INIT )
 		{
@@ -2459,78 +2325,25 @@ namespace xt_mp_sink
 				m_nIncoming = 0;
 				m_lastFrameMarkerSN = in_sn;
 				_lastseq = in_sn;
+				m_jitter.sync(in_sn);
 				DEBUG_LOG("sink reset seq",LL_NORMAL_INFO,"mp_task_data_switcher_sj | ptr_this[%p] reset seq!",this);
 			}
 			return -1;
 		}
 
-		// snȳMP_SN_JUDGE_CONDITIONİ
-		if((uint16_t)(in_sn - m_lastFrameMarkerSN) > MP_SN_JUDGE_CONDITION ||
-			in_sn == m_lastFrameMarkerSN)
+		//ٵظİ
+		uint32_t now = GetTickCount();
+		if (!m_jitter.insert(block, resend, now))
 		{
 			return -2;
 		}
-		// rtpʼ mark = 0 ( Ĭ ?? ) ʴ
-		// rtpʼ mark
 
-		//˴ͶǴе
-		boost::unique_lock<boost::recursive_mutex> lock(m_member_variable_mutex);
-		if (!(map_rtp_packets.insert(make_pair(in_sn, block)).second))
-		{
-			return -8;
-		}
-		//
-		/*if (check_jarless(in_sn) < 0)
-		{
-			return -4;
-		}*/
-		
-		//˾ɾǰһ֡
-		if (map_rtp_packets.size() > LEN_RTP_CACHE)
+		//֡֡ʱ޺
+		uint32_t frames = m_jitter.release(now);
+		m_lastFrameMarkerSN = m_jitter.last_sn();
+		for (; frames > 0; --frames)
 		{
-			printf("rtpnums:%d\n",map_rtp_packets.size());
-			erase_front_frame();
-		}
-		//markͶ񣬲߳ôæ
-		if (in_mark || resend)
-		{
-			if (in_mark) ++wait_frames;
-			bool bflags = false;
-			do 
-			{
-				bflags = false;
-				uint16_t seq = m_lastFrameMarkerSN;
-				itr_rtp_packet_t itr = map_rtp_packets.begin();
-				for (;itr!=map_rtp_packets.end();++itr)
-				{
-					++seq;
-					//snǷ
-					if ( (itr->second)->m_rtp_param.sequenceNumber != seq)  // seq  
-					{
-						bflags = false;
-						break;
-					}
-					//׳һ֡
-					if ( (itr->second)->m_rtp_param.marker == 1 )
-					{
-						m_lastFrameMarkerSN = (itr->second)->m_rtp_param.sequenceNumber;
-						bflags = true;
-						break;
-					}
-				}
-				if (bflags)
-				{
-					m_pRcvRtpCB( this, m_pContext);// ص¼
-					continue;
-				}
-				if (wait_frames >= m_waitFrames)
-				{
-					printf("this:%p map_rtp_packets:%d\n",this,map_rtp_packets.size());
-					printf("wait_frames sn:%d\n",in_sn);
-					erase_front_frame();
-					continue;
-				}
-			} while (bflags);
+			m_pRcvRtpCB( m_hself, m_pContext);// ص¼
 		}
 
 		return 0;
@@ -2623,8 +2436,7 @@ namespace xt_mp_sink
 					DEBUG_LOG(SINK_DATA,LL_INFO,"mp_entity::mp_task_data_switcher_sj | m_pRcvFrameCB ptr_this[%p] proc  start...",this);
 					//ֻΪ٣洦ٶȱȻСݽٶ
 					boost::unique_lock<boost::recursive_mutex> lock(m_member_variable_mutex);
-					m_pRcvRtpCB( this, m_pContext);// ص¼
-					--wait_frames;
+					m_pRcvRtpCB( m_hself, m_pContext);// ص¼
 					DEBUG_LOG(SINK_DATA,LL_INFO,"mp_entity::mp_task_data_switcher_sj | m_pRcvFrameCB ptr_this[%p] proc  end!",this);
 				}
 			}
@@ -2715,10 +2527,10 @@ namespace xt_mp_sink
             {
                 unsigned char *crc = block->get_raw()+ param.len-4;
 
-                unsigned long sum1 = 0;
+                uint32_t sum1 = 0;
                 ::memcpy(&sum1, crc, 4);
 
-                unsigned long sum2 = CRC_32(block->get_raw()+param.sByte, param.len-param.sByte-4);
+                uint32_t sum2 = tghelper::crc32(block->get_raw()+param.sByte, param.len-param.sByte-4);
                 if (sum1 != sum2)
                 {
                     block->release();
@@ -2896,11 +2708,11 @@ namespace xt_mp_sink
                     msg.subtype = 3;
                     ::memcpy(msg.name, name, sizeof(name));
 
-                    boost::recursive_mutex::scoped_lock lock2(xt_mp_sink::mp_entity::m_mEntityClose);
+                    entity_table::guard alive(m_hself);
                     msg.userData = (uint8_t*)&list_sn_buffer;
                     msg.userDataLength = snsize;
 
-                    if (xt_mp_sink::mp_entity::is_valid(this))
+                    if (alive)
                     {
                         RtcpSendApps(&m_handle, &msg, 1, false);
                     }
@@ -2935,10 +2747,10 @@ namespace xt_mp_sink
         if (post_task)
         {
             this->assign();
-            if (!sink_inst::sink_singleton()->tp_inst()->schedule( boost::bind(&mp_entity::mp_task_data_switcher_sj, this)))
+            if (!m_strand.post(&mp_entity::serial_task<&mp_entity::mp_task_data_switcher_sj>))
             {
                 this->release();
-                DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::7| ptr_this[%p] sink_singleton()->tp_inst()->schedule fail!",this);
+                DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_entity::7| ptr_this[%p] m_strand.post fail!",this);
             }
         }
         this->release();
@@ -6,7 +6,10 @@
 #include "rtp_macro_block.h"
 #include "packet_sink.h"
 #include "recycle_fifo.h"
-#include <set>
+#include "nack_tracker.h"
+#include "jitter_buffer.h"
+#include "entity_table.h"
+#include "serial_executor.h"
 #include <boost/threadpool.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/atomic.hpp>
@@ -106,6 +109,10 @@ namespace xt_mp_sink
 		long mp_read_out_rtp(uint8_t *pDst,uint32_t size,rv_rtp_param *param);
 		long mp_pump_out_rtp(void **p_rtp_block);
 
+		long mp_set_jitter(const jitter_config &cfg);
+		long mp_query_jitter(jitter_report &report);
+		long mp_query_sched(sched_report *data, sched_report *post);
+
         long mp_manual_send_rtcp_sr(uint32_t pack_size,uint32_t pack_ts);
 
         long mp_manual_send_rtcp_rr(uint32_t ssrc,uint32_t local_ts,uint32_t ts, uint32_t sn);
@@ -155,6 +162,14 @@ namespace xt_mp_sink
         void pump_rtp_in_sj( rv_handler hrv );
         void pump_rtp_in_sj( RV_IN void *buf, RV_IN uint32_t buf_len, RV_IN rv_rtp_param *p, RV_IN rv_net_address *address );
         void mp_task_data_switcher_sj();
+
+        //жڣctxΪʵ
+        template <void (mp_entity::*F)()>
+        static void serial_task(void *ctx, void *)
+        {
+            (static_cast<mp_entity*>(ctx)->*F)();
+        }
+        static void serial_pump_rtp_in_sj(void *ctx, void *hrv);
      private:
         int m_nIncoming;
         int m_syncPackets;
@@ -185,6 +200,7 @@ namespace xt_mp_sink
             return  RV_ADAPTER_TRUE == close_session(&m_handle) ? true : false;
         }
         uint32_t _transfer_video_byteblock();
+        void _pump_rtp_block(rtp_packet_block* block, rv_rtp_param &param);
         void _post_caster_task();
 
     public:
@@ -223,8 +239,10 @@ namespace xt_mp_sink
         //ˮߴҪдлMPʹ
         //boost::timed_mutex
         boost::timed_mutex m_mssrc_task_mutex;
-        boost::timed_mutex m_msink_task_mutex;
-        boost::timed_mutex m_mforword_task_mutex;
+
+        //ʵ崮жУһˮrtpm_strand֡صm_post_strand
+        serial_queue m_strand;
+        serial_queue m_post_strand;
 
         //صfifo
         tghelper::recycle_queue m_rtp_fifo;
@@ -284,8 +302,11 @@ namespace xt_mp_sink
         // 
         std::vector<RcvSeg> m_listAck;
 
-        // 㶪ʧ
-        inline void CalLost(std::vector<uint16_t> &listLost, uint16_t sn1, uint16_t sn2);
+        // (ޡRTT˱ظ)
+        nack_tracker m_nack;
+
+        // ش
+        void send_nack(const std::vector<uint16_t> &sns);
 
         // SNȽ
         inline bool IsSmaller(uint16_t sn1, uint16_t sn2);
@@ -327,13 +348,13 @@ namespace xt_mp_sink
         void update_srcaddr_rtcp(rv_net_address &addr);
 
         //////////////////////////////////////////////////////////////////////////
-        static boost::recursive_mutex m_mEntity;
-        static std::set<mp_handle> m_setSinkHandleMrg;
-        static void add_entity(void *entity);
-        static bool is_valid(void *entity);
-        static void del_entity(void *entity);
+        //Ϊentity_tableеĲ۾ʵָ
+        static mp_handle add_entity(mp_entity *entity);
+        static bool is_valid(mp_handle h);
+        static mp_entity* get_entity(mp_handle h);
+        //Ͼȴ;ص˳
+        static mp_entity* del_entity(mp_handle h);
         static int size_entity();
-        static boost::recursive_mutex m_mEntityClose;
         //////////////////////////////////////////////////////////////////////////
         //xt_mp_descriptor m_des;
         uint16_t m_last_rtp_sn;
@@ -349,38 +370,20 @@ namespace xt_mp_sink
         //ü
         boost::atomic<int> m_ref;
 
+        //ʵľصļRTCPʱУ
+        mp_handle m_hself;
+
 
 		////////////////////////////////////////////////////////////////
-		class sn_cmp
-		{
-		public:
-			bool operator()(uint16_t sn1,uint16_t sn2)
-			{
-				if (sn1<sn2 && (sn2-sn1)<MP_SN_JUDGE_CONDITION)
-				{
-					return true;
-				}
-				else if (sn1>sn2 && (sn1-sn2)>MP_SN_JUDGE_CONDITION)
-				{
-					return true;
-				}
-				else
-				{
-					return false;
-				}
-			}
-		};
 		rtp_block *m_block_pool;//ָ֡룬֤
 		int m_block_index;
 		int do_resend(bool resend,rv_rtp_param param);
-		void erase_front_frame();
 		int check_jarless(uint16_t sn);
 		int deal_rtp_packet(uint16_t in_sn,bool in_mark,bool resend,rtp_block* block);
 
-		typedef std::map<uint16_t,rtp_block *,sn_cmp> rtp_packet_t;
-		typedef std::map<uint16_t,rtp_block *,sn_cmp>::iterator itr_rtp_packet_t;
-		std::map<uint16_t,rtp_block *,sn_cmp> map_rtp_packets;
-		int wait_frames;
+		//壬m_member_variable_mutex
+		jitter_buffer m_jitter;
+		bool m_bSetJitter;
 		int lost_packet_count;
 		bool m_pump_flags;
     };
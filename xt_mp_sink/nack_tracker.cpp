@@ -0,0 +1,255 @@
+#include "nack_tracker.h"
+
+namespace xt_mp_sink
+{
+	nack_tracker::nack_tracker()
+	{
+		m_srtt = 0;
+		m_rttvar = 0;
+		reset();
+	}
+
+	void nack_tracker::reset()
+	{
+		m_losts.clear();
+		m_init = false;
+		m_highest = 0;
+		m_last_arrival = 0;
+		m_avg_gap = 0;
+		m_jitter = 0;
+	}
+
+	uint32_t nack_tracker::_extend(uint16_t sn) const
+	{
+		//ȡm_highestӽչֵ
+		uint32_t ext = (m_highest & 0xFFFF0000) | sn;
+		int32_t diff = (int32_t)(ext - m_highest);
+		if (diff > 0x8000)
+		{
+			ext -= 0x10000;
+		}
+		else if (diff < -0x8000)
+		{
+			ext += 0x10000;
+		}
+		return ext;
+	}
+
+	uint32_t nack_tracker::grace() const
+	{
+		uint32_t g = (m_jitter * 2) >> 4;
+		if (g < NACK_MIN_GRACE_MS)
+		{
+			g = NACK_MIN_GRACE_MS;
+		}
+		if (g > NACK_MAX_GRACE_MS)
+		{
+			g = NACK_MAX_GRACE_MS;
+		}
+		return g;
+	}
+
+	uint32_t nack_tracker::_rto() const
+	{
+		if (0 == m_srtt)
+		{
+			return NACK_INIT_RTO_MS;
+		}
+
+		uint32_t rto = m_srtt + 4 * m_rttvar;
+		if (rto < NACK_MIN_RTO_MS)
+		{
+			rto = NACK_MIN_RTO_MS;
+		}
+		if (rto > NACK_MAX_RTO_MS)
+		{
+			rto = NACK_MAX_RTO_MS;
+		}
+		return rto;
+	}
+
+	void nack_tracker::_update_rtt(uint32_t sample)
+	{
+		if (0 == m_srtt)
+		{
+			m_srtt = sample > 0 ? sample : 1;
+			m_rttvar = sample / 2;
+			return;
+		}
+
+		uint32_t err = sample > m_srtt ? sample - m_srtt : m_srtt - sample;
+		m_rttvar = (3 * m_rttvar + err) / 4;
+		m_srtt = (7 * m_srtt + sample) / 8;
+		if (0 == m_srtt)
+		{
+			m_srtt = 1;
+		}
+	}
+
+	uint32_t nack_tracker::on_packet(uint16_t sn, bool resend, uint32_t now)
+	{
+		if (!m_init)
+		{
+			if (resend)
+			{
+				return 0;
+			}
+			//ӵڶֿʼʼĻ򲻻
+			m_init = true;
+			m_highest = 0x10000 | sn;
+			m_last_arrival = now;
+			return 0;
+		}
+
+		uint32_t ext = _extend(sn);
+
+		//شϿն
+		if ((int32_t)(ext - m_highest) <= 0)
+		{
+			lost_map::iterator it = m_losts.find(ext);
+			if (it != m_losts.end())
+			{
+				//ֻ״sn޷ĴεӦ
+				if (resend && 1 == it->second.retry)
+				{
+					_update_rtt(now - it->second.sent);
+				}
+				m_losts.erase(it);
+			}
+			return 0;
+		}
+
+		if (resend)
+		{
+			return 0;
+		}
+
+		//ͬRFC 3550J(i)ƽʽ
+		uint32_t gap = (now - m_last_arrival) << 4;
+		m_last_arrival = now;
+		if (gap > m_avg_gap)
+		{
+			m_avg_gap += (gap - m_avg_gap) >> 4;
+		}
+		else
+		{
+			m_avg_gap -= (m_avg_gap - gap) >> 4;
+		}
+		uint32_t d = gap > m_avg_gap ? gap - m_avg_gap : m_avg_gap - gap;
+		if (d > m_jitter)
+		{
+			m_jitter += (d - m_jitter) >> 4;
+		}
+		else
+		{
+			m_jitter -= (m_jitter - d) >> 4;
+		}
+
+		uint32_t span = ext - m_highest - 1;
+		if (span >= NACK_MAX_TRACK)
+		{
+			//sn䣬¿ʼ
+			m_losts.clear();
+			m_highest = ext;
+			return 0;
+		}
+
+		lost_item item;
+		item.detect = now;
+		item.sent = 0;
+		item.due = now + grace();
+		item.retry = 0;
+		for (uint32_t s = m_highest + 1; s != ext; ++s)
+		{
+			m_losts[s] = item;
+		}
+		m_highest = ext;
+
+		//ֻNACK_MAX_TRACK
+		while (m_losts.size() > NACK_MAX_TRACK)
+		{
+			m_losts.erase(m_losts.begin());
+		}
+
+		return span;
+	}
+
+	void nack_tracker::expire_before(uint16_t sn)
+	{
+		if (!m_init)
+		{
+			return;
+		}
+
+		uint32_t ext = _extend(sn);
+		while (!m_losts.empty() && (int32_t)(m_losts.begin()->first - ext) < 0)
+		{
+			m_losts.erase(m_losts.begin());
+		}
+	}
+
+	uint32_t nack_tracker::collect(uint32_t now, uint32_t max_count, std::vector<uint16_t> &sns)
+	{
+		uint32_t nums = 0;
+		uint32_t rto = _rto();
+
+		lost_map::iterator it = m_losts.begin();
+		while (it != m_losts.end() && nums < max_count)
+		{
+			lost_item &item = it->second;
+			if ((int32_t)(now - item.due) < 0)
+			{
+				++it;
+				continue;
+			}
+
+			if (item.retry >= NACK_MAX_RETRY)
+			{
+				m_losts.erase(it++);
+				continue;
+			}
+
+			//nȴrto*2^(n-1)
+			item.sent = now;
+			item.due = now + (rto << item.retry);
+			++item.retry;
+
+			sns.push_back((uint16_t)it->first);
+			++nums;
+			++it;
+		}
+
+		return nums;
+	}
+
+	uint32_t nack_tracker::encode_fci(const std::vector<uint16_t> &sns, std::vector<uint8_t> &fci)
+	{
+		uint32_t nums = 0;
+		std::vector<uint16_t>::const_iterator it = sns.begin();
+		while (it != sns.end())
+		{
+			uint16_t pid = *it++;
+			uint16_t blp = 0;
+
+			//16snڵĶλͼ
+			while (it != sns.end())
+			{
+				uint16_t off = (uint16_t)(*it - pid);
+				if (off < 1 || off > 16)
+				{
+					break;
+				}
+				blp |= (uint16_t)(1 << (off - 1));
+				++it;
+			}
+
+			fci.push_back((uint8_t)(pid >> 8));
+			fci.push_back((uint8_t)pid);
+			fci.push_back((uint8_t)(blp >> 8));
+			fci.push_back((uint8_t)blp);
+			++nums;
+		}
+
+		return nums;
+	}
+}
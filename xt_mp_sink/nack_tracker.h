@@ -0,0 +1,100 @@
+#ifndef NACK_TRACKER_H
+#define NACK_TRACKER_H
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+//жǰС/ȴ(ms)
+#ifndef NACK_MIN_GRACE_MS
+#define NACK_MIN_GRACE_MS		5
+#endif
+#ifndef NACK_MAX_GRACE_MS
+#define NACK_MAX_GRACE_MS		100
+#endif
+//δRTTǰشʱ(ms)
+#ifndef NACK_INIT_RTO_MS
+#define NACK_INIT_RTO_MS		100
+#endif
+#ifndef NACK_MIN_RTO_MS
+#define NACK_MIN_RTO_MS			10
+#endif
+#ifndef NACK_MAX_RTO_MS
+#define NACK_MAX_RTO_MS			1000
+#endif
+//ͬһsn
+#ifndef NACK_MAX_RETRY
+#define NACK_MAX_RETRY			3
+#endif
+//ٵĶsn䳬ֵΪ
+#ifndef NACK_MAX_TRACK
+#define NACK_MAX_TRACK			1024
+#endif
+
+//RTCP APP "NACK"
+#define NACK_SUBTYPE_SINGLE		1	//sn
+#define NACK_SUBTYPE_LIST		3	//snб
+#define NACK_SUBTYPE_FCI		4	//RFC 4585 Generic NACK FCI(PID+BLP)б
+
+namespace xt_mp_sink
+{
+	//ն˶
+	//1snֿնȴһɵﶶڣڼ䲹İش
+	//2RTT㳬ʱʱδٴָ˱ܣ
+	//3RTTȡ״شʱ(sn)
+	class nack_tracker
+	{
+	public:
+		nack_tracker();
+
+		void reset();
+
+		//յһnowΪʱӣ·ֵĶ
+		uint32_t on_packet(uint16_t sn, bool resend, uint32_t now);
+
+		//sn֮ǰĶ(Խ֡λ)
+		void expire_before(uint16_t sn);
+
+		//ȡҪsn()max_count
+		uint32_t collect(uint32_t now, uint32_t max_count, std::vector<uint16_t> &sns);
+
+		//snΪPID+BLPÿ4ֽ򣬷
+		static uint32_t encode_fci(const std::vector<uint16_t> &sns, std::vector<uint8_t> &fci);
+
+		uint32_t rtt() const { return m_srtt; }
+		uint32_t grace() const;
+		uint32_t pending() const { return (uint32_t)m_losts.size(); }
+
+	private:
+		struct lost_item
+		{
+			uint32_t detect;	//ʱ
+			uint32_t sent;		//һʱ
+			uint32_t due;		//´ʱ
+			uint32_t retry;		//
+		};
+
+		//չsn(Ƽ)ΪƱȽ
+		typedef std::map<uint32_t, lost_item> lost_map;
+
+		uint32_t _extend(uint16_t sn) const;
+		uint32_t _rto() const;
+		void _update_rtt(uint32_t sample);
+
+		lost_map m_losts;
+
+		bool m_init;
+		uint32_t m_highest;	//յչsn
+
+		//(msx16)
+		uint32_t m_last_arrival;
+		uint32_t m_avg_gap;
+		uint32_t m_jitter;
+
+		//RTT(ms)ͬTCPsrtt/rttvar
+		uint32_t m_srtt;
+		uint32_t m_rttvar;
+	};
+}
+
+#endif //NACK_TRACKER_H
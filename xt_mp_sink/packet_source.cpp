@@ -9,46 +9,87 @@ namespace xt_mp_sink
     bool rtp_packet_source::_insert( rtp_packet_block *item )
     {
         DEBUG_LOG(SINK_CALL,LL_NORMAL_INFO,"rtp_packet_source::_insert start..");
-        bool ret = false;
-        if(m_queue.empty())
+        uint16_t sn = item->get_sn();
+        if (0 == m_count)
         {
-            m_queue.push_back(item);
-            DEBUG_LOG(SINK_CALL,LL_NORMAL_INFO,"_insert | push_back emp:%d ", item->get_sn());
+            m_slots[_slot(sn)] = item;
+            m_count = 1;
+            m_first_sn = sn;
+            m_last_sn = sn;
+            m_contig_sn = sn;
+            m_marker_count = 0;
+            if (item->is_marker1())
+            {
+                m_marker_sn = sn;
+                m_marker_count = 1;
+            }
+            DEBUG_LOG(SINK_CALL,LL_NORMAL_INFO,"_insert | push_back emp:%d ", sn);
             return true;
         }
 
-        rtp_packet_block* last_item = m_queue.back();
-
-        if (IsSmaller(last_item->get_sn(), item->get_sn()))
+        //󴰿ڿȲܳλͬsn䵽ͬһslot
+        uint16_t first_sn = IsSmaller(sn, m_first_sn) ? sn : m_first_sn;
+        uint16_t last_sn = IsSmaller(m_last_sn, sn) ? sn : m_last_sn;
+        if ((uint16_t)(last_sn - first_sn) >= m_capacity)
         {
-            m_queue.push_back(item);
-            DEBUG_LOG(SINK_CALL,LL_NORMAL_INFO,"_insert | push_back:%d - [%d] ", last_item->get_sn(), item->get_sn());
+            DEBUG_LOG(SINK_CALL,LL_INFO,"_insert | out of window:[%d] - [%d,%d] ", sn, m_first_sn, m_last_sn);
+            return false;
+        }
 
-            return true;
+        rtp_packet_block *&slot = m_slots[_slot(sn)];
+        if (slot)
+        {
+            //ظ(شA͵նʱ)ɵͷ
+            return false;
         }
 
-        SOURCE_ITER itr = m_queue.begin();
-        for (;itr != m_queue.end();++itr)
+        slot = item;
+        ++m_count;
+        if (item->is_marker1())
         {
-            rtp_packet_block *frm = *itr;
-            if (frm->get_sn() == item->get_sn())
+            if (0 == m_marker_count || IsSmaller(sn, m_marker_sn))
             {
-                //item->release();  // Ϊ 2014-08-06  ( شA ͵նC1, C2...ʱ, ܵ; ޴ڴй¶ )
-                break;
+                m_marker_sn = sn;
             }
+            ++m_marker_count;
+        }
 
-            if (IsSmaller(item->get_sn(), frm->get_sn()))
-            {
-                ret = true;
-                m_queue.insert(itr, item);
-                DEBUG_LOG(SINK_CALL,LL_INFO,"insert:[%d] - [%d] ", item->get_sn(), frm->get_sn());
-
-                break;
-            }
+        m_last_sn = last_sn;
+        if (first_sn != m_first_sn)
+        {
+            DEBUG_LOG(SINK_CALL,LL_INFO,"insert:[%d] - [%d] ", sn, m_first_sn);
+            m_first_sn = first_sn;
+            m_contig_sn = first_sn;
         }
+        _advance_contig();
+
         DEBUG_LOG(SINK_CALL,LL_NORMAL_INFO,"rtp_packet_source::_insert end!");
+        return true;
+    }
 
-        return ret;
+    void rtp_packet_source::_advance_contig()
+    {
+        while (m_contig_sn != m_last_sn && m_slots[_slot((uint16_t)(m_contig_sn + 1))])
+        {
+            ++m_contig_sn;
+        }
+    }
+
+    void rtp_packet_source::_find_first_marker(uint16_t sn)
+    {
+        for (;; ++sn)
+        {
+            rtp_packet_block *item = m_slots[_slot(sn)];
+            if (item && item->is_marker1())
+            {
+                m_marker_sn = sn;
+                return;
+            }
+            if (sn == m_last_sn)
+            {
+                return;
+            }
+        }
     }
 
     // SNȽ
@@ -88,75 +129,85 @@ namespace xt_mp_sink
             return false;
         }
 
-        bool bMark = true;
-        if(m_queue.size() >= m_max_size)
+        //ڶ׵İ(شĶװ)ڻʱڿ_insertУ
+        if (m_count > 0 && IsSmaller(seqNum, m_first_sn))
         {
-            SOURCE_ITER it = m_queue.begin();
-
-            if (IsSmaller(seqNum, (*it)->get_sn()))
+            if (m_count >= m_max_size)
             {
                 return false;
             }
-
-            while(m_queue.size())
+        }
+        //°δʱӶװ֡
+        //Ϊδ֡βʱlastSeqNum-1֡Ҫɾ
+        else if (m_count > 0 && (m_count >= m_max_size || (uint16_t)(seqNum - m_first_sn) >= m_capacity))
+        {
+            while (m_count > 0 && !IsSmaller(seqNum, m_first_sn)
+                && (m_count >= m_max_size || (uint16_t)(seqNum - m_first_sn) >= m_capacity))
             {
-                rtp_packet_block* pkt = m_queue.front();
-                if (pkt->is_marker1())
-                {
-                    bMark = true;
-
-                    lastSeqNum = pkt->get_sn();
-                    DEBUG_LOG("sink_overflow",LL_NORMAL_INFO,"[%d]", lastSeqNum);
-
-                    m_queue.erase(m_queue.begin());
-                    pkt->release();
+                DEBUG_LOG("sink_overflow",LL_NORMAL_INFO,"[%d]", m_first_sn);
+                _dropData(lastSeqNum);
+            }
 
-                    break;
-                }
-                else
-                {
-                    bMark = false;
-                }
-                DEBUG_LOG("sink_overflow",LL_NORMAL_INFO,"[%d]", item->get_sn());
-                m_queue.erase(m_queue.begin());
-                pkt->release();
+            //°Ѷ֡
+            if (lastSeqNum != -1 && !IsSmaller((uint16_t)lastSeqNum, seqNum))
+            {
+                return false;
             }
         }
 
         bRet = _insert(item); 
 
-		//markǵ˼queueһ֡Ҫɾ
-        if (!bMark)
-        {
-            lastSeqNum = -1;
-        }
-
         DEBUG_LOG("sink_overflow",LL_NORMAL_INFO,"rtp_packet_source::_push end!");
         return bRet;
     }
 
     rtp_packet_block * rtp_packet_source::_pop( bool bRelease )
     {
-        rtp_packet_block * item = 0;
+        if (0 == m_count)
+        {
+            return 0;
+        }
 
-        if ( !m_queue.empty() )
+        rtp_packet_block *&slot = m_slots[_slot(m_first_sn)];
+        rtp_packet_block *item = slot;
+        slot = NULL;
+        --m_count;
+
+        bool marker = (item->is_marker1() != 0);
+        if (marker)
         {
-            item = m_queue.front();
-            m_queue.erase(m_queue.begin());
+            --m_marker_count;
+        }
 
-            if (bRelease)
-                item->release();
+        if (0 == m_count)
+        {
+            m_marker_count = 0;
         }
+        else
+        {
+            //׺ƵһѵİβȻһҵ
+            do
+            {
+                ++m_first_sn;
+            } while (NULL == m_slots[_slot(m_first_sn)]);
 
-        return item;
-    }
+            if (IsSmaller(m_contig_sn, m_first_sn))
+            {
+                m_contig_sn = m_first_sn;
+                _advance_contig();
+            }
 
-    void rtp_packet_source::_erase(SOURCE_ITER pos,bool bRelease)
-    {
-        rtp_packet_block * item = *pos;
-        m_queue.erase(pos);
-        if(bRelease)
+            //ӵ֡βȻǵһ֡βһ
+            if (marker && m_marker_count > 0)
+            {
+                _find_first_marker(m_first_sn);
+            }
+        }
+
+        if (bRelease)
             item->release();
+
+        return item;
     }
 
     bool xt_mp_sink::rtp_packet_source::push( rtp_packet_block *item ,long& lastSeqNum)
@@ -171,48 +222,22 @@ namespace xt_mp_sink
         return _pop(bRelease);
     }
 
-    void rtp_packet_source::erase( SOURCE_ITER pos,bool bRelease /*= false*/ )
-    {
-        boost::mutex::scoped_lock lock(m_mutex);
-        _erase(pos,bRelease);
-    }
-
     void rtp_packet_source::clear()
     {
         boost::mutex::scoped_lock lock(m_mutex);
         std::vector<rtp_packet_block *>::iterator it;
-        for (it = m_queue.begin(); it != m_queue.end(); ++it)
+        for (it = m_slots.begin(); it != m_slots.end(); ++it)
         {
             rtp_packet_block * item = *it;
             if (item)
             {
                 if(0 > item->release())
                     utility::destruct_ptr(item);
+                *it = NULL;
             }
         }
-        m_queue.clear();
-    }
-
-    bool rtp_packet_source::_is_sequence_sn( SOURCE_ITER pos )
-    {
-        if(pos == m_queue.begin())
-            return true;
-        SOURCE_ITER	titer = pos;
-        if(pos != m_queue.end())
-            titer = pos++;
-        uint32_t n = 0;
-        for (SOURCE_ITER iter=m_queue.begin();iter!=titer;iter++)
-        {
-            if(iter != m_queue.begin())
-            {
-                if (uint16_t((*iter)->get_sn() - n) != 1)
-                {
-                    return false;
-                }
-            }
-            n = (*iter)->get_sn();
-        }
-        return true;
+        m_count = 0;
+        m_marker_count = 0;
     }
 
     uint32_t rtp_packet_source::_output_data( int _distance,pump_param& param )
@@ -281,7 +306,7 @@ namespace xt_mp_sink
     uint32_t rtp_packet_source::size()
     {
         boost::mutex::scoped_lock lock(m_mutex);
-        return m_queue.size();
+        return m_count;
     }
 
     ////////////////xy////////////////
@@ -296,7 +321,7 @@ namespace xt_mp_sink
         }
 
         //////////////////////////////////////////////////////////////////////////
-        DEBUG_LOG("sink_snin",LL_NORMAL_INFO,"dataRecombine |sn:%d - lastSN:%d - queueSize:%d", item->get_sn(), lastSeqNum,m_queue.size());
+        DEBUG_LOG("sink_snin",LL_NORMAL_INFO,"dataRecombine |sn:%d - lastSN:%d - queueSize:%d", item->get_sn(), lastSeqNum,m_count);
         //////////////////////////////////////////////////////////////////////////
 
         //ɾ֡¼֡βк
@@ -328,114 +353,35 @@ namespace xt_mp_sink
 Lable:
         {
             boost::mutex::scoped_lock lock(m_mutex);
-            int distance = -1;
-            if(m_queue.size() <= 0)
+            if(m_count <= 0)
             {
                 return false;
             }
 
-            SOURCE_ITER ite = m_queue.end();
-            SOURCE_ITER its = m_queue.end();
-            SOURCE_ITER it = m_queue.begin();
-
-            //ҵ֡β
-            SOURCE_ITER itr = m_queue.begin();
-            for(;itr != m_queue.end();++itr)
-            {
-                if ( NULL == (*itr))
-                {
-                    DEBUG_LOG(SINK_ERROE,LL_ERROE,"dataRecombine | *itr[%p]m_queue_size[%d]",*itr,m_queue.size());
-                    continue;
-                }
-
-                if((*itr)->is_marker1() == 1)
-                {
-                    ite = itr;
-                    break;
-                }
-            }
-            if(ite == m_queue.end())
+            //ҵ֡β֡βλӳʱά
+            if (0 == m_marker_count)
             {
                 checkTimeout(lastSeqNum);
                 return false;
             }
 
-            its = m_queue.begin();
-            if ( NULL == (*its) )
-            {
-                return false;
-            }
-
             //жǷΪһ֡еװ
-            if (lastSeqNum == MP_SOURCE_SN_MAX_NUM-1)
-            {
-                if((*its)->get_sn() != 0)
-                {
-                    checkTimeout(lastSeqNum);
-                    return false;
-                }
-            }
-            else if((*its)->get_sn() != lastSeqNum +1)
+            if (m_first_sn != (uint16_t)(lastSeqNum + 1))
             {
                 checkTimeout(lastSeqNum);
                 return false;
             }
 
-            //жSNǷ
-            int nSN = 0;
-            for(;it!=m_queue.end();++it)
-            {
-                if ( NULL == (*it))
-                {
-                     DEBUG_LOG(SINK_ERROE,LL_ERROE,"dataRecombine eer 2| *itr[%p]m_queue_size[%d]",*it,m_queue.size());
-                    continue;
-                }
-
-                if(it == its)
-                {
-                    nSN = (*it)->get_sn();
-                    if(nSN == 65535)
-                    {
-                        nSN = -1;
-                    }
-                }
-                else if(nSN+1 != (*it)->get_sn())
-                {
-                    bRet = false;
-                    break;
-                }
-                else if((*ite)->is_smaller(*it))
-                {
-                    break;
-                }
-                else
-                {
-                    if(nSN == 65535)
-                    {
-                        nSN = -1;
-                    }
-                    else
-                    {
-                        nSN +=1;
-                    }
-                }
-            }
-
-            if(!bRet)
+            //ж϶׵֡βSNǷ
+            if (_offset(m_marker_sn) > _offset(m_contig_sn))
             {
                 checkTimeout(lastSeqNum);
                 return false;
             }
 
-            if (NULL == (*ite))
-            {
-                DEBUG_LOG(SINK_ERROE,LL_ERROE,"dataRecombine eer 3| *its[%p] *ite[%p]m_queue_size[%d]",*its,*ite,m_queue.size());
-                return false;
-            }
-
-            distance = std::distance(m_queue.begin(),ite);
+            int distance = _offset(m_marker_sn);
 
-            lastSeqNum = (*ite)->get_sn();
+            lastSeqNum = m_marker_sn;
 
             _output_data(distance,param);
         }
@@ -448,9 +394,9 @@ Lable:
     {
         DEBUG_LOG("sink_drop",LL_NORMAL_INFO,"rtp_packet_source::_dropData start...");
         bool bMark = false;
-        while(m_queue.size())
+        while(m_count)
         {
-            rtp_packet_block* item = m_queue.front();
+            rtp_packet_block* item = _pop(false);
             DEBUG_LOG("sink_drop",LL_NORMAL_INFO,"_dropData | sn:%d",item->get_sn());
 
             if (item->is_marker1())
@@ -460,16 +406,10 @@ Lable:
                 lastSeqNum = item->get_sn();
 
                 item->release();
-                m_queue.erase(m_queue.begin());
                 break;
             }
-            else
-            {
-                bMark = false;
-            }
 
             item->release();
-            m_queue.erase(m_queue.begin());
         }
         if(!bMark)
         {
@@ -482,23 +422,11 @@ Lable:
     //жǷʱ
     void xt_mp_sink::rtp_packet_source::checkTimeout(long& lastSeqNum)
     {
-        //ҵ֡β
-        int nCount = 0;
-        SOURCE_ITER itr = m_queue.begin();
-        for(;itr != m_queue.end();++itr)
-        {
-            if (nCount >= m_frame_cache)
-            {
-                break;
-            }
-            if((*itr)->is_marker1() == 1)
-            {
-                nCount++;
-            }
-        }
+        //֡m_frame_cacheʱһ
+        unsigned int nCount = m_marker_count < m_frame_cache ? m_marker_count : m_frame_cache;
 
         if (nCount >= m_frame_cache)
-            for (int i=0;i<nCount/2;++i)
+            for (unsigned int i=0;i<nCount/2;++i)
             {
                 _dropData(lastSeqNum);
             }
@@ -7,9 +7,6 @@
 
 namespace xt_mp_sink
 {
-	typedef std::vector<rtp_packet_block *>::iterator SOURCE_ITER;
-	typedef std::vector<rtp_packet_block *>::reverse_iterator SOURCE_RITER;
-
 	typedef struct _pump_param
 	{
 		trans_mode mode;
@@ -31,6 +28,20 @@ namespace xt_mp_sink
 			{
 				m_frame_cache = 25;
 			}
+
+			//λ尴snȡģλȡС2ݣҲsnȽϵİ봰
+			m_capacity = 64;
+			while (m_capacity < m_max_size * 2 && m_capacity < MP_SN_JUDGE_CONDITION)
+			{
+				m_capacity <<= 1;
+			}
+			m_slots.assign(m_capacity, (rtp_packet_block *)NULL);
+			m_count = 0;
+			m_first_sn = 0;
+			m_last_sn = 0;
+			m_contig_sn = 0;
+			m_marker_sn = 0;
+			m_marker_count = 0;
 		}
 		virtual ~rtp_packet_source(){ clear(); }
 
@@ -46,7 +57,6 @@ namespace xt_mp_sink
 
 		bool push(rtp_packet_block *item,long& lastSeqNum);
 		rtp_packet_block * pop(bool bRelease = false);
-		void erase(SOURCE_ITER pos,bool bRelease = false);
 		void clear();
 
 		uint32_t size();
@@ -67,10 +77,18 @@ namespace xt_mp_sink
 
 		bool _push(rtp_packet_block *item,long& lastSeqNum);
 		rtp_packet_block * _pop(bool bRelease);
-		void _erase(SOURCE_ITER pos,bool bRelease);
 		bool _insert(rtp_packet_block *item);
 
-		bool _is_sequence_sn(SOURCE_ITER pos);
+		inline uint32_t _slot(uint16_t sn) const { return sn & (m_capacity - 1); }
+
+		//snԶ׵ƫ
+		inline uint16_t _offset(uint16_t sn) const { return (uint16_t)(sn - m_first_sn); }
+
+		//m_contig_snƽ
+		void _advance_contig();
+
+		//snʼҵһ֡βǰ
+		void _find_first_marker(uint16_t sn);
 
 		// SNȽ
 		bool IsSmaller(uint16_t sn1, uint16_t sn2);
@@ -93,9 +111,17 @@ namespace xt_mp_sink
 		// г
 		unsigned int m_frame_cache;
 	
-	public:
+		//snĻŻ壬slot = sn % m_capacity[m_first_sn, m_last_sn]m_capacity
+		std::vector<rtp_packet_block *> m_slots;
+		uint32_t m_capacity;
+		uint32_t m_count;
+		uint16_t m_first_sn;		//(С)sn
+		uint16_t m_last_sn;			//β()sn
+		uint16_t m_contig_sn;		//Ӷһsn
+		uint16_t m_marker_sn;		//еһ֡βǰsn
+		uint32_t m_marker_count;	//֡βǰ
 
-		std::vector<rtp_packet_block *> m_queue;
+	public:
 
 		boost::mutex m_mutex;
 	};
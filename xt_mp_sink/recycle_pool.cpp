@@ -10,41 +10,70 @@
 //#include "stdafx.h"
 #include "tghelper/recycle_pool.h"
 
+#if defined(_WIN32)
+#define TG_THREAD_LOCAL __declspec(thread)
+#else
+#define TG_THREAD_LOCAL __thread
+#endif
+
 namespace tghelper
 {
+	namespace inner
+	{
+		//̻߳ţ߳״ηڴʱ䣬1ʼ
+		static TG_THREAD_LOCAL uint32_t s_thread_cache_id = 0;
+		static boost::atomic<uint32_t> s_thread_cache_seq(0);
+
+		static inline uint32_t current_cache_slot()
+		{
+			if (0 == s_thread_cache_id)
+			{
+				s_thread_cache_id = ++s_thread_cache_seq;
+			}
+			return (s_thread_cache_id - 1) % TGHELPER_POOL_CACHE_SLOTS;
+		}
+	}
+
 	///////////////////////////////////////////////////
 	//recycle_pool_item
 	int recycle_pool_item::assign()
 	{
-		boost::mutex::scoped_lock lock(m_mutex);
-		m_ref_count++;
-		return m_ref_count;
+		//ڵķ봫ɳػеͬڴ
+		return m_ref_count.fetch_add(1, boost::memory_order_relaxed) + 1;
 	}
 	int recycle_pool_item::release()
 	{
 		int nRet = 0;
-		boost::mutex::scoped_lock lock(m_mutex);
-		if (0 < m_ref_count) m_ref_count--;
-		if (0 == m_ref_count)
+		int ref = m_ref_count.load(boost::memory_order_relaxed);
+		//0ʱԭӵݼΪ0ʱԭֱӽմ
+		while (0 < ref)
 		{
-			if (m_owner)
+			if (m_ref_count.compare_exchange_weak(ref, ref - 1, 
+				boost::memory_order_release, boost::memory_order_relaxed))
 			{
-				m_owner->release_item(this);
-				nRet = 0;
-			}
-			else
-			{
-				nRet = -1;
+				if (1 < ref) return (ref - 1);
+				break;
 			}
 		}
+		//̵߳release֤ͬǰԽڵдѿɼ
+		boost::atomic_thread_fence(boost::memory_order_acquire);
+
+		boost::mutex::scoped_lock lock(m_mutex);
+		if (m_owner)
+		{
+			m_owner->release_item(this);
+			nRet = 0;
+		}
 		else
-			nRet = m_ref_count;
+		{
+			nRet = -1;
+		}
 		return nRet;
 	}
 
 	///////////////////////////////////////////////////
 	// recycle_pool
-	recycle_pool::recycle_pool(void)
+	recycle_pool::recycle_pool(void) : m_cache()
 	{
 	}
 
@@ -90,6 +119,21 @@ namespace tghelper
 				}
 			}
 
+			//нڵҲλ̻߳
+			for (uint32_t i = 0; i < TGHELPER_POOL_CACHE_SLOTS; ++i)
+			{
+				inner::pool_cache_slot &slot = m_cache[i];
+				boost::detail::spinlock::scoped_lock slot_lock(slot.lock);
+				for (uint32_t j = 0; j < slot.count; ++j)
+				{
+					if (item == slot.items[j])
+					{
+						slot.items[j] = slot.items[--slot.count];
+						break;
+					}
+				}
+			}
+
 			if (item->get_trace_flag()) 
 			{
 				std::vector<recycle_pool_item *>::iterator itr = m_used.begin();
@@ -131,6 +175,7 @@ namespace tghelper
 			//ʵʱٷڵ״̬ܿƵͷŵĽڵ㲻ʹøù
 			if (bTrace) m_used.push_back(item);		
 			item->set_trace_flag(bTrace);
+			item->m_cache_slot = inner::current_cache_slot();
 			//¼
 			item->recycle_alloc_event();
 		}
@@ -139,10 +184,143 @@ namespace tghelper
 
 	recycle_pool_item * recycle_pool::alloc_item(bool bTrace)
 	{
+		if (!bTrace)
+		{
+			recycle_pool_item * item = _cache_alloc_item();
+			if (item) return item;
+		}
 		boost::mutex::scoped_lock lock(m_mutex);
 		return _alloc_item(bTrace);
 	}
 
+	recycle_pool_item * recycle_pool::_cache_alloc_item(bool refill)
+	{
+		recycle_pool_item * item = 0;
+	#if (TGHELPER_POOL_CACHE_SIZE > 0)
+		uint32_t slot_id = inner::current_cache_slot();
+		inner::pool_cache_slot &slot = m_cache[slot_id];
+		{
+			boost::detail::spinlock::scoped_lock slot_lock(slot.lock);
+			if (0 < slot.count)
+			{
+				item = slot.items[--slot.count];
+				slot.hits++;
+			}
+			else
+			{
+				slot.misses++;
+			}
+		}
+
+		if (!item && refill)
+		{
+			//Ϊգȫֿб䣬гڼ䲻ռòλ
+			recycle_pool_item * batch[TGHELPER_POOL_CACHE_BATCH];
+			uint32_t nums = 0;
+			{
+				boost::mutex::scoped_lock lock(m_mutex);
+				while ((nums < TGHELPER_POOL_CACHE_BATCH) && !m_unused.empty())
+				{
+					batch[nums++] = m_unused.back();
+					m_unused.pop_back();
+				}
+			}
+			if (0 < nums)
+			{
+				item = batch[--nums];
+				uint32_t rest = 0;
+				{
+					boost::detail::spinlock::scoped_lock slot_lock(slot.lock);
+					while ((rest < nums) && (slot.count < TGHELPER_POOL_CACHE_SIZE))
+					{
+						slot.items[slot.count++] = batch[rest++];
+					}
+				}
+				if (rest < nums)
+				{
+					//λ߳ͬʱڵ黹
+					boost::mutex::scoped_lock lock(m_mutex);
+					for (; rest < nums; ++rest) m_unused.push_back(batch[rest]);
+				}
+			}
+		}
+
+		if (item)
+		{
+			item->set_trace_flag(false);
+			item->m_cache_slot = slot_id;
+			//¼
+			item->recycle_alloc_event();
+		}
+	#endif
+		return item;
+	}
+
+	bool recycle_pool::_cache_release_item(recycle_pool_item *item)
+	{
+	#if (TGHELPER_POOL_CACHE_SIZE > 0)
+		uint32_t slot_id = inner::current_cache_slot();
+		inner::pool_cache_slot &slot = m_cache[slot_id];
+		//ڵ뻺󼴿ɱ̷߳䣬ȼ¼
+		item->recycle_release_event();
+
+		recycle_pool_item * batch[TGHELPER_POOL_CACHE_BATCH];
+		uint32_t nums = 0;
+		{
+			boost::detail::spinlock::scoped_lock slot_lock(slot.lock);
+			if (item->m_cache_slot != slot_id) slot.cross_frees++;
+			if (TGHELPER_POOL_CACHE_SIZE == slot.count)
+			{
+				//뻺һڵ黹ȫֿб
+				nums = TGHELPER_POOL_CACHE_BATCH;
+				::memcpy(batch, slot.items, nums * sizeof(recycle_pool_item *));
+				::memmove(slot.items, slot.items + nums, (slot.count - nums) * sizeof(recycle_pool_item *));
+				slot.count -= nums;
+			}
+			slot.items[slot.count++] = item;
+		}
+		if (0 < nums)
+		{
+			boost::mutex::scoped_lock lock(m_mutex);
+			m_unused.insert(m_unused.end(), batch, batch + nums);
+		}
+		return true;
+	#else
+		return false;
+	#endif
+	}
+
+	void recycle_pool::_cache_flush_all()
+	{
+		std::vector<recycle_pool_item *> items;
+		for (uint32_t i = 0; i < TGHELPER_POOL_CACHE_SLOTS; ++i)
+		{
+			inner::pool_cache_slot &slot = m_cache[i];
+			boost::detail::spinlock::scoped_lock slot_lock(slot.lock);
+			items.insert(items.end(), slot.items, slot.items + slot.count);
+			slot.count = 0;
+		}
+		if (!items.empty())
+		{
+			boost::mutex::scoped_lock lock(m_mutex);
+			m_unused.insert(m_unused.end(), items.begin(), items.end());
+		}
+	}
+
+	void recycle_pool::cache_stat(recycle_pool_cache_stat &stat)
+	{
+		::memset(&stat, 0, sizeof(recycle_pool_cache_stat));
+		for (uint32_t i = 0; i < TGHELPER_POOL_CACHE_SLOTS; ++i)
+		{
+			inner::pool_cache_slot &slot = m_cache[i];
+			boost::detail::spinlock::scoped_lock slot_lock(slot.lock);
+			stat.hits += slot.hits;
+			stat.misses += slot.misses;
+			stat.cross_frees += slot.cross_frees;
+			stat.stock += slot.count;
+		}
+	}
+
 	recycle_pool_item * recycle_pool::_add_alloc_fast_item(recycle_pool_item *item, bool bTrace)
 	{
 		if (item)
@@ -155,6 +333,7 @@ namespace tghelper
 				m_used.push_back(item);
 			}
 			item->set_trace_flag(bTrace);
+			item->m_cache_slot = inner::current_cache_slot();
 			//¼
 			item->recycle_alloc_event();
 		}
@@ -174,6 +353,7 @@ namespace tghelper
 				m_used.push_back(item);
 			}
 			item->set_trace_flag(bTrace);
+			item->m_cache_slot = inner::current_cache_slot();
 			//¼
 			item->recycle_alloc_event();
 		}
@@ -184,6 +364,9 @@ namespace tghelper
 	{
 		if (item)
 		{
+			//ǸٽڵȻ뱾̻߳
+			if (!item->get_trace_flag() && _cache_release_item(item)) return;
+
 			boost::mutex::scoped_lock lock(m_mutex);
 			m_unused.push_back(item);
 			
@@ -207,6 +390,7 @@ namespace tghelper
 	uint32_t recycle_pool::clear()
 	{
 		uint32_t nRet = m_used.size();
+		_cache_flush_all();
 		boost::mutex::scoped_lock lock(m_mutex);
 		//m_unusedнڵ㣬m_usedΪڴй¶ͳ
 		std::vector<recycle_pool_item *>::iterator it;
@@ -0,0 +1,283 @@
+#include "serial_executor.h"
+#include <boost/bind.hpp>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace xt_mp_sink
+{
+	serial_queue::serial_queue()
+	:m_executor(NULL),
+	m_ctx(NULL),
+	m_head(0),
+	m_size(0),
+	m_scheduled(false),
+	m_next(NULL),
+	m_max_depth(0),
+	m_last_latency_us(0),
+	m_max_latency_us(0),
+	m_tasks(0),
+	m_rejected(0)
+	{
+		m_ring.resize(64);
+	}
+
+	serial_queue::~serial_queue()
+	{
+		wait_idle();
+	}
+
+	void serial_queue::bind(serial_executor *executor, void *ctx)
+	{
+		wait_idle();
+
+		boost::mutex::scoped_lock lock(m_mutex);
+		m_executor = executor;
+		m_ctx = ctx;
+		m_max_depth = 0;
+		m_last_latency_us = 0;
+		m_max_latency_us = 0;
+		m_tasks = 0;
+		m_rejected = 0;
+	}
+
+	void serial_queue::grow()
+	{
+		//Ϊ2ݣᵽ»ͷ
+		uint32_t cap = (uint32_t)m_ring.size();
+		std::vector<task> ring(cap * 2);
+		for (uint32_t i = 0; i < m_size; ++i)
+		{
+			ring[i] = m_ring[(m_head + i) & (cap - 1)];
+		}
+		m_ring.swap(ring);
+		m_head = 0;
+	}
+
+	bool serial_queue::post(serial_task_fn fn, void *arg)
+	{
+		serial_executor *executor = NULL;
+		{
+			boost::mutex::scoped_lock lock(m_mutex);
+			if (NULL == m_executor)
+			{
+				return false;
+			}
+
+			uint32_t cap = (uint32_t)m_ring.size();
+			if (m_size == cap)
+			{
+				if (cap >= SERIAL_QUEUE_MAX_SIZE)
+				{
+					++m_rejected;
+					return false;
+				}
+				grow();
+				cap = (uint32_t)m_ring.size();
+			}
+
+			task &t = m_ring[(m_head + m_size) & (cap - 1)];
+			t.fn = fn;
+			t.arg = arg;
+			t.post_us = serial_executor::now_us();
+			++m_size;
+			if (m_size > m_max_depth)
+			{
+				m_max_depth = m_size;
+			}
+			++m_executor->m_pending;
+
+			if (m_scheduled)
+			{
+				return true;
+			}
+			m_scheduled = true;
+			executor = m_executor;
+		}
+
+		executor->schedule(this);
+		return true;
+	}
+
+	bool serial_queue::run(uint32_t budget)
+	{
+		for (uint32_t n = 0; n < budget; ++n)
+		{
+			task t;
+			{
+				boost::mutex::scoped_lock lock(m_mutex);
+				if (0 == m_size)
+				{
+					m_scheduled = false;
+					return false;
+				}
+
+				t = m_ring[m_head];
+				m_head = (m_head + 1) & ((uint32_t)m_ring.size() - 1);
+				--m_size;
+
+				int64_t latency = serial_executor::now_us() - t.post_us;
+				m_last_latency_us = latency > 0 ? (uint32_t)latency : 0;
+				if (m_last_latency_us > m_max_latency_us)
+				{
+					m_max_latency_us = m_last_latency_us;
+				}
+				++m_tasks;
+			}
+
+			--m_executor->m_pending;
+			t.fn(m_ctx, t.arg);
+		}
+
+		boost::mutex::scoped_lock lock(m_mutex);
+		if (0 == m_size)
+		{
+			m_scheduled = false;
+			return false;
+		}
+		return true;
+	}
+
+	void serial_queue::wait_idle()
+	{
+		for (;;)
+		{
+			{
+				boost::mutex::scoped_lock lock(m_mutex);
+				if (!m_scheduled)
+				{
+					return;
+				}
+			}
+			boost::this_thread::yield();
+		}
+	}
+
+	void serial_queue::report(sched_report &report) const
+	{
+		boost::mutex::scoped_lock lock(m_mutex);
+		report.depth = m_size;
+		report.max_depth = m_max_depth;
+		report.last_latency_us = m_last_latency_us;
+		report.max_latency_us = m_max_latency_us;
+		report.tasks = m_tasks;
+		report.rejected = m_rejected;
+	}
+
+	serial_executor::serial_executor(uint32_t threads)
+	:m_head(NULL),
+	m_tail(NULL),
+	m_run(true),
+	m_pending(0)
+	{
+		if (0 == threads)
+		{
+			threads = 1;
+		}
+		for (uint32_t i = 0; i < threads; ++i)
+		{
+			m_threads.create_thread(boost::bind(&serial_executor::worker, this));
+		}
+	}
+
+	serial_executor::~serial_executor()
+	{
+		{
+			boost::mutex::scoped_lock lock(m_mutex);
+			m_run = false;
+		}
+		m_cond.notify_all();
+		m_threads.join_all();
+	}
+
+	int64_t serial_executor::now_us()
+	{
+#ifdef _WIN32
+		static LARGE_INTEGER freq = {0};
+		if (0 == freq.QuadPart)
+		{
+			::QueryPerformanceFrequency(&freq);
+		}
+		LARGE_INTEGER cnt;
+		::QueryPerformanceCounter(&cnt);
+		return (int64_t)(cnt.QuadPart / freq.QuadPart * 1000000 + cnt.QuadPart % freq.QuadPart * 1000000 / freq.QuadPart);
+#else
+		struct timespec ts;
+		::clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+	}
+
+	void serial_executor::wait()
+	{
+		while (m_pending > 0)
+		{
+			boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+		}
+	}
+
+	void serial_executor::schedule(serial_queue *q)
+	{
+		bool wake = false;
+		{
+			boost::mutex::scoped_lock lock(m_mutex);
+			q->m_next = NULL;
+			if (m_tail)
+			{
+				m_tail->m_next = q;
+			}
+			else
+			{
+				m_head = q;
+				wake = true;
+			}
+			m_tail = q;
+		}
+
+		//ԭǿʱ̱߳ѻȡ
+		if (wake)
+		{
+			m_cond.notify_one();
+		}
+	}
+
+	void serial_executor::worker()
+	{
+		for (;;)
+		{
+			serial_queue *q = NULL;
+			{
+				boost::mutex::scoped_lock lock(m_mutex);
+				while (NULL == m_head && m_run)
+				{
+					m_cond.wait(lock);
+				}
+				if (NULL == m_head)
+				{
+					break;
+				}
+
+				q = m_head;
+				m_head = q->m_next;
+				if (NULL == m_head)
+				{
+					m_tail = NULL;
+				}
+				else
+				{
+					//ϻоУһ߳
+					m_cond.notify_one();
+				}
+			}
+
+			//δִĶŵβ֤ʵ幫ƽ
+			if (q->run(SERIAL_QUEUE_BATCH))
+			{
+				schedule(q);
+			}
+		}
+	}
+}
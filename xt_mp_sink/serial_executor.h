@@ -0,0 +1,115 @@
+#ifndef SERIAL_EXECUTOR_H
+#define SERIAL_EXECUTOR_H
+
+#include <stdint.h>
+#include <vector>
+#include <boost/atomic.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/noncopyable.hpp>
+#include "xt_mp_sink_def.h"
+
+//жеޣͶʧ
+#ifndef SERIAL_QUEUE_MAX_SIZE
+#define SERIAL_QUEUE_MAX_SIZE		4096
+#endif
+//߳һִͬһе֮ó
+#ifndef SERIAL_QUEUE_BATCH
+#define SERIAL_QUEUE_BATCH			32
+#endif
+
+namespace xt_mp_sink
+{
+	typedef void (*serial_task_fn)(void *ctx, void *arg);
+
+	class serial_executor;
+
+	//ʵ崮ж
+	//1ͬһеͶ˳ڹ̶̼߳ϴִУڲҪʵ
+	//2Ϊָ+ڶĻλУͶݲڴ
+	//3ɿձǿʱִһι̣߳Ͷֻ
+	class serial_queue : private boost::noncopyable
+	{
+	public:
+		serial_queue();
+		~serial_queue();
+
+		//ִģͶǰãͬʱͳ
+		void bind(serial_executor *executor, void *ctx);
+
+		//δִfalse
+		bool post(serial_task_fn fn, void *arg = NULL);
+
+		//ȴͶݵִҶ˳ȣرʵǰ
+		void wait_idle();
+
+		void report(sched_report &report) const;
+
+	private:
+		friend class serial_executor;
+
+		struct task
+		{
+			serial_task_fn fn;
+			void *arg;
+			int64_t post_us;
+		};
+
+		//ִbudget񣬷trueʾҪµ
+		bool run(uint32_t budget);
+		void grow();
+
+		serial_executor *m_executor;
+		void *m_ctx;
+
+		mutable boost::mutex m_mutex;
+		std::vector<task> m_ring;
+		uint32_t m_head;
+		uint32_t m_size;
+		bool m_scheduled;
+
+		//ִִ
+		serial_queue *m_next;
+
+		//ͳƣm_mutex
+		uint32_t m_max_depth;
+		uint32_t m_last_latency_us;
+		uint32_t m_max_latency_us;
+		uint32_t m_tasks;
+		uint32_t m_rejected;
+	};
+
+	//̶̣߳˳ִиж
+	class serial_executor : private boost::noncopyable
+	{
+	public:
+		explicit serial_executor(uint32_t threads);
+		~serial_executor();
+
+		//Ͷδִе
+		std::size_t pending() const { return m_pending; }
+
+		//ȴȫִ
+		void wait();
+
+		static int64_t now_us();
+
+	private:
+		friend class serial_queue;
+
+		void schedule(serial_queue *q);
+		void worker();
+
+		boost::mutex m_mutex;
+		boost::condition_variable m_cond;
+		serial_queue *m_head;
+		serial_queue *m_tail;
+		bool m_run;
+
+		boost::atomic<std::size_t> m_pending;
+		boost::thread_group m_threads;
+	};
+}
+
+#endif //SERIAL_EXECUTOR_H
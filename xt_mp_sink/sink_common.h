@@ -6,10 +6,13 @@
 #include <boost/filesystem.hpp>
 #include <tghelper/recycle_pool.h>
 #include <tghelper/byte_pool.h>
+#include <tghelper/async_log.h>
 #include <utility/utility.hpp>
 #include <xt_mp_def.h>
 #include <iostream>
 #include <list>
+#include <map>
+#include <string>
 #include <algorithm>
 #include <functional>
 #include <rv_adapter/rv_def.h>
@@ -78,45 +81,56 @@ inline std::string get_cur_time_microsec()
 #endif //#ifdef _WIN32
 #define MAX_LOG_BUF_SIZE 2048
 
-extern int g_log;
-inline void put_log_impl(const char* log_name,const int level,const char *fmt, ...)
+//־ޣֵڸֵDEBUG_LOGڱڱ
+#ifndef SINK_LOG_COMPILE_LEVEL
+#define SINK_LOG_COMPILE_LEVEL LL_NORMAL_INFO
+#endif
+
+//־صֻ첽־̨߳еãļֱִ־ſ
+inline void put_log_sink(const char* log_name,int level,const char *time,const char *text)
 {
-    if (level <= g_log)
+    static std::map<std::string, FILE*> s_files;
+    if (NULL == text)
     {
-        if (NULL == log_name)
+        for (std::map<std::string, FILE*>::iterator it = s_files.begin(); it != s_files.end(); ++it)
         {
-            return;
+            ::fclose(it->second);
         }
+        s_files.clear();
+        return;
+    }
 
-        va_list args;
-        va_start(args, fmt);
-        char log_buf[MAX_LOG_BUF_SIZE]={0};
-#ifdef _WIN32
-        ::vsnprintf_s(log_buf, MAX_LOG_BUF_SIZE,MAX_LOG_BUF_SIZE,fmt, args);
-#else
-        ::vsnprintf(log_buf, MAX_LOG_BUF_SIZE,fmt, args);
-#endif //#ifdef _WIN32
-        va_end(args);
-
-        log_buf[MAX_LOG_BUF_SIZE - 1] = 0;
-        std::string strlog;
-        strlog.append("[");
-        strlog.append(get_cur_time_microsec());
-        strlog.append("]");
-        strlog.append(log_buf);
-
+    FILE *&fp = s_files[log_name];
+    if (NULL == fp)
+    {
         char sfilename[256] = {0};
         sprintf(sfilename, LOG_PATH_NAME"xt_mp_sink_dll_%s.txt",log_name);
-
-        FILE *fp = ::fopen(sfilename,"a");
-        if(NULL != fp)
+        fp = ::fopen(sfilename,"a");
+        if (NULL == fp)
         {
-            ::fprintf(fp,"%s\n",strlog.c_str());
-            ::fclose(fp);
+            s_files.erase(log_name);
+            return;
         }
     }
+    ::fprintf(fp,"[%s]%s\n",time,text);
+}
+
+extern int g_log;
+//ֻ߳ʽдļɺ̨߳
+inline void put_log_impl(const char* log_name,const int level,const char *fmt, ...)
+{
+    if (NULL == log_name)
+    {
+        return;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    tghelper::async_log_vput(put_log_sink, log_name, level, fmt, args);
+    va_end(args);
 }
-#define DEBUG_LOG(log_name,level,fmt,...) put_log_impl(log_name,level,fmt,##__VA_ARGS__)
+//fmtΪַδļֻһαȽ
+#define DEBUG_LOG(log_name,level,fmt,...) do { if ((level) <= SINK_LOG_COMPILE_LEVEL && (level) <= g_log) put_log_impl(log_name,level,"" fmt,##__VA_ARGS__); } while (0)
 
 #define SINK_ERROE "sink_error"
 #define SINK_CALL "sink_call"
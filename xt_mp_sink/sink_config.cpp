@@ -257,6 +257,91 @@ int sink_config::check_sum(int val_default)
 	return ::atoi(val);	 
 }
 
+int sink_config::jitter_min_delay(int val_default)
+{
+	xtXmlNodePtr node = m_config.getNode(get_cfg(),"jitter_min_delay");
+	if (node.IsNull())
+	{
+		return val_default;
+	}
+
+	const char *val = m_config.getValue(node);
+	if (NULL == val)
+	{
+		return val_default;
+	}
+
+	return ::atoi(val);	 
+}
+
+int sink_config::jitter_max_delay(int val_default)
+{
+	xtXmlNodePtr node = m_config.getNode(get_cfg(),"jitter_max_delay");
+	if (node.IsNull())
+	{
+		return val_default;
+	}
+
+	const char *val = m_config.getValue(node);
+	if (NULL == val)
+	{
+		return val_default;
+	}
+
+	return ::atoi(val);	 
+}
+
+int sink_config::jitter_factor(int val_default)
+{
+	xtXmlNodePtr node = m_config.getNode(get_cfg(),"jitter_factor");
+	if (node.IsNull())
+	{
+		return val_default;
+	}
+
+	const char *val = m_config.getValue(node);
+	if (NULL == val)
+	{
+		return val_default;
+	}
+
+	return ::atoi(val);	 
+}
+
+int sink_config::jitter_clock(int val_default)
+{
+	xtXmlNodePtr node = m_config.getNode(get_cfg(),"jitter_clock");
+	if (node.IsNull())
+	{
+		return val_default;
+	}
+
+	const char *val = m_config.getValue(node);
+	if (NULL == val)
+	{
+		return val_default;
+	}
+
+	return ::atoi(val);	 
+}
+
+int sink_config::jitter_drop_incomplete(int val_default)
+{
+	xtXmlNodePtr node = m_config.getNode(get_cfg(),"jitter_drop_incomplete");
+	if (node.IsNull())
+	{
+		return val_default;
+	}
+
+	const char *val = m_config.getValue(node);
+	if (NULL == val)
+	{
+		return val_default;
+	}
+
+	return ::atoi(val);	 
+}
+
 int sink_config::rtp_heart(int val_default)
 {
 	xtXmlNodePtr node = m_config.getNode(get_cfg(),"rtp_heart");
@@ -274,3 +359,19 @@ int sink_config::rtp_heart(int val_default)
 	return ::atoi(val);	 
 }
 
+int sink_config::multiplex_shards(int val_default)
+{
+	xtXmlNodePtr node = m_config.getNode(get_cfg(),"multiplex_shards");
+	if (node.IsNull())
+	{
+		return val_default;
+	}
+
+	const char *val = m_config.getValue(node);
+	if (NULL == val)
+	{
+		return val_default;
+	}
+
+	return ::atoi(val);	 
+}
@@ -43,6 +43,12 @@ public:
 	int check_sum(int val_default);
 	int lost(int val_default);
 	int rtp_heart(int val_default);
+	int jitter_min_delay(int val_default);
+	int jitter_max_delay(int val_default);
+	int jitter_factor(int val_default);
+	int jitter_clock(int val_default);
+	int jitter_drop_incomplete(int val_default);
+	int multiplex_shards(int val_default);
 
 private:
 	// xml
@@ -9,11 +9,11 @@ namespace xt_mp_sink
 		
 		//׼̳߳
 		//sink_des->sink_thread_num = 16;
-		//õsinkʵ߳
-		_tp = new boost::threadpool::pool(sink_des->sink_thread_num);
+		//ʵжŶӣ̰߳˳ִ
+		_tp = new serial_executor(sink_des->sink_thread_num);
 		printf("\nxt_mp_sink threadnums:%d\n",sink_des->sink_thread_num);
 		//˽̳߳
-		_post_tp = new boost::threadpool::pool(sink_des->post_thread_num);
+		_post_tp = new serial_executor(sink_des->post_thread_num);
 
 		//rv_adapterֻһֻ̣߳ɶ¼֪ͨ
 		rv_adapter_descriptor des;
@@ -25,14 +25,14 @@ namespace xt_mp_sink
 			//sink_inst::_instance = null;
 		}
 
-		//̳߳ص
-		boost::threadpool::pool * tp_inst()
+		//ʵ崮жִհ֡rtp
+		serial_executor * tp_inst()
 		{
 			boost::unique_lock<boost::shared_mutex> lock(_mutex);
 			return _tp;
 		}		
-		//Ͷ̵߳
-		boost::threadpool::pool * post_tp_inst()
+		//֡صִ
+		serial_executor * post_tp_inst()
 		{
 			boost::unique_lock<boost::shared_mutex> lock(_mutex);
 			return _post_tp;
@@ -54,6 +54,7 @@ namespace xt_mp_sink
 	protected:
 		sink_inst()
 			: _tp(null)
+			,_post_tp(null)
 			,m_run(true)
 			,m_theart(mp_task_heart)
 		{}
@@ -65,8 +66,8 @@ namespace xt_mp_sink
 			m_theart.join();
 		}
 	public:
-		boost::threadpool::pool *	_tp;
-		boost::threadpool::pool *	_post_tp;
+		serial_executor *	_tp;
+		serial_executor *	_post_tp;
 
 		boost::shared_mutex	_mutex;
 
@@ -0,0 +1,236 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   entity_table_test.cpp
+// sink(entity_table)Ĵ/ѹ
+//
+// 1̷߳add/removeر߳removeͬһֻһõʵ岢
+// 2ص߳ȡľguardסڼУʵδӦ
+// 3ʱΪգÿʵǡһΣͬʱ-fsanitize=address
+// 4add+removeguardĵκʱ
+//
+// ÷entity_table_test [seconds]
+///////////////////////////////////////////////////////////////////////////////////////////
+#include "entity_table.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <boost/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+//ֻʵָ룬õʵֻУֶ
+namespace xt_mp_sink
+{
+	class mp_entity
+	{
+	public:
+		enum { ALIVE = 0x5a5a5a5a, DEAD = 0xdeaddead };
+
+		mp_entity() : magic(ALIVE), handle(NULL) {}
+		~mp_entity() { magic = DEAD; }
+
+		volatile uint32_t magic;
+		mp_handle handle;
+	};
+}
+
+using namespace xt_mp_sink;
+
+namespace
+{
+	const uint32_t OPEN_THREADS = 4;
+	const uint32_t CLOSE_THREADS = 2;
+	const uint32_t CALLBACK_THREADS = 4;
+	const uint32_t RECENT = 512;
+	const uint32_t BENCH_LOOPS = 1000000;
+
+	boost::atomic<mp_handle> g_recent[RECENT];
+	boost::atomic<uint64_t> g_added(0);
+	boost::atomic<uint64_t> g_removed(0);
+	boost::atomic<uint64_t> g_pinned(0);
+	boost::atomic<uint64_t> g_stale(0);
+	boost::atomic<uint32_t> g_errors(0);
+	volatile bool g_stop = false;
+
+	uint32_t next_rand(uint32_t &seed)
+	{
+		seed = seed * 1103515245u + 12345u;
+		return seed >> 8;
+	}
+
+	//removeɹһ
+	void close_entity(mp_handle h)
+	{
+		mp_entity *entity = entity_table::inst()->remove(h);
+		if (NULL == entity)
+		{
+			return;
+		}
+
+		if (entity->magic != mp_entity::ALIVE || entity->handle != h)
+		{
+			++g_errors;
+		}
+		//removeغʧЧ
+		if (entity_table::inst()->is_valid(h) || NULL != entity_table::inst()->get(h))
+		{
+			++g_errors;
+		}
+		++g_removed;
+		delete entity;
+	}
+
+	void open_worker(uint32_t id)
+	{
+		uint32_t seed = id * 2654435761u + 1;
+		std::vector<mp_handle> own;
+		while (!g_stop)
+		{
+			mp_entity *entity = new mp_entity();
+			mp_handle h = entity_table::inst()->add(entity);
+			if (NULL == h)
+			{
+				delete entity;
+				boost::this_thread::yield();
+				continue;
+			}
+			entity->handle = h;
+			++g_added;
+
+			if (entity_table::inst()->get(h) != entity)
+			{
+				++g_errors;
+			}
+
+			g_recent[next_rand(seed) % RECENT].store(h);
+			own.push_back(h);
+
+			//ɾرһر߳̿ȹر
+			if (own.size() > 32)
+			{
+				size_t i = next_rand(seed) % own.size();
+				close_entity(own[i]);
+				own[i] = own.back();
+				own.pop_back();
+			}
+		}
+		for (size_t i = 0; i < own.size(); ++i)
+		{
+			close_entity(own[i]);
+		}
+	}
+
+	void close_worker(uint32_t id)
+	{
+		uint32_t seed = id * 40503u + 7;
+		while (!g_stop)
+		{
+			mp_handle h = g_recent[next_rand(seed) % RECENT].load();
+			if (NULL != h)
+			{
+				close_entity(h);
+			}
+			boost::this_thread::yield();
+		}
+	}
+
+	void callback_worker(uint32_t id)
+	{
+		uint32_t seed = id * 69069u + 3;
+		while (!g_stop)
+		{
+			mp_handle h = g_recent[next_rand(seed) % RECENT].load();
+			if (NULL == h)
+			{
+				continue;
+			}
+
+			entity_table::guard alive(h);
+			if (!alive)
+			{
+				++g_stale;
+				continue;
+			}
+
+			//סڼʵ岻ᱻҲǸͬһۺŵʵ
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				if (alive->magic != mp_entity::ALIVE || alive->handle != h)
+				{
+					++g_errors;
+					break;
+				}
+			}
+			++g_pinned;
+		}
+	}
+
+	int run_stress(int seconds)
+	{
+		for (uint32_t i = 0; i < RECENT; ++i)
+		{
+			g_recent[i].store(NULL);
+		}
+
+		boost::thread_group threads;
+		for (uint32_t i = 0; i < OPEN_THREADS; ++i)
+		{
+			threads.create_thread(boost::bind(open_worker, i));
+		}
+		for (uint32_t i = 0; i < CLOSE_THREADS; ++i)
+		{
+			threads.create_thread(boost::bind(close_worker, i));
+		}
+		for (uint32_t i = 0; i < CALLBACK_THREADS; ++i)
+		{
+			threads.create_thread(boost::bind(callback_worker, i));
+		}
+		boost::this_thread::sleep(boost::posix_time::seconds(seconds));
+		g_stop = true;
+		threads.join_all();
+
+		uint32_t size = entity_table::inst()->size();
+		printf("stress: %llu handles created, %llu closed, %llu callbacks pinned, %llu stale rejected, errors %u, table size %u\n",
+			(unsigned long long)g_added.load(), (unsigned long long)g_removed.load(),
+			(unsigned long long)g_pinned.load(), (unsigned long long)g_stale.load(), g_errors.load(), size);
+		return (0 == g_errors.load() && g_added.load() == g_removed.load() && 0 == size) ? 0 : 1;
+	}
+
+	double elapsed_ns(const boost::posix_time::ptime &begin, uint32_t loops)
+	{
+		boost::posix_time::time_duration d = boost::posix_time::microsec_clock::universal_time() - begin;
+		return (double)d.total_microseconds() * 1000.0 / loops;
+	}
+
+	void run_bench()
+	{
+		mp_entity entity;
+		boost::posix_time::ptime begin = boost::posix_time::microsec_clock::universal_time();
+		for (uint32_t i = 0; i < BENCH_LOOPS; ++i)
+		{
+			entity_table::inst()->remove(entity_table::inst()->add(&entity));
+		}
+		double add_remove_ns = elapsed_ns(begin, BENCH_LOOPS);
+
+		mp_handle h = entity_table::inst()->add(&entity);
+		uint32_t hits = 0;
+		begin = boost::posix_time::microsec_clock::universal_time();
+		for (uint32_t i = 0; i < BENCH_LOOPS; ++i)
+		{
+			entity_table::guard alive(h);
+			hits += alive ? 1 : 0;
+		}
+		double guard_ns = elapsed_ns(begin, BENCH_LOOPS);
+		entity_table::inst()->remove(h);
+
+		printf("bench: add+remove %.1f ns, guard %.1f ns (%u hits)\n", add_remove_ns, guard_ns, hits);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int seconds = (argc > 1) ? atoi(argv[1]) : 5;
+	int ret = run_stress(seconds);
+	run_bench();
+	printf("%s\n", (0 == ret) ? "PASS" : "FAIL");
+	return ret;
+}
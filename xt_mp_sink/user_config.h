@@ -8,6 +8,7 @@
 #define BYTE_POOL_BLOCK_SIZE	2048			//bytepoolݿС
 #define BYTE_POOL_EXPAND_SIZE	5				//bytepoolԶչ
 #define BYTE_POOL_INIT_SIZE		5				//bytepoolʼݿ
+#define MP_RTP_RECV_BATCH		32				//һˮrtp
 #define BYTE_BLOCK_FIFO_SIZE	0
 #define MP_SOURCE_FIFO_MAX_SIZE	0				//mp source fifo󳤶,ѭʹ10*1024*1024
 #define MP_SINK_FIFO_MAX_SIZE	0				//mp sink fifo󳤶,ѭʹ
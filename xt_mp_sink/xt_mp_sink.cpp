@@ -35,15 +35,13 @@ long mp_open( xt_mp_descriptor* mp_des,p_msink_handle handle )
     }
 #endif //#ifdef use_recycle_entity_pool_func__
 
-    handle->h_mp = static_cast<mp_handle>(entity);
+    handle->h_mp = xt_mp_sink::mp_entity::add_entity(entity);
     if (NULL == handle->h_mp)
     {
-        DEBUG_LOG(SINK_ERROE,LL_ERROE,"handle->h_mp = static_cast<mp_handle>(entity) fail!");
+        DEBUG_LOG(SINK_ERROE,LL_ERROE,"handle->h_mp = mp_entity::add_entity(entity) fail! size[%d]",xt_mp_sink::mp_entity::size_entity());
         return -1;
     }
 
-    xt_mp_sink::mp_entity::add_entity(entity);
-
     ret = entity->mp_open(mp_des,handle,0,0,false);
     if (ret == 0)
     {
@@ -75,8 +73,12 @@ long mp_open_mult( xt_mp_descriptor* mp_des, p_msink_handle handle, uint32_t *mu
         return -1;
     }
 #endif //#ifdef use_recycle_entity_pool_func__ 
-    handle->h_mp = entity;
-    xt_mp_sink::mp_entity::add_entity(entity);
+    handle->h_mp = xt_mp_sink::mp_entity::add_entity(entity);
+    if (NULL == handle->h_mp)
+    {
+        DEBUG_LOG(SINK_ERROE,LL_ERROE,"handle->h_mp = mp_entity::add_entity(entity) fail! size[%d]",xt_mp_sink::mp_entity::size_entity());
+        return -1;
+    }
 
     ret = entity->mp_open(mp_des,handle,true,multid,false);
     if (ret == 0)
@@ -119,7 +121,7 @@ bool mp_pump_demux_rtp(
         return false;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(!entity)
     {
         return false;
@@ -150,13 +152,13 @@ bool mp_get_multinfo(p_msink_handle handle, bool *multiplex, uint32_t *multid)
         return false;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(!entity)
     {
         return false;
     }
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_get_multinfo entity valide entity[%p]",entity);
         return false;
@@ -176,7 +178,7 @@ long mp_active( p_msink_handle handle,uint32_t bActive )
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == NULL) return -1;
 #ifdef use_recycle_entity_pool_func__
     if (!xt_mp_sink::mp_entity::check_entity(entity))
@@ -195,7 +197,7 @@ long mp_directoutput(p_msink_handle handle, bool direct)
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
 #ifdef use_recycle_entity_pool_func__
@@ -205,7 +207,7 @@ long mp_directoutput(p_msink_handle handle, bool direct)
     }
 #endif //#ifdef use_recycle_entity_pool_func__
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_directoutput entity valide entity[%p]",entity);
         return -1;
@@ -223,7 +225,7 @@ long mp_close( p_msink_handle handle )
     DEBUG_LOG(SINK_CALL,LL_INFO,"mp_close| handle[%p] handle->h_mp[%p]",handle,handle->h_mp);
 
     int32_t ret = -1;
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1; 
 #ifdef use_recycle_entity_pool_func__
     if (!xt_mp_sink::mp_entity::check_entity(entity))
@@ -235,15 +237,14 @@ long mp_close( p_msink_handle handle )
 
     do 
     {
-        boost::recursive_mutex::scoped_lock lock2(xt_mp_sink::mp_entity::m_mEntityClose);
-        if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
+        //Ͼȴ;ص˳֮صУʧ
+        if (entity != xt_mp_sink::mp_entity::del_entity(handle->h_mp))
         {
             DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_close| mp_entity::is_valid fail! handle[%p] handle->h_mp[%p]",handle,handle->h_mp);
             return -1;
         }
         else
         {
-            xt_mp_sink::mp_entity::del_entity(handle->h_mp);
             DEBUG_LOG(SINK_CALL,LL_INFO,"mp_close| mp_entity::del_entity handle[%p] handle->h_mp[%p]",handle,handle->h_mp);
         }
 //         ret = entity->mp_close(true);
@@ -302,7 +303,7 @@ long mp_read_out_data( p_msink_handle handle,uint8_t * pDst,uint32_t size,block_
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null)
     {
         return -1;
@@ -323,7 +324,7 @@ long mp_read_out_data2( p_msink_handle handle,uint8_t * pDst,uint32_t size,block
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null)
     {
         DEBUG_LOG("sink_frame",LL_ERROE,"mp_read_out_data2 fail handle:%p", handle);
@@ -350,7 +351,7 @@ long mp_pump_out_rtp( p_msink_handle handle,void **p_rtp_block)
 		return -1;
 	}
 
-	xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+	xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
 	if(entity == null)
 	{
 		return -1;
@@ -372,7 +373,7 @@ long mp_read_out_rtp( p_msink_handle handle,uint8_t *pDst,uint32_t size,rv_rtp_p
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null)
     {
         return -1;
@@ -387,6 +388,63 @@ long mp_read_out_rtp( p_msink_handle handle,uint8_t *pDst,uint32_t size,rv_rtp_p
     return nRet;
 }
 
+long mp_set_jitter(p_msink_handle handle,const jitter_config *cfg)
+{
+    if (!handle || !cfg)
+    {
+        return -1;
+    }
+
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
+    if(entity == null) return -1;
+
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
+    {
+        DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_set_jitter entity valide entity[%p]",entity);
+        return -1;
+    }
+
+    return entity->mp_set_jitter(*cfg);
+}
+
+long mp_query_jitter(p_msink_handle handle,jitter_report *report)
+{
+    if (!handle || !report)
+    {
+        return -1;
+    }
+
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
+    if(entity == null) return -1;
+
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
+    {
+        DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_query_jitter entity valide entity[%p]",entity);
+        return -1;
+    }
+
+    return entity->mp_query_jitter(*report);
+}
+
+long mp_query_sched(p_msink_handle handle,sched_report *data,sched_report *post)
+{
+    if (!handle)
+    {
+        return -1;
+    }
+
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
+    if(entity == null) return -1;
+
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
+    {
+        DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_query_sched entity valide entity[%p]",entity);
+        return -1;
+    }
+
+    return entity->mp_query_sched(data, post);
+}
+
 long mp_query_rcv_rtcp( p_msink_handle handle,rtcp_receive_report * rtcp )
 {
     if (!handle || !rtcp)
@@ -394,10 +452,10 @@ long mp_query_rcv_rtcp( p_msink_handle handle,rtcp_receive_report * rtcp )
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_query_rcv_rtcp entity valide entity[%p]",entity);
         return -1;
@@ -413,10 +471,10 @@ long mp_query_snd_rtcp( p_msink_handle handle,rtcp_send_report * rtcp )
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_query_snd_rtcp entity valide entity[%p]",entity);
         return -1;
@@ -437,10 +495,10 @@ long mp_add_rtp_remote_address( p_msink_handle handle,mp_address_descriptor * ad
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_add_rtp_remote_address entity valide entity[%p]",entity);
         return -1;
@@ -463,10 +521,10 @@ long mp_add_mult_rtp_remote_address( p_msink_handle handle,mp_address_descriptor
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_add_mult_rtp_remote_address entity valide entity[%p]",entity);
         return -1;
@@ -489,10 +547,10 @@ long mp_del_rtp_remote_address( p_msink_handle handle,mp_address_descriptor * ad
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_del_rtp_remote_address entity valide entity[%p]",entity);
         return -1;
@@ -516,10 +574,10 @@ long mp_clear_rtp_remote_address( p_msink_handle handle )
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_clear_rtp_remote_address entity valide entity[%p]",entity);
         return -1;
@@ -544,10 +602,10 @@ long mp_add_rtcp_remote_address( p_msink_handle handle,mp_address_descriptor * a
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_add_rtcp_remote_address entity valide entity[%p]",entity);
         return -1;
@@ -571,10 +629,10 @@ long mp_del_rtcp_remote_address( p_msink_handle handle,mp_address_descriptor * a
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_del_rtcp_remote_address entity valide entity[%p]",entity);
         return -1;
@@ -596,9 +654,9 @@ long mp_add_mult_rtcp_remote_address( p_msink_handle handle,mp_address_descripto
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_add_mult_rtcp_remote_address entity valid entity[%p]",entity);
         return -1;
@@ -621,10 +679,10 @@ long mp_clear_rtcp_remote_address( p_msink_handle handle,mp_address_descriptor *
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_clear_rtcp_remote_address entity valide entity[%p]",entity);
         return -1;
@@ -640,10 +698,10 @@ long mp_manual_send_rtcp_sr( p_msink_handle handle,uint32_t pack_size,uint32_t p
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_manual_send_rtcp_sr entity valide entity[%p]",entity);
         return -1;
@@ -659,10 +717,10 @@ long mp_manual_send_rtcp_rr( p_msink_handle handle,uint32_t ssrc,uint32_t local_
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_manual_send_rtcp_rr entity valide entity[%p]",entity);
         return -1;
@@ -688,7 +746,7 @@ long mp_rtcp_send_dar(p_msink_handle handle, uint32_t rate, uint32_t level)
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
     if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
@@ -711,10 +769,10 @@ long mp_rtcp_send_fir(p_msink_handle handle)
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_rtcp_send_fir entity valide entity[%p]",entity);
         return -1;
@@ -730,10 +788,10 @@ long mp_get_xtsr(p_msink_handle handle, int &nDeviceType, int &nLinkRet, int &nF
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_get_xtsr entity valide entity[%p]",entity);
         return -1;
@@ -760,10 +818,10 @@ int mp_RegistSendReportEvent(p_msink_handle handle, FPSendReportOutput fpSendRep
         return -1;
     }
 
-    xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(handle->h_mp);
+    xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(handle->h_mp);
     if(entity == null) return -1;
 
-    if (!xt_mp_sink::mp_entity::is_valid(entity))
+    if (!xt_mp_sink::mp_entity::is_valid(handle->h_mp))
     {
         DEBUG_LOG(SINK_ERROE,LL_ERROE,"mp_RegistSendReportEvent entity valide entity[%p]",entity);
         return -1;
@@ -774,7 +832,7 @@ int mp_RegistSendReportEvent(p_msink_handle handle, FPSendReportOutput fpSendRep
 
 rv_rtp mp_query_rtp_handle(p_msink_handle h)
 {
-	xt_mp_sink::mp_entity * entity = static_cast<xt_mp_sink::mp_entity *>(h->h_mp);
+	xt_mp_sink::mp_entity * entity = xt_mp_sink::mp_entity::get_entity(h->h_mp);
 	if(!entity)
 	{
 		return NULL;
@@ -62,9 +62,16 @@ extern "C" {
 	MPSINK_API long mp_read_out_data( p_msink_handle handle,uint8_t * pDst,uint32_t size,block_params * param );
 	MPSINK_API long mp_read_out_data2( p_msink_handle handle,uint8_t * pDst,uint32_t size,block_params * param , XTFrameInfo &frame);
 
-	//ȡrtp
+	//ȡrtpݣ0֡ڰ 1֡ 2嵽Ĳ֡
 	MPSINK_API long mp_read_out_rtp(p_msink_handle handle,uint8_t *pDst,uint32_t size,rv_rtp_param *param);
 	MPSINK_API long mp_pump_out_rtp(p_msink_handle handle,void **p_rtp_block);
+
+	///ѯ壬Ĭϲȡļ
+	MPSINK_API long mp_set_jitter(p_msink_handle handle,const jitter_config *cfg);
+	MPSINK_API long mp_query_jitter(p_msink_handle handle,jitter_report *report);
+
+	//ѯʵ崮жͳƣdataΪհ֡УpostΪ֡صУΪNULL
+	MPSINK_API long mp_query_sched(p_msink_handle handle,sched_report *data,sched_report *post);
 	//ֶһηͶrtcp
 	MPSINK_API long mp_manual_send_rtcp_sr(p_msink_handle handle,uint32_t pack_size,uint32_t pack_ts);
 
@@ -105,6 +112,7 @@ extern "C" {
 	//ѯSR
 	MPSINK_API long mp_get_xtsr(p_msink_handle handle, int &nDeviceType, int &nLinkRet, int &nFrameType,XTSSendReport *rtcp);
 	//öش
+	//resend: 0ش 1sn 3 snб 4 RFC 4585 PID+BLPλͼ
 	MPSINK_API int mp_set_resend(int resend,int wait_resend, int max_resend, int vga_order);
 	MPSINK_API int mp_RegistSendReportEvent(p_msink_handle handle, FPSendReportOutput fpSendReportOutput, void *objUserContext);
 
@@ -109,6 +109,37 @@ extern "C" {
 		unsigned int datatype;
 	}XTFrameInfo;
 
+	//(׼Ǹrtp)
+	typedef struct _jitter_config
+	{
+		uint32_t	min_delay_ms;		//Ŀ겥ʱ
+		uint32_t	max_delay_ms;		//Ŀ겥ʱ
+		uint32_t	jitter_factor;		//ĿʱΪıԽԽƫԽСԽƫʱ
+		uint32_t	clock_rate;			//RTPʱʱƵ
+		xt_bool		drop_incomplete;	//1 Բ֡ 0 
+	}jitter_config;
+
+	typedef struct _jitter_report
+	{
+		uint32_t	jitter_ms;			//RFC 3550
+		uint32_t	target_delay_ms;	//ǰĿ겥ʱ
+		uint32_t	buffered_packets;	//
+		uint32_t	late;				//ŵİ
+		uint32_t	discarded;			//Ĳ֡
+		uint32_t	concealed;			//֡
+	}jitter_report;
+
+	//ʵ崮жͳƣmp_openۼ
+	typedef struct _sched_report
+	{
+		uint32_t	depth;				//ǰŶ
+		uint32_t	max_depth;			//Ŷ
+		uint32_t	last_latency_us;	//һͶݵʼִеʱ
+		uint32_t	max_latency_us;		//Ͷݵʼִеʱ
+		uint32_t	tasks;				//ִ
+		uint32_t	rejected;			//Ͷʧ
+	}sched_report;
+
 #ifdef __cplusplus
 }
 #endif
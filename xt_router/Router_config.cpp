@@ -126,6 +126,16 @@ unsigned int config::rtsp_srv_time_out_interval(unsigned int val_default)
     return get_router_sub_node_value("rtsp_srv_time_out_interval",val_default);
 }
 
+uint32_t config::cmd_pipeline_shards(uint32_t val_default)
+{
+    return get_router_sub_node_value("cmd_pipeline_shards",val_default);
+}
+
+uint32_t config::cmd_start_deadline(uint32_t val_default)
+{
+    return get_router_sub_node_value("cmd_start_deadline",val_default);
+}
+
 int config::break_monitor_onoff(int val_default)
 {
     xtXmlNodePtr node = m_config.getNode(get_router(),"break_monitor");
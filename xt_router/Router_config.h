@@ -62,6 +62,12 @@ public:
 	unsigned int rtsp_srv_check_timer_interval(unsigned int val_default);
 	unsigned int rtsp_srv_time_out_interval(unsigned int val_default);
 
+    //ָƬ߳
+    uint32_t cmd_pipeline_shards(uint32_t val_default);
+
+    //㲥ָŶӳʱ()
+    uint32_t cmd_start_deadline(uint32_t val_default);
+
     //base cfg
     //߼⿪ĬϿ
     int break_monitor_onoff(int val_default);
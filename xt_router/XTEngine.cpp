@@ -11,6 +11,7 @@
 #include "XTRouterLog.h"
 #include "break_monitor.h"
 #include "pri_jk_engine.h"
+#include "../tghelper/crc32.h"
 
 #define SDP_TEMPLATE "v=0\no=- 1430622498429749 1 IN IP4 0.0.0.0\ns=PLAY stream from IPNC\nb=AS:12000\nt=0 0\na=tool:XTRouter Media v2015.05.20\na=rtcp-fb:* ccm fir\n"
 
@@ -26,6 +27,7 @@ XTEngine::XTEngine(void)
 :m_nCopy(-1)
 ,m_strmids(0)
 ,m_srcs(0)
+,m_src_states(0)
 {
 }
 
@@ -287,18 +289,22 @@ void XTEngine::post_one_frame(int strmid,
 {
 	rtp_block *rtp2 = (rtp_block *)(data);
 
-	std::vector<src_info> srcs;
-    _()->get_src_strmid(strmid, srcs);//for loop 512x(512+1)/2=13w 
-    for(std::vector<src_info>::iterator itr = srcs.begin();srcs.end() != itr; ++itr)
+    src_fanout_ptr fanout = _()->get_src_fanout();
+    if (!fanout || strmid < 0 || strmid >= (long)fanout->strms.size())
+    {
+        rtp2->release();
+        return;
+    }
+    const src_fanout_table::items_t &items = fanout->strms[strmid];
+    for(src_fanout_table::items_t::const_iterator itr = items.begin();items.end() != itr; ++itr)
     {
-        if (itr->srcno<0 || !itr->active ) continue;
         _()->upate_frame_state(itr->srcno);
 
 		//˽㲥˽ʱ пܹƵ תԴֻƵ
-		if (DEV_SIP == itr->device.db_type && CODEC_VIDEO == itr->device.dev_strmtype && MEDIA_TYPE_VIDEO == media_type) continue;
+		if (DEV_SIP == itr->db_type && CODEC_VIDEO == itr->dev_strmtype && MEDIA_TYPE_VIDEO == media_type) continue;
 
 		if (KEY_FRAME_TYPE==frame_type && len < MAX_KEY_SIZE)(void)_()->update_sdp(itr->srcno,(char*)data,len,data_type);
-        int trackid = _()->get_trackid(itr->srcno,media_type);
+        int trackid = itr->trackids[media_type + 1];
 		long ret_code = media_server::send_rtp_stamp(itr->srcno, trackid, (char*)rtp2, 0, frame_type, data_type, 0,false,0);
         if (ret_code < 0)
 		{
@@ -349,19 +355,23 @@ long XTEngine::data_out_cb(long handle,unsigned char* data,long len, long frame_
 		rtp2->assign();
 		m_tp->schedule( boost::bind(post_one_frame, strmid,frame_type,media_type,data_type,rtp2,len));
         */
-		std::vector<src_info> srcs;
-        _()->get_src_strmid(strmid, srcs);//for loop 512x(512+1)/2=13w 
-        for(std::vector<src_info>::iterator itr = srcs.begin();srcs.end() != itr; ++itr)
+        //ֻգĸתԴڴ
+        src_fanout_ptr fanout = _()->get_src_fanout();
+        if (!fanout || strmid < 0 || strmid >= (long)fanout->strms.size())
+        {
+            break;
+        }
+        const src_fanout_table::items_t &items = fanout->strms[strmid];
+        for(src_fanout_table::items_t::const_iterator itr = items.begin();items.end() != itr; ++itr)
         {
-            if (itr->srcno<0 || !itr->active ) continue;
             _()->upate_frame_state(itr->srcno);
 
             //˽㲥˽ʱ пܹƵ תԴֻƵ
-            if (DEV_SIP == itr->device.db_type && CODEC_VIDEO == itr->device.dev_strmtype && MEDIA_TYPE_VIDEO == media_type) continue;
+            if (DEV_SIP == itr->db_type && CODEC_VIDEO == itr->dev_strmtype && MEDIA_TYPE_VIDEO == media_type) continue;
 
             if (KEY_FRAME_TYPE==frame_type && len < MAX_KEY_SIZE)(void)_()->update_sdp(itr->srcno,(char*)data,len,data_type);
 
-            int trackid = _()->get_trackid(itr->srcno,media_type);
+            int trackid = itr->trackids[media_type + 1];
 			ret_code = media_server::send_rtp_stamp(itr->srcno, trackid, (char*)data, len, frame_type, data_type, time_stamp,false,0);
             if (ret_code < 0)
 			{
@@ -658,6 +668,8 @@ int XTEngine::start_play(const std::string& on_db_sn,const std::string& dev_ids,
     int iRet = -1;
     int srcno = -1;
     device_info device;
+    //εĲɼʧʱֻͷűνԴ
+    bool own_capture = false;
     do
     {
         if (is_exist_src(dev_ids, dev_chanid, dev_strmtype) != -1)
@@ -667,6 +679,10 @@ int XTEngine::start_play(const std::string& on_db_sn,const std::string& dev_ids,
             break;
         }
 
+        //豸¼ܳ룬¼ڼ䲻ȫ豸ĵ㲥ͣɲִ
+        //ͬһ豸ָrouter_cmd_pipelineУڴڼظ㲥ͬһ·
+        lock.unlock();
+
         //CCS ĿƵ㲥ʽ
         if (!CXTRouter::_()->use_ccs())
         {
@@ -702,6 +718,24 @@ int XTEngine::start_play(const std::string& on_db_sn,const std::string& dev_ids,
         {
             iRet = start_capture(device, regist_client.ids, dev_chanid, dev_strmtype, db_type, "0.0.0.0",regist_client.ip, db_chanid,regist_client.port, login_name, login_password, link_type);
         }
+        own_capture = (iRet >= 0);
+        lock.lock();
+
+        //¼ڼѽͬһ·ת
+        int exist_srcno = is_exist_src(dev_ids, dev_chanid, dev_strmtype);
+        if (exist_srcno != -1)
+        {
+            //Է뱾θͬһ豸(ѽĽ)ʱͣԷʹõĲɼ
+            src_info exist_src;
+            if (own_capture && get_src_no(exist_srcno, exist_src) == 0 && exist_src.device.dev_handle == device.dev_handle)
+            {
+                own_capture = false;
+            }
+            WRITE_LOG(DBLOGINFO,ll_info,"existed play after capture response center play fail|:dev_ids[%s]dev_chanid[%d]dev_strmtype[%d] own_capture[%d]", dev_ids.c_str(),dev_chanid,dev_strmtype,own_capture);
+            iRet = -1;
+            break;
+        }
+
 		//ģDRVģʽ
 		if (m_nCopy > 1)
 		{
@@ -735,9 +769,10 @@ int XTEngine::start_play(const std::string& on_db_sn,const std::string& dev_ids,
     } while (0);
 
     //ĵ㲥ʧͣشתĵBug
+    //ֻͷűεýĲɼתԴδߵɼɼʧʱdeviceΪ
     if (iRet < 0)
     {
-        if (!media_device::_()->is_md_handle(device.dev_handle))
+        if (own_capture && !media_device::_()->is_md_handle(device.dev_handle))
         {
             (void)stop_capture(device);
         }
@@ -1108,40 +1143,27 @@ int XTEngine::parse_tracks(const char* sdp,const int sdp_len,track_ctx_t* track_
         return -1;
     }
     int track_num = 0;
-    xt_sdp::parse_buffer_t pb(sdp, sdp_len);
-    xt_sdp::sdp_session_t xsdp;
-    try
-    {
-        xsdp.parse(pb);
-    }
-    catch(...)
+    xt_sdp::sdp_view_t xsdp;
+    if (!xsdp.parse(sdp, sdp_len))
     {
         return -2;
     }
 
-    std::map<std::string, std::list<std::string> >::iterator itr_ctrl;
-    int ctrl_id=-1;
     bool is_exists_ctrl = false;
-    xt_sdp::sdp_session_t::medium_container_t::iterator itr = xsdp.media_.begin();
-    for(track_num=0; xsdp.media_.end() != itr;++track_num,++itr)
+    const xt_sdp::sdp_medium_ref_t *itr = xsdp.media();
+    for(track_num=0; NULL != itr;++track_num,itr = itr->next())
     {
-        if (itr->attribute_helper_.exists("control"))
+        const xt_sdp::sdp_attr_ref_t *ctrl = itr->find_attribute("control");
+        if (NULL != ctrl)
         {
-            itr_ctrl = itr->attribute_helper_.attributes_.find("control");
-            if (itr->attribute_helper_.attributes_.end() != itr_ctrl)
+            int trackid = find_trackid(ctrl->value.data(), ctrl->value.size());
+            if (-1 != trackid)
             {
-                if (!itr_ctrl->second.empty())
-                {
-                    int trackid = find_trackid(itr_ctrl->second.front());
-                    if (-1 != trackid)
-                    {
-                        track_info->trackId = trackid;
-                        is_exists_ctrl = true;
-                    }
-                }
+                track_info->trackId = trackid;
+                is_exists_ctrl = true;
             }
         }
-        if ( 0 == itr->name_.compare("video"))
+        if (itr->name() == "video")
         {
             if (!is_exists_ctrl)
             {
@@ -1150,7 +1172,7 @@ int XTEngine::parse_tracks(const char* sdp,const int sdp_len,track_ctx_t* track_
             track_info->trackType = 0; 
             ::strncpy(track_info->trackname,"video",MAX_TRACKNAME_LEN);
         }
-        else if ( 0 == itr->name_.compare("audio"))
+        else if (itr->name() == "audio")
         {
             if (!is_exists_ctrl)
             {
@@ -1164,7 +1186,7 @@ int XTEngine::parse_tracks(const char* sdp,const int sdp_len,track_ctx_t* track_
         {
             track_info->trackId = -1;
             track_info->trackType = -1;
-            ::strncpy(track_info->trackname,itr->name_.c_str(),MAX_TRACKNAME_LEN);
+            itr->name().copy(track_info->trackname,MAX_TRACKNAME_LEN);
         }
 
         ++track_info;
@@ -1213,41 +1235,28 @@ void XTEngine::del_m_of_sdp(const char* in_sdp,const int in_sdp_len,const std::s
 int XTEngine::parse_tracks_ex(const char* sdp,const int sdp_len,std::vector<track_ctx_t>& track_infos)
 {
     track_infos.clear();
-    xt_sdp::parse_buffer_t pb(sdp, sdp_len);
-    xt_sdp::sdp_session_t xsdp;
-    try
-    {
-        xsdp.parse(pb);
-    }
-    catch(...)
+    xt_sdp::sdp_view_t xsdp;
+    if (!xsdp.parse(sdp, sdp_len))
     {
         return -1;
     }
 
-    std::map<std::string, std::list<std::string> >::iterator itr_ctrl;
-    int ctrl_id=-1;
     bool is_exists_ctrl = false;
     track_ctx_t track_info;
-    xt_sdp::sdp_session_t::medium_container_t::iterator itr = xsdp.media_.begin();
-    for(; xsdp.media_.end() != itr;++itr)
+    const xt_sdp::sdp_medium_ref_t *itr = xsdp.media();
+    for(; NULL != itr;itr = itr->next())
     {
-        if (itr->attribute_helper_.exists("control"))
+        const xt_sdp::sdp_attr_ref_t *ctrl = itr->find_attribute("control");
+        if (NULL != ctrl)
         {
-            itr_ctrl = itr->attribute_helper_.attributes_.find("control");
-            if (itr->attribute_helper_.attributes_.end() != itr_ctrl)
+            int trackid = find_trackid(ctrl->value.data(), ctrl->value.size());
+            if (-1 != trackid)
             {
-                if (!itr_ctrl->second.empty())
-                {
-                    int trackid = find_trackid(itr_ctrl->second.front());
-                    if (-1 != trackid)
-                    {
-                        track_info.trackId = trackid;
-                        is_exists_ctrl = true;
-                    }
-                }
+                track_info.trackId = trackid;
+                is_exists_ctrl = true;
             }
         }
-        if ( 0 == itr->name_.compare("video"))
+        if (itr->name() == "video")
         {
             if (!is_exists_ctrl)
             {
@@ -1256,7 +1265,7 @@ int XTEngine::parse_tracks_ex(const char* sdp,const int sdp_len,std::vector<trac
             track_info.trackType = 0; 
             ::strncpy(track_info.trackname,"video",MAX_TRACKNAME_LEN);
         }
-        else if ( 0 == itr->name_.compare("audio"))
+        else if (itr->name() == "audio")
         {
             if (!is_exists_ctrl)
             {
@@ -1270,7 +1279,7 @@ int XTEngine::parse_tracks_ex(const char* sdp,const int sdp_len,std::vector<trac
         {
             track_info.trackId = -1;
             track_info.trackType = -1;
-            ::strncpy(track_info.trackname,itr->name_.c_str(),MAX_TRACKNAME_LEN);
+            itr->name().copy(track_info.trackname,MAX_TRACKNAME_LEN);
         }
 
         track_infos.push_back(track_info);
@@ -1581,6 +1590,7 @@ int XTEngine::init_src(int num)
     if (!m_srcs)
     {
         m_srcs = new src_info[num];
+        m_src_states = new src_frame_state[num];
         DEBUG_LOG(NULL,ll_info,"XTEngine::init_src m_srcs[%p] num[%d]\n",m_srcs,num);
     }
 
@@ -1589,6 +1599,8 @@ int XTEngine::init_src(int num)
         return -1;
     }
 
+    rebuild_src_fanout();
+
     return 0;
 }
 int XTEngine::uninit_src()
@@ -1601,6 +1613,14 @@ int XTEngine::uninit_src()
         m_srcs = NULL;
     }
 
+    if (m_src_states)
+    {
+        delete[] m_src_states;
+        m_src_states = NULL;
+    }
+
+    boost::atomic_store(&m_src_fanout, src_fanout_ptr());
+
     return 0;
 }
 int XTEngine::upate_src(const int srcno,const src_info& new_src)
@@ -1611,6 +1631,7 @@ int XTEngine::upate_src(const int srcno,const src_info& new_src)
         return -1;
     }
     m_srcs[srcno] = new_src;
+    rebuild_src_fanout();
 
     return 0;
 }
@@ -1623,6 +1644,7 @@ int XTEngine::upate_src(const src_info &new_src_info)
         return -1;
     }
     m_srcs[new_src_info.srcno] = new_src_info;
+    rebuild_src_fanout();
     return 0;
 }
 
@@ -1634,6 +1656,7 @@ int XTEngine::update_strmid_of_src(const int srcno,const long strmid)
         return -1;
     }
     m_srcs[srcno].device.strmid = strmid;
+    rebuild_src_fanout();
     return 0;
 }
 int XTEngine::update_dev_handle_of_src(const int srcno,dev_handle_t handle)
@@ -1690,6 +1713,8 @@ int XTEngine::active_src(int srcno, const src_info &info,const bool active_state
 
     m_srcs[srcno] = info;
     m_srcs[srcno].active = active_state;
+    reset_frame_state(srcno);
+    rebuild_src_fanout();
 
     return 0;
 }
@@ -1723,6 +1748,7 @@ int XTEngine::get_src_ids(const std::string& dev_ids, long dev_chanid, long dev_
             m_srcs[u].device.dev_strmtype == dev_strmtype)
         {
             info = m_srcs[u];
+            load_frame_state(info);
             return info.srcno;
         }
     }
@@ -1739,6 +1765,7 @@ int XTEngine::get_src_no(int srcno,src_info &info)
     }
 
     info = m_srcs[srcno];
+    load_frame_state(info);
 
     return 0;
 }
@@ -1764,6 +1791,7 @@ int XTEngine::get_src_ids2(const std::string& dev_ids,std::vector<src_info> &src
         if (m_srcs[u].device.dev_ids == dev_ids)
         {
             srcs.push_back(m_srcs[u]);
+            load_frame_state(srcs.back());
         }
     }
 
@@ -1778,6 +1806,7 @@ int XTEngine::get_src_strmid(long strmid,std::vector<src_info> &srcs)
         if (m_srcs[u].device.strmid == strmid && m_srcs[u].active)
         {
             srcs.push_back(m_srcs[u]);
+            load_frame_state(srcs.back());
         }
     }
 
@@ -1792,6 +1821,7 @@ int XTEngine::get_src_url(const std::string &db_url,std::vector<src_info> &srcs)
         if (m_srcs[u].device.db_url == db_url)
         {
             srcs.push_back(m_srcs[u]);
+            load_frame_state(srcs.back());
         }
     }
 
@@ -1816,6 +1846,7 @@ int XTEngine::get_src_all(std::vector<src_info> &srcs)
         if (m_srcs[u].active)
         {
             srcs.push_back(m_srcs[u]);
+            load_frame_state(srcs.back());
         }
     }
 
@@ -1831,6 +1862,8 @@ int XTEngine::free_src(int srcno)
             //modify  by songlei 20150626
             m_srcs[u].reset();
             m_srcs[u].device.strmid = -1;
+            reset_frame_state(u);
+            rebuild_src_fanout();
             return 0;
         }
     }
@@ -1845,6 +1878,7 @@ int XTEngine::inactive_src(int srcno)
         if (m_srcs[u].srcno == srcno)
         {
             m_srcs[u].active = false;
+            rebuild_src_fanout();
             return 0;
         }
     }
@@ -1852,6 +1886,77 @@ int XTEngine::inactive_src(int srcno)
     return -1;
 }
 
+void XTEngine::rebuild_src_fanout()
+{
+    boost::shared_ptr<src_fanout_table> fanout(new src_fanout_table);
+    if (m_srcs)
+    {
+        long strm_num = m_msCfg.num_chan;
+        for (int u = 0;u < m_msCfg.num_chan ;++u)
+        {
+            if (m_srcs[u].device.strmid >= strm_num)
+            {
+                strm_num = m_srcs[u].device.strmid + 1;
+            }
+        }
+        fanout->strms.resize(strm_num);
+
+        for (int u = 0;u < m_msCfg.num_chan ;++u)
+        {
+            const src_info &src = m_srcs[u];
+            if (!src.active || src.srcno < 0 || src.device.strmid < 0)
+            {
+                continue;
+            }
+
+            src_fanout_item item;
+            item.srcno = src.srcno;
+            item.db_type = src.device.db_type;
+            item.dev_strmtype = src.device.dev_strmtype;
+            item.trackids[0] = get_trackid(src.device, MEDIA_TYPE_NA);
+            item.trackids[1] = get_trackid(src.device, MEDIA_TYPE_VIDEO);
+            item.trackids[2] = get_trackid(src.device, MEDIA_TYPE_AUDIO);
+            fanout->strms[src.device.strmid].push_back(item);
+        }
+    }
+
+    boost::atomic_store(&m_src_fanout, src_fanout_ptr(fanout));
+}
+
+void XTEngine::reset_frame_state(const int srcno)
+{
+    if (!m_src_states || srcno<0 || srcno >= m_msCfg.num_chan)
+    {
+        return;
+    }
+    m_src_states[srcno].frames.store(0, boost::memory_order_relaxed);
+    boost::atomic_store(&m_src_states[srcno].key, src_key_ptr());
+}
+
+void XTEngine::invalidate_key_cache(const int srcno)
+{
+    if (!m_src_states || srcno<0 || srcno >= m_msCfg.num_chan)
+    {
+        return;
+    }
+    boost::atomic_store(&m_src_states[srcno].key, src_key_ptr());
+}
+
+void XTEngine::load_frame_state(src_info &src) const
+{
+    if (!m_src_states || src.srcno<0 || src.srcno >= m_msCfg.num_chan)
+    {
+        return;
+    }
+    src.frames = m_src_states[src.srcno].frames.load(boost::memory_order_relaxed);
+    src_key_ptr key = boost::atomic_load(&m_src_states[src.srcno].key);
+    if (key)
+    {
+        ::memcpy(src.device.key, key->data.data(), key->len);
+        src.device.key_len = key->len;
+    }
+}
+
 bool XTEngine::is_active_src(const int srcno)
 {
     boost::unique_lock<boost::shared_mutex> lock2(m_mSrc);
@@ -1881,33 +1986,41 @@ long XTEngine::get_dev_stremtype_by_srcno(const int srcno)
 
 void XTEngine::upate_frame_state(const int srcno)
 {
-    //boost::shared_lock<boost::shared_mutex> lock(m_mSrc);
-
-    if (srcno<0 || srcno >= m_msCfg.num_chan)
+    //ֻ֡״̬ԭӼдm_srcs
+    if (!m_src_states || srcno<0 || srcno >= m_msCfg.num_chan)
     {
         return;
     }
-    if (m_srcs[srcno].active)
-    {
-        m_srcs[srcno].frames += 1;
-    }
+    m_src_states[srcno].frames.fetch_add(1, boost::memory_order_relaxed);
 }
 int XTEngine::update_sdp(const int srcno,char *key, long len,long data_type)
 {
-    do 
-    { 
-        //boost::shared_lock<boost::shared_mutex> lock(m_mSrc); 
-        if (srcno<0 || srcno >= m_msCfg.num_chan)
-        {
-            return -1;
-        }
-        if (m_srcs[srcno].active)
-        {
-            ::memcpy(m_srcs[srcno].device.key,key,len);
-            m_srcs[srcno].device.key_len = len;
-        } 
-    } while (false);
-    return media_server::set_key_data(srcno,key, len, data_type);
+    if (!m_src_states || srcno<0 || srcno >= m_msCfg.num_chan || !key || len < 0 || len > MAX_KEY_SIZE)
+    {
+        return -1;
+    }
+
+    //ؼ֡ÿζϵͳͷδ仯ʱٿ·crcֽͬȷ
+    src_frame_state &state = m_src_states[srcno];
+    const uint32_t crc = tghelper::crc32((const uint8_t*)key, (uint32_t)len);
+    src_key_ptr cur = boost::atomic_load(&state.key);
+    if (cur && cur->sent && cur->crc == crc && cur->len == len && cur->data_type == data_type
+        && 0 == ::memcmp(cur->data.data(), key, len))
+    {
+        return 0;
+    }
+
+    int ret_code = media_server::set_key_data(srcno,key, len, data_type);
+
+    //ϵͳͷݷ¿滻߲ῴдһϵͳͷ·ʧܵһؼ֡
+    boost::shared_ptr<src_key_cache> next(new src_key_cache);
+    next->crc = crc;
+    next->data_type = data_type;
+    next->len = len;
+    next->sent = (ret_code >= 0);
+    next->data.assign(key, len);
+    boost::atomic_store(&state.key, src_key_ptr(next));
+    return ret_code;
 }
 long  XTEngine::get_sdp_size(const int srcno)
 {
@@ -1918,6 +2031,14 @@ long  XTEngine::get_sdp_size(const int srcno)
         return -1;
     }
 
+    if (m_src_states)
+    {
+        src_key_ptr cur = boost::atomic_load(&m_src_states[srcno].key);
+        if (cur)
+        {
+            return cur->len;
+        }
+    }
     return m_srcs[srcno].device.key_len;
 }
 long XTEngine::save_sdp_srcno_to_srv_and_access(const int srcno,const long recv_dev_handle,const std::string& sdp)
@@ -1936,6 +2057,7 @@ long XTEngine::save_sdp_srcno_to_srv_and_access(const int srcno,const long recv_
             break;
         }
         DEBUG_LOG(DBLOGINFO,ll_info,"save_sdp_srcno_to_srv_and_access srcno[%d] sdp[%s] _sdp_len[%d]",srcno,_sdp,_sdp_len);
+        invalidate_key_cache(srcno);
         ret_code = media_server::set_key_data(srcno, _sdp, _sdp_len,172);
         if (ret_code < 0)
         {
@@ -2032,6 +2154,7 @@ long XTEngine::save_sdp_to_srv(const int srcno,const char* sdp,const long sdp_le
         boost::shared_lock<boost::shared_mutex> lock(m_mSrc);
         ::memcpy(m_srcs[srcno].device.key,sdp,sdp_len);
         m_srcs[srcno].device.key_len = sdp_len;
+        invalidate_key_cache(srcno);
         ret_code = media_server::set_key_data(srcno, m_srcs[srcno].device.key, sdp_len,data_type);
         if (ret_code < 0)
         {
@@ -2063,6 +2186,7 @@ long XTEngine::save_sdp_to_srv(const int srcno,std::string& recv_sdp)
             ::memcpy(m_srcs[srcno].device.key,sdp,sdp_len);
             m_srcs[srcno].device.key_len = sdp_len;
         }
+        invalidate_key_cache(srcno);
         ret_code = media_server::set_key_data(srcno, sdp, sdp_len, 172);
         if (ret_code < 0)
         {
@@ -2082,8 +2206,22 @@ int XTEngine::get_key(long strmid, char *key, long &len)
     {
         if (m_srcs[u].device.strmid == strmid)
         {
-            len = m_srcs[u].device.key_len;
-            ::memcpy(key, m_srcs[u].device.key, len);
+            //ȡؼ֡ϵͳͷգûʱΪԴⲿϵͳͷ
+            src_key_ptr cur;
+            if (m_src_states)
+            {
+                cur = boost::atomic_load(&m_src_states[u].key);
+            }
+            if (cur)
+            {
+                len = cur->len;
+                ::memcpy(key, cur->data.data(), len);
+            }
+            else
+            {
+                len = m_srcs[u].device.key_len;
+                ::memcpy(key, m_srcs[u].device.key, len);
+            }
 
             return 0;
         }
@@ -2099,8 +2237,13 @@ int XTEngine::get_trackid(const int srcno,const int media_type)
     {
         return -1;
     }
-    device_info::track_info_container_handle_t itr = m_srcs[srcno].device.track_infos.begin();
-    for (;m_srcs[srcno].device.track_infos.end() != itr; ++itr)
+    return get_trackid(m_srcs[srcno].device,media_type);
+}
+
+int XTEngine::get_trackid(const device_info &device,const int media_type)
+{
+    device_info::track_info_container_t::const_iterator itr = device.track_infos.begin();
+    for (;device.track_infos.end() != itr; ++itr)
     {
         if (itr->trackType == media_type)
         {
@@ -2144,6 +2287,7 @@ void XTEngine::get_all_src(std::list<src_info>& lst_src)
         if (m_srcs && m_srcs[u].active)
         {
             lst_src.push_back(m_srcs[u]);
+            load_frame_state(lst_src.back());
         }
     }
 }
@@ -7,6 +7,8 @@
 #include <algorithm>
 #include <boost/noncopyable.hpp>
 #include <boost/thread/shared_mutex.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/atomic.hpp>
 #include <boost/threadpool.hpp>
 #include "media_server.h"
 #include "media_device.h"
@@ -15,6 +17,7 @@
 
 #include "sdp.h"
 #include "parse_buffer.h"
+#include "sdp_view.h"
 
 #ifdef _WIN32
 #define XT_CALLBACK __stdcall
@@ -179,6 +182,44 @@ struct strmid_info
     bool use;
 };
 
+// ->תԴȳ(ݻصʹ)
+struct src_fanout_item
+{
+    int     srcno;          //תԴʶ
+    long    db_type;        //㲥
+    long    dev_strmtype;   //豸
+    int     trackids[3];    //media_type(-1/0/1)Ӧtrackid
+};
+
+// ->תԴȳֻգ޸ʱƺ滻
+struct src_fanout_table
+{
+    typedef std::vector<src_fanout_item> items_t;
+    std::vector<items_t> strms; //±Ϊstrmid
+};
+typedef boost::shared_ptr<const src_fanout_table> src_fanout_ptr;
+
+// תԴѷϵͳͷֻգ仯ʱ滻
+struct src_key_cache
+{
+    uint32_t    crc;        //ϵͳͷcrc32(仯)
+    long        data_type;  //
+    long        len;        //ϵͳͷ
+    bool        sent;       //·media_server
+    std::string data;       //ϵͳͷ
+};
+typedef boost::shared_ptr<const src_key_cache> src_key_ptr;
+
+// תԴ֡״̬(ݻص)
+struct src_frame_state
+{
+    boost::atomic<unsigned long> frames;  //֡
+    src_key_ptr                  key;     //ϵͳͷ(atomic_load/atomic_store)
+
+    src_frame_state():frames(0),key()
+    {}
+};
+
 #include "../tghelper/recycle_pool.h"
 #include "../tghelper/recycle_pools.h"
 #include "../tghelper/byte_pool.h"
@@ -409,6 +450,9 @@ public:
     dev_handle_t get_dev_link_handle_src(const int srcno);
     bool is_active_src(const int srcno);
 
+    // ȡ->תԴȳ()
+    src_fanout_ptr get_src_fanout() const { return boost::atomic_load(&m_src_fanout); }
+
     // /ɾתԴ
     int create_src(device_info &device,int &srcno,long chanid = -1);// long chanid = -1ָͨ
     int create_src_v1(device_info &device,int &srcno);
@@ -433,6 +477,7 @@ public:
 
     // 
     int get_trackid(const int srcno,const int media_type);
+    static int get_trackid(const device_info &device,const int media_type);
 
     // תԴӦͨ
     int get_chanid(int srcno, int trackid, long &chanid);
@@ -564,7 +609,18 @@ public:
             }
             t--;
         }
-        return ((len - 1) == (t - str)) ? -1 : atoi(t + 1);
+        if ((len - 1) == (t - str))
+        {
+            return -1;
+        }
+
+        //strSDPԭƬΣ'\0'βת
+        int trackid = 0;
+        for (++t; t < str + len; ++t)
+        {
+            trackid = trackid * 10 + (*t - '0');
+        }
+        return trackid;
     }
 
     inline int find_trackid(const std::string& str)
@@ -580,6 +636,18 @@ public:
 private:
     long sip_create_sdp_r_impl_v1(long link_handle,const long dev_strmtype,int& track_num,std::string&sdp);
     long sip_create_sdp_r_impl_v2(long link_handle,const long dev_strmtype,int& track_num,std::string&sdp);
+
+    // ؽ->תԴȳ(߳m_mSrcд)
+    void rebuild_src_fanout();
+
+    // תԴ֡״̬(m_mSrcдڵ)
+    void reset_frame_state(const int srcno);
+
+    // ϵͳͷⲿдʹʧЧһؼ֡·
+    void invalidate_key_cache(const int srcno);
+
+    // ԭ֡ϵͳͷsrc_info
+    void load_frame_state(src_info &src) const;
 private:
     boost::shared_mutex            m_global_mutex;      // mutex(ȫ)
     MS_CFG                         m_msCfg;       // ת
@@ -589,6 +657,8 @@ private:
 private:
     boost::shared_mutex           m_mSrc;       // mutex(src)-m_srcs 	
     src_info                       *m_srcs;      // תԴ
+    src_frame_state                *m_src_states; // תԴ֡״̬(m_srcsͬ±)
+    src_fanout_ptr                 m_src_fanout; // ->תԴȳ(m_mSrcд,ݻص)
 
     boost::shared_mutex           strmid_mutex_;     // mutex(strmid)
     strmid_info                    *m_strmids;     // ids(ݻصʹ)
@@ -8,6 +8,7 @@
 #include "FuncEx.h"
 #include "media_server.h"
 #include "router_task.h"
+#include "router_cmd_pipeline.h"
 #include "xt_regist_server.h"
 #include "XTRouterLog.h"
 #include "SlaveIPC.h"
@@ -24,6 +25,7 @@ CXTRouter CXTRouter::m_obj;
 extern bool router_engine_init();
 extern bool reouter_engine_uninit();
 int g_ids_index=-1;
+int g_router_log_level = ll_off;
 //
 /////////////////////////////////////////////////////////////////////////////////
 #define  COMMAND_HELP "help"                  //
@@ -152,13 +154,17 @@ void CXTRouter::regist_log_sys()
     init_log_target(LOG_PATH"rtsp_svr");
     init_log_target(LOG_PATH"tcp_svr");
 
+    //LogOnOffһ£ͬʱDEBUG_LOGļ
     if (level <= 0)
     {
         set_log_on_off(false);
+        g_router_log_level = ll_error + 1;
     }
     else
     {
         set_log_on_off(true);
+        set_log_level((severity_level)level);
+        g_router_log_level = level;
     }
 }
 
@@ -276,6 +282,11 @@ int CXTRouter::StartXTRouter()
         web_srv_mgr::_()->init(config::instance()->get_web_server_port(8140));
 #endif// #ifdef _USE_WEB_SRV_
 
+        //ָ豸ƬִУڽǰ
+        std::cout << "start command pipeline..." << std::endl;
+        router_cmd_pipeline::_()->start(config::_()->cmd_pipeline_shards(ROUTER_CMD_PIPELINE_DEFAULT_SHARDS),
+            config::_()->cmd_start_deadline(ROUTER_CMD_START_DEADLINE_MS));
+
         //ģʼ
         std::cout << "modules init..." << std::endl;
         CtrlMsgInit();
@@ -292,6 +303,9 @@ int CXTRouter::StopXTRouter()
     std::cout<<"stop center link..."<<std::endl;
     CtrlMsgUninit();
 
+    std::cout<<"stop command pipeline..."<<std::endl;
+    router_cmd_pipeline::_()->stop();
+
 #ifdef USE_SNMP_
     //stop SNMP report server by wluo
     std::cout<<"stop SNMP slave report server..."<<std::endl;
@@ -402,6 +416,14 @@ void CXTRouter::ResCommand()
         "framework",
         boost::bind(&CXTRouter::QueryFrameworkTaskScheduler,this,_1,_2));
 
+    command_manager_t::instance()->register_cmd(
+        "cmdq",
+        boost::bind(&CXTRouter::QueryCommandPipeline,this,_1,_2));
+
+    command_manager_t::instance()->register_cmd(
+        "demux",
+        boost::bind(&CXTRouter::QueryDemuxStats,this,_1,_2));
+
     command_manager_t::instance()->register_cmd(
         COMMAND_LOG_ON_OFF,boost::bind(&CXTRouter::LogOnOff,this,_1,_2));
 
@@ -979,11 +1001,13 @@ COMMAND_DISPATTCH_FUNCTION CXTRouter::LogOnOff(const command_argument_t& Args,st
     if (level < 0)
     {
         set_log_on_off(false);
+        g_router_log_level = ll_error + 1;
     }
     else
     {
         set_log_on_off(true);
 		set_log_level((severity_level)level);
+        g_router_log_level = level;
     }
 
     result = "log operator sucess";
@@ -1830,3 +1854,74 @@ COMMAND_DISPATTCH_FUNCTION CXTRouter::QueryFrameworkTaskScheduler(const command_
     }
     return true;
 }
+
+COMMAND_DISPATTCH_FUNCTION CXTRouter::QueryCommandPipeline(const command_argument_t& args, std::string& result)
+{
+    //without arguments
+    if (0 != args.count())
+    {
+        return false;
+    }
+
+    std::ostringstream os;
+    result.clear();
+
+    std::vector<router_cmd_shard_info> infos;
+    router_cmd_pipeline::_()->query(infos);
+    if (infos.empty())
+    {
+        std::cout << "command pipeline not running" << std::endl;
+        os << "command pipeline not running" << std::endl;
+        result.append(os.str());
+        return true;
+    }
+
+    os << "command pipeline shards:" << infos.size() << std::endl;
+    for (std::vector<router_cmd_shard_info>::size_type index = 0; index < infos.size(); ++index)
+    {
+        os << " [" << index << "]depth:" << infos[index].depth
+            << ",max_depth:" << infos[index].max_depth
+            << ",executed:" << infos[index].executed
+            << ",coalesced:" << infos[index].coalesced
+            << ",expired:" << infos[index].expired
+            << ",last_wait_ms:" << infos[index].last_wait_ms
+            << ",max_wait_ms:" << infos[index].max_wait_ms
+            << ",busy_ms:" << infos[index].busy_ms << std::endl;
+    }
+
+    std::cout << os.str();
+    result.append(os.str());
+    return true;
+}
+
+COMMAND_DISPATTCH_FUNCTION CXTRouter::QueryDemuxStats(const command_argument_t& args, std::string& result)
+{
+    //without arguments
+    if (0 != args.count())
+    {
+        return false;
+    }
+
+    std::ostringstream os;
+    result.clear();
+
+    demux_stats_t stats;
+    if (media_server::get_demux_stats(stats) < 0)
+    {
+        os << "query demux stats fail" << std::endl;
+        std::cout << os.str();
+        result.append(os.str());
+        return true;
+    }
+
+    os << "demux sessions:" << stats.sessions
+        << ",buckets:" << stats.buckets
+        << ",max_probe:" << stats.max_probe
+        << ",lookups:" << stats.lookups
+        << ",collisions:" << stats.collisions
+        << ",open_fails:" << stats.open_fails << std::endl;
+
+    std::cout << os.str();
+    result.append(os.str());
+    return true;
+}
@@ -116,6 +116,12 @@ protected:
     //query information of the framework task schedulers
     COMMAND_DISPATTCH_FUNCTION QueryFrameworkTaskScheduler(const command_argument_t& Args,std::string &result);
 
+    //ָƬ״̬
+    COMMAND_DISPATTCH_FUNCTION QueryCommandPipeline(const command_argument_t& Args,std::string &result);
+
+    //Ͷ˸ûỰͳ
+    COMMAND_DISPATTCH_FUNCTION QueryDemuxStats(const command_argument_t& Args,std::string &result);
+
     COMMAND_DISPATTCH_FUNCTION LogOnOff(const command_argument_t& Args,std::string&result);
 
     COMMAND_DISPATTCH_FUNCTION XmppPlay(const command_argument_t& Args,std::string &result);
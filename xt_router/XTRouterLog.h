@@ -21,6 +21,7 @@
 #endif //#ifdef _WIN32
 
 #include "web_srv_mgr.h"
+#include "../tghelper/async_log.h"
 
 #define MAX_LOG_BUF_SIZE 4096
 #define LOG_HEAD_FLAG "XTRouter| "
@@ -32,44 +33,41 @@
 #endif
 
 #define WRITE_LOG(logger_name, loglevel, format, ...) xt_log_write(std::string(LOG_PATH).append(logger_name).c_str(), loglevel, format, __VA_ARGS__)
-#define DEBUG_LOG(logger_name, loglevel,fmt, ...) put_log_impl(logger_name, loglevel,fmt,##__VA_ARGS__)
+//־ޣڸüDEBUG_LOGڱڱ
+#ifndef XTROUTER_LOG_COMPILE_LEVEL
+#define XTROUTER_LOG_COMPILE_LEVEL ll_off
+#endif
 
-inline void put_log_impl(const char* logger_name, const severity_level log_leve,const char *fmt, ...)
-{
-    va_list args;
-    va_start(args, fmt);
-    char log_buf[MAX_LOG_BUF_SIZE]={0};
-#ifdef _WIN32
-    ::vsnprintf_s(log_buf, MAX_LOG_BUF_SIZE,MAX_LOG_BUF_SIZE,fmt, args);
-#else
-    ::vsnprintf(log_buf, MAX_LOG_BUF_SIZE,fmt, args);
-#endif //#ifdef _WIN32
-    va_end(args);
+//־ޣLogOnOffboost.log˼ͬ
+extern int g_router_log_level;
 
-    log_buf[MAX_LOG_BUF_SIZE - 1] = 0;
+//fmtΪַδļֻһαȽ
+#define DEBUG_LOG(logger_name, loglevel,fmt, ...) do { if ((loglevel) >= XTROUTER_LOG_COMPILE_LEVEL && (loglevel) >= g_router_log_level) put_log_impl(logger_name, loglevel,"" fmt,##__VA_ARGS__); } while (0)
 
-    if (logger_name != NULL)
+//־صֻ첽־̨߳е
+inline void router_log_sink(const char* logger_name, int log_leve, const char *time, const char *text)
+{
+    if (NULL == text)
     {
-        WRITE_LOG(logger_name,log_leve,"%s",log_buf);
+        return;
     }
-    
-    std::string t = get_cur_time_microsec();
-    if (t.empty())
+
+    if (logger_name != NULL)
     {
-        return;
+        WRITE_LOG(logger_name,(severity_level)log_leve,"%s",text);
     }
 
     std::string strlog;
     strlog.append("[");
-    strlog.append(t.c_str());
+    strlog.append(time);
     strlog.append("]");
     strlog.append(LOG_HEAD_FLAG);
-    strlog.append(log_buf);
+    strlog.append(text);
     strlog.append("\n");
 
     if (NULL == logger_name)
     {
-        ::printf(strlog.c_str());
+        ::printf("%s", strlog.c_str());
     }
 
 #ifdef _USE_WEB_SRV_
@@ -77,4 +75,13 @@ inline void put_log_impl(const char* logger_name, const severity_level log_leve,
 #endif//_USE_WEB_SRV_
 }
 
+//ֻ߳ʽboost.logдweb־ɺ̨߳
+inline void put_log_impl(const char* logger_name, const severity_level log_leve,const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    tghelper::async_log_vput(router_log_sink, logger_name, log_leve, fmt, args);
+    va_end(args);
+}
+
 #endif // XTROUTERLOG_H
\ No newline at end of file
@@ -187,6 +187,11 @@ int media_server::get_svr_info(svr_info info[],int& tracknum,const int srcno)
     return ::xt_get_svr_info(info,tracknum,srcno); 
 }
 
+int media_server::get_demux_stats(demux_stats_t& stats)
+{
+    return ::xt_get_demux_stats(stats);
+}
+
 int media_server::create_src_defult(int* srcno,char sdp[],int* sdp_len,const long chanid,const char* local_bind_ip)
 {
     return ::xt_create_src_defult(srcno,sdp,sdp_len,chanid,local_bind_ip);
@@ -97,6 +97,9 @@ public:
 
     static int get_svr_info(svr_info info[],int& tracknum,const int srcno);
 
+    // ûỰͳ
+    static int get_demux_stats(demux_stats_t& stats);
+
     static int create_src_defult(int* srcno,char sdp[],int* sdp_len,const long chanid,const char* local_bind_ip);
 
     static int set_rtsp_heartbit_time(const unsigned int check_timer_interval,const unsigned int time_out_interval);
@@ -0,0 +1,360 @@
+#include "router_cmd_pipeline.h"
+#include "XTRouterLog.h"
+#include <boost/bind.hpp>
+#include <boost/functional/hash.hpp>
+
+router_cmd_pipeline router_cmd_pipeline::self_;
+
+router_cmd_pipeline::router_cmd_pipeline()
+:start_deadline_(boost::posix_time::milliseconds(ROUTER_CMD_START_DEADLINE_MS)),
+run_(false)
+{}
+
+router_cmd_pipeline::~router_cmd_pipeline()
+{
+    stop();
+    for (std::vector<shard_t *>::size_type i = 0; i < shards_.size(); ++i)
+    {
+        delete shards_[i];
+    }
+    shards_.clear();
+}
+
+int router_cmd_pipeline::start(uint32_t shards, uint32_t start_deadline_ms)
+{
+    boost::mutex::scoped_lock lock(global_mutex_);
+    if (run_ || !shards_.empty())
+    {
+        return -1;
+    }
+
+    if (shards < 1)
+    {
+        shards = 1;
+    }
+    if (shards > ROUTER_CMD_PIPELINE_MAX_SHARDS)
+    {
+        shards = ROUTER_CMD_PIPELINE_MAX_SHARDS;
+    }
+    start_deadline_ = boost::posix_time::milliseconds(start_deadline_ms);
+
+    for (uint32_t i = 0; i < shards; ++i)
+    {
+        shards_.push_back(new shard_t);
+    }
+
+    run_ = true;
+    for (uint32_t i = 0; i < shards; ++i)
+    {
+        shards_[i]->thread = new boost::thread(boost::bind(&router_cmd_pipeline::work, this, i));
+    }
+
+    DEBUG_LOG(DBLOGINFO,ll_info,"router_cmd_pipeline::start | shards[%d] start_deadline_ms[%d]",shards,start_deadline_ms);
+    return 0;
+}
+
+void router_cmd_pipeline::stop()
+{
+    {
+        boost::mutex::scoped_lock lock(global_mutex_);
+        if (!run_)
+        {
+            return;
+        }
+        run_ = false;
+
+        for (std::vector<shard_t *>::size_type i = 0; i < shards_.size(); ++i)
+        {
+            boost::mutex::scoped_lock shard_lock(shards_[i]->mutex);
+            shards_[i]->cond.notify_all();
+        }
+    }
+
+    //Ƭ˳󵽴ָɵ÷תԭ߳
+    for (std::vector<shard_t *>::size_type i = 0; i < shards_.size(); ++i)
+    {
+        if (shards_[i]->thread)
+        {
+            shards_[i]->thread->join();
+            delete shards_[i]->thread;
+            shards_[i]->thread = NULL;
+        }
+    }
+}
+
+uint32_t router_cmd_pipeline::shard_of(const std::string& ids) const
+{
+    boost::hash<std::string> hasher;
+    return (uint32_t)(hasher(ids) % shards_.size());
+}
+
+void router_cmd_pipeline::push(shard_t &shard, cmd_t &cmd)
+{
+    cmd.enqueue_time = boost::posix_time::microsec_clock::universal_time();
+    shard.cmds.push_back(cmd);
+
+    //std::list::size()֤ʱ䣬ȵ
+    ++shard.info.depth;
+    if (shard.info.depth > shard.info.max_depth)
+    {
+        shard.info.max_depth = shard.info.depth;
+    }
+    shard.cond.notify_one();
+}
+
+void router_cmd_pipeline::cancel_pending_start(shard_t &shard, const std::string& ids, bool any_chan, long chanid, long strmtype,
+                                               std::vector<cmd_fn_t> &drops)
+{
+    cmd_container_t::iterator itr = shard.cmds.end();
+    while (itr != shard.cmds.begin())
+    {
+        --itr;
+        if (CMD_GLOBAL == itr->type)
+        {
+            break;
+        }
+        if (itr->ids != ids)
+        {
+            continue;
+        }
+        if (CMD_DEVICE == itr->type)
+        {
+            break;
+        }
+        if (CMD_START != itr->type)
+        {
+            continue;
+        }
+        if (!any_chan && (itr->chanid != chanid || itr->strmtype != strmtype))
+        {
+            continue;
+        }
+
+        drops.push_back(itr->drop);
+        itr = shard.cmds.erase(itr);
+        --shard.info.depth;
+        ++shard.info.coalesced;
+    }
+}
+
+bool router_cmd_pipeline::post_start(const std::string& ids, long chanid, long strmtype, const cmd_fn_t& exec, const cmd_fn_t& drop)
+{
+    if (!run_)
+    {
+        return false;
+    }
+
+    cmd_t cmd;
+    cmd.type = CMD_START;
+    cmd.ids = ids;
+    cmd.chanid = chanid;
+    cmd.strmtype = strmtype;
+    cmd.exec = exec;
+    cmd.drop = drop;
+
+    shard_t &shard = *shards_[shard_of(ids)];
+    boost::mutex::scoped_lock lock(shard.mutex);
+    if (!run_)
+    {
+        return false;
+    }
+    push(shard, cmd);
+    return true;
+}
+
+bool router_cmd_pipeline::post_stop(const std::string& ids, long chanid, long strmtype, const cmd_fn_t& exec)
+{
+    if (!run_)
+    {
+        return false;
+    }
+
+    cmd_t cmd;
+    cmd.type = CMD_STOP;
+    cmd.ids = ids;
+    cmd.chanid = chanid;
+    cmd.strmtype = strmtype;
+    cmd.exec = exec;
+
+    std::vector<cmd_fn_t> drops;
+    {
+        shard_t &shard = *shards_[shard_of(ids)];
+        boost::mutex::scoped_lock lock(shard.mutex);
+        if (!run_)
+        {
+            return false;
+        }
+        cancel_pending_start(shard, ids, false, chanid, strmtype, drops);
+        push(shard, cmd);
+    }
+
+    for (std::vector<cmd_fn_t>::size_type i = 0; i < drops.size(); ++i)
+    {
+        DEBUG_LOG(DBLOGINFO,ll_info,"router_cmd_pipeline::post_stop | cancel pending play ids[%s] chanid[%d] strmtype[%d]",
+            ids.c_str(),chanid,strmtype);
+        drops[i]();
+    }
+    return true;
+}
+
+bool router_cmd_pipeline::post_device(const std::string& ids, const cmd_fn_t& exec)
+{
+    if (!run_)
+    {
+        return false;
+    }
+
+    cmd_t cmd;
+    cmd.type = CMD_DEVICE;
+    cmd.ids = ids;
+    cmd.chanid = -1;
+    cmd.strmtype = -1;
+    cmd.exec = exec;
+
+    std::vector<cmd_fn_t> drops;
+    {
+        shard_t &shard = *shards_[shard_of(ids)];
+        boost::mutex::scoped_lock lock(shard.mutex);
+        if (!run_)
+        {
+            return false;
+        }
+        cancel_pending_start(shard, ids, true, -1, -1, drops);
+        push(shard, cmd);
+    }
+
+    for (std::vector<cmd_fn_t>::size_type i = 0; i < drops.size(); ++i)
+    {
+        DEBUG_LOG(DBLOGINFO,ll_info,"router_cmd_pipeline::post_device | cancel pending play ids[%s]",ids.c_str());
+        drops[i]();
+    }
+    return true;
+}
+
+bool router_cmd_pipeline::post_global(const cmd_fn_t& exec)
+{
+    boost::mutex::scoped_lock lock(global_mutex_);
+    if (!run_)
+    {
+        return false;
+    }
+
+    cmd_t cmd;
+    cmd.type = CMD_GLOBAL;
+    cmd.chanid = -1;
+    cmd.strmtype = -1;
+    cmd.barrier.reset(new barrier_t);
+    cmd.barrier->exec = exec;
+
+    for (std::vector<shard_t *>::size_type i = 0; i < shards_.size(); ++i)
+    {
+        boost::mutex::scoped_lock shard_lock(shards_[i]->mutex);
+        push(*shards_[i], cmd);
+    }
+    return true;
+}
+
+void router_cmd_pipeline::pass_barrier(barrier_t &barrier)
+{
+    boost::mutex::scoped_lock lock(barrier.mutex);
+    if (++barrier.arrived < shards_.size())
+    {
+        while (!barrier.done)
+        {
+            barrier.cond.wait(lock);
+        }
+        return;
+    }
+
+    lock.unlock();
+    barrier.exec();
+    lock.lock();
+
+    barrier.done = true;
+    barrier.cond.notify_all();
+}
+
+void router_cmd_pipeline::work(uint32_t index)
+{
+    shard_t &shard = *shards_[index];
+
+    for (;;)
+    {
+        cmd_t cmd;
+        bool expired = false;
+        {
+            boost::mutex::scoped_lock lock(shard.mutex);
+            while (shard.cmds.empty() && run_)
+            {
+                shard.cond.wait(lock);
+            }
+            if (shard.cmds.empty())
+            {
+                break;
+            }
+
+            cmd = shard.cmds.front();
+            shard.cmds.pop_front();
+            --shard.info.depth;
+
+            boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+            boost::posix_time::time_duration wait = now - cmd.enqueue_time;
+            shard.info.last_wait_ms = (uint32_t)wait.total_milliseconds();
+            if (shard.info.last_wait_ms > shard.info.max_wait_ms)
+            {
+                shard.info.max_wait_ms = shard.info.last_wait_ms;
+            }
+
+            //ͣ㲻ޣ㲥ŶӹѳʱִҲ
+            if (CMD_START == cmd.type && (!run_ || wait > start_deadline_))
+            {
+                expired = true;
+                ++shard.info.expired;
+            }
+            else
+            {
+                shard.busy = true;
+                shard.busy_since = now;
+            }
+        }
+
+        if (expired)
+        {
+            DEBUG_LOG(DBLOGINFO,ll_warn,"router_cmd_pipeline::work | shard[%d] drop expired play ids[%s] chanid[%d] strmtype[%d]",
+                index,cmd.ids.c_str(),cmd.chanid,cmd.strmtype);
+            cmd.drop();
+            continue;
+        }
+
+        if (CMD_GLOBAL == cmd.type)
+        {
+            pass_barrier(*cmd.barrier);
+        }
+        else
+        {
+            cmd.exec();
+        }
+
+        boost::mutex::scoped_lock lock(shard.mutex);
+        shard.busy = false;
+        ++shard.info.executed;
+    }
+}
+
+void router_cmd_pipeline::query(std::vector<router_cmd_shard_info>& infos)
+{
+    infos.clear();
+    if (!run_)
+    {
+        return;
+    }
+
+    boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+    for (std::vector<shard_t *>::size_type i = 0; i < shards_.size(); ++i)
+    {
+        boost::mutex::scoped_lock lock(shards_[i]->mutex);
+        router_cmd_shard_info info = shards_[i]->info;
+        info.busy_ms = shards_[i]->busy ? (uint32_t)(now - shards_[i]->busy_since).total_milliseconds() : 0;
+        infos.push_back(info);
+    }
+}
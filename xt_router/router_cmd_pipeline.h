@@ -0,0 +1,142 @@
+#ifndef _ROUTER_CMD_PIPELINE_H_INCLUDED
+#define _ROUTER_CMD_PIPELINE_H_INCLUDED
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <list>
+#include <vector>
+#include <string>
+#include <stdint.h>
+
+//Ƭ߳
+#define ROUTER_CMD_PIPELINE_DEFAULT_SHARDS      4
+#define ROUTER_CMD_PIPELINE_MAX_SHARDS          32
+
+//㲥ָŶӳʱ()ʱδֱִķ㲥ʧ
+#define ROUTER_CMD_START_DEADLINE_MS            30000
+
+//ָƬˮ
+//1ͬһ豸(ids)ָͬһƬ˳ִУͬ豸У̨豸¼豸
+//2ͣ/豸ߵʱȡŶδִеͬ·㲥ȡĵ㲥ķ㲥ʧܣͣճִ
+//3ȫͣ㡢תͨͣ㡢idsµȿ豸ָΪϣзƬִеλú󵽴ķƬִ
+struct router_cmd_shard_info
+{
+    uint32_t depth;             //ǰŶ
+    uint32_t max_depth;         //ʷŶ
+    uint64_t executed;          //ִָ
+    uint64_t coalesced;         //ͣȡĵ㲥
+    uint64_t expired;           //Ŷӳʱĵ㲥
+    uint32_t last_wait_ms;      //һָŶʱ
+    uint32_t max_wait_ms;       //Ŷʱ
+    uint32_t busy_ms;           //ǰִָʱΪ0
+};
+
+class router_cmd_pipeline : boost::noncopyable
+{
+public:
+    static router_cmd_pipeline* instance(){return &self_;}
+    static router_cmd_pipeline* _(){return &self_;}
+
+    typedef boost::function<void()> cmd_fn_t;
+
+protected:
+    router_cmd_pipeline();
+    ~router_cmd_pipeline();
+    static router_cmd_pipeline self_;
+
+public:
+    int start(uint32_t shards, uint32_t start_deadline_ms);
+
+    //˳ʱŶеĵ㲥ֱӷִָ߳˳
+    void stop();
+
+    bool running() const { return run_; }
+
+    //δʱfalseɵ÷ԭ߳
+    //execִָdrop㲥(ķʧܲͷ)ֻһ
+    bool post_start(const std::string& ids, long chanid, long strmtype, const cmd_fn_t& exec, const cmd_fn_t& drop);
+    bool post_stop(const std::string& ids, long chanid, long strmtype, const cmd_fn_t& exec);
+    bool post_device(const std::string& ids, const cmd_fn_t& exec);
+    bool post_global(const cmd_fn_t& exec);
+
+    void query(std::vector<router_cmd_shard_info>& infos);
+
+private:
+    enum cmd_type
+    {
+        CMD_START = 0,
+        CMD_STOP,
+        CMD_DEVICE,
+        CMD_GLOBAL
+    };
+
+    struct barrier_t
+    {
+        boost::mutex mutex;
+        boost::condition_variable cond;
+        uint32_t arrived;
+        bool done;
+        cmd_fn_t exec;
+
+        barrier_t() : arrived(0), done(false) {}
+    };
+
+    struct cmd_t
+    {
+        cmd_type type;
+        std::string ids;
+        long chanid;
+        long strmtype;
+        cmd_fn_t exec;
+        cmd_fn_t drop;
+        boost::shared_ptr<barrier_t> barrier;
+        boost::posix_time::ptime enqueue_time;
+    };
+
+    typedef std::list<cmd_t> cmd_container_t;
+
+    struct shard_t
+    {
+        boost::mutex mutex;
+        boost::condition_variable cond;
+        cmd_container_t cmds;
+        boost::thread *thread;
+
+        //ͳmutex¸
+        router_cmd_shard_info info;
+        boost::posix_time::ptime busy_since;
+        bool busy;
+
+        shard_t() : thread(NULL), busy(false)
+        {
+            info.depth = 0;
+            info.max_depth = 0;
+            info.executed = 0;
+            info.coalesced = 0;
+            info.expired = 0;
+            info.last_wait_ms = 0;
+            info.max_wait_ms = 0;
+            info.busy_ms = 0;
+        }
+    };
+
+    uint32_t shard_of(const std::string& ids) const;
+    void push(shard_t &shard, cmd_t &cmd);
+
+    //Ӷβǰҿȡĵ㲥ϻͬ·ͣΪֹ
+    void cancel_pending_start(shard_t &shard, const std::string& ids, bool any_chan, long chanid, long strmtype,
+        std::vector<cmd_fn_t> &drops);
+
+    void work(uint32_t index);
+    void pass_barrier(barrier_t &barrier);
+
+    std::vector<shard_t *> shards_;
+    boost::mutex global_mutex_;     //֤ڸƬе˳һ
+    boost::posix_time::time_duration start_deadline_;
+    bool run_;
+};
+
+#endif //_ROUTER_CMD_PIPELINE_H_INCLUDED
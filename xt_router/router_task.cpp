@@ -7,6 +7,8 @@
 #include "gw_join_sip_session_mgr.h"
 #include "XTRouterLog.h"
 #include "pri_jk_engine.h"
+#include "router_cmd_pipeline.h"
+#include <boost/bind.hpp>
 
 #define ROUTER_TASK_LOG_BUF_LEN  1024
 static void (*gs_pn_log_entry)(const char *) = NULL;
@@ -24,38 +26,61 @@ void router_task_request_mgr::start_play(const std::string& ondb_sn,const std::s
     start_play_router_task *request_task = new start_play_router_task(ondb_sn,ids, chanid, strmtype, 
 		localip,db_url, db_chanid, 
         db_type, chanid2, link_type,login_name,login_password,login_port);
-    request_task->request_event();
+    if (!router_cmd_pipeline::_()->post_start(ids, chanid, strmtype,
+        boost::bind(&start_play_router_task::run, request_task),
+        boost::bind(&start_play_router_task::discard, request_task)))
+    {
+        request_task->request_event();
+    }
 }
 
 void router_task_request_mgr::update_ids(const std::string& ids, long chanid, long strmtype, 
                                          const std::string& new_ids, long new_chaid)
 {
     update_ids_router_task *request_task = new update_ids_router_task(ids, chanid, strmtype, new_ids, new_chaid);
-    request_task->request_event();
+
+    //漰¾ids豸ָ
+    if (!router_cmd_pipeline::_()->post_global(boost::bind(&update_ids_router_task::run, request_task)))
+    {
+        request_task->request_event();
+    }
 }
 
 void router_task_request_mgr::stop_play(const std::string& ondb_sn,const std::string& ids, long chanid, long strmtype)
 {
     stop_play_router_task *request_task = new stop_play_router_task(ondb_sn,ids, chanid, strmtype);
-    request_task->request_event();
+    if (!router_cmd_pipeline::_()->post_stop(ids, chanid, strmtype, boost::bind(&stop_play_router_task::run, request_task)))
+    {
+        request_task->request_event();
+    }
 }
 
 void router_task_request_mgr::stop_play(const std::string& ids)
 {
     stop_play_router_task2 *request_task = new stop_play_router_task2(ids);
-    request_task->request_event();
+    if (!router_cmd_pipeline::_()->post_device(ids, boost::bind(&stop_play_router_task2::run, request_task)))
+    {
+        request_task->request_event();
+    }
 }
 
 void router_task_request_mgr::stop_play(const long chanid)
 {
+    //תͨӦ豸δ֪豸ָ
     stop_play_router_task3 *request_task = new stop_play_router_task3(chanid);
-    request_task->request_event();
+    if (!router_cmd_pipeline::_()->post_global(boost::bind(&stop_play_router_task3::run, request_task)))
+    {
+        request_task->request_event();
+    }
 }
 
 void router_task_request_mgr::stop_all()
 {
     stop_all_router_task *request_task = new stop_all_router_task;
-    request_task->request_event();
+    if (!router_cmd_pipeline::_()->post_global(boost::bind(&stop_all_router_task::run, request_task)))
+    {
+        request_task->request_event();
+    }
 }
 
 // void router_task_request_mgr::error_to_center(const std::string& ondb_sn,const std::string&ids, long chanid,  long stream_type,
@@ -115,7 +140,10 @@ void router_task_request_mgr::device_logout_pro(const std::string& ids)
     dev_logout_pro_task* ptr_task = new dev_logout_pro_task(ids);
     if (NULL != ptr_task)
     {
-        ptr_task->request_event();
+        if (!router_cmd_pipeline::_()->post_device(ids, boost::bind(&dev_logout_pro_task::run, ptr_task)))
+        {
+            ptr_task->request_event();
+        }
     }
 }
 
@@ -407,6 +435,15 @@ uint32_t start_play_router_task::run()
     return 0;
 }
 
+void start_play_router_task::discard()
+{
+    router_task_request_mgr::log("discard play:ids(%s),chanid(%d),stream_type(%d)", ids_.c_str(), chanid_, strmtype_);
+
+    router_task_request_mgr::reponse_play_fail_to_center(ondb_sn_,ids_, chanid_, strmtype_);
+
+    delete this;
+}
+
 uint32_t update_ids_router_task::run()
 {
     int result = XTEngine::_()->update_ids(ids_, chanid_, strmtype_, new_ids_, new_chanid_);
@@ -78,6 +78,9 @@ public:
     uint32_t run();
     void process_event() { signal(deferred, recv_center_cmd_pro_thread); }
 
+    //Ŷбͣȡʱִе㲥ֱķʧ
+    void discard();
+
 private:
     std::string ids_;
     long chanid_;
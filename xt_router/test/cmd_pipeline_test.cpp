@@ -0,0 +1,233 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//   cmd_pipeline_test.cpp
+// ָƬˮ(router_cmd_pipeline)ģ豸
+//
+// 1һ̨ģ豸¼ʱ5룬豸¼20ms豸ֻͬƬָƬĵ㲥1
+// 2豸¼ڼ䵽ͬ·ͣȡŶеĵ㲥ȡĵ㲥ֻصdrop
+// 3ͬƬ豸֮󳬹Ŷ޵ĵ㲥ʱٵ¼
+// 4ȫͣΪϣ֮ǰзƬִִָֻһ
+//
+// ÷cmd_pipeline_test
+///////////////////////////////////////////////////////////////////////////////////////////
+#include "router_cmd_pipeline.h"
+
+#include <stdio.h>
+#include <map>
+#include <boost/bind.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace
+{
+    const uint32_t SHARDS = 4;
+    const uint32_t FAST_DEVICES = 64;
+    const uint32_t SLOW_LOGIN_MS = 5000;
+    const uint32_t FAST_LOGIN_MS = 20;
+    const uint32_t START_DEADLINE_MS = 3000;
+    const char *SLOW_IDS = "cam_slow";
+
+    typedef boost::posix_time::ptime ptime_t;
+
+    ptime_t now()
+    {
+        return boost::posix_time::microsec_clock::universal_time();
+    }
+
+    //ģ豸㲥ȵ¼ٵǼһ·
+    class mock_device_mgr
+    {
+    public:
+        mock_device_mgr() : logins_(0), stops_(0), stop_all_(0), streams_at_stop_all_(0) {}
+
+        void play(const std::string &ids, long chanid, uint32_t login_ms)
+        {
+            boost::this_thread::sleep(boost::posix_time::milliseconds(login_ms));
+
+            boost::mutex::scoped_lock lock(mutex_);
+            ++logins_;
+            streams_[key(ids, chanid)] = now();
+        }
+
+        void stop(const std::string &ids, long chanid)
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            ++stops_;
+            streams_.erase(key(ids, chanid));
+        }
+
+        void drop(const std::string &ids, long chanid)
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            dropped_[key(ids, chanid)] = now();
+        }
+
+        void stop_all()
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            ++stop_all_;
+            streams_at_stop_all_ = (uint32_t)streams_.size();
+            streams_.clear();
+        }
+
+        //ص㲥ʱ̣δɷnot_a_date_time
+        ptime_t played(const std::string &ids, long chanid)
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            std::map<std::string, ptime_t>::iterator itr = streams_.find(key(ids, chanid));
+            return (itr == streams_.end()) ? ptime_t() : itr->second;
+        }
+
+        bool is_dropped(const std::string &ids, long chanid)
+        {
+            boost::mutex::scoped_lock lock(mutex_);
+            return dropped_.find(key(ids, chanid)) != dropped_.end();
+        }
+
+        uint32_t logins_;
+        uint32_t stops_;
+        uint32_t stop_all_;
+        uint32_t streams_at_stop_all_;
+
+    private:
+        static std::string key(const std::string &ids, long chanid)
+        {
+            char buf[16];
+            ::snprintf(buf, sizeof(buf), "#%ld", chanid);
+            return ids + buf;
+        }
+
+        boost::mutex mutex_;
+        std::map<std::string, ptime_t> streams_;
+        std::map<std::string, ptime_t> dropped_;
+    };
+
+    mock_device_mgr g_devices;
+
+    //router_cmd_pipeline::shard_ofһ
+    uint32_t shard_of(const std::string &ids)
+    {
+        boost::hash<std::string> hasher;
+        return (uint32_t)(hasher(ids) % SHARDS);
+    }
+
+    bool post_play(const std::string &ids, long chanid, uint32_t login_ms)
+    {
+        return router_cmd_pipeline::_()->post_start(ids, chanid, 0,
+            boost::bind(&mock_device_mgr::play, &g_devices, ids, chanid, login_ms),
+            boost::bind(&mock_device_mgr::drop, &g_devices, ids, chanid));
+    }
+
+    std::string fast_ids(uint32_t i)
+    {
+        char buf[32];
+        ::snprintf(buf, sizeof(buf), "cam_%03u", i);
+        return buf;
+    }
+}
+
+int main()
+{
+    uint32_t errors = 0;
+    router_cmd_pipeline::_()->start(SHARDS, START_DEADLINE_MS);
+    ptime_t begin = now();
+
+    //豸ռסڷƬ
+    post_play(SLOW_IDS, 0, SLOW_LOGIN_MS);
+    post_play(SLOW_IDS, 1, FAST_LOGIN_MS);
+    post_play(SLOW_IDS, 2, FAST_LOGIN_MS);
+    router_cmd_pipeline::_()->post_stop(SLOW_IDS, 1, 0, boost::bind(&mock_device_mgr::stop, &g_devices, std::string(SLOW_IDS), 1));
+
+    uint32_t slow_shard = shard_of(SLOW_IDS);
+    uint32_t same_shard = 0;
+    for (uint32_t i = 0; i < FAST_DEVICES; ++i)
+    {
+        post_play(fast_ids(i), 0, FAST_LOGIN_MS);
+        if (shard_of(fast_ids(i)) == slow_shard)
+        {
+            ++same_shard;
+        }
+    }
+    router_cmd_pipeline::_()->post_global(boost::bind(&mock_device_mgr::stop_all, &g_devices));
+
+    //ͣ豸¼ڼ䵽ͬ·Ŷеĵ㲥ȡ
+    if (!g_devices.is_dropped(SLOW_IDS, 1))
+    {
+        printf("ERROR: queued play of %s#1 was not cancelled by the stop\n", SLOW_IDS);
+        ++errors;
+    }
+
+    //Ƭĵ㲥豸Ӱ
+    boost::this_thread::sleep(boost::posix_time::milliseconds(1000));
+    uint32_t fast_done = 0;
+    uint32_t max_fast_ms = 0;
+    for (uint32_t i = 0; i < FAST_DEVICES; ++i)
+    {
+        if (shard_of(fast_ids(i)) == slow_shard)
+        {
+            continue;
+        }
+        ptime_t t = g_devices.played(fast_ids(i), 0);
+        if (t.is_not_a_date_time())
+        {
+            printf("ERROR: %s on shard %u not played within 1 s\n", fast_ids(i).c_str(), shard_of(fast_ids(i)));
+            ++errors;
+            continue;
+        }
+        uint32_t ms = (uint32_t)(t - begin).total_milliseconds();
+        if (ms > max_fast_ms)
+        {
+            max_fast_ms = ms;
+        }
+        ++fast_done;
+    }
+
+    //豸¼ɡִ
+    boost::this_thread::sleep(boost::posix_time::milliseconds(SLOW_LOGIN_MS));
+    std::vector<router_cmd_shard_info> infos;
+    router_cmd_pipeline::_()->query(infos);
+    router_cmd_pipeline::_()->stop();
+
+    uint64_t coalesced = 0;
+    uint64_t expired = 0;
+    for (size_t i = 0; i < infos.size(); ++i)
+    {
+        coalesced += infos[i].coalesced;
+        expired += infos[i].expired;
+        printf("shard %u: executed %llu, coalesced %llu, expired %llu, max wait %u ms\n", (uint32_t)i,
+            (unsigned long long)infos[i].executed, (unsigned long long)infos[i].coalesced,
+            (unsigned long long)infos[i].expired, infos[i].max_wait_ms);
+    }
+
+    //ͬƬ5¼֮ĵ㲥(豸#2ͬƬ豸)3
+    uint32_t expired_played = 0;
+    for (uint32_t i = 0; i < FAST_DEVICES; ++i)
+    {
+        if (shard_of(fast_ids(i)) == slow_shard && !g_devices.is_dropped(fast_ids(i), 0))
+        {
+            ++expired_played;
+        }
+    }
+    if (!g_devices.is_dropped(SLOW_IDS, 2))
+    {
+        ++expired_played;
+    }
+    if (1 != coalesced || same_shard + 1 != expired || 0 != expired_played)
+    {
+        printf("ERROR: coalesced %llu (expect 1), expired %llu (expect %u), expired but played %u\n",
+            (unsigned long long)coalesced, (unsigned long long)expired, same_shard + 1, expired_played);
+        ++errors;
+    }
+
+    //¼ = 豸#0 + ƬĿ豸Щ㲥ִ֮һ
+    uint32_t expect_logins = 1 + (FAST_DEVICES - same_shard);
+    if (1 != g_devices.stop_all_ || expect_logins != g_devices.logins_ || expect_logins != g_devices.streams_at_stop_all_ || 1 != g_devices.stops_)
+    {
+        printf("ERROR: stop_all %u (expect 1), logins %u, streams at stop_all %u (expect %u), stops %u (expect 1)\n",
+            g_devices.stop_all_, g_devices.logins_, g_devices.streams_at_stop_all_, expect_logins, g_devices.stops_);
+        ++errors;
+    }
+
+    printf("%u/%u devices on other shards played, slowest after %u ms; %u devices shared the %u ms login shard\n",
+        fast_done, FAST_DEVICES - same_shard, max_fast_ms, same_shard, SLOW_LOGIN_MS);
+    printf("%s\n", (0 == errors) ? "PASS" : "FAIL");
+    return (0 == errors) ? 0 : 1;
+}
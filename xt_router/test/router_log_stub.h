@@ -0,0 +1,13 @@
+//־׮ͨ-includeXTRouterLog.h־web
+#ifndef ROUTER_LOG_STUB_H
+#define ROUTER_LOG_STUB_H
+
+#define XTROUTERLOG_H
+#define DBLOGINFO "db_info"
+
+enum { ll_debug = 0, ll_info, ll_warn, ll_error };
+
+#define DEBUG_LOG(logger_name, loglevel, fmt, ...) do {} while (0)
+#define WRITE_LOG(logger_name, loglevel, fmt, ...) do {} while (0)
+
+#endif //ROUTER_LOG_STUB_H
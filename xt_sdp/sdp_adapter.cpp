@@ -0,0 +1,565 @@
+#include "sdp_adapter.h"
+
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace xt_sdp;
+
+namespace
+{
+    enum
+    {
+        built_origin = 1 << 0,
+        built_name = 1 << 1,
+        built_information = 1 << 2,
+        built_connection = 1 << 3,
+        built_bandwidths = 1 << 4,
+        built_times = 1 << 5,
+        built_media = 1 << 6,
+        built_protocol = 1 << 7,
+        built_formats = 1 << 8,
+        built_connections = 1 << 9,
+        built_codecs = 1 << 10
+    };
+
+    // forward-only scanner over one record value
+    class cursor_t
+    {
+    public:
+        explicit cursor_t(const str_ref_t& ref)
+            : pos_(ref.data()),
+            end_(ref.data() + ref.size())
+        {}
+
+        bool eof() const { return pos_ >= end_; }
+        char peek() const { return eof() ? 0 : *pos_; }
+        void skip() { if (!eof()) ++pos_; }
+
+        void skip_blank()
+        {
+            while (!eof() && (*pos_ == ' ' || *pos_ == '\t'))
+            {
+                ++pos_;
+            }
+        }
+
+        // up to the next blank
+        std::string token()
+        {
+            const char* anchor = pos_;
+            while (!eof() && *pos_ != ' ' && *pos_ != '\t')
+            {
+                ++pos_;
+            }
+            return std::string(anchor, pos_);
+        }
+
+        // up to c or the end, c is left in place
+        std::string until(char c)
+        {
+            const char* anchor = pos_;
+            while (!eof() && *pos_ != c)
+            {
+                ++pos_;
+            }
+            return std::string(anchor, pos_);
+        }
+
+        std::string rest()
+        {
+            const char* anchor = pos_;
+            pos_ = end_;
+            return std::string(anchor, end_);
+        }
+
+        uint64_t to_uint64()
+        {
+            uint64_t num = 0;
+            while (!eof() && *pos_ >= '0' && *pos_ <= '9')
+            {
+                num = num * 10 + (*pos_ - '0');
+                ++pos_;
+            }
+            return num;
+        }
+
+        // parse_buffer_t::integer: optional sign then digits, false without digits
+        bool integer(int& num)
+        {
+            int sign = 1;
+            if (!eof() && (*pos_ == '-' || *pos_ == '+'))
+            {
+                sign = (*pos_ == '-') ? -1 : 1;
+                ++pos_;
+            }
+            if (eof() || *pos_ < '0' || *pos_ > '9')
+            {
+                num = 0;
+                return false;
+            }
+            num = sign * static_cast<int>(to_uint64());
+            return true;
+        }
+
+        // r= times may carry a d/h/m/s unit
+        int typed_time()
+        {
+            int num = 0;
+            integer(num);
+            int64_t v = num;
+            switch (peek())
+            {
+            case 'd': v *= 24 * 3600; skip(); break;
+            case 'h': v *= 3600; skip(); break;
+            case 'm': v *= 60; skip(); break;
+            case 's': skip(); break;
+            default: break;
+            }
+            return static_cast<int>(v);
+        }
+
+    private:
+        const char* pos_;
+        const char* end_;
+    };
+
+    addr_type to_addr_type(const std::string& s)
+    {
+        if (s == "IP4")
+        {
+            return ipv4;
+        }
+        if (s == "IP6")
+        {
+            return ipv6;
+        }
+        return static_cast<addr_type>(0);
+    }
+
+    // c=IN IP4 <address>[/ttl][/count], like connection_t::parse plus the
+    // medium's address expansion; count is 0 when absent
+    sdp_session_t::connection_t parse_connection(const str_ref_t& value, int& count)
+    {
+        cursor_t c(value);
+        c.token();
+        c.skip_blank();
+        addr_type type = to_addr_type(c.token());
+        c.skip();
+
+        sdp_session_t::connection_t con(type, c.until('/'));
+        if (ipv4 == type && '/' == c.peek())
+        {
+            c.skip();
+            int ttl = 0;
+            c.integer(ttl);
+            con.ttl() = static_cast<unsigned long>(ttl);
+        }
+
+        count = 0;
+        if ('/' == c.peek())
+        {
+            c.skip();
+            c.integer(count);
+        }
+        return con;
+    }
+
+    void add_connections(std::list<sdp_session_t::connection_t>& out, const str_ref_t& value)
+    {
+        int count = 0;
+        out.push_back(parse_connection(value, count));
+
+        const sdp_session_t::connection_t con = out.back();
+        const std::string& addr = con.address();
+        if (count > SDP_ADAPTER_MAX_ADDRESSES)
+        {
+            count = SDP_ADAPTER_MAX_ADDRESSES;
+        }
+        if (count < 2 || addr.empty())
+        {
+            return;
+        }
+
+        size_t i = addr.find_last_of(".:");
+        if (std::string::npos == i)
+        {
+            return;
+        }
+        std::string before(addr, 0, i + 1);
+        const char* last = addr.c_str() + i + 1;
+        bool v4 = ('.' == addr[i]);
+        // ipv6 takes at most 8 hex digits, like the legacy helper
+        unsigned long after = v4 ? strtoul(last, 0, 10) : strtoul(std::string(last).substr(0, 8).c_str(), 0, 16);
+        for (int k = 1; k < count; ++k)
+        {
+            std::ostringstream num;
+            if (v4)
+            {
+                num << (after + k);
+            }
+            else
+            {
+                num << std::hex << (after + k);
+            }
+            out.push_back(con);
+            out.back().set_address(before + num.str(), con.address_type());
+        }
+    }
+
+    void add_bandwidths(std::list<sdp_session_t::bandwidth_t>& out, const sdp_line_ref_t* line)
+    {
+        for (; line; line = line->next)
+        {
+            cursor_t c(line->value);
+            std::string modifier = c.until(':');
+            if (c.eof())
+            {
+                continue;
+            }
+            c.skip();
+            int kbs = 0;
+            c.integer(kbs);
+            out.push_back(sdp_session_t::bandwidth_t(modifier, static_cast<unsigned long>(kbs)));
+        }
+    }
+
+    void add_values(std::list<std::string>& out, const sdp_attr_ref_t* attr, const std::string& key)
+    {
+        for (; attr; attr = attr->next)
+        {
+            if (attr->key == key)
+            {
+                out.push_back(attr->value.str());
+            }
+        }
+    }
+
+    // a=fmtp:<payload> <parameters> for the codec's payload, first match wins
+    void assign_format_parameters(sdp_session_t::codec_t& codec, const std::list<std::string>& fmtps)
+    {
+        for (std::list<std::string>::const_iterator i = fmtps.begin(); i != fmtps.end(); ++i)
+        {
+            cursor_t c(str_ref_t(i->data(), i->size()));
+            int payload = 0;
+            if (c.integer(payload) && payload == codec.payload())
+            {
+                while (!c.eof() && strchr(" \t\r\n", c.peek()))
+                {
+                    c.skip();
+                }
+                codec.parameters() = c.rest();
+                break;
+            }
+        }
+    }
+}
+
+sdp_session_adapter_t::sdp_session_adapter_t(const sdp_view_t& view)
+    : view_(view),
+    built_(0)
+{}
+
+const sdp_session_adapter_t::origin_t& sdp_session_adapter_t::origin() const
+{
+    if (!(built_ & built_origin) && !view_.origin().empty())
+    {
+        cursor_t c(view_.origin());
+        std::string user = c.until(' ');
+        c.skip();
+        uint64_t session_id = c.to_uint64();
+        c.until(' ');
+        c.skip();
+        uint64_t version = c.to_uint64();
+        c.until(' ');
+        c.skip();
+        c.token();
+        c.skip_blank();
+        addr_type type = to_addr_type(c.token());
+        c.skip();
+        origin_ = origin_t(user, session_id, version, type, c.rest());
+    }
+    built_ |= built_origin;
+    return origin_;
+}
+
+const std::string& sdp_session_adapter_t::name() const
+{
+    if (!(built_ & built_name))
+    {
+        name_ = view_.name().str();
+        built_ |= built_name;
+    }
+    return name_;
+}
+
+const std::string& sdp_session_adapter_t::information() const
+{
+    if (!(built_ & built_information))
+    {
+        information_ = view_.information().str();
+        built_ |= built_information;
+    }
+    return information_;
+}
+
+const sdp_session_adapter_t::connection_t& sdp_session_adapter_t::connection() const
+{
+    if (!(built_ & built_connection))
+    {
+        if (!view_.connection().empty())
+        {
+            int count = 0;
+            connection_ = parse_connection(view_.connection(), count);
+        }
+        built_ |= built_connection;
+    }
+    return connection_;
+}
+
+const std::list<sdp_session_adapter_t::bandwidth_t>& sdp_session_adapter_t::bandwidths() const
+{
+    if (!(built_ & built_bandwidths))
+    {
+        add_bandwidths(bandwidths_, view_.bandwidths());
+        built_ |= built_bandwidths;
+    }
+    return bandwidths_;
+}
+
+const std::list<sdp_session_adapter_t::time_t>& sdp_session_adapter_t::times() const
+{
+    if (!(built_ & built_times))
+    {
+        for (const sdp_time_ref_t* t = view_.times(); t; t = t->next)
+        {
+            cursor_t c(t->value);
+            unsigned long start = static_cast<unsigned long>(c.to_uint64());
+            c.skip_blank();
+            unsigned long stop = static_cast<unsigned long>(c.to_uint64());
+            times_.push_back(time_t(start, stop));
+
+            for (const sdp_line_ref_t* r = t->repeats; r; r = r->next)
+            {
+                cursor_t rc(r->value);
+                unsigned long interval = static_cast<unsigned long>(rc.typed_time());
+                rc.skip_blank();
+                unsigned long duration = static_cast<unsigned long>(rc.typed_time());
+                std::list<int> offsets;
+                for (rc.skip_blank(); !rc.eof(); rc.skip_blank())
+                {
+                    offsets.push_back(rc.typed_time());
+                    rc.token();
+                }
+                times_.back().add_repeat(time_t::repeat_t(interval, duration, offsets));
+            }
+        }
+        built_ |= built_times;
+    }
+    return times_;
+}
+
+const sdp_session_adapter_t::medium_container_t& sdp_session_adapter_t::media() const
+{
+    if (!(built_ & built_media))
+    {
+        for (const sdp_medium_ref_t* m = view_.media(); m; m = m->next())
+        {
+            media_.push_back(medium_t(this, m));
+        }
+        built_ |= built_media;
+    }
+    return media_;
+}
+
+const std::list<std::string>& sdp_session_adapter_t::get_values(const std::string& key) const
+{
+    static const std::list<std::string> empty;
+    if (!view_.find_attribute(key.c_str()))
+    {
+        return empty;
+    }
+
+    std::map<std::string, std::list<std::string> >::iterator i = values_.find(key);
+    if (i == values_.end())
+    {
+        i = values_.insert(std::make_pair(key, std::list<std::string>())).first;
+        add_values(i->second, view_.attributes(), key);
+    }
+    return i->second;
+}
+
+sdp_session_adapter_t::medium_t::medium_t(const sdp_session_adapter_t* session, const sdp_medium_ref_t* medium)
+    : session_(session),
+    medium_(medium),
+    built_(0)
+{}
+
+const std::string& sdp_session_adapter_t::medium_t::name() const
+{
+    if (!(built_ & built_name))
+    {
+        name_ = medium_->name().str();
+        built_ |= built_name;
+    }
+    return name_;
+}
+
+const std::string& sdp_session_adapter_t::medium_t::protocol() const
+{
+    if (!(built_ & built_protocol))
+    {
+        protocol_ = medium_->protocol().str();
+        built_ |= built_protocol;
+    }
+    return protocol_;
+}
+
+const std::list<std::string>& sdp_session_adapter_t::medium_t::formats() const
+{
+    if (!(built_ & built_formats))
+    {
+        for (size_t i = 0; i < medium_->format_count(); ++i)
+        {
+            formats_.push_back(medium_->formats()[i].str());
+        }
+        built_ |= built_formats;
+    }
+    return formats_;
+}
+
+const std::string& sdp_session_adapter_t::medium_t::information() const
+{
+    if (!(built_ & built_information))
+    {
+        information_ = medium_->information().str();
+        built_ |= built_information;
+    }
+    return information_;
+}
+
+const std::list<sdp_session_adapter_t::bandwidth_t>& sdp_session_adapter_t::medium_t::bandwidths() const
+{
+    if (!(built_ & built_bandwidths))
+    {
+        add_bandwidths(bandwidths_, medium_->bandwidths());
+        built_ |= built_bandwidths;
+    }
+    return bandwidths_;
+}
+
+const std::list<sdp_session_adapter_t::connection_t> sdp_session_adapter_t::medium_t::connections() const
+{
+    std::list<connection_t> connections = get_medium_connections();
+    if (connections.empty() && session_->is_connection())
+    {
+        connections.push_back(session_->connection());
+    }
+    return connections;
+}
+
+const std::list<sdp_session_adapter_t::connection_t>& sdp_session_adapter_t::medium_t::get_medium_connections() const
+{
+    if (!(built_ & built_connections))
+    {
+        for (const sdp_line_ref_t* line = medium_->connections(); line; line = line->next)
+        {
+            add_connections(connections_, line->value);
+        }
+        built_ |= built_connections;
+    }
+    return connections_;
+}
+
+// same steps as sdp_session_t::medium_t::codecs(): rtpmap entries by payload,
+// then static payload types, both in m= format order with their fmtp
+const sdp_session_adapter_t::medium_t::codec_container_t& sdp_session_adapter_t::medium_t::codecs() const
+{
+    if (!(built_ & built_codecs))
+    {
+        built_ |= built_codecs;
+
+        const std::list<std::string>& fmtps = get_values("fmtp");
+        std::map<int, codec_t> rtp_map;
+        const std::list<std::string>& rtpmaps = get_values("rtpmap");
+        for (std::list<std::string>::const_iterator i = rtpmaps.begin(); i != rtpmaps.end(); ++i)
+        {
+            // <payload> <name>[/<rate>[/<encoding parameters>]]
+            cursor_t c(str_ref_t(i->data(), i->size()));
+            int payload = 0;
+            if (!c.integer(payload))
+            {
+                continue;
+            }
+            while (!c.eof() && strchr(" \t\r\n", c.peek()))
+            {
+                c.skip();
+            }
+            std::string name = c.until('/');
+            int rate = 0;
+            std::string encoding;
+            if (!c.eof())
+            {
+                c.skip();
+                if (!c.integer(rate))
+                {
+                    rtp_map.erase(payload);
+                    continue;
+                }
+                c.until('/');
+                if (!c.eof())
+                {
+                    c.skip();
+                    encoding = c.rest();
+                }
+            }
+
+            codec_t codec(name, payload, static_cast<unsigned long>(rate), "", encoding);
+            assign_format_parameters(codec, fmtps);
+            rtp_map[payload] = codec;
+        }
+
+        const std::list<std::string>& fmts = formats();
+        for (std::list<std::string>::const_iterator i = fmts.begin(); i != fmts.end(); ++i)
+        {
+            int key = atoi(i->c_str());
+            std::map<int, codec_t>::const_iterator ri = rtp_map.find(key);
+            if (ri != rtp_map.end())
+            {
+                codecs_.push_back(ri->second);
+                continue;
+            }
+
+            codec_t::codec_map_t& statics = codec_t::get_static_codecs();
+            codec_t::codec_map_t::const_iterator si = statics.find(key);
+            if (si != statics.end())
+            {
+                codec_t codec(si->second);
+                assign_format_parameters(codec, fmtps);
+                codecs_.push_back(codec);
+            }
+        }
+    }
+    return codecs_;
+}
+
+bool sdp_session_adapter_t::medium_t::exists(const std::string& key) const
+{
+    return medium_->exists(key.c_str());
+}
+
+const std::list<std::string>& sdp_session_adapter_t::medium_t::get_values(const std::string& key) const
+{
+    if (!medium_->find_attribute(key.c_str()))
+    {
+        return session_->get_values(key);
+    }
+
+    std::map<std::string, std::list<std::string> >::iterator i = values_.find(key);
+    if (i == values_.end())
+    {
+        i = values_.insert(std::make_pair(key, std::list<std::string>())).first;
+        add_values(i->second, medium_->attributes(), key);
+    }
+    return i->second;
+}
@@ -0,0 +1,124 @@
+#ifndef _SDP_ADAPTER_H_INCLUDED
+#define _SDP_ADAPTER_H_INCLUDED
+
+#include <list>
+#include <map>
+#include <string>
+#include "sdp.h"
+#include "sdp_view.h"
+
+// c=<address>/<ttl>/<count> expands to at most this many addresses
+#define SDP_ADAPTER_MAX_ADDRESSES   256
+
+namespace xt_sdp
+{
+    // read-only sdp_session_t over an sdp_view_t: accessor names and return
+    // types follow sdp_session_t and sdp_session_t::medium_t, every field is
+    // built from the view records on first access and cached. The view and
+    // its buffer must outlive the adapter, and the view must not be parsed
+    // again or have media erased while the adapter is in use.
+    //
+    // Malformed numbers read as 0 and b= lines without ':' are skipped where
+    // sdp_session_t::parse would fail the whole message. Unlike the legacy
+    // parser, a c= address count is capped at SDP_ADAPTER_MAX_ADDRESSES.
+    class sdp_session_adapter_t
+    {
+    public:
+        typedef sdp_session_t::origin_t origin_t;
+        typedef sdp_session_t::connection_t connection_t;
+        typedef sdp_session_t::bandwidth_t bandwidth_t;
+        typedef sdp_session_t::time_t time_t;
+        typedef sdp_session_t::codec_t codec_t;
+
+        class medium_t
+        {
+        public:
+            typedef std::list<codec_t> codec_container_t;
+
+            const std::string& name() const;
+            int port() const { return static_cast<int>(medium_->port()); }
+            int multicast() const { return static_cast<int>(medium_->multicast()); }
+            const std::string& protocol() const;
+            const std::list<std::string>& formats() const;
+            const std::string& information() const;
+            const std::list<bandwidth_t>& bandwidths() const;
+
+            // medium c= lines, the session one when there are none
+            const std::list<connection_t> connections() const;
+            // medium c= lines with /count expanded
+            const std::list<connection_t>& get_medium_connections() const;
+
+            // unlike sdp_session_t::medium_t::codecs() the formats and the
+            // rtpmap/fmtp attributes are left in place
+            const codec_container_t& codecs() const;
+
+            bool exists(const std::string& key) const;
+            const std::list<std::string>& get_values(const std::string& key) const;
+
+            const sdp_medium_ref_t& ref() const { return *medium_; }
+
+        private:
+            friend class sdp_session_adapter_t;
+
+            medium_t(const sdp_session_adapter_t* session, const sdp_medium_ref_t* medium);
+
+            const sdp_session_adapter_t* session_;
+            const sdp_medium_ref_t* medium_;
+
+            mutable unsigned built_;
+            mutable std::string name_;
+            mutable std::string protocol_;
+            mutable std::string information_;
+            mutable std::list<std::string> formats_;
+            mutable std::list<bandwidth_t> bandwidths_;
+            mutable std::list<connection_t> connections_;
+            mutable codec_container_t codecs_;
+            mutable std::map<std::string, std::list<std::string> > values_;
+        };
+
+        typedef std::list<medium_t> medium_container_t;
+
+        explicit sdp_session_adapter_t(const sdp_view_t& view);
+
+        int version() const { return view_.version(); }
+        const origin_t& origin() const;
+        const std::string& name() const;
+        const std::string& information() const;
+
+        const connection_t& connection() const;
+        bool is_connection() const { return !connection().address().empty(); }
+
+        const std::list<bandwidth_t>& bandwidths() const;
+        const std::list<time_t>& times() const;
+
+        // media not erased from the view when the adapter first lists them
+        const medium_container_t& media() const;
+
+        bool exists(const std::string& key) const { return view_.exists(key.c_str()); }
+        const std::list<std::string>& get_values(const std::string& key) const;
+
+        const sdp_view_t& view() const { return view_; }
+
+        // escape hatch for code that needs the owning object model, a full
+        // legacy parse, see sdp_view_t::to_session
+        void to_session(sdp_session_t& session) const { view_.to_session(session); }
+
+    private:
+        sdp_session_adapter_t(const sdp_session_adapter_t&);
+        sdp_session_adapter_t& operator=(const sdp_session_adapter_t&);
+
+        const sdp_view_t& view_;
+
+        mutable unsigned built_;
+        mutable origin_t origin_;
+        mutable std::string name_;
+        mutable std::string information_;
+        mutable connection_t connection_;
+        mutable std::list<bandwidth_t> bandwidths_;
+        mutable std::list<time_t> times_;
+        mutable medium_container_t media_;
+        mutable std::map<std::string, std::list<std::string> > values_;
+    };
+}
+
+#endif  //_SDP_ADAPTER_H_INCLUDED
@@ -0,0 +1,610 @@
+#include "sdp_view.h"
+#include "sdp.h"
+#include "parse_buffer.h"
+
+#include <ostream>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace xt_sdp;
+
+namespace
+{
+    const char* find_char(const char* pos, const char* end, char c)
+    {
+        const char* p = static_cast<const char*>(memchr(pos, c, end - pos));
+        return p ? p : end;
+    }
+
+    const char* skip_blank(const char* pos, const char* end)
+    {
+        while (pos < end && (*pos == ' ' || *pos == '\t'))
+        {
+            ++pos;
+        }
+        return pos;
+    }
+
+    const char* skip_token(const char* pos, const char* end)
+    {
+        while (pos < end && *pos != ' ' && *pos != '\t')
+        {
+            ++pos;
+        }
+        return pos;
+    }
+
+    const char* skip_digits(const char* pos, const char* end)
+    {
+        while (pos < end && *pos >= '0' && *pos <= '9')
+        {
+            ++pos;
+        }
+        return pos;
+    }
+
+    const size_t arena_align = 8;
+}
+
+bool str_ref_t::equals(const char* s, size_t len) const
+{
+    return (size_ == len) && (0 == len || 0 == memcmp(data_, s, len));
+}
+
+bool str_ref_t::operator==(const char* s) const
+{
+    return equals(s, strlen(s));
+}
+
+unsigned long str_ref_t::to_ulong() const
+{
+    size_t i = 0;
+    while (i < size_ && (data_[i] == ' ' || data_[i] == '\t'))
+    {
+        ++i;
+    }
+
+    unsigned long num = 0;
+    for (; i < size_ && data_[i] >= '0' && data_[i] <= '9'; ++i)
+    {
+        num = num * 10 + (data_[i] - '0');
+    }
+    return num;
+}
+
+void str_ref_t::copy(char* dst, size_t n) const
+{
+    size_t len = size_ < n ? size_ : n;
+    if (len > 0)
+    {
+        memcpy(dst, data_, len);
+    }
+    if (len < n)
+    {
+        memset(dst + len, 0, n - len);
+    }
+}
+
+std::ostream& xt_sdp::operator<<(std::ostream& s, const str_ref_t& ref)
+{
+    if (!ref.empty())
+    {
+        s.write(ref.data(), ref.size());
+    }
+    return s;
+}
+
+sdp_arena_t::sdp_arena_t()
+    : inline_used_(0),
+    blocks_(0)
+{}
+
+sdp_arena_t::~sdp_arena_t()
+{
+    reset();
+}
+
+void* sdp_arena_t::alloc(size_t size)
+{
+    size = (size + arena_align - 1) & ~(arena_align - 1);
+
+    if (SDP_ARENA_INLINE_SIZE - inline_used_ >= size)
+    {
+        void* p = inline_.buf + inline_used_;
+        inline_used_ += size;
+        return p;
+    }
+
+    if (blocks_ && blocks_->size - blocks_->used >= size)
+    {
+        void* p = reinterpret_cast<char*>(blocks_ + 1) + blocks_->used;
+        blocks_->used += size;
+        return p;
+    }
+
+    size_t block_size = size > SDP_ARENA_BLOCK_SIZE ? size : SDP_ARENA_BLOCK_SIZE;
+    block_t* block = static_cast<block_t*>(malloc(sizeof(block_t) + block_size));
+    if (!block)
+    {
+        return 0;
+    }
+    block->next = blocks_;
+    block->size = block_size;
+    block->used = size;
+    blocks_ = block;
+    return block + 1;
+}
+
+void sdp_arena_t::reset()
+{
+    while (blocks_)
+    {
+        block_t* next = blocks_->next;
+        free(blocks_);
+        blocks_ = next;
+    }
+    inline_used_ = 0;
+}
+
+const str_ref_t& sdp_medium_ref_t::connection_address() const
+{
+    return connection_.empty() ? view_->connection_ : connection_;
+}
+
+const sdp_attr_ref_t* sdp_medium_ref_t::find_attribute(const char* key) const
+{
+    return sdp_view_t::find(attrs_, key);
+}
+
+bool sdp_medium_ref_t::exists(const char* key) const
+{
+    return find_attribute(key) || view_->exists(key);
+}
+
+str_ref_t sdp_medium_ref_t::get_value(const char* key) const
+{
+    const sdp_attr_ref_t* attr = find_attribute(key);
+    return attr ? attr->value : view_->get_value(key);
+}
+
+const sdp_medium_ref_t* sdp_medium_ref_t::next() const
+{
+    const sdp_medium_ref_t* m = next_;
+    while (m && m->erased_)
+    {
+        m = m->next_;
+    }
+    return m;
+}
+
+sdp_view_t::sdp_view_t()
+{
+    clear();
+}
+
+void sdp_view_t::clear()
+{
+    arena_.reset();
+    buf_ = 0;
+    end_ = 0;
+    header_end_ = 0;
+    version_ = 0;
+    origin_ = str_ref_t();
+    name_ = str_ref_t();
+    information_ = str_ref_t();
+    connection_ = str_ref_t();
+    connection_line_ = str_ref_t();
+    bandwidths_ = 0;
+    bandwidths_tail_ = 0;
+    times_ = 0;
+    times_tail_ = 0;
+    repeats_tail_ = 0;
+    attrs_ = 0;
+    attrs_tail_ = 0;
+    media_ = 0;
+    media_tail_ = 0;
+    media_count_ = 0;
+    erased_ = false;
+}
+
+// same line rules as sdp_session_t::parse: records end at '\n', any '\r'
+// before it is dropped, unknown records are skipped and a NUL ends the SDP
+bool sdp_view_t::parse(const char* buf, size_t len)
+{
+    clear();
+    if (!buf)
+    {
+        return false;
+    }
+
+    buf_ = buf;
+    end_ = buf + len;
+    const char* nul = static_cast<const char*>(memchr(buf, '\0', len));
+    if (nul)
+    {
+        end_ = nul;
+    }
+    header_end_ = end_;
+
+    // r= lines belong to the t= or r= line right before them
+    bool after_time = false;
+    const char* pos = buf_;
+    while (pos < end_)
+    {
+        const char* line = pos;
+        const char* eol = find_char(line, end_, '\n');
+        pos = (eol < end_) ? eol + 1 : end_;
+
+        bool repeat_allowed = after_time;
+        after_time = false;
+
+        const char* content_end = find_char(line, eol, '\r');
+        if (content_end - line < 2 || line[1] != '=')
+        {
+            continue;
+        }
+
+        str_ref_t value(line + 2, content_end - line - 2);
+        sdp_medium_ref_t* medium = media_tail_;
+        switch (line[0])
+        {
+        case 'v':
+            if (!medium)
+            {
+                version_ = static_cast<int>(value.to_ulong());
+            }
+            break;
+        case 'o':
+            if (!medium)
+            {
+                origin_ = value;
+            }
+            break;
+        case 's':
+            if (!medium)
+            {
+                name_ = value;
+            }
+            break;
+        case 'i':
+            (medium ? medium->information_ : information_) = value;
+            break;
+        case 'c':
+            if (medium)
+            {
+                if (medium->connection_.empty())
+                {
+                    medium->connection_ = parse_connection(value);
+                }
+                if (!add_line(value, medium->connections_, medium->connections_tail_))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                connection_ = parse_connection(value);
+                connection_line_ = value;
+            }
+            break;
+        case 'b':
+            if (!(medium ? add_line(value, medium->bandwidths_, medium->bandwidths_tail_)
+                : add_line(value, bandwidths_, bandwidths_tail_)))
+            {
+                return false;
+            }
+            break;
+        case 't':
+            if (!medium)
+            {
+                if (!add_time(value))
+                {
+                    return false;
+                }
+                after_time = true;
+            }
+            break;
+        case 'r':
+            if (!medium && repeat_allowed)
+            {
+                if (!add_repeat(value))
+                {
+                    return false;
+                }
+                after_time = true;
+            }
+            break;
+        case 'a':
+            if (!(medium ? add_attribute(value, medium->attrs_, medium->attrs_tail_)
+                : add_attribute(value, attrs_, attrs_tail_)))
+            {
+                return false;
+            }
+            break;
+        case 'm':
+            if (!parse_medium(value, line))
+            {
+                return false;
+            }
+            break;
+        default:
+            break;
+        }
+
+        if (media_tail_)
+        {
+            sdp_medium_ref_t* m = media_tail_;
+            m->raw_ = str_ref_t(m->raw_.data(), pos - m->raw_.data());
+        }
+    }
+
+    return true;
+}
+
+bool sdp_view_t::parse_medium(const str_ref_t& value, const char* line)
+{
+    sdp_medium_ref_t* m = make<sdp_medium_ref_t>();
+    if (!m)
+    {
+        return false;
+    }
+
+    const char* pos = value.data();
+    const char* end = pos + value.size();
+
+    const char* anchor = pos;
+    pos = find_char(pos, end, ' ');
+    m->name_ = str_ref_t(anchor, pos - anchor);
+    pos = skip_blank(pos, end);
+
+    anchor = pos;
+    pos = skip_digits(pos, end);
+    m->port_ = str_ref_t(anchor, pos - anchor).to_ulong();
+    m->multicast_ = 1;
+    if (pos < end && *pos == '/')
+    {
+        anchor = ++pos;
+        pos = skip_digits(pos, end);
+        m->multicast_ = str_ref_t(anchor, pos - anchor).to_ulong();
+    }
+    pos = skip_blank(pos, end);
+
+    anchor = pos;
+    pos = skip_token(pos, end);
+    m->protocol_ = str_ref_t(anchor, pos - anchor);
+
+    size_t count = 0;
+    for (const char* p = skip_blank(pos, end); p < end; p = skip_blank(skip_token(p, end), end))
+    {
+        ++count;
+    }
+    if (count > 0)
+    {
+        m->formats_ = static_cast<str_ref_t*>(arena_.alloc(count * sizeof(str_ref_t)));
+        if (!m->formats_)
+        {
+            return false;
+        }
+        for (pos = skip_blank(pos, end); pos < end; pos = skip_blank(pos, end))
+        {
+            anchor = pos;
+            pos = skip_token(pos, end);
+            new (&m->formats_[m->format_count_++]) str_ref_t(anchor, pos - anchor);
+        }
+    }
+
+    m->view_ = this;
+    m->raw_ = str_ref_t(line, 0);
+    if (media_tail_)
+    {
+        media_tail_->next_ = m;
+    }
+    else
+    {
+        media_ = m;
+        header_end_ = line;
+    }
+    media_tail_ = m;
+    ++media_count_;
+    return true;
+}
+
+bool sdp_view_t::add_attribute(const str_ref_t& value, sdp_attr_ref_t*& head, sdp_attr_ref_t*& tail)
+{
+    sdp_attr_ref_t* attr = make<sdp_attr_ref_t>();
+    if (!attr)
+    {
+        return false;
+    }
+
+    const char* pos = value.data();
+    const char* end = pos + value.size();
+    const char* colon = find_char(pos, end, ':');
+    attr->key = str_ref_t(pos, colon - pos);
+    if (colon < end)
+    {
+        attr->value = str_ref_t(colon + 1, end - colon - 1);
+    }
+
+    if (tail)
+    {
+        tail->next = attr;
+    }
+    else
+    {
+        head = attr;
+    }
+    tail = attr;
+    return true;
+}
+
+bool sdp_view_t::add_line(const str_ref_t& value, sdp_line_ref_t*& head, sdp_line_ref_t*& tail)
+{
+    sdp_line_ref_t* line = make<sdp_line_ref_t>();
+    if (!line)
+    {
+        return false;
+    }
+    line->value = value;
+
+    if (tail)
+    {
+        tail->next = line;
+    }
+    else
+    {
+        head = line;
+    }
+    tail = line;
+    return true;
+}
+
+bool sdp_view_t::add_time(const str_ref_t& value)
+{
+    sdp_time_ref_t* t = make<sdp_time_ref_t>();
+    if (!t)
+    {
+        return false;
+    }
+    t->value = value;
+
+    if (times_tail_)
+    {
+        times_tail_->next = t;
+    }
+    else
+    {
+        times_ = t;
+    }
+    times_tail_ = t;
+    repeats_tail_ = 0;
+    return true;
+}
+
+bool sdp_view_t::add_repeat(const str_ref_t& value)
+{
+    sdp_line_ref_t* line = make<sdp_line_ref_t>();
+    if (!line)
+    {
+        return false;
+    }
+    line->value = value;
+
+    if (repeats_tail_)
+    {
+        repeats_tail_->next = line;
+    }
+    else
+    {
+        times_tail_->repeats = line;
+    }
+    repeats_tail_ = line;
+    return true;
+}
+
+// c=IN IP4 <address>[/ttl[/count]]
+str_ref_t sdp_view_t::parse_connection(const str_ref_t& value)
+{
+    const char* pos = value.data();
+    const char* end = pos + value.size();
+
+    pos = skip_blank(skip_token(pos, end), end);
+    pos = skip_blank(skip_token(pos, end), end);
+
+    const char* anchor = pos;
+    while (pos < end && *pos != '/' && *pos != ' ')
+    {
+        ++pos;
+    }
+    return str_ref_t(anchor, pos - anchor);
+}
+
+const sdp_attr_ref_t* sdp_view_t::find(const sdp_attr_ref_t* attrs, const char* key)
+{
+    size_t len = strlen(key);
+    for (; attrs; attrs = attrs->next)
+    {
+        if (attrs->key.equals(key, len))
+        {
+            return attrs;
+        }
+    }
+    return 0;
+}
+
+const sdp_attr_ref_t* sdp_view_t::find_attribute(const char* key) const
+{
+    return find(attrs_, key);
+}
+
+str_ref_t sdp_view_t::get_value(const char* key) const
+{
+    const sdp_attr_ref_t* attr = find_attribute(key);
+    return attr ? attr->value : str_ref_t();
+}
+
+const sdp_medium_ref_t* sdp_view_t::media() const
+{
+    const sdp_medium_ref_t* m = media_;
+    while (m && m->erased_)
+    {
+        m = m->next_;
+    }
+    return m;
+}
+
+void sdp_view_t::erase_medium(const sdp_medium_ref_t* medium)
+{
+    for (sdp_medium_ref_t* m = media_; m; m = m->next_)
+    {
+        if (m == medium && !m->erased_)
+        {
+            m->erased_ = true;
+            erased_ = true;
+            --media_count_;
+            break;
+        }
+    }
+}
+
+std::ostream& sdp_view_t::encode(std::ostream& s) const
+{
+    if (!erased_)
+    {
+        s.write(buf_, end_ - buf_);
+        return s;
+    }
+
+    s.write(buf_, header_end_ - buf_);
+    for (const sdp_medium_ref_t* m = media(); m; m = m->next())
+    {
+        s << m->raw_;
+    }
+    return s;
+}
+
+void sdp_view_t::encode(std::string& out) const
+{
+    out.clear();
+    if (!erased_)
+    {
+        out.assign(buf_, end_ - buf_);
+        return;
+    }
+
+    out.reserve(end_ - buf_);
+    out.append(buf_, header_end_ - buf_);
+    for (const sdp_medium_ref_t* m = media(); m; m = m->next())
+    {
+        out.append(m->raw_.data(), m->raw_.size());
+    }
+}
+
+// the legacy parser relies on a terminating NUL, so it runs over a copy
+void sdp_view_t::to_session(sdp_session_t& session) const
+{
+    std::string text;
+    encode(text);
+    parse_buffer_t pb(text.c_str(), text.size());
+    session.parse(pb);
+}
@@ -0,0 +1,269 @@
+#ifndef _SDP_VIEW_H_INCLUDED
+#define _SDP_VIEW_H_INCLUDED
+
+#include <iosfwd>
+#include <new>
+#include <string>
+#include <stddef.h>
+#include <stdint.h>
+
+// first arena block lives inside sdp_view_t, typical camera SDPs never leave it
+#define SDP_ARENA_INLINE_SIZE   2048
+#define SDP_ARENA_BLOCK_SIZE    4096
+
+namespace xt_sdp
+{
+    class sdp_session_t;
+    class sdp_view_t;
+
+    // non-owning reference into the parsed buffer
+    class str_ref_t
+    {
+    public:
+        str_ref_t() : data_(0), size_(0) {}
+        str_ref_t(const char* data, size_t size) : data_(data), size_(size) {}
+
+        const char* data() const { return data_; }
+        size_t size() const { return size_; }
+        bool empty() const { return 0 == size_; }
+
+        std::string str() const { return empty() ? std::string() : std::string(data_, size_); }
+
+        bool equals(const char* s, size_t len) const;
+        bool operator==(const char* s) const;
+        bool operator==(const std::string& s) const { return equals(s.data(), s.size()); }
+        bool operator!=(const char* s) const { return !(*this == s); }
+
+        // leading decimal digits after blanks, 0 when there are none
+        unsigned long to_ulong() const;
+
+        // strncpy semantics
+        void copy(char* dst, size_t n) const;
+
+    private:
+        const char* data_;
+        size_t size_;
+    };
+
+    std::ostream& operator<<(std::ostream& s, const str_ref_t& ref);
+
+    // per-message record storage, released as a whole
+    class sdp_arena_t
+    {
+    public:
+        sdp_arena_t();
+        ~sdp_arena_t();
+
+        void* alloc(size_t size);
+        void reset();
+
+    private:
+        sdp_arena_t(const sdp_arena_t&);
+        sdp_arena_t& operator=(const sdp_arena_t&);
+
+        struct block_t
+        {
+            block_t* next;
+            size_t size;
+            size_t used;
+        };
+
+        union
+        {
+            char buf[SDP_ARENA_INLINE_SIZE];
+            uint64_t align;
+        } inline_;
+        size_t inline_used_;
+        block_t* blocks_;
+    };
+
+    struct sdp_attr_ref_t
+    {
+        sdp_attr_ref_t() : next(0) {}
+
+        str_ref_t key;
+        str_ref_t value;
+        const sdp_attr_ref_t* next;
+    };
+
+    // one b=, c= or r= line, value is the text after '='
+    struct sdp_line_ref_t
+    {
+        sdp_line_ref_t() : next(0) {}
+
+        str_ref_t value;
+        const sdp_line_ref_t* next;
+    };
+
+    // t= line with the r= lines that directly follow it
+    struct sdp_time_ref_t
+    {
+        sdp_time_ref_t() : repeats(0), next(0) {}
+
+        str_ref_t value;
+        const sdp_line_ref_t* repeats;
+        const sdp_time_ref_t* next;
+    };
+
+    class sdp_medium_ref_t
+    {
+    public:
+        const str_ref_t& name() const { return name_; }
+        unsigned long port() const { return port_; }
+        unsigned long multicast() const { return multicast_; }
+        const str_ref_t& protocol() const { return protocol_; }
+        const str_ref_t& information() const { return information_; }
+
+        const str_ref_t* formats() const { return formats_; }
+        size_t format_count() const { return format_count_; }
+
+        // address of the first c= line of this medium, the session one when absent
+        const str_ref_t& connection_address() const;
+
+        // every c= and b= line of this medium, no session fallback
+        const sdp_line_ref_t* connections() const { return connections_; }
+        const sdp_line_ref_t* bandwidths() const { return bandwidths_; }
+
+        // medium attributes only
+        const sdp_attr_ref_t* attributes() const { return attrs_; }
+        const sdp_attr_ref_t* find_attribute(const char* key) const;
+
+        // like sdp_session_t::medium_t, fall back to session attributes
+        bool exists(const char* key) const;
+        str_ref_t get_value(const char* key) const;
+
+        // whole m= section as received
+        const str_ref_t& raw() const { return raw_; }
+
+        // next medium not erased
+        const sdp_medium_ref_t* next() const;
+
+    private:
+        friend class sdp_view_t;
+
+        // only sdp_view_t creates mediums, in its arena
+        sdp_medium_ref_t()
+            : view_(0),
+            port_(0),
+            multicast_(0),
+            formats_(0),
+            format_count_(0),
+            connections_(0),
+            connections_tail_(0),
+            bandwidths_(0),
+            bandwidths_tail_(0),
+            attrs_(0),
+            attrs_tail_(0),
+            erased_(false),
+            next_(0)
+        {}
+
+        const sdp_view_t* view_;
+        str_ref_t raw_;
+        str_ref_t name_;
+        unsigned long port_;
+        unsigned long multicast_;
+        str_ref_t protocol_;
+        str_ref_t information_;
+        str_ref_t connection_;
+        str_ref_t* formats_;
+        size_t format_count_;
+        sdp_line_ref_t* connections_;
+        sdp_line_ref_t* connections_tail_;
+        sdp_line_ref_t* bandwidths_;
+        sdp_line_ref_t* bandwidths_tail_;
+        sdp_attr_ref_t* attrs_;
+        sdp_attr_ref_t* attrs_tail_;
+        bool erased_;
+        sdp_medium_ref_t* next_;
+    };
+
+    // zero-copy SDP parser: records reference the original buffer and live in
+    // a per-message arena, encode() writes the received text back unchanged
+    class sdp_view_t
+    {
+    public:
+        sdp_view_t();
+
+        // buf must outlive the view and is never modified
+        bool parse(const char* buf, size_t len);
+        void clear();
+
+        int version() const { return version_; }
+        const str_ref_t& origin() const { return origin_; }
+        const str_ref_t& name() const { return name_; }
+        const str_ref_t& information() const { return information_; }
+        const str_ref_t& connection_address() const { return connection_; }
+        // whole value of the last session c= line
+        const str_ref_t& connection() const { return connection_line_; }
+        const sdp_line_ref_t* bandwidths() const { return bandwidths_; }
+        const sdp_time_ref_t* times() const { return times_; }
+
+        const sdp_attr_ref_t* attributes() const { return attrs_; }
+        const sdp_attr_ref_t* find_attribute(const char* key) const;
+        bool exists(const char* key) const { return 0 != find_attribute(key); }
+        str_ref_t get_value(const char* key) const;
+
+        const sdp_medium_ref_t* media() const;
+        size_t media_count() const { return media_count_; }
+
+        // drop the m= section from encode(), the buffer is left untouched
+        void erase_medium(const sdp_medium_ref_t* medium);
+
+        std::ostream& encode(std::ostream& s) const;
+        void encode(std::string& out) const;
+
+        // conversion, not a view: encodes the text and parses it again with
+        // sdp_session_t, so it costs a full legacy parse and owns copies of
+        // every field. Erased media are left out. session must be empty.
+        // Read-only callers use sdp_session_adapter_t (sdp_adapter.h), this
+        // is kept for code that edits the object model.
+        void to_session(sdp_session_t& session) const;
+
+    private:
+        sdp_view_t(const sdp_view_t&);
+        sdp_view_t& operator=(const sdp_view_t&);
+
+        friend class sdp_medium_ref_t;
+
+        template<typename T> T* make()
+        {
+            void* p = arena_.alloc(sizeof(T));
+            return p ? new (p) T() : 0;
+        }
+
+        bool parse_medium(const str_ref_t& value, const char* line);
+        bool add_attribute(const str_ref_t& value, sdp_attr_ref_t*& head, sdp_attr_ref_t*& tail);
+        bool add_line(const str_ref_t& value, sdp_line_ref_t*& head, sdp_line_ref_t*& tail);
+        bool add_time(const str_ref_t& value);
+        bool add_repeat(const str_ref_t& value);
+        static str_ref_t parse_connection(const str_ref_t& value);
+        static const sdp_attr_ref_t* find(const sdp_attr_ref_t* attrs, const char* key);
+
+        sdp_arena_t arena_;
+        const char* buf_;
+        const char* end_;
+        const char* header_end_;
+
+        int version_;
+        str_ref_t origin_;
+        str_ref_t name_;
+        str_ref_t information_;
+        str_ref_t connection_;
+        str_ref_t connection_line_;
+        sdp_line_ref_t* bandwidths_;
+        sdp_line_ref_t* bandwidths_tail_;
+        sdp_time_ref_t* times_;
+        sdp_time_ref_t* times_tail_;
+        sdp_line_ref_t* repeats_tail_;
+        sdp_attr_ref_t* attrs_;
+        sdp_attr_ref_t* attrs_tail_;
+
+        sdp_medium_ref_t* media_;
+        sdp_medium_ref_t* media_tail_;
+        size_t media_count_;
+        bool erased_;
+    };
+}
+
+#endif  //_SDP_VIEW_H_INCLUDED
@@ -0,0 +1,450 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+// file   : sdp_view_test.cpp
+// content: sdp_view_t against the legacy sdp_session_t parser
+//
+// 1. parity: every corpus SDP parses to the same fields as sdp_session_t, encode()
+//    gives back the received text, to_session() and erase_medium() match the
+//    legacy session, and sdp_session_adapter_t returns the legacy values through
+//    the legacy accessors (origin, connections, bandwidths, times, codecs)
+// 2. fuzz: mutated and truncated corpus SDPs parsed from exact-size heap copies
+//    (run under ASan to catch overreads), checked for encode round trip and
+//    erase_medium() consistency, with every adapter field built once
+// 3. bench: parse plus a control lookup per medium, legacy vs view
+//
+// usage: sdp_view_test [fuzz_iterations] [bench_loops] [corpus_dir]
+///////////////////////////////////////////////////////////////////////////////////////////
+#include "sdp.h"
+#include "parse_buffer.h"
+#include "sdp_view.h"
+#include "sdp_adapter.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace xt_sdp;
+
+namespace
+{
+    const char* const corpus_files[] = { "hik", "dahua", "gb28181_invite", "ffmpeg_lf", "xt_mux", "multicast" };
+
+    int g_fails = 0;
+
+#define CHECK(cond) \
+    do { if (!(cond)) { printf("FAIL %s:%d %s\n", name, __LINE__, #cond); ++g_fails; } } while (0)
+
+    bool read_file(const std::string& path, std::string& text)
+    {
+        std::ifstream in(path.c_str(), std::ios::binary);
+        if (!in)
+        {
+            return false;
+        }
+        std::ostringstream s;
+        s << in.rdbuf();
+        text = s.str();
+        return true;
+    }
+
+    double now_ns()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1e9 + ts.tv_nsec;
+    }
+
+    typedef std::list<std::pair<std::string, std::string> > attr_list_t;
+
+    void check_attributes(const char* name, const sdp_attr_ref_t* a, const attr_list_t& legacy)
+    {
+        attr_list_t::const_iterator l = legacy.begin();
+        for (; a && l != legacy.end(); a = a->next, ++l)
+        {
+            CHECK(a->key == l->first);
+            CHECK(a->value == l->second);
+        }
+        CHECK(!a && l == legacy.end());
+    }
+
+    void check_connections(const char* name, const std::list<sdp_session_t::connection_t>& a,
+        const std::list<sdp_session_t::connection_t>& legacy)
+    {
+        CHECK(a.size() == legacy.size());
+        std::list<sdp_session_t::connection_t>::const_iterator i = a.begin();
+        std::list<sdp_session_t::connection_t>::const_iterator l = legacy.begin();
+        for (; i != a.end() && l != legacy.end(); ++i, ++l)
+        {
+            CHECK(i->address_type() == l->address_type());
+            CHECK(i->address() == l->address());
+            CHECK(i->ttl() == l->ttl());
+        }
+    }
+
+    void check_bandwidths(const char* name, const std::list<sdp_session_t::bandwidth_t>& a,
+        const std::list<sdp_session_t::bandwidth_t>& legacy)
+    {
+        CHECK(a.size() == legacy.size());
+        std::list<sdp_session_t::bandwidth_t>::const_iterator i = a.begin();
+        std::list<sdp_session_t::bandwidth_t>::const_iterator l = legacy.begin();
+        for (; i != a.end() && l != legacy.end(); ++i, ++l)
+        {
+            CHECK(i->modifier() == l->modifier());
+            CHECK(i->kbs() == l->kbs());
+        }
+    }
+
+    void check_values(const char* name, const std::list<std::string>& a, const std::list<std::string>& legacy)
+    {
+        CHECK(a == legacy);
+    }
+
+    void adapter_parity(const char* name, const sdp_view_t& view, const sdp_session_t& legacy)
+    {
+        sdp_session_adapter_t adapter(view);
+        CHECK(adapter.version() == legacy.version());
+        CHECK(adapter.origin().user() == legacy.origin().user());
+        CHECK(adapter.origin().session_id() == legacy.origin().session_id());
+        CHECK(adapter.origin().version() == legacy.origin().version());
+        CHECK(adapter.origin().address_type() == legacy.origin().address_type());
+        CHECK(adapter.origin().address() == legacy.origin().address());
+        CHECK(adapter.name() == legacy.name());
+        CHECK(adapter.information() == legacy.information());
+        CHECK(adapter.is_connection() == legacy.is_connection());
+
+        std::list<sdp_session_t::connection_t> session_connection(1, adapter.connection());
+        check_connections(name, session_connection, std::list<sdp_session_t::connection_t>(1, legacy.connection()));
+        check_bandwidths(name, adapter.bandwidths(), legacy.bandwidths());
+
+        CHECK(adapter.times().size() == legacy.times().size());
+        std::list<sdp_session_t::time_t>::const_iterator t = adapter.times().begin();
+        std::list<sdp_session_t::time_t>::const_iterator lt = legacy.times().begin();
+        for (; t != adapter.times().end() && lt != legacy.times().end(); ++t, ++lt)
+        {
+            CHECK(t->start() == lt->start());
+            CHECK(t->stop() == lt->stop());
+            CHECK(t->repeats().size() == lt->repeats().size());
+            std::list<sdp_session_t::time_t::repeat_t>::const_iterator r = t->repeats().begin();
+            std::list<sdp_session_t::time_t::repeat_t>::const_iterator lr = lt->repeats().begin();
+            for (; r != t->repeats().end() && lr != lt->repeats().end(); ++r, ++lr)
+            {
+                CHECK(r->interval() == lr->interval());
+                CHECK(r->duration() == lr->duration());
+                CHECK(r->offsets() == lr->offsets());
+            }
+        }
+
+        const char* keys[] = { "control", "rtpmap", "fmtp", "tool", "sendonly", "missing" };
+        const size_t key_count = sizeof(keys) / sizeof(keys[0]);
+        for (size_t i = 0; i < key_count; ++i)
+        {
+            CHECK(adapter.exists(keys[i]) == legacy.exists(keys[i]));
+            check_values(name, adapter.get_values(keys[i]), legacy.get_values(keys[i]));
+        }
+
+        CHECK(adapter.media().size() == legacy.media().size());
+        sdp_session_adapter_t::medium_container_t::const_iterator m = adapter.media().begin();
+        sdp_session_t::medium_container_t::const_iterator lm = legacy.media().begin();
+        for (; m != adapter.media().end() && lm != legacy.media().end(); ++m, ++lm)
+        {
+            CHECK(m->name() == lm->name());
+            CHECK(m->port() == lm->port());
+            CHECK(m->multicast() == lm->multicast());
+            CHECK(m->protocol() == lm->protocol());
+            CHECK(m->information() == lm->information());
+            CHECK(m->formats() == lm->formats());
+            check_bandwidths(name, m->bandwidths(), lm->bandwidths());
+            check_connections(name, m->get_medium_connections(), lm->get_medium_connections());
+            check_connections(name, m->connections(), lm->connections());
+            for (size_t i = 0; i < key_count; ++i)
+            {
+                CHECK(m->exists(keys[i]) == lm->exists(keys[i]));
+                check_values(name, m->get_values(keys[i]), lm->get_values(keys[i]));
+            }
+
+            // legacy codecs() drops the formats and rtpmap/fmtp attributes,
+            // so it runs on a copy bound to the same session
+            sdp_session_t::medium_t codec_medium(*lm);
+            codec_medium.set_session(lm->session_);
+            const sdp_session_t::medium_t::codec_container_t& lc = codec_medium.codecs();
+            CHECK(m->codecs().size() == lc.size());
+            sdp_session_t::medium_t::codec_container_t::const_iterator c = m->codecs().begin();
+            sdp_session_t::medium_t::codec_container_t::const_iterator l = lc.begin();
+            for (; c != m->codecs().end() && l != lc.end(); ++c, ++l)
+            {
+                CHECK(c->name() == l->name());
+                CHECK(c->rate() == l->rate());
+                CHECK(c->payload() == l->payload());
+                CHECK(c->parameters() == l->parameters());
+                CHECK(c->encoding_parameters() == l->encoding_parameters());
+            }
+        }
+    }
+
+    std::string encode_session(const sdp_session_t& session)
+    {
+        std::ostringstream s;
+        session.encode(s);
+        return s.str();
+    }
+
+    void parity(const char* name, const std::string& text)
+    {
+        sdp_session_t legacy;
+        parse_buffer_t pb(text.c_str(), text.size());
+        legacy.parse(pb);
+
+        sdp_view_t view;
+        CHECK(view.parse(text.data(), text.size()));
+        CHECK(view.version() == legacy.version());
+        CHECK(view.name() == legacy.name());
+        CHECK(view.information() == legacy.information());
+        CHECK(view.connection_address() == legacy.connection().address());
+        CHECK(view.media_count() == legacy.media().size());
+        check_attributes(name, view.attributes(), legacy.attribute_helper_.attribute_list_);
+
+        const sdp_medium_ref_t* m = view.media();
+        for (sdp_session_t::medium_container_t::const_iterator lm = legacy.media().begin();
+            lm != legacy.media().end(); ++lm, m = m->next())
+        {
+            CHECK(m);
+            if (!m)
+            {
+                break;
+            }
+            CHECK(m->name() == lm->name());
+            CHECK(m->port() == lm->port_);
+            CHECK(m->multicast() == lm->multicast_);
+            CHECK(m->protocol() == lm->protocol());
+            CHECK(m->information() == lm->information());
+
+            CHECK(m->format_count() == lm->formats().size());
+            size_t k = 0;
+            for (std::list<std::string>::const_iterator f = lm->formats().begin();
+                f != lm->formats().end() && k < m->format_count(); ++f, ++k)
+            {
+                CHECK(m->formats()[k] == *f);
+            }
+
+            if (!lm->get_medium_connections().empty())
+            {
+                CHECK(m->connection_address() == lm->get_medium_connections().front().address());
+            }
+            else
+            {
+                CHECK(m->connection_address() == legacy.connection().address());
+            }
+            check_attributes(name, m->attributes(), lm->attribute_helper_.attribute_list_);
+
+            const char* keys[] = { "rtpmap", "control", "recvonly", "range" };
+            for (size_t i = 0; i < sizeof(keys) / sizeof(keys[0]); ++i)
+            {
+                CHECK(m->exists(keys[i]) == lm->exists(keys[i]));
+                if (lm->exists(keys[i]))
+                {
+                    CHECK(m->get_value(keys[i]) == lm->get_values(keys[i]).front());
+                }
+            }
+        }
+        CHECK(!m);
+
+        std::string out;
+        view.encode(out);
+        CHECK(out == text);
+
+        sdp_session_t converted;
+        view.to_session(converted);
+        CHECK(encode_session(converted) == encode_session(legacy));
+
+        adapter_parity(name, view, legacy);
+
+        if (view.media() && !legacy.media().empty())
+        {
+            view.erase_medium(view.media());
+            legacy.media_.pop_front();
+
+            view.encode(out);
+            sdp_view_t reparsed;
+            CHECK(reparsed.parse(out.data(), out.size()));
+            CHECK(reparsed.media_count() == legacy.media().size());
+
+            sdp_session_t erased;
+            view.to_session(erased);
+            CHECK(encode_session(erased) == encode_session(legacy));
+
+            adapter_parity(name, view, legacy);
+        }
+    }
+
+    uint32_t g_seed = 1;
+
+    uint32_t rnd()
+    {
+        g_seed = g_seed * 1103515245u + 12345u;
+        return g_seed >> 8;
+    }
+
+    void mutate(std::string& s)
+    {
+        static const char tokens[] = "\r\n=:/ am0";
+        uint32_t edits = rnd() % 8;
+        for (uint32_t i = 0; i < edits && !s.empty(); ++i)
+        {
+            size_t pos = rnd() % s.size();
+            switch (rnd() % 5)
+            {
+            case 0: s[pos] = (char)rnd(); break;
+            case 1: s.erase(pos, rnd() % 16); break;
+            case 2: s.insert(pos, 1, tokens[rnd() % (sizeof(tokens) - 1)]); break;
+            case 3: s.resize(pos); break;
+            default: s.insert(pos, s.substr(rnd() % s.size(), rnd() % 64)); break;
+            }
+        }
+    }
+
+    void fuzz(const std::vector<std::string>& corpus, uint32_t iterations)
+    {
+        const char* name = "fuzz";
+        uint64_t parsed = 0;
+        uint64_t touched = 0;
+        for (uint32_t it = 0; it < iterations; ++it)
+        {
+            std::string s = corpus[rnd() % corpus.size()];
+            mutate(s);
+
+            // exact-size copy without a terminator, as the view must never need one
+            char* buf = static_cast<char*>(malloc(s.empty() ? 1 : s.size()));
+            memcpy(buf, s.data(), s.size());
+
+            sdp_view_t view;
+            if (view.parse(buf, s.size()))
+            {
+                ++parsed;
+                // a NUL ends the SDP, like the legacy parser
+                std::string out;
+                view.encode(out);
+                CHECK(out == s.substr(0, s.find('\0')));
+
+                // every adapter field once, before any medium is erased
+                sdp_session_adapter_t adapter(view);
+                touched += adapter.origin().address().size() + adapter.connection().address().size()
+                    + adapter.bandwidths().size() + adapter.times().size() + adapter.get_values("rtpmap").size();
+                for (sdp_session_adapter_t::medium_container_t::const_iterator am = adapter.media().begin();
+                    am != adapter.media().end(); ++am)
+                {
+                    touched += am->codecs().size() + am->connections().size() + am->bandwidths().size()
+                        + am->formats().size() + am->get_values("fmtp").size();
+                }
+
+                size_t kept = view.media_count();
+                for (const sdp_medium_ref_t* m = view.media(); m; m = m->next())
+                {
+                    touched += m->name().size() + m->format_count() + m->get_value("rtpmap").size()
+                        + m->connection_address().size();
+                    if (0 == rnd() % 4)
+                    {
+                        view.erase_medium(m);
+                        --kept;
+                    }
+                }
+
+                size_t listed = 0;
+                for (const sdp_medium_ref_t* m = view.media(); m; m = m->next())
+                {
+                    ++listed;
+                }
+                CHECK(listed == kept);
+
+                // dropping whole m= sections keeps every remaining line intact
+                view.encode(out);
+                sdp_view_t reparsed;
+                CHECK(reparsed.parse(out.data(), out.size()));
+                std::string again;
+                reparsed.encode(again);
+                CHECK(again == out);
+            }
+            free(buf);
+        }
+        printf("fuzz: %u inputs, %llu parsed, %llu bytes touched\n",
+            iterations, (unsigned long long)parsed, (unsigned long long)touched);
+    }
+
+    void bench(const std::vector<std::string>& corpus, uint32_t loops)
+    {
+        for (size_t i = 0; i < corpus.size(); ++i)
+        {
+            const std::string& text = corpus[i];
+            uint64_t legacy_hits = 0;
+            uint64_t view_hits = 0;
+
+            double begin = now_ns();
+            for (uint32_t k = 0; k < loops; ++k)
+            {
+                sdp_session_t session;
+                parse_buffer_t pb(text.c_str(), text.size());
+                session.parse(pb);
+                for (sdp_session_t::medium_container_t::const_iterator m = session.media().begin();
+                    m != session.media().end(); ++m)
+                {
+                    legacy_hits += m->exists("control") ? 1 : 0;
+                }
+            }
+            double legacy_ns = (now_ns() - begin) / loops;
+
+            begin = now_ns();
+            for (uint32_t k = 0; k < loops; ++k)
+            {
+                sdp_view_t view;
+                view.parse(text.data(), text.size());
+                for (const sdp_medium_ref_t* m = view.media(); m; m = m->next())
+                {
+                    view_hits += m->exists("control") ? 1 : 0;
+                }
+            }
+            double view_ns = (now_ns() - begin) / loops;
+
+            if (legacy_hits != view_hits)
+            {
+                printf("FAIL bench %s: %llu vs %llu control lookups\n", corpus_files[i],
+                    (unsigned long long)legacy_hits, (unsigned long long)view_hits);
+                ++g_fails;
+            }
+            printf("bench: %-16s %4u bytes  legacy %8.0f ns  view %6.0f ns  x%.1f\n",
+                corpus_files[i], (uint32_t)text.size(), legacy_ns, view_ns, legacy_ns / view_ns);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t iterations = (argc > 1) ? (uint32_t)atoi(argv[1]) : 200000;
+    uint32_t loops = (argc > 2) ? (uint32_t)atoi(argv[2]) : 20000;
+    std::string dir = (argc > 3) ? argv[3] : "corpus";
+
+    std::vector<std::string> corpus;
+    for (size_t i = 0; i < sizeof(corpus_files) / sizeof(corpus_files[0]); ++i)
+    {
+        std::string text;
+        if (!read_file(dir + "/" + corpus_files[i] + ".sdp", text))
+        {
+            printf("can not read %s/%s.sdp\n", dir.c_str(), corpus_files[i]);
+            return 1;
+        }
+        corpus.push_back(text);
+        parity(corpus_files[i], text);
+    }
+    printf("parity: %u SDPs, %d failures\n", (uint32_t)corpus.size(), g_fails);
+
+    fuzz(corpus, iterations);
+    if (loops > 0)
+    {
+        bench(corpus, loops);
+    }
+
+    printf("%s\n", (0 == g_fails) ? "PASS" : "FAIL");
+    return (0 == g_fails) ? 0 : 1;
+}